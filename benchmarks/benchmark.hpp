@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace netatmoapi {
+namespace benchmark {
+
+/**
+ * Prevents the compiler from optimizing away a result.
+ */
+template <typename T>
+inline void doNotOptimize(const T &value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * @brief Minimal benchmark runner.
+ *
+ * Every benchmark function is called repeatedly until it ran for at least
+ * the minimum time (default 0.5 seconds, "--min-time=<seconds>"). Only
+ * benchmarks, whose name contains the filter ("--filter=<text>"), are
+ * run. The time per iteration and the throughput are printed to stdout.
+ *
+ * With "--json=<file>" the results are also written to a json file, when
+ * the runner is destroyed. The file uses the keys of Google Benchmark
+ * ("name", "iterations", "real_time", "time_unit", "items_per_second",
+ * "bytes_per_second"), so its comparison tools can track regressions.
+ */
+class Runner {
+public:
+    Runner(int argc, char **argv) :
+        mExecutable(argc > 0 ? argv[0] : ""),
+        mMinTime(0.5)
+    {
+        for (int i = 1; i < argc; ++i) {
+            if (std::strncmp(argv[i], "--filter=", 9) == 0) {
+                mFilter = argv[i] + 9;
+            } else if (std::strncmp(argv[i], "--min-time=", 11) == 0) {
+                mMinTime = std::atof(argv[i] + 11);
+            } else if (std::strncmp(argv[i], "--json=", 7) == 0) {
+                mJsonPath = argv[i] + 7;
+            }
+        }
+        std::cout << std::left << std::setw(48) << "Benchmark" << std::right
+                  << std::setw(14) << "Iterations" << std::setw(16) << "ns/iteration"
+                  << std::setw(16) << "items/s" << std::setw(14) << "MB/s" << "\n";
+    }
+
+    Runner(const Runner &) = delete;
+    Runner &operator =(const Runner &) = delete;
+
+    /**
+     * Destructor.
+     * Writes the json file, if requested.
+     */
+    ~Runner() {
+        if (mJsonPath.empty()) {
+            return;
+        }
+        char date[32];
+        std::time_t now = std::time(nullptr);
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", std::localtime(&now));
+        std::ofstream file(mJsonPath);
+        file << "{\n  \"context\": {\n    \"date\": \"" << date << "\",\n    \"executable\": \"" << escape(mExecutable) << "\"\n  },\n"
+             << "  \"benchmarks\": [";
+        for (std::size_t i = 0; i < mResults.size(); ++i) {
+            file << (i > 0 ? ",\n" : "\n") << mResults[i];
+        }
+        file << "\n  ]\n}\n";
+        if (!file) {
+            std::cerr << "Could not write " << mJsonPath << "\n";
+        }
+    }
+
+    /**
+     * Runs a benchmark.
+     * @param name The name of the benchmark.
+     * @param itemsPerIteration The number of processed items per call of f, e.g. measures.
+     * @param bytesPerIteration The number of processed bytes per call of f, 0 if not applicable.
+     * @param f The benchmark function.
+     */
+    template <typename F>
+    void run(const std::string &name, std::uint64_t itemsPerIteration, std::uint64_t bytesPerIteration, F &&f) {
+        if (!mFilter.empty() && name.find(mFilter) == std::string::npos) {
+            return;
+        }
+        typedef std::chrono::steady_clock Clock;
+        f();
+        std::uint64_t iterations = 0;
+        std::uint64_t batch = 1;
+        double seconds = 0;
+        Clock::time_point start = Clock::now();
+        while (seconds < mMinTime) {
+            for (std::uint64_t i = 0; i < batch; ++i) {
+                f();
+            }
+            iterations += batch;
+            seconds = std::chrono::duration<double>(Clock::now() - start).count();
+            if (batch < (std::uint64_t(1) << 20)) {
+                batch *= 2;
+            }
+        }
+        double nsPerIteration = seconds * 1e9 / double(iterations);
+        double itemsPerSecond = double(itemsPerIteration) * double(iterations) / seconds;
+        double megabytesPerSecond = double(bytesPerIteration) * double(iterations) / seconds / 1e6;
+        std::cout << std::left << std::setw(48) << name << std::right
+                  << std::setw(14) << iterations
+                  << std::setw(16) << std::fixed << std::setprecision(1) << nsPerIteration
+                  << std::setw(16) << std::scientific << std::setprecision(3) << itemsPerSecond
+                  << std::setw(14) << std::fixed << std::setprecision(1) << megabytesPerSecond << "\n";
+        std::cout.unsetf(std::ios::floatfield);
+
+        if (!mJsonPath.empty()) {
+            std::ostringstream result;
+            result << std::setprecision(17)
+                   << "    {\n      \"name\": \"" << escape(name) << "\",\n"
+                   << "      \"iterations\": " << iterations << ",\n"
+                   << "      \"real_time\": " << nsPerIteration << ",\n"
+                   << "      \"time_unit\": \"ns\",\n"
+                   << "      \"items_per_second\": " << itemsPerSecond << ",\n"
+                   << "      \"bytes_per_second\": " << megabytesPerSecond * 1e6 << "\n    }";
+            mResults.push_back(result.str());
+        }
+    }
+
+private:
+    static std::string escape(const std::string &value) {
+        std::string escaped;
+        for (char c: value) {
+            if (c == '"' || c == '\\') {
+                escaped.push_back('\\');
+            }
+            escaped.push_back(c);
+        }
+        return escaped;
+    }
+
+    std::string mExecutable;
+    std::string mFilter;
+    std::string mJsonPath;
+    std::vector<std::string> mResults;
+    double mMinTime;
+};
+
+}
+}
+
+#endif /* BENCHMARK_HPP */
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "benchmark.hpp"
+#include "core/utils.h"
+
+#include <random>
+#include <vector>
+
+using namespace netatmoapi;
+using namespace std;
+
+// Synthetic getmeasure response with two types, variable steps, gaps and missing values.
+json makeBlocks(size_t measures) {
+    mt19937 random(42);
+    uniform_int_distribution<size_t> blockSize(50, 500);
+    uniform_int_distribution<int> percent(0, 99);
+    json blocks = json::array();
+    uint64_t timeStamp = 1483228800;
+    size_t count = 0;
+    while (count < measures) {
+        size_t size = min(blockSize(random), measures - count);
+        uint64_t step = percent(random) < 80 ? 300 : 600;
+        json values = json::array();
+        for (size_t i = 0; i < size; ++i) {
+            json row = json::array();
+            row.push_back(20.0 + double(i % 100) / 10.0);
+            if (percent(random) < 2) {
+                row.push_back(nullptr);
+            } else {
+                row.push_back(40 + int(i % 50));
+            }
+            values.push_back(move(row));
+        }
+        blocks.push_back({ { "beg_time", timeStamp }, { "step_time", step }, { "value", move(values) } });
+        // Gap of a few steps between the blocks.
+        timeStamp += step * (size + 3);
+        count += size;
+    }
+    return blocks;
+}
+
+int main(int argc, char **argv) {
+    benchmark::Runner runner(argc, argv);
+    for (size_t measures: { size_t(10000), size_t(1000000) }) {
+        json blocks = makeBlocks(measures);
+        string raw = blocks.dump();
+        string suffix = "/" + to_string(measures);
+
+        MeasureColumns columns(2);
+        runner.run("decodeMeasureBlocks" + suffix, measures, 0, [&]() {
+            columns.clear();
+            utils::decodeMeasureBlocks(blocks, columns);
+            benchmark::doNotOptimize(columns.mTimeStamps.data());
+        });
+
+        // Baseline: one Measures struct per measure.
+        vector<Measures> points;
+        runner.run("expandToMeasures" + suffix, measures, 0, [&]() {
+            points.clear();
+            for (const json &block: blocks) {
+                uint64_t timeStamp = block["beg_time"];
+                uint64_t step = block["step_time"];
+                for (const json &row: block["value"]) {
+                    Measures measure;
+                    measure.mTimeStamp = timeStamp;
+                    measure.mTemperature = row[0];
+                    if (row[1].is_number()) {
+                        measure.mHumidity = row[1];
+                    }
+                    points.push_back(measure);
+                    timeStamp += step;
+                }
+            }
+            benchmark::doNotOptimize(points.data());
+        });
+
+        runner.run("parseAndDecodeMeasureBlocks" + suffix, measures, raw.size(), [&]() {
+            columns.clear();
+            utils::decodeMeasureBlocks(json::parse(raw), columns);
+            benchmark::doNotOptimize(columns.mTimeStamps.data());
+        });
+    }
+    return 0;
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "benchmark.hpp"
+#include "core/derivedmetrics.h"
+
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace netatmoapi;
+using namespace std;
+
+int main(int argc, char **argv) {
+    benchmark::Runner runner(argc, argv);
+    const size_t count = 1000000;
+    mt19937 random(42);
+    uniform_int_distribution<int> percent(0, 99);
+    uniform_real_distribution<double> temperature(-20, 40);
+    uniform_real_distribution<double> humidity(10, 100);
+    uniform_real_distribution<double> windStrength(0, 60);
+    vector<double> temperatures, humidities, windStrengths;
+    for (size_t i = 0; i < count; ++i) {
+        temperatures.push_back(percent(random) < 2 ? numeric_limits<double>::min() : temperature(random));
+        humidities.push_back(humidity(random));
+        windStrengths.push_back(windStrength(random));
+    }
+    vector<double> result(count);
+    const size_t bytes = 3 * count * sizeof(double);
+
+    runner.run("dewPoint/scalar", count, bytes, [&]() {
+        for (size_t i = 0; i < count; ++i) {
+            result[i] = derived::dewPoint(temperatures[i], humidities[i]);
+        }
+        benchmark::doNotOptimize(result.data());
+    });
+    runner.run("dewPoint/batch", count, bytes, [&]() {
+        derived::dewPoint(temperatures.data(), humidities.data(), result.data(), count);
+        benchmark::doNotOptimize(result.data());
+    });
+    runner.run("heatIndex/scalar", count, bytes, [&]() {
+        for (size_t i = 0; i < count; ++i) {
+            result[i] = derived::heatIndex(temperatures[i], humidities[i]);
+        }
+        benchmark::doNotOptimize(result.data());
+    });
+    runner.run("heatIndex/batch", count, bytes, [&]() {
+        derived::heatIndex(temperatures.data(), humidities.data(), result.data(), count);
+        benchmark::doNotOptimize(result.data());
+    });
+    runner.run("humidex/scalar", count, bytes, [&]() {
+        for (size_t i = 0; i < count; ++i) {
+            result[i] = derived::humidex(temperatures[i], humidities[i]);
+        }
+        benchmark::doNotOptimize(result.data());
+    });
+    runner.run("humidex/batch", count, bytes, [&]() {
+        derived::humidex(temperatures.data(), humidities.data(), result.data(), count);
+        benchmark::doNotOptimize(result.data());
+    });
+    runner.run("windChill/scalar", count, bytes, [&]() {
+        for (size_t i = 0; i < count; ++i) {
+            result[i] = derived::windChill(temperatures[i], windStrengths[i]);
+        }
+        benchmark::doNotOptimize(result.data());
+    });
+    runner.run("windChill/batch", count, bytes, [&]() {
+        derived::windChill(temperatures.data(), windStrengths.data(), result.data(), count);
+        benchmark::doNotOptimize(result.data());
+    });
+    return 0;
+}
@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef FIXTURES_HPP
+#define FIXTURES_HPP
+
+#include "core/transport.h"
+
+#include <cstddef>
+#include <cstdio>
+#include <map>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace netatmoapi {
+namespace benchmark {
+
+using json = nlohmann::json;
+
+/**
+ * Returns a station of a getstationsdata response.
+ * @param index The index of the station, which is part of the id.
+ * @param modules The number of modules: an outdoor module, a wind gauge with its wind history and a rain gauge, at most 3.
+ * @return The station.
+ */
+inline json makeStation(std::size_t index, std::size_t modules = 1) {
+    char id[18];
+    std::snprintf(id, sizeof(id), "70:ee:50:%02zx:%02zx:%02zx", (index >> 16) & 0xff, (index >> 8) & 0xff, index & 0xff);
+    const std::string suffix = id + 2;
+    json jsonModules = json::array();
+    if (modules > 0) {
+        jsonModules.push_back({
+            { "_id", "02" + suffix }, { "type", "NAModule1" }, { "module_name", "Outdoor" },
+            { "battery_percent", 88 }, { "rf_status", 75 },
+            { "dashboard_data", { { "time_utc", 1509446923 }, { "Temperature", 8.2 }, { "temp_trend", "up" }, { "Humidity", 84 },
+                                  { "date_max_temp", 1509446923 }, { "date_min_temp", 1509406779 }, { "min_temp", 3.8 }, { "max_temp", 8.2 } } }
+        });
+    }
+    if (modules > 1) {
+        jsonModules.push_back({
+            { "_id", "06" + suffix }, { "type", "NAModule2" }, { "module_name", "Wind" },
+            { "battery_percent", 64 }, { "rf_status", 70 },
+            { "dashboard_data", { { "time_utc", 1509446917 }, { "WindStrength", 12 }, { "WindAngle", 225 }, { "GustStrength", 21 }, { "GustAngle", 240 },
+                                  { "max_wind_str", 27 }, { "max_wind_angle", 250 }, { "date_max_wind_str", 1509438000 },
+                                  { "WindHistoric", {
+                                      { { "WindStrength", 10 }, { "WindAngle", 220 }, { "time_utc", 1509446317 } },
+                                      { { "WindStrength", 14 }, { "WindAngle", 230 }, { "time_utc", 1509446617 } },
+                                      { { "WindStrength", 12 }, { "WindAngle", 225 }, { "time_utc", 1509446917 } } } } } }
+        });
+    }
+    if (modules > 2) {
+        jsonModules.push_back({
+            { "_id", "05" + suffix }, { "type", "NAModule3" }, { "module_name", "Rain" },
+            { "battery_percent", 92 }, { "rf_status", 68 },
+            { "dashboard_data", { { "time_utc", 1509446917 }, { "Rain", 0.1 }, { "sum_rain_24", 3.4 }, { "sum_rain_1", 0.3 } } }
+        });
+    }
+    return {
+        { "_id", id }, { "station_name", "Station" }, { "module_name", "Indoor" }, { "type", "NAMain" },
+        { "place", { { "altitude", 248 }, { "city", "Waldbreitbach" }, { "country", "DE" }, { "timezone", "Europe/Berlin" }, { "location", { 7.4, 50.5 } } } },
+        { "dashboard_data", { { "AbsolutePressure", 999.2 }, { "time_utc", 1509446950 }, { "Noise", 48 }, { "Temperature", 21.1 },
+                              { "temp_trend", "stable" }, { "Humidity", 56 }, { "Pressure", 1029.1 }, { "pressure_trend", "stable" }, { "CO2", 1101 },
+                              { "date_max_temp", 1509446041 }, { "date_min_temp", 1509432104 }, { "min_temp", 19.5 }, { "max_temp", 21.1 } } },
+        { "modules", jsonModules }
+    };
+}
+
+/**
+ * Returns a getstationsdata response.
+ * @param stations The number of stations.
+ * @param modules The number of modules per station, see makeStation().
+ * @return The serialized response.
+ */
+inline std::string makeStationsResponse(std::size_t stations, std::size_t modules = 1) {
+    json devices = json::array();
+    for (std::size_t i = 0; i < stations; ++i) {
+        devices.push_back(makeStation(i, modules));
+    }
+    json response = { { "body", { { "devices", devices } } }, { "status", "ok" } };
+    return response.dump();
+}
+
+/**
+ * @brief Transport with canned responses.
+ *
+ * A request is answered with the response of the first path contained in
+ * its url, otherwise with the default response. The responses must be set
+ * before the transport is used.
+ */
+class CannedTransport: public Transport {
+public:
+    /**
+     * Constructor.
+     * @param response The default response.
+     */
+    explicit CannedTransport(std::string &&response) :
+        mResponse(std::move(response))
+        {}
+
+    /**
+     * Sets the response of the requests to a path, e.g. getstationsdata.
+     * @param path The path.
+     * @param response The response.
+     */
+    void setResponse(std::string &&path, std::string &&response) {
+        mResponses.emplace_back(std::move(path), std::move(response));
+    }
+
+    std::string get(const std::string &url, const std::map<std::string, std::string> &) override {
+        return response(url);
+    }
+
+    std::string post(const std::string &url, const std::map<std::string, std::string> &) override {
+        return response(url);
+    }
+
+private:
+    const std::string &response(const std::string &url) const {
+        for (const std::pair<std::string, std::string> &response: mResponses) {
+            if (url.find(response.first) != std::string::npos) {
+                return response.second;
+            }
+        }
+        return mResponse;
+    }
+
+    std::string mResponse;
+    std::vector<std::pair<std::string, std::string>> mResponses;
+};
+
+}
+}
+
+#endif /* FIXTURES_HPP */
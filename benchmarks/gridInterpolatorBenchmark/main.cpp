@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "benchmark.hpp"
+#include "core/gridinterpolator.h"
+#include "core/simd.hpp"
+
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace netatmoapi;
+using namespace std;
+
+vector<GridInterpolator::Sample> makeSamples(size_t count) {
+    mt19937 random(42);
+    uniform_real_distribution<double> latitude(45, 55);
+    uniform_real_distribution<double> longitude(0, 15);
+    uniform_real_distribution<double> value(-10, 30);
+    vector<GridInterpolator::Sample> samples(count);
+    for (GridInterpolator::Sample &sample: samples) {
+        sample = { latitude(random), longitude(random), value(random) };
+    }
+    return samples;
+}
+
+int main(int argc, char **argv) {
+    benchmark::Runner runner(argc, argv);
+    const size_t rows = 512, columns = 512;
+    const BoundingBox region(55, 15, 45, 0);
+
+    GridInterpolator interpolator;
+    interpolator.setSamples(makeSamples(10000));
+    runner.run("idw/8/power2/512x512", rows * columns, 0, [&]() {
+        Raster raster = interpolator.interpolate(region, rows, columns);
+        benchmark::doNotOptimize(raster.mValues.data());
+    });
+    interpolator.setPower(3);
+    runner.run("idw/8/power3/512x512", rows * columns, 0, [&]() {
+        Raster raster = interpolator.interpolate(region, rows, columns);
+        benchmark::doNotOptimize(raster.mValues.data());
+    });
+    interpolator.setMethod(GridInterpolator::nearestNeighbour);
+    runner.run("nearest/512x512", rows * columns, 0, [&]() {
+        Raster raster = interpolator.interpolate(region, rows, columns);
+        benchmark::doNotOptimize(raster.mValues.data());
+    });
+
+    // The weighting of one row alone, without the neighbour lookup.
+    const size_t neighbours = 8;
+    mt19937 random(7);
+    uniform_real_distribution<double> distance(1e-6, 1e-3);
+    vector<double> squared(neighbours * columns), values(neighbours * columns), result(columns);
+    for (size_t i = 0; i < squared.size(); ++i) {
+        squared[i] = distance(random);
+        values[i] = distance(random) * 1e4;
+    }
+    for (double power: { 2.0, 3.0 }) {
+        string suffix = power == 2 ? "power2" : "power3";
+        runner.run("weights/scalar/" + suffix, columns, 0, [&]() {
+            simd::inverseDistanceScalar(squared.data(), values.data(), columns, columns, neighbours, power, 1e-18, result.data());
+            benchmark::doNotOptimize(result.data());
+        });
+        runner.run("weights/simd/" + suffix, columns, 0, [&]() {
+            simd::inverseDistance(squared.data(), values.data(), columns, neighbours, power, 1e-18, result.data());
+            benchmark::doNotOptimize(result.data());
+        });
+    }
+    return 0;
+}
@@ -0,0 +1,327 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "core/nawsapiclient.h"
+#include "core/tdigest.h"
+#include "core/utils.h"
+#include "mockserver.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <nlohmann/json.hpp>
+#include <sys/resource.h>
+#include <thread>
+#include <vector>
+
+using json = nlohmann::json;
+using namespace netatmoapi;
+using namespace std;
+
+typedef chrono::steady_clock Clock;
+
+struct Options {
+    size_t mAccounts = 100;
+    size_t mConcurrency = 8;
+    double mDuration = 10;
+    chrono::milliseconds mInterval = chrono::milliseconds(0);
+    size_t mStations = MockServer::sDefaultStationCount;
+    size_t mModules = MockServer::sDefaultModuleCount;
+    chrono::milliseconds mMinLatency = chrono::milliseconds(0);
+    chrono::milliseconds mMaxLatency = chrono::milliseconds(0);
+    double mErrorRate = 0;
+    int64_t mTokenLifetime = 5;
+    string mUrl;
+    bool mParse = false;
+    string mJsonPath;
+    bool mAllowDebug = false;
+};
+
+// Latencies in milliseconds and counts of one operation.
+struct Operation {
+    Operation() :
+        mLatencies(200),
+        mCount(0),
+        mErrors(0) {
+    }
+
+    void merge(const Operation &o) {
+        mLatencies.merge(o.mLatencies);
+        mCount += o.mCount;
+        mErrors += o.mErrors;
+    }
+
+    TDigest mLatencies;
+    size_t mCount;
+    size_t mErrors;
+};
+
+struct Stats {
+    Operation mLogin;
+    Operation mRefresh;
+    Operation mPoll;
+    // User and system time of the client threads in seconds.
+    double mCpu = 0;
+};
+
+struct Account {
+    explicit Account(NAWSApiClient &&client) :
+        mClient(move(client)),
+        mDue(Clock::now()),
+        mLoggedIn(false) {
+    }
+
+    NAWSApiClient mClient;
+    Clock::time_point mDue;
+    bool mLoggedIn;
+};
+
+double threadCpu() {
+    rusage usage;
+    getrusage(RUSAGE_THREAD, &usage);
+    return double(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) + double(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+// Times f and adds the latency, or counts the error.
+template <typename F>
+bool measure(Operation &operation, F &&f) {
+    auto start = Clock::now();
+    try {
+        f();
+    } catch (const exception &) {
+        ++operation.mErrors;
+        return false;
+    }
+    ++operation.mCount;
+    operation.mLatencies.add(chrono::duration<double, milli>(Clock::now() - start).count());
+    return true;
+}
+
+// Polls its accounts until the deadline. Every account logs in, refreshes
+// its token when it expired and polls the stations data, at most once per
+// interval, or as fast as possible without an interval.
+void runWorker(vector<Account> &accounts, const Options &options, Clock::time_point deadline, Stats &stats) {
+    const double cpuStart = threadCpu();
+    list<Station> stations;
+    while (!accounts.empty()) {
+        auto account = min_element(accounts.begin(), accounts.end(), [](const Account &a, const Account &b) {
+            return a.mDue < b.mDue;
+        });
+        if (account->mDue >= deadline) {
+            break;
+        }
+        if (account->mDue > Clock::now()) {
+            this_thread::sleep_until(account->mDue);
+        }
+        if (Clock::now() >= deadline) {
+            break;
+        }
+        const Clock::time_point start = Clock::now();
+        NAWSApiClient &client = account->mClient;
+        if (!account->mLoggedIn) {
+            account->mLoggedIn = measure(stats.mLogin, [&client]() { client.login(); });
+        } else if (time(nullptr) >= client.expiresIn()) {
+            // A failed refresh logs in again.
+            account->mLoggedIn = measure(stats.mRefresh, [&client]() { client.updateSession(); });
+        }
+        if (account->mLoggedIn) {
+            measure(stats.mPoll, [&]() {
+                json response = client.requestStationsData();
+                if (options.mParse) {
+                    utils::parseDevices(response, stations);
+                }
+            });
+        }
+        account->mDue = start + options.mInterval;
+    }
+    stats.mCpu = threadCpu() - cpuStart;
+}
+
+bool parseOptions(int argc, char **argv, Options &options) {
+    for (int i = 1; i < argc; ++i) {
+        const char *value = strchr(argv[i], '=');
+        value = value ? value + 1 : "";
+        if (strncmp(argv[i], "--accounts=", 11) == 0) {
+            options.mAccounts = size_t(atol(value));
+        } else if (strncmp(argv[i], "--concurrency=", 14) == 0) {
+            options.mConcurrency = max<size_t>(size_t(atol(value)), 1);
+        } else if (strncmp(argv[i], "--duration=", 11) == 0) {
+            options.mDuration = atof(value);
+        } else if (strncmp(argv[i], "--interval=", 11) == 0) {
+            options.mInterval = chrono::milliseconds(atol(value));
+        } else if (strncmp(argv[i], "--stations=", 11) == 0) {
+            options.mStations = size_t(atol(value));
+        } else if (strncmp(argv[i], "--modules=", 10) == 0) {
+            options.mModules = size_t(atol(value));
+        } else if (strncmp(argv[i], "--latency=", 10) == 0) {
+            const char *max = strchr(value, ':');
+            options.mMinLatency = chrono::milliseconds(atol(value));
+            options.mMaxLatency = chrono::milliseconds(max ? atol(max + 1) : 0);
+        } else if (strncmp(argv[i], "--error-rate=", 13) == 0) {
+            options.mErrorRate = atof(value);
+        } else if (strncmp(argv[i], "--token-lifetime=", 17) == 0) {
+            options.mTokenLifetime = atol(value);
+        } else if (strncmp(argv[i], "--url=", 6) == 0) {
+            options.mUrl = value;
+        } else if (strcmp(argv[i], "--parse") == 0) {
+            options.mParse = true;
+        } else if (strncmp(argv[i], "--json=", 7) == 0) {
+            options.mJsonPath = value;
+        } else if (strcmp(argv[i], "--allow-debug") == 0) {
+            options.mAllowDebug = true;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+json report(const char *name, Operation &operation, double duration) {
+    json result = {
+        { "name", name },
+        { "count", operation.mCount },
+        { "errors", operation.mErrors },
+        { "throughput", double(operation.mCount) / duration }
+    };
+    if (operation.mCount > 0) {
+        result["p50"] = operation.mLatencies.quantile(0.5);
+        result["p99"] = operation.mLatencies.quantile(0.99);
+        result["p999"] = operation.mLatencies.quantile(0.999);
+        result["max"] = operation.mLatencies.max();
+    }
+    return result;
+}
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        cerr << "Usage: " << argv[0] << " [--accounts=<count>] [--concurrency=<threads>] [--duration=<seconds>] [--interval=<ms>]\n"
+             << "    [--stations=<count>] [--modules=<0-4>] [--latency=<min ms>[:<max ms>]] [--error-rate=<0-1>] [--token-lifetime=<seconds>]\n"
+             << "    [--url=<base url of a running mock server>] [--parse] [--json=<file>] [--allow-debug]\n";
+        return 1;
+    }
+#if !defined(NDEBUG)
+    // Without NDEBUG the transport prints every response, which costs more
+    // cpu than the client itself.
+    if (!options.mAllowDebug) {
+        cerr << "The load generator needs a release build (-DCMAKE_BUILD_TYPE=Release), or run it with --allow-debug.\n";
+        return 1;
+    }
+    cerr << "Warning: debug build, the numbers include the debug output of the transport.\n";
+#endif
+
+    // Without an url, the mock server runs in this process. Its threads are
+    // not part of the client cpu time, but of the process cpu time and memory.
+    MockServer server;
+    string url = options.mUrl;
+    if (url.empty()) {
+        server.setFleet(options.mStations, options.mModules);
+        server.setLatency(options.mMinLatency, options.mMaxLatency);
+        server.setErrorRate(options.mErrorRate);
+        server.setTokenLifetime(options.mTokenLifetime);
+        server.start();
+        url = server.urlBase();
+    }
+
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    const long baselineRss = usage.ru_maxrss;
+
+    vector<vector<Account>> accounts(options.mConcurrency);
+    for (size_t i = 0; i < options.mAccounts; ++i) {
+        string user = "user" + to_string(i);
+        NAWSApiClient client(user + "@example.com", "password", "client" + to_string(i), "secret");
+        client.setUrlBase(url);
+        client.setRateLimit(0, 0);
+        accounts[i % options.mConcurrency].emplace_back(move(client));
+    }
+
+    vector<Stats> stats(options.mConcurrency);
+    const Clock::time_point start = Clock::now();
+    const Clock::time_point deadline = start + chrono::duration_cast<Clock::duration>(chrono::duration<double>(options.mDuration));
+    vector<thread> threads;
+    for (size_t i = 0; i < options.mConcurrency; ++i) {
+        threads.emplace_back(runWorker, ref(accounts[i]), cref(options), deadline, ref(stats[i]));
+    }
+    for (thread &t: threads) {
+        t.join();
+    }
+    const double duration = chrono::duration<double>(Clock::now() - start).count();
+    server.stop();
+
+    Stats total;
+    for (const Stats &s: stats) {
+        total.mLogin.merge(s.mLogin);
+        total.mRefresh.merge(s.mRefresh);
+        total.mPoll.merge(s.mPoll);
+        total.mCpu += s.mCpu;
+    }
+    getrusage(RUSAGE_SELF, &usage);
+    const double processCpu = double(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) + double(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+    const size_t requests = total.mLogin.mCount + total.mRefresh.mCount + total.mPoll.mCount
+        + total.mLogin.mErrors + total.mRefresh.mErrors + total.mPoll.mErrors;
+
+    json result = {
+        { "accounts", options.mAccounts },
+        { "concurrency", options.mConcurrency },
+        { "duration", duration },
+        { "operations", { report("login", total.mLogin, duration), report("refresh", total.mRefresh, duration), report("poll", total.mPoll, duration) } },
+        { "requests", requests },
+        { "clientCpuPerRequest", requests > 0 ? total.mCpu / double(requests) * 1e6 : 0 },
+        { "processCpuPerRequest", requests > 0 ? processCpu / double(requests) * 1e6 : 0 },
+        { "baselineRssKb", baselineRss },
+        { "maxRssKb", usage.ru_maxrss }
+    };
+    if (!options.mJsonPath.empty()) {
+        ofstream file(options.mJsonPath);
+        file << result.dump(2) << "\n";
+        if (!file) {
+            cerr << "Could not write " << options.mJsonPath << "\n";
+        }
+    }
+
+    cout << options.mAccounts << " accounts, " << options.mConcurrency << " threads, " << fixed << setprecision(1) << duration << " s against "
+         << (options.mUrl.empty() ? "the embedded mock server" : options.mUrl) << "\n\n";
+    cout << left << setw(10) << "Operation" << right << setw(10) << "Count" << setw(10) << "Errors" << setw(12) << "Requests/s"
+         << setw(10) << "p50 ms" << setw(10) << "p99 ms" << setw(10) << "p999 ms" << setw(10) << "max ms" << "\n";
+    for (const json &operation: result["operations"]) {
+        cout << left << setw(10) << operation["name"].get<string>() << right << setw(10) << operation["count"].get<size_t>()
+             << setw(10) << operation["errors"].get<size_t>() << setw(12) << setprecision(1) << operation["throughput"].get<double>() << setprecision(3);
+        for (const char *key: { "p50", "p99", "p999", "max" }) {
+            cout << setw(10);
+            if (operation.find(key) != operation.end()) {
+                cout << operation[key].get<double>();
+            } else {
+                cout << "-";
+            }
+        }
+        cout << "\n";
+    }
+    cout << "\nCPU per request: " << setprecision(1) << result["clientCpuPerRequest"].get<double>() << " us client threads, "
+         << result["processCpuPerRequest"].get<double>() << " us process\n";
+    cout << "Max RSS: " << usage.ru_maxrss / 1024.0 << " MB (" << baselineRss / 1024.0 << " MB before the accounts were created)\n";
+    return 0;
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "benchmark.hpp"
+#include "core/measurelog.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <dirent.h>
+#include <unistd.h>
+
+using namespace netatmoapi;
+using namespace std;
+
+// Fleet with a main module and three additional modules per station.
+list<Station> makeStations(size_t moduleCount) {
+    list<Station> stations;
+    char id[18];
+    for (size_t i = 0; i < moduleCount / 4; ++i) {
+        snprintf(id, sizeof(id), "70:ee:50:%02x:%02x:%02x", unsigned(i >> 16) & 0xFF, unsigned(i >> 8) & 0xFF, unsigned(i) & 0xFF);
+        Station station("Station", string(id));
+        for (size_t j = 0; j < 4; ++j) {
+            id[0] = char('0' + j);
+            Measures measures;
+            measures.mTimeStamp = 1509446950;
+            measures.mTemperature = 21.1;
+            measures.mHumidity = 45;
+            Module module("Module", string(id), string(j == 0 ? Module::sTypeBase : Module::sTypeOutdoor));
+            module.setMeasures(move(measures));
+            station.addModule(move(module));
+        }
+        stations.emplace_back(move(station));
+    }
+    return stations;
+}
+
+void nextPoll(list<Station> &stations, uint64_t timeStamp) {
+    for (Station &station: stations) {
+        for (Module &module: station.modulesRef()) {
+            Measures measures = module.measures();
+            measures.mTimeStamp = timeStamp;
+            module.setMeasures(move(measures));
+        }
+    }
+}
+
+void removeDirectory(const string &directory) {
+    DIR *dir = ::opendir(directory.c_str());
+    if (dir) {
+        while (struct dirent *entry = ::readdir(dir)) {
+            if (entry->d_name[0] != '.') {
+                remove((directory + "/" + entry->d_name).c_str());
+            }
+        }
+        ::closedir(dir);
+    }
+    ::rmdir(directory.c_str());
+}
+
+int main(int argc, char **argv) {
+    benchmark::Runner runner(argc, argv);
+    const char *tmp = getenv("TMPDIR");
+    string directory = string(tmp ? tmp : "/tmp") + "/measureLogBenchmark." + to_string(::getpid());
+    const size_t moduleCount = 100000;
+    list<Station> stations = makeStations(moduleCount);
+    {
+        MeasureLog log(directory);
+        // One hour of 5 minute measures per segment.
+        log.setRetention(3600);
+        uint64_t timeStamp = 1509446950;
+        runner.run("appendPoll/100000", moduleCount, 0, [&]() {
+            timeStamp += 300;
+            nextPoll(stations, timeStamp);
+            log.append(stations);
+        });
+        string moduleId = stations.front().modulesRef().back().id();
+        runner.run("queryModule/100000", 1, 0, [&]() {
+            benchmark::doNotOptimize(log.query(moduleId, timeStamp - 1800, timeStamp).data());
+        });
+    }
+    removeDirectory(directory);
+    return 0;
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "benchmark.hpp"
+#include "fixtures.hpp"
+#include "core/utils.h"
+
+#include <list>
+#include <string>
+#include <utility>
+
+using namespace netatmoapi;
+using namespace std;
+
+int main(int argc, char **argv) {
+    benchmark::Runner runner(argc, argv);
+
+    // A station with its base module, an outdoor module, a wind gauge and a rain gauge.
+    list<Station> stations = utils::parseDevices(json::parse(benchmark::makeStationsResponse(1000, 3)));
+    Station station = stations.front();
+    Module module = station.modulesRef().back();
+
+    runner.run("Station/copy", 1, 0, [&]() {
+        Station copy(station);
+        benchmark::doNotOptimize(&copy);
+    });
+    Station target;
+    runner.run("Station/copyAssign", 1, 0, [&]() {
+        target = station;
+        benchmark::doNotOptimize(&target);
+    });
+    // Moves the station away and back.
+    runner.run("Station/move", 2, 0, [&]() {
+        Station moved(move(station));
+        benchmark::doNotOptimize(&moved);
+        station = move(moved);
+    });
+
+    runner.run("Module/copy", 1, 0, [&]() {
+        Module copy(module);
+        benchmark::doNotOptimize(&copy);
+    });
+    runner.run("Module/move", 2, 0, [&]() {
+        Module moved(move(module));
+        benchmark::doNotOptimize(&moved);
+        module = move(moved);
+    });
+
+    runner.run("stations/copy/" + to_string(stations.size()), stations.size(), 0, [&]() {
+        list<Station> copy(stations);
+        benchmark::doNotOptimize(&copy);
+    });
+    runner.run("stations/move/" + to_string(stations.size()), stations.size(), 0, [&]() {
+        list<Station> moved(move(stations));
+        benchmark::doNotOptimize(&moved);
+        stations = move(moved);
+    });
+    return 0;
+}
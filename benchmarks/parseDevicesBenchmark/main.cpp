@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "benchmark.hpp"
+#include "fixtures.hpp"
+#include "core/devicesparser.h"
+#include "core/utils.h"
+#include "model/module.h"
+
+#include <list>
+#include <string>
+
+using namespace netatmoapi;
+using namespace std;
+
+int main(int argc, char **argv) {
+    benchmark::Runner runner(argc, argv);
+    for (size_t stations: { size_t(1), size_t(10), size_t(100), size_t(1000), size_t(10000) }) {
+        // Stations with an outdoor module, a wind gauge and a rain gauge.
+        const string text = benchmark::makeStationsResponse(stations, 3);
+        const json response = json::parse(text);
+        const string suffix = "/" + to_string(stations);
+
+        // Text to json, without the model.
+        runner.run("jsonParse" + suffix, stations, text.size(), [&]() {
+            json parsed = json::parse(text);
+            benchmark::doNotOptimize(&parsed);
+        });
+
+        // Json to the model, into a new list.
+        runner.run("parseDevices" + suffix, stations, text.size(), [&]() {
+            list<Station> parsed = utils::parseDevices(response);
+            benchmark::doNotOptimize(&parsed);
+        });
+
+        // Json to the model, updating the list of the last call.
+        list<Station> previous;
+        runner.run("parseDevicesInPlace" + suffix, stations, text.size(), [&]() {
+            utils::parseDevices(response, previous);
+            benchmark::doNotOptimize(&previous);
+        });
+
+        // Json to the model, reusing the unchanged stations.
+        DevicesParser parser;
+        runner.run("devicesParserUnchanged" + suffix, stations, text.size(), [&]() {
+            const list<Station> &parsed = parser.parse(response);
+            benchmark::doNotOptimize(&parsed);
+        });
+
+        // Text to the model, the whole parsing of a poll.
+        runner.run("jsonAndTypedParse" + suffix, stations, text.size(), [&]() {
+            list<Station> parsed = utils::parseDevices(json::parse(text));
+            benchmark::doNotOptimize(&parsed);
+        });
+    }
+
+    const json station = benchmark::makeStation(0, 3);
+    const pair<const json *, const string *> dashboards[] = {
+        { &station["dashboard_data"], &Module::sTypeBase },
+        { &station["modules"][0]["dashboard_data"], &Module::sTypeOutdoor },
+        { &station["modules"][1]["dashboard_data"], &Module::sTypeWindGauge },
+        { &station["modules"][2]["dashboard_data"], &Module::sTypeRainGauge }
+    };
+    for (const auto &dashboard: dashboards) {
+        runner.run("parseMeasures/" + *dashboard.second, 1, 0, [&]() {
+            Measures measures = utils::parseMeasures(*dashboard.first, *dashboard.second);
+            benchmark::doNotOptimize(&measures);
+        });
+    }
+    return 0;
+}
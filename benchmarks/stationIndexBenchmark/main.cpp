@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "benchmark.hpp"
+#include "core/stationindex.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace netatmoapi;
+using namespace std;
+
+// One million stations, dense in Europe like the public stations of the api.
+vector<PublicStation> makeStations(size_t count) {
+    mt19937 random(42);
+    uniform_real_distribution<double> latitude(36, 70);
+    uniform_real_distribution<double> longitude(-10, 40);
+    vector<PublicStation> stations(count);
+    for (size_t i = 0; i < count; ++i) {
+        stations[i].mId = "70:ee:50:" + to_string(i);
+        stations[i].mLatitude = latitude(random);
+        stations[i].mLongitude = longitude(random);
+    }
+    return stations;
+}
+
+int main(int argc, char **argv) {
+    benchmark::Runner runner(argc, argv);
+    const size_t count = 1000000;
+    vector<PublicStation> stations = makeStations(count);
+
+    StationIndex index;
+    runner.run("build/1M", count, 0, [&]() {
+        index.build(stations);
+        benchmark::doNotOptimize(&index);
+    });
+
+    mt19937 random(7);
+    uniform_real_distribution<double> latitude(40, 65);
+    uniform_real_distribution<double> longitude(-5, 35);
+    const size_t queryCount = 10000;
+    vector<StationIndex::Location> locations;
+    for (size_t i = 0; i < queryCount; ++i) {
+        locations.emplace_back(latitude(random), longitude(random));
+    }
+
+    runner.run("nearest/10", queryCount, 0, [&]() {
+        for (const StationIndex::Location &location: locations) {
+            vector<StationIndex::Result> results = index.nearest(location.first, location.second, 10);
+            benchmark::doNotOptimize(results.data());
+        }
+    });
+    runner.run("radius/10km", queryCount, 0, [&]() {
+        for (const StationIndex::Location &location: locations) {
+            vector<StationIndex::Result> results = index.radius(location.first, location.second, 10);
+            benchmark::doNotOptimize(results.data());
+        }
+    });
+    runner.run("batch/nearest/10", queryCount, 0, [&]() {
+        vector<vector<StationIndex::Result>> results = index.nearest(locations, 10);
+        benchmark::doNotOptimize(results.data());
+    });
+    runner.run("batch/radius/10km", queryCount, 0, [&]() {
+        vector<vector<StationIndex::Result>> results = index.radius(locations, 10);
+        benchmark::doNotOptimize(results.data());
+    });
+
+    // Moves stations, which go through the buffer and the periodic rebuilds.
+    const size_t updateCount = 100000;
+    runner.run("insert/move", updateCount, 0, [&]() {
+        for (size_t i = 0; i < updateCount; ++i) {
+            const PublicStation &station = stations[i * 7 % count];
+            index.insert(station.mId, station.mLatitude + 0.01, station.mLongitude);
+        }
+        benchmark::doNotOptimize(&index);
+    });
+    return 0;
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "benchmark.hpp"
+#include "fixtures.hpp"
+#include "core/nawsapiclient.h"
+#include "core/utils.h"
+
+#include <ctime>
+#include <memory>
+#include <string>
+
+using namespace netatmoapi;
+using namespace std;
+
+int main(int argc, char **argv) {
+    benchmark::Runner runner(argc, argv);
+    for (size_t stations: { size_t(10), size_t(1000) }) {
+        string response = benchmark::makeStationsResponse(stations);
+        string suffix = "/" + to_string(stations);
+
+        // The whole pipeline without network: client, json parsing and model.
+        NAWSApiClient client("user", "password", "id", "secret", "access", "refresh");
+        client.setExpiresIn(time(nullptr) + 3600);
+        client.setRateLimit(0, 0);
+        client.setTransport(make_shared<benchmark::CannedTransport>(string(response)));
+        list<Station> parsed;
+        runner.run("requestAndParse" + suffix, stations, response.size(), [&]() {
+            utils::parseDevices(client.requestStationsData(), parsed);
+            benchmark::doNotOptimize(&parsed);
+        });
+
+        runner.run("parseOnly" + suffix, stations, response.size(), [&]() {
+            utils::parseDevices(json::parse(response), parsed);
+            benchmark::doNotOptimize(&parsed);
+        });
+    }
+    return 0;
+}
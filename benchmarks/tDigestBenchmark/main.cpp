@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "benchmark.hpp"
+#include "core/tdigest.h"
+
+#include <random>
+#include <vector>
+
+using namespace netatmoapi;
+using namespace std;
+
+int main(int argc, char **argv) {
+    benchmark::Runner runner(argc, argv);
+    const size_t count = 1000000;
+    mt19937_64 random(42);
+    normal_distribution<double> distribution(800, 200);
+    vector<double> values;
+    for (size_t i = 0; i < count; ++i) {
+        values.push_back(distribution(random));
+    }
+
+    for (double compression: { 100.0, 300.0 }) {
+        string suffix = "/" + to_string(int(compression));
+        TDigest digest(compression);
+        runner.run("add" + suffix, count, 0, [&]() {
+            digest.clear();
+            for (double value: values) {
+                digest.add(value);
+            }
+            benchmark::doNotOptimize(&digest);
+        });
+
+        runner.run("quantile" + suffix, 3, 0, [&]() {
+            double sum = digest.quantile(0.5) + digest.quantile(0.95) + digest.quantile(0.99);
+            benchmark::doNotOptimize(&sum);
+        });
+
+        // Merge the digests of 1000 modules into the digest of a site.
+        vector<TDigest> modules(1000, TDigest(compression));
+        for (size_t i = 0; i < count; ++i) {
+            modules[i % modules.size()].add(values[i]);
+        }
+        runner.run("merge1000" + suffix, modules.size(), 0, [&]() {
+            TDigest site(compression);
+            for (const TDigest &module: modules) {
+                site.merge(module);
+            }
+            benchmark::doNotOptimize(&site);
+        });
+
+        string serialized = digest.serialize();
+        runner.run("deserialize" + suffix, 1, serialized.size(), [&]() {
+            TDigest copy = TDigest::deserialize(serialized);
+            benchmark::doNotOptimize(&copy);
+        });
+    }
+
+    SlidingTDigest window(3600, 300);
+    uint64_t timeStamp = 0;
+    runner.run("slidingAdd", count, 0, [&]() {
+        for (double value: values) {
+            window.add(timeStamp++, value);
+        }
+        benchmark::doNotOptimize(&window);
+    });
+    runner.run("slidingQuantile", 1, 0, [&]() {
+        double value = window.quantile(0.99);
+        benchmark::doNotOptimize(&value);
+    });
+    return 0;
+}
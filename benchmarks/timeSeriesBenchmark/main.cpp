@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "benchmark.hpp"
+#include "core/timeseries.h"
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace netatmoapi;
+using namespace std;
+
+// Temperature like measures with one decimal place every 5 minutes and some jitter.
+void makeMeasures(size_t count, vector<uint64_t> &timeStamps, vector<double> &values) {
+    mt19937_64 random(42);
+    uniform_int_distribution<int> percent(0, 99);
+    uniform_real_distribution<double> noise(-0.3, 0.3);
+    uint64_t timeStamp = 1483228800;
+    double value = 20.0;
+    for (size_t i = 0; i < count; ++i) {
+        timeStamp += percent(random) < 95 ? 300 : 301 + percent(random);
+        value = round((value + noise(random)) * 10) / 10;
+        timeStamps.push_back(timeStamp);
+        values.push_back(value);
+    }
+}
+
+int main(int argc, char **argv) {
+    benchmark::Runner runner(argc, argv);
+    for (size_t count: { size_t(10000), size_t(1000000) }) {
+        vector<uint64_t> timeStamps;
+        vector<double> values;
+        makeMeasures(count, timeStamps, values);
+        string suffix = "/" + to_string(count);
+
+        TimeSeries series;
+        runner.run("append" + suffix, count, 0, [&]() {
+            series = TimeSeries();
+            for (size_t i = 0; i < count; ++i) {
+                series.append(timeStamps[i], values[i]);
+            }
+            benchmark::doNotOptimize(&series);
+        });
+
+        vector<uint64_t> readTimeStamps;
+        vector<double> readValues;
+        readTimeStamps.reserve(count);
+        readValues.reserve(count);
+        runner.run("read" + suffix, count, 0, [&]() {
+            readTimeStamps.clear();
+            readValues.clear();
+            series.read(0, numeric_limits<uint64_t>::max(), readTimeStamps, readValues);
+            benchmark::doNotOptimize(readValues.data());
+        });
+
+        // A tenth of the series in the middle.
+        uint64_t begin = timeStamps[count / 2];
+        uint64_t end = timeStamps[count / 2 + count / 10];
+        runner.run("scanRange" + suffix, count / 10, 0, [&]() {
+            double sum = 0;
+            series.scan(begin, end, [&sum](uint64_t, double value) {
+                sum += value;
+            });
+            benchmark::doNotOptimize(&sum);
+        });
+
+        cout << "bytes per measure" << suffix << ": " << double(series.memoryUsage()) / double(count)
+             << " (uncompressed " << sizeof(uint64_t) + sizeof(double) << ")" << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "benchmark.hpp"
+#include "core/utils.h"
+
+#include <map>
+#include <string>
+
+using namespace netatmoapi;
+using namespace std;
+
+int main(int argc, char **argv) {
+    benchmark::Runner runner(argc, argv);
+
+    // Unreserved characters only, like a token, and a value with reserved characters.
+    const string token = "5a1b2c3d4e5f60718293a4b5|0123456789abcdef0123456789abcdef";
+    const string deviceId = "70:ee:50:00:00:01";
+    const string email = "first.last+netatmo@example.com";
+    for (const string *value: { &token, &deviceId, &email }) {
+        runner.run("urlEncode/" + to_string(value->size()) + "chars", 1, value->size(), [&]() {
+            string encoded = utils::urlEncode(*value);
+            benchmark::doNotOptimize(&encoded);
+        });
+    }
+
+    const map<string, string> stationsData = {
+        { "access_token", token },
+        { "device_id", deviceId },
+        { "get_favorites", "true" }
+    };
+    runner.run("buildUrlQuery/getstationsdata", stationsData.size(), 0, [&]() {
+        string query = utils::buildUrlQuery(stationsData, '&');
+        benchmark::doNotOptimize(&query);
+    });
+
+    const map<string, string> measure = {
+        { "access_token", token },
+        { "device_id", deviceId },
+        { "module_id", "02:00:00:00:00:01" },
+        { "scale", "max" },
+        { "type", "Temperature,Humidity,CO2,Pressure,Noise" },
+        { "date_begin", "1509408000" },
+        { "date_end", "1509494399" },
+        { "limit", "1024" },
+        { "optimize", "true" }
+    };
+    runner.run("buildUrlQuery/getmeasure", measure.size(), 0, [&]() {
+        string query = utils::buildUrlQuery(measure, '&');
+        benchmark::doNotOptimize(&query);
+    });
+
+    const map<string, string> tokenRequest = {
+        { "grant_type", "password" },
+        { "client_id", "5a1b2c3d4e5f60718293a4b5" },
+        { "client_secret", "AbCdEfGhIjKlMnOpQrStUvWxYz0123" },
+        { "username", email },
+        { "password", "p@ss w0rd&more" }
+    };
+    runner.run("buildUrlQuery/token", tokenRequest.size(), 0, [&]() {
+        string query = utils::buildUrlQuery(tokenRequest, '&');
+        benchmark::doNotOptimize(&query);
+    });
+    return 0;
+}
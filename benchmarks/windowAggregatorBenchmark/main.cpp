@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "benchmark.hpp"
+#include "core/simd.hpp"
+#include "core/windowaggregator.h"
+
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace netatmoapi;
+using namespace std;
+
+// A year of 5 minute samples with 2% missing values.
+void makeSamples(size_t count, vector<uint64_t> &timeStamps, vector<double> &values) {
+    mt19937 random(42);
+    uniform_int_distribution<int> percent(0, 99);
+    uniform_real_distribution<double> value(-10, 30);
+    uint64_t timeStamp = 1483228800;
+    for (size_t i = 0; i < count; ++i) {
+        timeStamps.push_back(timeStamp);
+        values.push_back(percent(random) < 2 ? numeric_limits<double>::min() : value(random));
+        timeStamp += 300;
+    }
+}
+
+int main(int argc, char **argv) {
+    benchmark::Runner runner(argc, argv);
+    const size_t count = 365 * 288;
+    vector<uint64_t> timeStamps;
+    vector<double> values;
+    makeSamples(count, timeStamps, values);
+    const size_t bytes = count * (sizeof(uint64_t) + sizeof(double));
+
+    runner.run("reduceScalar", count, count * sizeof(double), [&]() {
+        simd::Reduction reduction;
+        simd::reduceScalar(values.data(), count, numeric_limits<double>::min(), reduction);
+        benchmark::doNotOptimize(&reduction);
+    });
+    runner.run("reduce", count, count * sizeof(double), [&]() {
+        simd::Reduction reduction;
+        simd::reduce(values.data(), count, numeric_limits<double>::min(), reduction);
+        benchmark::doNotOptimize(&reduction);
+    });
+
+    runner.run("tumbling/1h", count, bytes, [&]() {
+        vector<Aggregate> windows = WindowAggregator::aggregate(timeStamps.data(), values.data(), count, 3600);
+        benchmark::doNotOptimize(windows.data());
+    });
+    runner.run("tumbling/1d", count, bytes, [&]() {
+        vector<Aggregate> windows = WindowAggregator::aggregate(timeStamps.data(), values.data(), count, 86400);
+        benchmark::doNotOptimize(windows.data());
+    });
+    runner.run("sliding/1d/1h", count, bytes, [&]() {
+        vector<Aggregate> windows = WindowAggregator::aggregate(timeStamps.data(), values.data(), count, 86400, 3600);
+        benchmark::doNotOptimize(windows.data());
+    });
+
+    // New samples of a poll, appended one by one.
+    runner.run("incremental/1d/1h", count, bytes, [&]() {
+        WindowAggregator aggregator(86400, 3600);
+        for (size_t i = 0; i < count; ++i) {
+            aggregator.append(timeStamps[i], values[i]);
+        }
+        benchmark::doNotOptimize(aggregator.takeWindows().data());
+    });
+    return 0;
+}
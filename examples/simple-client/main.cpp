@@ -18,6 +18,7 @@
  */
 
 #include "core/nawsapiclient.h"
+#include "core/unitconverter.h"
 #include "core/utils.h"
 
 #include <string>
@@ -81,6 +82,7 @@ int main(int argc, char **argv) {
         naWSApiClient->login();
         json stationsData = naWSApiClient->requestStationsData();
         list<Station> stations = utils::parseDevices(stationsData);
+        UnitConverter converter(utils::parseUserSettings(stationsData));
         for (const Station &station: stations) {
             cout << "====================Station begin======================\n";
             cout << "Station name: " << station.name() << "\n";
@@ -94,32 +96,32 @@ int main(int argc, char **argv) {
                 cout << "Module type: " << type << "\n";
                 cout << "Module battery status: " << module.batteryPercent() << "%\n";
                 cout << "Module wireless status: " << module.rfStatus() << "\n";
-                Measures measures = module.measures();
+                Measures measures = converter.convert(module.measures());
                 if (type == Module::sTypeBase || type == Module::sTypeIndoor) {
-                    cout << "Temperature: " << measures.mTemperature << "°C\n";
+                    cout << "Temperature: " << measures.mTemperature << converter.unit(Measures::temperature) << "\n";
                     cout << "Temperature trend: " << Measures::convertTrendToString(measures.mTemperatureTrend) << "\n";
-                    cout << "Min. temperature: " << measures.mMinTemperature << "°C\n";
-                    cout << "Max. temperature: " << measures.mMaxTemperature << "°C\n";
+                    cout << "Min. temperature: " << measures.mMinTemperature << converter.unit(Measures::minTemperature) << "\n";
+                    cout << "Max. temperature: " << measures.mMaxTemperature << converter.unit(Measures::maxTemperature) << "\n";
                     cout << "Co2: " << measures.mCo2 << "ppm\n";
-                    cout << "Pressure: " << measures.mPressure << "mbar\n";
+                    cout << "Pressure: " << measures.mPressure << converter.unit(Measures::pressure) << "\n";
                     cout << "Pressure trend: " << Measures::convertTrendToString(measures.mPressureTrend) << "\n";
-                    cout << "Absolute pressure: " << measures.mAbsolutePressure << "mbar\n";
+                    cout << "Absolute pressure: " << measures.mAbsolutePressure << converter.unit(Measures::absolutePressure) << "\n";
                     cout << "Noise: " << measures.mNoise << "dB\n";
                     cout << "Humidity: " << measures.mHumidity << "%\n";
                 } else if (type == Module::sTypeOutdoor) {
-                    cout << "Temperature: " << measures.mTemperature << "°C\n";
+                    cout << "Temperature: " << measures.mTemperature << converter.unit(Measures::temperature) << "\n";
                     cout << "Temperature trend: " << Measures::convertTrendToString(measures.mTemperatureTrend) << "\n";
-                    cout << "Min. temperature: " << measures.mMinTemperature << "°C\n";
-                    cout << "Max. temperature: " << measures.mMaxTemperature << "°C\n";
+                    cout << "Min. temperature: " << measures.mMinTemperature << converter.unit(Measures::minTemperature) << "\n";
+                    cout << "Max. temperature: " << measures.mMaxTemperature << converter.unit(Measures::maxTemperature) << "\n";
                     cout << "Humidity: " << measures.mHumidity << "%\n";
                 } else if (type == Module::sTypeRainGauge) {
-                    cout << "Rain: " << measures.mRain << "mm\n";
-                    cout << "Rain sum 1h: " << measures.mSumRain1 << "mm\n";
-                    cout << "Rain sum 24h: " << measures.mSumRain24 << "mm\n";
+                    cout << "Rain: " << measures.mRain << converter.unit(Measures::rain) << "\n";
+                    cout << "Rain sum 1h: " << measures.mSumRain1 << converter.unit(Measures::sumRain1) << "\n";
+                    cout << "Rain sum 24h: " << measures.mSumRain24 << converter.unit(Measures::sumRain24) << "\n";
                 } else if (type == Module::sTypeWindGauge) {
-                    cout << "Wind strength: " << measures.mWindStrength << "km\\h\n";
+                    cout << "Wind strength: " << measures.mWindStrength << converter.unit(Measures::windStrength) << "\n";
                     cout << "Wind angle: " << measures.mWindAngle << "°\n";
-                    cout << "Gust strength: " << measures.mGustStrength << "km\\h\n";
+                    cout << "Gust strength: " << measures.mGustStrength << converter.unit(Measures::gustStrength) << "\n";
                     cout << "Gust angle: " << measures.mGustAngle << "°\n";
                 }
                 cout << "================Module end=========================\n";
@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "backfillcheckpoint.h"
+
+#include <cerrno>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace netatmoapi {
+
+namespace {
+
+const char cFormat[] = "netatmoapi-backfill-1";
+
+void writeAll(int fd, const string &data, const string &path) {
+    const char *bytes = data.data();
+    size_t size = data.size();
+    while (size > 0) {
+        ssize_t written = ::write(fd, bytes, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw system_error(errno, generic_category(), "Can not write " + path);
+        }
+        bytes += written;
+        size -= static_cast<size_t>(written);
+    }
+}
+
+}
+
+struct BackfillCheckpointPrivate {
+    BackfillCheckpointPrivate(const string &path, const string &scale, uint64_t begin, uint64_t end) :
+        mPath(path),
+        mBegin(begin),
+        mEnd(end),
+        mFd(-1)
+    {
+        ostringstream header;
+        header << cFormat << ' ' << scale << ' ' << begin << ' ' << end;
+        mHeader = header.str();
+    }
+    ~BackfillCheckpointPrivate() {
+        if (mFd >= 0) {
+            ::close(mFd);
+        }
+    }
+    void load();
+    void compact();
+
+    string mPath;
+    string mHeader;
+    uint64_t mBegin;
+    uint64_t mEnd;
+    int mFd;
+    map<pair<string, string>, uint64_t> mNext;
+    mutable mutex mMutex;
+};
+
+void BackfillCheckpointPrivate::load() {
+    ifstream file(mPath);
+    if (!file) {
+        return;
+    }
+    string line;
+    if (!getline(file, line) || line.empty()) {
+        return;
+    }
+    if (line != mHeader) {
+        throw runtime_error("The checkpoint file " + mPath + " belongs to another backfill: " + line);
+    }
+    while (getline(file, line)) {
+        if (file.eof()) {
+            // The last line was not terminated, the update was interrupted.
+            break;
+        }
+        istringstream stream(line);
+        string deviceId;
+        string moduleId;
+        uint64_t next;
+        if (stream >> deviceId >> moduleId >> next) {
+            mNext[make_pair(deviceId, moduleId)] = next;
+        }
+    }
+}
+
+void BackfillCheckpointPrivate::compact() {
+    string data = mHeader + "\n";
+    for (const auto &module: mNext) {
+        data += module.first.first + " " + module.first.second + " " + to_string(module.second) + "\n";
+    }
+    string tmpPath = mPath + ".tmp";
+    int fd = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw system_error(errno, generic_category(), "Can not open " + tmpPath);
+    }
+    try {
+        writeAll(fd, data, tmpPath);
+        if (::fsync(fd) != 0) {
+            throw system_error(errno, generic_category(), "Can not sync " + tmpPath);
+        }
+    } catch (...) {
+        ::close(fd);
+        ::unlink(tmpPath.c_str());
+        throw;
+    }
+    ::close(fd);
+    if (::rename(tmpPath.c_str(), mPath.c_str()) != 0) {
+        int error = errno;
+        ::unlink(tmpPath.c_str());
+        throw system_error(error, generic_category(), "Can not rename " + tmpPath);
+    }
+    mFd = ::open(mPath.c_str(), O_WRONLY | O_APPEND | O_CLOEXEC);
+    if (mFd < 0) {
+        throw system_error(errno, generic_category(), "Can not open " + mPath);
+    }
+}
+
+BackfillCheckpoint::BackfillCheckpoint(const string &path, const string &scale, uint64_t begin, uint64_t end) :
+    d(new BackfillCheckpointPrivate(path, scale, begin, end)) {
+    d->load();
+    d->compact();
+}
+
+BackfillCheckpoint::~BackfillCheckpoint() noexcept = default;
+
+uint64_t BackfillCheckpoint::next(const string &deviceId, const string &moduleId) const {
+    lock_guard<mutex> lock(d->mMutex);
+    auto it = d->mNext.find(make_pair(deviceId, moduleId));
+    return it == d->mNext.end() ? d->mBegin : it->second;
+}
+
+bool BackfillCheckpoint::isDone(const string &deviceId, const string &moduleId) const {
+    return next(deviceId, moduleId) > d->mEnd;
+}
+
+void BackfillCheckpoint::update(const string &deviceId, const string &moduleId, uint64_t next) {
+    string line = deviceId + " " + moduleId + " " + to_string(next) + "\n";
+    lock_guard<mutex> lock(d->mMutex);
+    writeAll(d->mFd, line, d->mPath);
+    if (::fdatasync(d->mFd) != 0) {
+        throw system_error(errno, generic_category(), "Can not sync " + d->mPath);
+    }
+    d->mNext[make_pair(deviceId, moduleId)] = next;
+}
+
+size_t BackfillCheckpoint::size() const {
+    lock_guard<mutex> lock(d->mMutex);
+    return d->mNext.size();
+}
+
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef BACKFILLCHECKPOINT_H
+#define BACKFILLCHECKPOINT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace netatmoapi {
+
+struct BackfillCheckpointPrivate;
+
+/**
+ * @brief This class stores the progress of a BackfillJob per module in a text file.
+ *
+ * The first line of the file identifies the backfill: the scale and the
+ * time range. Every other line holds the device id, the module id and the
+ * time stamp, at which the backfill of the module continues. The lines
+ * are appended and synced on every update, so an interrupted backfill
+ * loses at most the request in progress. A later line of a module
+ * overrides the earlier ones, an incomplete last line is ignored.
+ *
+ * The file is compacted, when it is opened. All methods are thread safe.
+ */
+class BackfillCheckpoint {
+public:
+    /**
+     * Constructor.
+     * Opens or creates the checkpoint file.
+     * @param path The path of the checkpoint file.
+     * @param scale The scale of the backfill.
+     * @param begin The begin of the backfill.
+     * @param end The end of the backfill.
+     * @throw std::runtime_error If the file belongs to another backfill.
+     * @throw std::system_error If the file can not be read or written.
+     */
+    explicit BackfillCheckpoint(const std::string &path, const std::string &scale, std::uint64_t begin, std::uint64_t end);
+
+    BackfillCheckpoint(const BackfillCheckpoint &) = delete;
+
+    /**
+     * Destructor.
+     * Is default.
+     */
+    virtual ~BackfillCheckpoint() noexcept;
+
+    /**
+     * Returns the time stamp, at which the backfill of a module continues.
+     * @param deviceId The id of the station.
+     * @param moduleId The id of the module.
+     * @return The time stamp, the begin of the backfill for a new module.
+     */
+    std::uint64_t next(const std::string &deviceId, const std::string &moduleId) const;
+
+    /**
+     * Returns true, if the backfill of a module is complete.
+     * @param deviceId The id of the station.
+     * @param moduleId The id of the module.
+     * @return True, if next() is after the end of the backfill.
+     */
+    bool isDone(const std::string &deviceId, const std::string &moduleId) const;
+
+    /**
+     * Stores the time stamp, at which the backfill of a module continues.
+     * @param deviceId The id of the station.
+     * @param moduleId The id of the module.
+     * @param next The time stamp. A time stamp after the end marks the module as complete.
+     * @throw std::system_error If the file can not be written.
+     */
+    void update(const std::string &deviceId, const std::string &moduleId, std::uint64_t next);
+
+    /**
+     * Returns the number of modules in the checkpoint.
+     * @return The number of modules.
+     */
+    std::size_t size() const;
+
+    BackfillCheckpoint &operator =(const BackfillCheckpoint &) = delete;
+
+private:
+    std::unique_ptr<BackfillCheckpointPrivate> d;
+};
+
+}
+
+#endif /* BACKFILLCHECKPOINT_H */
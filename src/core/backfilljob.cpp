@@ -0,0 +1,253 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "backfilljob.h"
+#include "backfillcheckpoint.h"
+#include "utils.h"
+#include "model/params.h"
+
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <utility>
+
+using namespace std;
+
+namespace netatmoapi {
+
+struct BackfillModule {
+    string mDeviceId;
+    string mModuleId;
+    vector<string> mTypes;
+    vector<pair<uint64_t, uint64_t>> mChunks;
+};
+
+struct BackfillJobPrivate {
+    BackfillJobPrivate(const string &checkpointPath, const string &scale, uint64_t begin, uint64_t end) :
+        mCheckpointPath(checkpointPath),
+        mScale(scale),
+        mBegin(begin),
+        mEnd(end),
+        mStopped(false)
+    {}
+    void work(NAWSApiClient &client, const vector<BackfillModule> &modules, BackfillCheckpoint &checkpoint);
+    void chunkDone(size_t measures, bool moduleDone);
+
+    string mCheckpointPath;
+    string mScale;
+    uint64_t mBegin;
+    uint64_t mEnd;
+    vector<NAWSApiClient> mAccounts;
+    BackfillJob::MeasuresCallback mMeasuresCallback;
+    BackfillJob::ProgressCallback mProgressCallback;
+    atomic<bool> mStopped;
+    // Protects the progress, it is not held during the callbacks, which may call BackfillJob::progress().
+    mutable mutex mMutex;
+    // Serializes the callbacks.
+    mutex mCallbackMutex;
+    BackfillJob::Progress mProgress;
+    chrono::steady_clock::time_point mStart;
+};
+
+void BackfillJobPrivate::work(NAWSApiClient &client, const vector<BackfillModule> &modules, BackfillCheckpoint &checkpoint) {
+    for (const BackfillModule &module: modules) {
+        // The main module is requested without module id.
+        const string moduleId = module.mModuleId == module.mDeviceId ? string() : module.mModuleId;
+        for (size_t i = 0; i < module.mChunks.size(); ++i) {
+            if (mStopped) {
+                return;
+            }
+            const pair<uint64_t, uint64_t> &chunk = module.mChunks[i];
+            json blocks = client.requestMeasures(module.mDeviceId, moduleId, mScale, module.mTypes, chunk.first, chunk.second, 1);
+            size_t measures = 0;
+            for (const json &block: blocks) {
+                auto values = block.find("value");
+                if (values != block.end()) {
+                    measures += values->size();
+                }
+            }
+            if (mMeasuresCallback) {
+                lock_guard<mutex> lock(mCallbackMutex);
+                mMeasuresCallback(module.mDeviceId, module.mModuleId, module.mTypes, blocks);
+            }
+            checkpoint.update(module.mDeviceId, module.mModuleId, chunk.second + 1);
+            chunkDone(measures, i + 1 == module.mChunks.size());
+        }
+    }
+}
+
+void BackfillJobPrivate::chunkDone(size_t measures, bool moduleDone) {
+    // Taken before the progress is updated, so the callback sees the progress in order.
+    lock_guard<mutex> callbackLock(mCallbackMutex);
+    unique_lock<mutex> lock(mMutex);
+    ++mProgress.mChunksDone;
+    mProgress.mMeasures += measures;
+    if (moduleDone) {
+        ++mProgress.mModulesDone;
+    }
+    mProgress.mElapsed = chrono::duration<double>(chrono::steady_clock::now() - mStart).count();
+    if (mProgress.mElapsed > 0) {
+        mProgress.mMeasuresPerSecond = static_cast<double>(mProgress.mMeasures) / mProgress.mElapsed;
+        double chunksPerSecond = static_cast<double>(mProgress.mChunksDone) / mProgress.mElapsed;
+        mProgress.mEta = static_cast<double>(mProgress.mChunks - mProgress.mChunksDone) / chunksPerSecond;
+    }
+    if (mProgressCallback) {
+        const BackfillJob::Progress progress = mProgress;
+        lock.unlock();
+        mProgressCallback(progress);
+    }
+}
+
+BackfillJob::Progress::Progress() :
+    mModules(0),
+    mModulesDone(0),
+    mChunks(0),
+    mChunksDone(0),
+    mMeasures(0),
+    mElapsed(0),
+    mMeasuresPerSecond(0),
+    mEta(-1)
+{
+
+}
+
+BackfillJob::BackfillJob(const string &checkpointPath, const string &scale, uint64_t begin, uint64_t end) :
+    d(new BackfillJobPrivate(checkpointPath, scale, begin, end)) {
+    // Throws for an unknown scale.
+    utils::scaleInterval(scale);
+}
+
+BackfillJob::~BackfillJob() noexcept = default;
+
+void BackfillJob::addAccount(const NAWSApiClient &client) {
+    d->mAccounts.push_back(client);
+}
+
+void BackfillJob::setMeasuresCallback(MeasuresCallback callback) {
+    d->mMeasuresCallback = move(callback);
+}
+
+void BackfillJob::setProgressCallback(ProgressCallback callback) {
+    d->mProgressCallback = move(callback);
+}
+
+void BackfillJob::run() {
+    d->mStopped = false;
+    BackfillCheckpoint checkpoint(d->mCheckpointPath, d->mScale, d->mBegin, d->mEnd);
+
+    Progress progress;
+    vector<vector<BackfillModule>> accountModules(d->mAccounts.size());
+    set<pair<string, string>> seen;
+    for (size_t i = 0; i < d->mAccounts.size(); ++i) {
+        list<Station> stations = utils::parseDevices(d->mAccounts[i].requestStationsData());
+        for (const Station &station: stations) {
+            for (const Module &module: station.modulesRef()) {
+                BackfillModule backfillModule;
+                backfillModule.mDeviceId = station.id();
+                backfillModule.mModuleId = module.id();
+                backfillModule.mTypes = measureTypes(module.type());
+                if (backfillModule.mTypes.empty() || !seen.emplace(backfillModule.mDeviceId, backfillModule.mModuleId).second) {
+                    continue;
+                }
+                ++progress.mModules;
+                uint64_t next = checkpoint.next(backfillModule.mDeviceId, backfillModule.mModuleId);
+                if (next > d->mEnd) {
+                    ++progress.mModulesDone;
+                    continue;
+                }
+                backfillModule.mChunks = utils::splitTimeRange(next, d->mEnd, d->mScale, params::cMaxMeasuresPerRequest);
+                progress.mChunks += backfillModule.mChunks.size();
+                accountModules[i].push_back(move(backfillModule));
+            }
+        }
+    }
+    {
+        lock_guard<mutex> lock(d->mMutex);
+        d->mProgress = progress;
+        d->mStart = chrono::steady_clock::now();
+    }
+
+    exception_ptr error;
+    mutex errorMutex;
+    vector<thread> threads;
+    try {
+        for (size_t i = 0; i < d->mAccounts.size(); ++i) {
+            if (accountModules[i].empty()) {
+                continue;
+            }
+            threads.emplace_back([this, i, &accountModules, &checkpoint, &error, &errorMutex]() {
+                try {
+                    d->work(d->mAccounts[i], accountModules[i], checkpoint);
+                } catch (const exception &ex) {
+#if !defined(NDEBUG)
+                    cerr << "Error received in file: " << __FILE__ << ", function: " << __FUNCTION__ << ", in line: " << __LINE__ << "\n";
+                    cerr << "Error: " << ex.what() << "\n";
+#endif
+                    lock_guard<mutex> lock(errorMutex);
+                    if (!error) {
+                        error = current_exception();
+                    }
+                    d->mStopped = true;
+                }
+            });
+        }
+    } catch (...) {
+        // The started threads must be joined before they are destroyed.
+        d->mStopped = true;
+        for (thread &t: threads) {
+            t.join();
+        }
+        throw;
+    }
+    for (thread &t: threads) {
+        t.join();
+    }
+    if (error) {
+        rethrow_exception(error);
+    }
+}
+
+void BackfillJob::stop() {
+    d->mStopped = true;
+}
+
+BackfillJob::Progress BackfillJob::progress() const {
+    lock_guard<mutex> lock(d->mMutex);
+    return d->mProgress;
+}
+
+vector<string> BackfillJob::measureTypes(const string &moduleType) {
+    if (moduleType == Module::sTypeBase) {
+        return { params::cTypeTemperature, params::cTypeCo2, params::cTypeHumidity, params::cTypePressure, params::cTypeNoise };
+    } else if (moduleType == Module::sTypeOutdoor) {
+        return { params::cTypeTemperature, params::cTypeHumidity };
+    } else if (moduleType == Module::sTypeWindGauge) {
+        return { params::cTypeWindStrength, params::cTypeWindAngle, params::cTypeGustStrength, params::cTypeGustAngle };
+    } else if (moduleType == Module::sTypeRainGauge) {
+        return { params::cTypeRain };
+    } else if (moduleType == Module::sTypeIndoor) {
+        return { params::cTypeTemperature, params::cTypeCo2, params::cTypeHumidity };
+    }
+    return {};
+}
+
+}
@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef BACKFILLJOB_H
+#define BACKFILLJOB_H
+
+#include "nawsapiclient.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace netatmoapi {
+
+struct BackfillJobPrivate;
+
+/**
+ * @brief This class downloads the measure history of all modules of one or more accounts.
+ *
+ * run() enumerates the modules of every account with
+ * NAWSApiClient::requestStationsData(). A module, which is visible in
+ * several accounts, is only downloaded once. The time range is split into
+ * chunks of at most params::cMaxMeasuresPerRequest measures, which are
+ * requested with NAWSApiClient::requestMeasures(). Every account has its
+ * own worker thread, so the requests of an account stay within the rate
+ * limit of its client, see NAApiClient::setRateLimit().
+ *
+ * After every chunk the progress of the module is stored in a
+ * BackfillCheckpoint. If the job is interrupted, e.g. by stop(), an error
+ * or a crash, the next run continues with the first chunk, which was not
+ * completed.
+ */
+class BackfillJob {
+public:
+    /**
+     * @brief The progress of a backfill.
+     */
+    struct Progress {
+        /**
+         * Default constructor.
+         */
+        Progress();
+
+        /**
+         * The number of modules.
+         */
+        std::size_t     mModules;
+
+        /**
+         * The number of completed modules, including the ones of earlier runs.
+         */
+        std::size_t     mModulesDone;
+
+        /**
+         * The number of chunks of this run.
+         */
+        std::size_t     mChunks;
+
+        /**
+         * The number of completed chunks of this run.
+         */
+        std::size_t     mChunksDone;
+
+        /**
+         * The number of received measures of this run.
+         */
+        std::uint64_t   mMeasures;
+
+        /**
+         * The seconds since the start of this run.
+         */
+        double          mElapsed;
+
+        /**
+         * The received measures per second.
+         */
+        double          mMeasuresPerSecond;
+
+        /**
+         * The estimated seconds until the end of the run, negative if unknown.
+         */
+        double          mEta;
+    };
+
+    /**
+     * Called with the measure blocks of a chunk, e.g. for utils::decodeMeasureBlocks().
+     * The parameters are the device id, the module id, the measure types and the blocks.
+     */
+    using MeasuresCallback = std::function<void (const std::string &, const std::string &, const std::vector<std::string> &, const json &)>;
+
+    /**
+     * Called with the progress after every chunk.
+     */
+    using ProgressCallback = std::function<void (const Progress &)>;
+
+    /**
+     * Constructor.
+     * @param checkpointPath The path of the checkpoint file.
+     * @param scale The scale of the measures, e.g. params::cScaleMax.
+     * @param begin The begin of the time range.
+     * @param end The end of the time range.
+     * @throw std::invalid_argument If scale is unknown.
+     */
+    explicit BackfillJob(const std::string &checkpointPath, const std::string &scale, std::uint64_t begin, std::uint64_t end);
+
+    BackfillJob(const BackfillJob &) = delete;
+
+    /**
+     * Destructor.
+     * Is default.
+     */
+    virtual ~BackfillJob() noexcept;
+
+    /**
+     * Adds an account.
+     * @param client The client of the account. The job uses a copy.
+     */
+    void addAccount(const NAWSApiClient &client);
+
+    /**
+     * Sets the callback for the received measures.
+     * The callback is called from the worker threads, but never concurrently.
+     * It may call progress() and stop().
+     * @param callback The callback.
+     */
+    void setMeasuresCallback(MeasuresCallback callback);
+
+    /**
+     * Sets the callback for the progress.
+     * The callback is called from the worker threads, but never concurrently,
+     * with a copy of the progress in order. It may call progress() and stop().
+     * @param callback The callback.
+     */
+    void setProgressCallback(ProgressCallback callback);
+
+    /**
+     * Runs the backfill and returns, when all modules are complete or the job was stopped.
+     * @throw std::runtime_error If the checkpoint file belongs to another backfill.
+     * @throw std::system_error If the checkpoint file can not be written.
+     * @throw CurlException, ResponseException, LoginException The first error of a request. The other workers stop after their current chunk.
+     */
+    void run();
+
+    /**
+     * Stops a running backfill after the current chunks.
+     * Can be called from any thread, e.g. from a callback.
+     */
+    void stop();
+
+    /**
+     * Returns the progress of the current or last run.
+     * @return The progress.
+     */
+    Progress progress() const;
+
+    /**
+     * Returns the measure types, which are backfilled for a module type.
+     * @param moduleType The module type, e.g. Module::sTypeOutdoor.
+     * @return The measure types, empty for an unknown module type.
+     */
+    static std::vector<std::string> measureTypes(const std::string &moduleType);
+
+    BackfillJob &operator =(const BackfillJob &) = delete;
+
+private:
+    std::unique_ptr<BackfillJobPrivate> d;
+};
+
+}
+
+#endif /* BACKFILLJOB_H */
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "curltransport.h"
+#include "utils.h"
+#include "scopeexit.hpp"
+#include "exceptions/curlexception.hpp"
+
+#include <curl/curl.h>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+
+using namespace std;
+
+namespace netatmoapi {
+
+namespace {
+
+size_t writeCallback(char *buffer, size_t size, size_t nmemb, void *userp) {
+    if (userp) {
+        ostream *os = static_cast<ostream *>(userp);
+        size_t len = size * nmemb;
+        if (os->write(buffer, streamsize (len))) {
+            return len;
+        }
+    }
+
+    return 0;
+}
+
+// curl_global_init() and curl_global_cleanup() are not thread safe.
+mutex curlGlobalMutex;
+
+void curlGlobalInit() {
+    lock_guard<mutex> lock(curlGlobalMutex);
+    curl_global_init(CURL_GLOBAL_ALL);
+}
+
+void curlGlobalCleanup() {
+    lock_guard<mutex> lock(curlGlobalMutex);
+    curl_global_cleanup();
+}
+
+// Performs the request, a post request if postField is not nullptr.
+string perform(const string &url, const string *postField) {
+    CURL *curl;
+    CURLcode res;
+
+    ostringstream rawResponse;
+
+    curlGlobalInit();
+    curl = curl_easy_init();
+    auto cleanup = makeScopeExit([=]() mutable { if (curl) {curl_easy_cleanup(curl);} curlGlobalCleanup(); });
+    if (curl) {
+        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, &writeCallback);
+        curl_easy_setopt(curl, CURLOPT_FILE, &rawResponse);
+        if (postField) {
+            curl_easy_setopt(curl, CURLOPT_POSTFIELDS, postField->c_str());
+        }
+        res = curl_easy_perform(curl);
+        if (res != CURLE_OK) {
+            throw CurlException("Curl error", int {res});
+        }
+    }
+
+#if !defined(NDEBUG)
+    cout << rawResponse.str() << "\n";
+#endif
+
+    return rawResponse.str();
+}
+
+}
+
+CurlTransport::~CurlTransport() noexcept = default;
+
+string CurlTransport::get(const string &url, const map<string, string> &params) {
+    return perform(url + '?' + utils::buildUrlQuery(params, '&'), nullptr);
+}
+
+string CurlTransport::post(const string &url, const map<string, string> &params) {
+    string postField = utils::buildUrlQuery(params, '&');
+    return perform(url, &postField);
+}
+
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CURLTRANSPORT_H
+#define CURLTRANSPORT_H
+
+#include "transport.h"
+
+namespace netatmoapi {
+
+/**
+ * @brief Transport with libcurl.
+ *
+ * Every request uses its own curl easy handle, so requests can run
+ * concurrently. The global initialization of libcurl is guarded by a
+ * mutex, which is shared by all instances.
+ */
+class CurlTransport : public Transport {
+public:
+    /**
+     * Destructor.
+     * Is default.
+     */
+    ~CurlTransport() noexcept override;
+
+    /**
+     * Performs a http get request via libcurl.
+     * @param url The request url without query.
+     * @param params The query parameters.
+     * @return The response body.
+     * @throw CurlException Is thrown if a negativ result returned from curl.
+     */
+    std::string get(const std::string &url, const std::map<std::string, std::string> &params) override;
+
+    /**
+     * Performs a http post request via libcurl.
+     * @param url The request url.
+     * @param params The post parameters.
+     * @return The response body.
+     * @throw CurlException Is thrown if a negativ result returned from curl.
+     */
+    std::string post(const std::string &url, const std::map<std::string, std::string> &params) override;
+};
+
+}
+
+#endif /* CURLTRANSPORT_H */
@@ -0,0 +1,244 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "derivedmetrics.h"
+#include "simd.hpp"
+
+#include <cmath>
+#include <limits>
+
+using namespace std;
+
+namespace netatmoapi {
+namespace derived {
+
+namespace {
+
+const double cMissing = numeric_limits<double>::min();
+
+// Magnus coefficients over water, Sonntag 1990.
+const double cMagnusA = 17.62;
+const double cMagnusB = 243.12;
+const double cMagnusE = 6.112;
+
+double heatIndexFahrenheit(double fahrenheit, double humidity) {
+    double simple = 0.5 * (fahrenheit + 61 + (fahrenheit - 68) * 1.2 + humidity * 0.094);
+    if ((simple + fahrenheit) * 0.5 < 80) {
+        return simple;
+    }
+    double f = fahrenheit, rh = humidity;
+    double result = -42.379 + 2.04901523 * f + 10.14333127 * rh - 0.22475541 * f * rh - 0.00683783 * f * f
+            - 0.05481717 * rh * rh + 0.00122874 * f * f * rh + 0.00085282 * f * rh * rh - 0.00000199 * f * f * rh * rh;
+    if (rh < 13 && f >= 80 && f <= 112) {
+        result -= (13 - rh) * 0.25 * sqrt((17 - fabs(f - 95)) / 17);
+    } else if (rh > 85 && f >= 80 && f <= 87) {
+        result += (rh - 85) * 0.1 * ((87 - f) * 0.2);
+    }
+    return result;
+}
+
+#ifdef __SSE2__
+
+__m128d valid(__m128d a, __m128d b) {
+    const __m128d missing = _mm_set1_pd(cMissing);
+    return _mm_and_pd(_mm_cmpneq_pd(a, missing), _mm_cmpneq_pd(b, missing));
+}
+
+__m128d dewPoint(__m128d temperature, __m128d humidity) {
+    __m128d mask = _mm_and_pd(valid(temperature, humidity), _mm_cmpgt_pd(humidity, _mm_setzero_pd()));
+    humidity = simd::select(mask, humidity, _mm_set1_pd(100.0));
+    temperature = simd::select(mask, temperature, _mm_setzero_pd());
+    __m128d a = _mm_set1_pd(cMagnusA), b = _mm_set1_pd(cMagnusB);
+    __m128d gamma = _mm_add_pd(simd::log(_mm_mul_pd(humidity, _mm_set1_pd(0.01))),
+                               _mm_div_pd(_mm_mul_pd(a, temperature), _mm_add_pd(b, temperature)));
+    __m128d result = _mm_div_pd(_mm_mul_pd(b, gamma), _mm_sub_pd(a, gamma));
+    return simd::select(mask, result, _mm_set1_pd(cMissing));
+}
+
+__m128d humidex(__m128d temperature, __m128d humidity) {
+    __m128d mask = valid(temperature, humidity);
+    temperature = simd::select(mask, temperature, _mm_setzero_pd());
+    __m128d exponent = _mm_div_pd(_mm_mul_pd(_mm_set1_pd(cMagnusA), temperature), _mm_add_pd(_mm_set1_pd(cMagnusB), temperature));
+    __m128d vapourPressure = _mm_mul_pd(_mm_mul_pd(_mm_set1_pd(cMagnusE * 0.01), simd::exp(exponent)), humidity);
+    __m128d result = _mm_add_pd(temperature, _mm_mul_pd(_mm_set1_pd(5.0 / 9.0), _mm_sub_pd(vapourPressure, _mm_set1_pd(10.0))));
+    return simd::select(mask, result, _mm_set1_pd(cMissing));
+}
+
+__m128d windChill(__m128d temperature, __m128d windStrength) {
+    __m128d mask = valid(temperature, windStrength);
+    __m128d chill = _mm_and_pd(_mm_cmple_pd(temperature, _mm_set1_pd(10.0)), _mm_cmpgt_pd(windStrength, _mm_set1_pd(4.8)));
+    if (_mm_movemask_pd(_mm_and_pd(mask, chill)) == 0) {
+        return simd::select(mask, temperature, _mm_set1_pd(cMissing));
+    }
+    windStrength = simd::select(chill, windStrength, _mm_set1_pd(1.0));
+    __m128d power = simd::exp(_mm_mul_pd(_mm_set1_pd(0.16), simd::log(windStrength)));
+    __m128d result = _mm_add_pd(_mm_set1_pd(13.12), _mm_mul_pd(_mm_set1_pd(0.6215), temperature));
+    result = _mm_sub_pd(result, _mm_mul_pd(_mm_set1_pd(11.37), power));
+    result = _mm_add_pd(result, _mm_mul_pd(_mm_mul_pd(_mm_set1_pd(0.3965), temperature), power));
+    result = simd::select(chill, result, temperature);
+    return simd::select(mask, result, _mm_set1_pd(cMissing));
+}
+
+// Both branches of the regression are computed and selected per lane.
+__m128d heatIndex(__m128d temperature, __m128d humidity) {
+    __m128d mask = valid(temperature, humidity);
+    __m128d f = _mm_add_pd(_mm_mul_pd(temperature, _mm_set1_pd(1.8)), _mm_set1_pd(32.0));
+    __m128d rh = humidity;
+    __m128d simple = _mm_add_pd(_mm_add_pd(f, _mm_set1_pd(61.0)), _mm_mul_pd(_mm_sub_pd(f, _mm_set1_pd(68.0)), _mm_set1_pd(1.2)));
+    simple = _mm_mul_pd(_mm_set1_pd(0.5), _mm_add_pd(simple, _mm_mul_pd(rh, _mm_set1_pd(0.094))));
+    __m128d regression = _mm_cmpge_pd(_mm_mul_pd(_mm_add_pd(simple, f), _mm_set1_pd(0.5)), _mm_set1_pd(80.0));
+
+    __m128d f2 = _mm_mul_pd(f, f), rh2 = _mm_mul_pd(rh, rh), frh = _mm_mul_pd(f, rh);
+    __m128d result = _mm_add_pd(_mm_set1_pd(-42.379), _mm_mul_pd(_mm_set1_pd(2.04901523), f));
+    result = _mm_add_pd(result, _mm_mul_pd(_mm_set1_pd(10.14333127), rh));
+    result = _mm_sub_pd(result, _mm_mul_pd(_mm_set1_pd(0.22475541), frh));
+    result = _mm_sub_pd(result, _mm_mul_pd(_mm_set1_pd(0.00683783), f2));
+    result = _mm_sub_pd(result, _mm_mul_pd(_mm_set1_pd(0.05481717), rh2));
+    result = _mm_add_pd(result, _mm_mul_pd(_mm_set1_pd(0.00122874), _mm_mul_pd(f2, rh)));
+    result = _mm_add_pd(result, _mm_mul_pd(_mm_set1_pd(0.00085282), _mm_mul_pd(f, rh2)));
+    result = _mm_sub_pd(result, _mm_mul_pd(_mm_set1_pd(0.00000199), _mm_mul_pd(f2, rh2)));
+
+    __m128d hot = _mm_and_pd(_mm_cmpge_pd(f, _mm_set1_pd(80.0)), _mm_cmple_pd(f, _mm_set1_pd(112.0)));
+    __m128d dry = _mm_and_pd(hot, _mm_cmplt_pd(rh, _mm_set1_pd(13.0)));
+    __m128d distance = _mm_andnot_pd(_mm_set1_pd(-0.0), _mm_sub_pd(f, _mm_set1_pd(95.0)));
+    __m128d root = _mm_sqrt_pd(_mm_max_pd(_mm_mul_pd(_mm_sub_pd(_mm_set1_pd(17.0), distance), _mm_set1_pd(1.0 / 17)), _mm_setzero_pd()));
+    __m128d dryAdjustment = _mm_mul_pd(_mm_mul_pd(_mm_sub_pd(_mm_set1_pd(13.0), rh), _mm_set1_pd(0.25)), root);
+    result = _mm_sub_pd(result, _mm_and_pd(dry, dryAdjustment));
+    __m128d humid = _mm_and_pd(_mm_and_pd(_mm_cmpgt_pd(rh, _mm_set1_pd(85.0)), _mm_cmpge_pd(f, _mm_set1_pd(80.0))),
+                               _mm_cmple_pd(f, _mm_set1_pd(87.0)));
+    __m128d humidAdjustment = _mm_mul_pd(_mm_mul_pd(_mm_sub_pd(rh, _mm_set1_pd(85.0)), _mm_set1_pd(0.1)),
+                                         _mm_mul_pd(_mm_sub_pd(_mm_set1_pd(87.0), f), _mm_set1_pd(0.2)));
+    result = _mm_add_pd(result, _mm_and_pd(humid, humidAdjustment));
+
+    result = simd::select(regression, result, simple);
+    result = _mm_mul_pd(_mm_sub_pd(result, _mm_set1_pd(32.0)), _mm_set1_pd(1.0 / 1.8));
+    return simd::select(mask, result, _mm_set1_pd(cMissing));
+}
+
+template <__m128d (*Vector)(__m128d, __m128d), double (*Scalar)(double, double)>
+void apply(const double *a, const double *b, double *result, size_t count) {
+    // Two independent vectors per iteration, the kernels are latency bound.
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128d result0 = Vector(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i));
+        __m128d result1 = Vector(_mm_loadu_pd(a + i + 2), _mm_loadu_pd(b + i + 2));
+        _mm_storeu_pd(result + i, result0);
+        _mm_storeu_pd(result + i + 2, result1);
+    }
+    for (; i < count; ++i) {
+        result[i] = Scalar(a[i], b[i]);
+    }
+}
+
+#else
+
+template <double (*Scalar)(double, double)>
+void apply(const double *a, const double *b, double *result, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        result[i] = Scalar(a[i], b[i]);
+    }
+}
+
+#endif
+
+}
+
+double dewPoint(double temperature, double humidity) {
+    if (temperature == cMissing || humidity == cMissing || humidity <= 0) {
+        return cMissing;
+    }
+    double gamma = log(humidity * 0.01) + cMagnusA * temperature / (cMagnusB + temperature);
+    return cMagnusB * gamma / (cMagnusA - gamma);
+}
+
+double heatIndex(double temperature, double humidity) {
+    if (temperature == cMissing || humidity == cMissing) {
+        return cMissing;
+    }
+    return (heatIndexFahrenheit(temperature * 1.8 + 32, humidity) - 32) / 1.8;
+}
+
+double humidex(double temperature, double humidity) {
+    if (temperature == cMissing || humidity == cMissing) {
+        return cMissing;
+    }
+    double vapourPressure = cMagnusE * 0.01 * exp(cMagnusA * temperature / (cMagnusB + temperature)) * humidity;
+    return temperature + 5.0 / 9.0 * (vapourPressure - 10);
+}
+
+double windChill(double temperature, double windStrength) {
+    if (temperature == cMissing || windStrength == cMissing) {
+        return cMissing;
+    }
+    if (temperature > 10 || windStrength <= 4.8) {
+        return temperature;
+    }
+    double power = pow(windStrength, 0.16);
+    return 13.12 + 0.6215 * temperature - 11.37 * power + 0.3965 * temperature * power;
+}
+
+void dewPoint(const double *temperature, const double *humidity, double *result, size_t count) {
+#ifdef __SSE2__
+    apply<dewPoint, dewPoint>(temperature, humidity, result, count);
+#else
+    apply<dewPoint>(temperature, humidity, result, count);
+#endif
+}
+
+void heatIndex(const double *temperature, const double *humidity, double *result, size_t count) {
+#ifdef __SSE2__
+    apply<heatIndex, heatIndex>(temperature, humidity, result, count);
+#else
+    apply<heatIndex>(temperature, humidity, result, count);
+#endif
+}
+
+void humidex(const double *temperature, const double *humidity, double *result, size_t count) {
+#ifdef __SSE2__
+    apply<humidex, humidex>(temperature, humidity, result, count);
+#else
+    apply<humidex>(temperature, humidity, result, count);
+#endif
+}
+
+void windChill(const double *temperature, const double *windStrength, double *result, size_t count) {
+#ifdef __SSE2__
+    apply<windChill, windChill>(temperature, windStrength, result, count);
+#else
+    apply<windChill>(temperature, windStrength, result, count);
+#endif
+}
+
+double dewPoint(const Measures &measures) {
+    return dewPoint(measures.mTemperature, measures.mHumidity);
+}
+
+double heatIndex(const Measures &measures) {
+    return heatIndex(measures.mTemperature, measures.mHumidity);
+}
+
+double humidex(const Measures &measures) {
+    return humidex(measures.mTemperature, measures.mHumidity);
+}
+
+double windChill(const Measures &outdoor, const Measures &wind) {
+    return windChill(outdoor.mTemperature, wind.mWindStrength);
+}
+
+}
+}
@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef DERIVEDMETRICS_H
+#define DERIVEDMETRICS_H
+
+#include "model/measures.h"
+
+#include <cstddef>
+
+namespace netatmoapi {
+
+/**
+ * @brief Namespace for derived weather and comfort metrics.
+ *
+ * The metrics are computed from the metric values of the api, i.e.
+ * temperatures in °C, humidity in % and wind strength in km/h, and are
+ * returned in °C. If an input value is missing, i.e.
+ * std::numeric_limits<double>::min(), the result is missing, too.
+ *
+ * The batch functions work on columns, e.g. of MeasureColumns, and are
+ * vectorized with SSE2, where available. The scalar functions are the
+ * reference and give the same results up to rounding.
+ */
+namespace derived {
+
+/**
+ * Computes the dew point with the Magnus formula.
+ * @param temperature The temperature.
+ * @param humidity The relative humidity. Missing, if not positive.
+ * @return The dew point.
+ */
+double dewPoint(double temperature, double humidity);
+
+/**
+ * Computes the heat index with the regression of the US National Weather Service.
+ * @param temperature The temperature.
+ * @param humidity The relative humidity.
+ * @return The heat index.
+ */
+double heatIndex(double temperature, double humidity);
+
+/**
+ * Computes the humidex of Environment Canada.
+ * The vapour pressure is computed with the Magnus formula.
+ * @param temperature The temperature.
+ * @param humidity The relative humidity.
+ * @return The humidex.
+ */
+double humidex(double temperature, double humidity);
+
+/**
+ * Computes the wind chill of Environment Canada.
+ * Above 10 °C or below 4.8 km/h the wind chill is the temperature.
+ * @param temperature The temperature.
+ * @param windStrength The wind strength in km/h.
+ * @return The wind chill.
+ */
+double windChill(double temperature, double windStrength);
+
+/**
+ * Computes the dew point of columns.
+ * @param temperature The temperatures.
+ * @param humidity The relative humidities.
+ * @param result The dew points, may be one of the inputs.
+ * @param count The number of values.
+ */
+void dewPoint(const double *temperature, const double *humidity, double *result, std::size_t count);
+
+/**
+ * Computes the heat index of columns.
+ * @param temperature The temperatures.
+ * @param humidity The relative humidities.
+ * @param result The heat indices, may be one of the inputs.
+ * @param count The number of values.
+ */
+void heatIndex(const double *temperature, const double *humidity, double *result, std::size_t count);
+
+/**
+ * Computes the humidex of columns.
+ * @param temperature The temperatures.
+ * @param humidity The relative humidities.
+ * @param result The humidex values, may be one of the inputs.
+ * @param count The number of values.
+ */
+void humidex(const double *temperature, const double *humidity, double *result, std::size_t count);
+
+/**
+ * Computes the wind chill of columns.
+ * @param temperature The temperatures.
+ * @param windStrength The wind strengths in km/h.
+ * @param result The wind chill values, may be one of the inputs.
+ * @param count The number of values.
+ */
+void windChill(const double *temperature, const double *windStrength, double *result, std::size_t count);
+
+/**
+ * Computes the dew point of the measures of an outdoor or indoor module.
+ * @param measures The measures.
+ * @return The dew point.
+ */
+double dewPoint(const Measures &measures);
+
+/**
+ * Computes the heat index of the measures of an outdoor or indoor module.
+ * @param measures The measures.
+ * @return The heat index.
+ */
+double heatIndex(const Measures &measures);
+
+/**
+ * Computes the humidex of the measures of an outdoor or indoor module.
+ * @param measures The measures.
+ * @return The humidex.
+ */
+double humidex(const Measures &measures);
+
+/**
+ * Computes the wind chill of a station.
+ * @param outdoor The measures of the outdoor module.
+ * @param wind The measures of the wind gauge.
+ * @return The wind chill.
+ */
+double windChill(const Measures &outdoor, const Measures &wind);
+
+}
+
+}
+
+#endif /* DERIVEDMETRICS_H */
@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "devicesparser.h"
+#include "utils.h"
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace std;
+
+namespace netatmoapi {
+
+struct DevicesParserPrivate {
+    DevicesParserPrivate() :
+        mHits(0),
+        mMisses(0)
+    {}
+    list<Station> mStations;
+    unordered_map<string, uint64_t> mSignatures;
+    uint64_t mHits;
+    uint64_t mMisses;
+};
+
+namespace {
+
+uint64_t combine(uint64_t seed, uint64_t value) {
+    return seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+}
+
+uint64_t timeStamp(const json &object, const string &key) {
+    auto it = object.find(key);
+    if (it != object.end() && it->is_number()) {
+        return it->get<uint64_t>();
+    }
+    return 0;
+}
+
+uint64_t signature(const json &jsonStation) {
+    uint64_t seed = timeStamp(jsonStation, "last_status_store");
+    auto dashboardData = jsonStation.find("dashboard_data");
+    if (dashboardData != jsonStation.end()) {
+        seed = combine(seed, timeStamp(*dashboardData, "time_utc"));
+    }
+    auto jsonModules = jsonStation.find("modules");
+    if (jsonModules != jsonStation.end()) {
+        for (const json &jsonModule: *jsonModules) {
+            seed = combine(seed, hash<string>()(jsonModule["_id"].get_ref<const string &>()));
+            dashboardData = jsonModule.find("dashboard_data");
+            if (dashboardData != jsonModule.end()) {
+                seed = combine(seed, timeStamp(*dashboardData, "time_utc"));
+            }
+        }
+    }
+    return seed;
+}
+
+}
+
+DevicesParser::DevicesParser() :
+    d(new DevicesParserPrivate) {
+}
+
+DevicesParser::DevicesParser(const DevicesParser &o) :
+    d(new DevicesParserPrivate(*o.d)) {
+}
+
+DevicesParser::DevicesParser(DevicesParser &&o) noexcept :
+    d(move(o.d)) {
+}
+
+DevicesParser::~DevicesParser() noexcept = default;
+
+const list<Station> &DevicesParser::parse(const json &response) {
+    unordered_map<string, uint64_t> &signatures = d->mSignatures;
+    try {
+        utils::parseDevices(response, d->mStations, [this, &signatures](const json &jsonStation) {
+            uint64_t newSignature = signature(jsonStation);
+            const string &id = jsonStation["_id"].get_ref<const string &>();
+            auto it = signatures.find(id);
+            if (it == signatures.end()) {
+                signatures.emplace(id, newSignature);
+            } else if (it->second == newSignature) {
+                ++d->mHits;
+                return true;
+            } else {
+                it->second = newSignature;
+            }
+            ++d->mMisses;
+            return false;
+        });
+    } catch (...) {
+        // A partly parsed station must not be reused by the next poll.
+        signatures.clear();
+        throw;
+    }
+
+    // Forget the signatures of removed stations.
+    if (signatures.size() > d->mStations.size()) {
+        unordered_set<string> ids;
+        for (const Station &station: d->mStations) {
+            ids.insert(station.id());
+        }
+        for (auto it = signatures.begin(); it != signatures.end();) {
+            if (ids.count(it->first)) {
+                ++it;
+            } else {
+                it = signatures.erase(it);
+            }
+        }
+    }
+
+    return d->mStations;
+}
+
+const list<Station> &DevicesParser::stations() const {
+    return d->mStations;
+}
+
+list<Station> DevicesParser::takeStations() {
+    list<Station> stations = move(d->mStations);
+    d->mStations.clear();
+    d->mSignatures.clear();
+    return stations;
+}
+
+uint64_t DevicesParser::hits() const {
+    return d->mHits;
+}
+
+uint64_t DevicesParser::misses() const {
+    return d->mMisses;
+}
+
+double DevicesParser::hitRate() const {
+    uint64_t total = d->mHits + d->mMisses;
+    if (total == 0) {
+        return 0;
+    }
+    return static_cast<double>(d->mHits) / static_cast<double>(total);
+}
+
+void DevicesParser::resetStatistics() {
+    d->mHits = 0;
+    d->mMisses = 0;
+}
+
+DevicesParser &DevicesParser::operator =(const DevicesParser &o) {
+    d.reset(new DevicesParserPrivate(*o.d));
+    return *this;
+}
+
+DevicesParser &DevicesParser::operator =(DevicesParser &&o) noexcept {
+    d = move(o.d);
+    return *this;
+}
+
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef DEVICESPARSER_H
+#define DEVICESPARSER_H
+
+#include "model/station.h"
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+namespace netatmoapi {
+
+struct DevicesParserPrivate;
+
+/**
+ * @brief This class parses consecutive polls of the weather stations data.
+ *
+ * The parser keeps the result of the last poll and updates it in place
+ * with utils::parseDevices(const json &, std::list<Station> &, const std::function<bool (const json &)> &).
+ *
+ * Before a station is parsed, only its "last_status_store" value and
+ * the "time_utc" value of every module are read and hashed. If the hash
+ * equals the hash of the last poll, the station did not send new data
+ * and the already parsed station is reused. The number of reused and
+ * parsed stations is counted, see hits(), misses() and hitRate().
+ */
+class DevicesParser {
+public:
+    /**
+     * Default constructor.
+     */
+    DevicesParser();
+
+    /**
+     * Copy constructor.
+     * @param o The element to copy.
+     */
+    DevicesParser(const DevicesParser &o);
+
+    /**
+     * Move constructor.
+     * @param o The element to move.
+     */
+    DevicesParser(DevicesParser &&o) noexcept;
+
+    /**
+     * Destructor.
+     * Is default.
+     */
+    virtual ~DevicesParser() noexcept;
+
+    /**
+     * Parses a new poll.
+     * @param response The json response from NAWSApiClient::requestStationsData().
+     * @return The parsed list of Stations. The reference is valid until the next call or the destruction of the parser.
+     */
+    const std::list<Station> &parse(const json &response);
+
+    /**
+     * Returns the parsed list of Stations of the last poll.
+     * @return The parsed list of Stations.
+     */
+    const std::list<Station> &stations() const;
+
+    /**
+     * Moves the parsed list of Stations out of the parser and forgets the last poll.
+     * @return The parsed list of Stations.
+     */
+    std::list<Station> takeStations();
+
+    /**
+     * Returns the number of stations, which were reused unchanged.
+     * @return The number of hits.
+     */
+    std::uint64_t hits() const;
+
+    /**
+     * Returns the number of stations, which were parsed.
+     * @return The number of misses.
+     */
+    std::uint64_t misses() const;
+
+    /**
+     * Returns the ratio of reused stations to all stations.
+     * @return The hit rate between 0 and 1, or 0 if nothing was parsed yet.
+     */
+    double hitRate() const;
+
+    /**
+     * Resets the hit and miss counters.
+     */
+    void resetStatistics();
+
+    /**
+     * Copy assignment operator.
+     * @param o The element to copy.
+     * @return This element as reference.
+     */
+    DevicesParser &operator =(const DevicesParser &o);
+
+    /**
+     * Move assignment operator.
+     * @param o The element to move.
+     * @return This element as reference.
+     */
+    DevicesParser &operator =(DevicesParser &&o) noexcept;
+
+private:
+    std::unique_ptr<DevicesParserPrivate> d;
+};
+
+}
+
+#endif /* DEVICESPARSER_H */
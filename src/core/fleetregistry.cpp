@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "fleetregistry.h"
+
+#include <algorithm>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <unordered_map>
+
+using namespace std;
+
+namespace netatmoapi {
+
+namespace {
+
+// The newest module time stamp decides, which copy of a station is newer.
+uint64_t dataTime(const Station &station) {
+    uint64_t time = 0;
+    for (const Module &module: station.modulesRef()) {
+        time = max(time, module.measures().mTimeStamp);
+    }
+    return time;
+}
+
+struct Entry {
+    Station         mStation;
+    uint64_t        mDataTime;
+    uint64_t        mLastFetch;
+    set<string>     mAccounts;
+};
+
+}
+
+struct FleetRegistryPrivate {
+    explicit FleetRegistryPrivate(uint64_t maxAge) :
+        mMaxAge(maxAge)
+    {}
+
+    bool isFresh(const Entry &entry, uint64_t now) const {
+        return entry.mLastFetch + mMaxAge > now;
+    }
+
+    void hide(const string &account, const string &deviceId) {
+        auto entry = mEntries.find(deviceId);
+        if (entry == mEntries.end()) {
+            return;
+        }
+        entry->second.mAccounts.erase(account);
+        if (entry->second.mAccounts.empty()) {
+            mEntries.erase(entry);
+        }
+    }
+
+    mutable mutex mMutex;
+    uint64_t mMaxAge;
+    unordered_map<string, Entry> mEntries;
+    unordered_map<string, set<string>> mDevicesByAccount;
+};
+
+const uint64_t FleetRegistry::sDefaultMaxAge = 600;
+
+FleetRegistry::FleetRegistry(uint64_t maxAge) :
+    d(new FleetRegistryPrivate(maxAge)) {
+}
+
+FleetRegistry::~FleetRegistry() noexcept = default;
+
+uint64_t FleetRegistry::maxAge() const {
+    lock_guard<mutex> lock(d->mMutex);
+    return d->mMaxAge;
+}
+
+void FleetRegistry::setMaxAge(uint64_t maxAge) {
+    lock_guard<mutex> lock(d->mMutex);
+    d->mMaxAge = maxAge;
+}
+
+size_t FleetRegistry::update(const string &account, list<Station> &&stations, uint64_t fetchTime, bool complete) {
+    lock_guard<mutex> lock(d->mMutex);
+    set<string> &devices = d->mDevicesByAccount[account];
+    set<string> seen;
+    size_t replaced = 0;
+    for (Station &station: stations) {
+        string id = station.id();
+        uint64_t time = dataTime(station);
+        auto inserted = d->mEntries.emplace(id, Entry());
+        Entry &entry = inserted.first->second;
+        if (inserted.second || time > entry.mDataTime) {
+            entry.mStation = move(station);
+            entry.mDataTime = time;
+            ++replaced;
+        }
+        if (inserted.second) {
+            entry.mLastFetch = fetchTime;
+        } else {
+            entry.mLastFetch = max(entry.mLastFetch, fetchTime);
+        }
+        entry.mAccounts.insert(account);
+        devices.insert(id);
+        seen.insert(move(id));
+    }
+    if (complete) {
+        for (auto device = devices.begin(); device != devices.end();) {
+            if (seen.count(*device)) {
+                ++device;
+            } else {
+                d->hide(account, *device);
+                device = devices.erase(device);
+            }
+        }
+    }
+    return replaced;
+}
+
+bool FleetRegistry::shouldFetch(const string &account, const string &deviceId, uint64_t now) const {
+    lock_guard<mutex> lock(d->mMutex);
+    auto entry = d->mEntries.find(deviceId);
+    if (entry == d->mEntries.end()) {
+        return true;
+    }
+    return entry->second.mAccounts.count(account) && !d->isFresh(entry->second, now);
+}
+
+vector<string> FleetRegistry::devicesToFetch(const string &account, uint64_t now) const {
+    lock_guard<mutex> lock(d->mMutex);
+    vector<string> result;
+    auto devices = d->mDevicesByAccount.find(account);
+    if (devices == d->mDevicesByAccount.end()) {
+        return result;
+    }
+    for (const string &deviceId: devices->second) {
+        if (!d->isFresh(d->mEntries.at(deviceId), now)) {
+            result.push_back(deviceId);
+        }
+    }
+    return result;
+}
+
+vector<string> FleetRegistry::accounts(const string &deviceId) const {
+    lock_guard<mutex> lock(d->mMutex);
+    auto entry = d->mEntries.find(deviceId);
+    if (entry == d->mEntries.end()) {
+        return vector<string>();
+    }
+    return vector<string>(entry->second.mAccounts.begin(), entry->second.mAccounts.end());
+}
+
+vector<string> FleetRegistry::devices(const string &account) const {
+    lock_guard<mutex> lock(d->mMutex);
+    auto devices = d->mDevicesByAccount.find(account);
+    if (devices == d->mDevicesByAccount.end()) {
+        return vector<string>();
+    }
+    return vector<string>(devices->second.begin(), devices->second.end());
+}
+
+Station FleetRegistry::station(const string &deviceId) const {
+    lock_guard<mutex> lock(d->mMutex);
+    auto entry = d->mEntries.find(deviceId);
+    if (entry == d->mEntries.end()) {
+        throw out_of_range("Unknown station: " + deviceId);
+    }
+    return entry->second.mStation;
+}
+
+list<Station> FleetRegistry::stations() const {
+    lock_guard<mutex> lock(d->mMutex);
+    vector<const Entry *> entries;
+    entries.reserve(d->mEntries.size());
+    for (const auto &entry: d->mEntries) {
+        entries.push_back(&entry.second);
+    }
+    sort(entries.begin(), entries.end(), [](const Entry *a, const Entry *b) {
+        return a->mStation.id() < b->mStation.id();
+    });
+    list<Station> result;
+    for (const Entry *entry: entries) {
+        result.push_back(entry->mStation);
+    }
+    return result;
+}
+
+uint64_t FleetRegistry::lastFetch(const string &deviceId) const {
+    lock_guard<mutex> lock(d->mMutex);
+    auto entry = d->mEntries.find(deviceId);
+    return entry == d->mEntries.end() ? 0 : entry->second.mLastFetch;
+}
+
+void FleetRegistry::removeAccount(const string &account) {
+    lock_guard<mutex> lock(d->mMutex);
+    auto devices = d->mDevicesByAccount.find(account);
+    if (devices == d->mDevicesByAccount.end()) {
+        return;
+    }
+    for (const string &deviceId: devices->second) {
+        d->hide(account, deviceId);
+    }
+    d->mDevicesByAccount.erase(devices);
+}
+
+size_t FleetRegistry::size() const {
+    lock_guard<mutex> lock(d->mMutex);
+    return d->mEntries.size();
+}
+
+}
@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef FLEETREGISTRY_H
+#define FLEETREGISTRY_H
+
+#include "model/station.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace netatmoapi {
+
+struct FleetRegistryPrivate;
+
+/**
+ * @brief This class merges the stations of many accounts into one fleet.
+ *
+ * With getFavorites and with stations shared with friends, the same
+ * station is part of the requestStationsData() responses of many
+ * accounts. The registry keeps one canonical copy per device id, the
+ * one with the newest measures, and remembers which accounts can see
+ * the station.
+ *
+ * A poller asks devicesToFetch() or shouldFetch() before it requests a
+ * station through an account. A station, which was fetched through any
+ * account within maxAge() seconds, is fresh and skipped. The registry
+ * only knows the stations of the responses, so a poller still requests
+ * the complete list of an account from time to time to find new
+ * stations.
+ *
+ * All time stamps are unix time stamps. All methods are thread safe.
+ */
+class FleetRegistry {
+public:
+    /**
+     * Constructor.
+     * @param maxAge The age in seconds, up to which a fetched station is fresh.
+     */
+    explicit FleetRegistry(std::uint64_t maxAge = sDefaultMaxAge);
+
+    FleetRegistry(const FleetRegistry &) = delete;
+
+    /**
+     * Destructor.
+     * Is default.
+     */
+    virtual ~FleetRegistry() noexcept;
+
+    /**
+     * Returns the age, up to which a fetched station is fresh.
+     * Default: [sDefaultMaxAge](@ref netatmoapi::FleetRegistry::sDefaultMaxAge)
+     * @return The age in seconds.
+     */
+    std::uint64_t maxAge() const;
+
+    /**
+     * Sets the age, up to which a fetched station is fresh.
+     * @param maxAge The age in seconds.
+     */
+    void setMaxAge(std::uint64_t maxAge);
+
+    /**
+     * Merges the stations of a response of an account.
+     *
+     * The account can see all stations. A station replaces the canonical
+     * copy, if its newest module time stamp is newer. If complete is
+     * true, the stations are all stations of the account, e.g. a
+     * response without device id. Then the account can not see the
+     * other stations anymore, and stations, which no account can see,
+     * are removed.
+     *
+     * @param account The account, e.g. the user name.
+     * @param stations The parsed stations, e.g. from utils::parseDevices(). Replacing stations are moved out.
+     * @param fetchTime The time of the request.
+     * @param complete True, if the response holds all stations of the account.
+     * @return The number of new or replaced canonical copies.
+     */
+    std::size_t update(const std::string &account, std::list<Station> &&stations, std::uint64_t fetchTime, bool complete = true);
+
+    /**
+     * Returns true, if a station should be fetched through an account.
+     * @param account The account.
+     * @param deviceId The id of the station.
+     * @param now The current time.
+     * @return False, if the account can not see the known station or the station is fresh, true otherwise.
+     */
+    bool shouldFetch(const std::string &account, const std::string &deviceId, std::uint64_t now) const;
+
+    /**
+     * Returns the stations of an account, which are not fresh.
+     * @param account The account.
+     * @param now The current time.
+     * @return The sorted device ids.
+     */
+    std::vector<std::string> devicesToFetch(const std::string &account, std::uint64_t now) const;
+
+    /**
+     * Returns the accounts, which can see a station.
+     * @param deviceId The id of the station.
+     * @return The sorted accounts, empty for an unknown station.
+     */
+    std::vector<std::string> accounts(const std::string &deviceId) const;
+
+    /**
+     * Returns the stations, which an account can see.
+     * @param account The account.
+     * @return The sorted device ids, empty for an unknown account.
+     */
+    std::vector<std::string> devices(const std::string &account) const;
+
+    /**
+     * Returns the canonical copy of a station.
+     * @param deviceId The id of the station.
+     * @return The station.
+     * @throw std::out_of_range If the station is unknown.
+     */
+    Station station(const std::string &deviceId) const;
+
+    /**
+     * Returns the canonical copies of all stations.
+     * @return The stations, sorted by id.
+     */
+    std::list<Station> stations() const;
+
+    /**
+     * Returns the time, when a station was fetched last through any account.
+     * @param deviceId The id of the station.
+     * @return The time, 0 for an unknown station.
+     */
+    std::uint64_t lastFetch(const std::string &deviceId) const;
+
+    /**
+     * Removes an account.
+     * Stations, which no other account can see, are removed.
+     * @param account The account.
+     */
+    void removeAccount(const std::string &account);
+
+    /**
+     * Returns the number of stations.
+     * @return The number of stations.
+     */
+    std::size_t size() const;
+
+    FleetRegistry &operator =(const FleetRegistry &) = delete;
+
+    /**
+     * The default age, up to which a fetched station is fresh.
+     * Netatmo stations send their measures every 10 minutes.
+     * Value: 600
+     */
+    static const std::uint64_t sDefaultMaxAge;
+
+private:
+    std::unique_ptr<FleetRegistryPrivate> d;
+};
+
+}
+
+#endif /* FLEETREGISTRY_H */
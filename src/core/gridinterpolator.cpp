@@ -0,0 +1,258 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "gridinterpolator.h"
+#include "kdtree.hpp"
+#include "simd.hpp"
+#include "stationindex.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+
+using namespace std;
+
+namespace netatmoapi {
+
+namespace {
+
+// Samples nearer than 1e-9 of the earth radius, i.e. about 6 mm, count as at the cell.
+const double cMinSquaredChord = 1e-18;
+
+bool acceptAll(uint32_t) {
+    return true;
+}
+
+}
+
+struct GridInterpolatorPrivate {
+    explicit GridInterpolatorPrivate(GridInterpolator::Method method) :
+        mMethod(method),
+        mNeighbours(GridInterpolator::sDefaultNeighbours),
+        mPower(GridInterpolator::sDefaultPower),
+        mMaxDistance(0)
+    {}
+
+    void add(double latitude, double longitude, double value, vector<kdtree::Point> &points) {
+        points.push_back(kdtree::toPoint(latitude, longitude, static_cast<uint32_t>(mValues.size())));
+        mValues.push_back(value);
+    }
+
+    // Interpolates one row. The buffers hold the neighbours of all cells of the row.
+    void interpolateRow(Raster &raster, size_t row, size_t neighbours, double limit,
+                        vector<double> &squared, vector<double> &values, vector<double> &result) const {
+        const size_t columns = raster.mColumns;
+        float *out = raster.mValues.data() + row * columns;
+        double latitude = raster.latitude(row);
+        squared.assign(neighbours * columns, numeric_limits<double>::infinity());
+        values.assign(neighbours * columns, 0);
+        priority_queue<kdtree::Candidate> heap;
+        for (size_t column = 0; column < columns; ++column) {
+            kdtree::Point query = kdtree::toPoint(latitude, raster.longitude(column), 0);
+            mTree.nearest(query, neighbours, limit, acceptAll, heap);
+            for (size_t j = heap.size(); j > 0; --j) {
+                squared[(j - 1) * columns + column] = heap.top().first;
+                values[(j - 1) * columns + column] = mValues[heap.top().second];
+                heap.pop();
+            }
+        }
+        if (mMethod == GridInterpolator::nearestNeighbour) {
+            for (size_t column = 0; column < columns; ++column) {
+                out[column] = squared[column] == numeric_limits<double>::infinity()
+                        ? numeric_limits<float>::quiet_NaN() : static_cast<float>(values[column]);
+            }
+            return;
+        }
+        result.resize(columns);
+        simd::inverseDistance(squared.data(), values.data(), columns, neighbours, mPower, cMinSquaredChord, result.data());
+        for (size_t column = 0; column < columns; ++column) {
+            out[column] = static_cast<float>(result[column]);
+        }
+    }
+
+    GridInterpolator::Method mMethod;
+    size_t mNeighbours;
+    double mPower;
+    double mMaxDistance;
+    kdtree::Tree mTree;
+    vector<double> mValues;
+};
+
+const size_t GridInterpolator::sDefaultNeighbours = 8;
+const double GridInterpolator::sDefaultPower = 2;
+
+GridInterpolator::GridInterpolator(Method method) :
+    d(new GridInterpolatorPrivate(method)) {
+}
+
+GridInterpolator::GridInterpolator(const GridInterpolator &o) :
+    d(new GridInterpolatorPrivate(*o.d)) {
+}
+
+GridInterpolator::GridInterpolator(GridInterpolator &&o) noexcept :
+    d(move(o.d)) {
+}
+
+GridInterpolator::~GridInterpolator() noexcept = default;
+
+GridInterpolator::Method GridInterpolator::method() const {
+    return d->mMethod;
+}
+
+void GridInterpolator::setMethod(Method method) {
+    d->mMethod = method;
+}
+
+size_t GridInterpolator::neighbours() const {
+    return d->mNeighbours;
+}
+
+void GridInterpolator::setNeighbours(size_t neighbours) {
+    if (neighbours == 0) {
+        throw invalid_argument("The number of neighbours must be at least 1.");
+    }
+    d->mNeighbours = neighbours;
+}
+
+double GridInterpolator::power() const {
+    return d->mPower;
+}
+
+void GridInterpolator::setPower(double power) {
+    if (!(power > 0)) {
+        throw invalid_argument("The power must be positive.");
+    }
+    d->mPower = power;
+}
+
+double GridInterpolator::maxDistance() const {
+    return d->mMaxDistance;
+}
+
+void GridInterpolator::setMaxDistance(double maxDistance) {
+    d->mMaxDistance = max(maxDistance, 0.0);
+}
+
+void GridInterpolator::setSamples(const vector<Sample> &samples) {
+    vector<kdtree::Point> points;
+    points.reserve(samples.size());
+    d->mValues.clear();
+    d->mValues.reserve(samples.size());
+    for (const Sample &sample: samples) {
+        d->add(sample.mLatitude, sample.mLongitude, sample.mValue, points);
+    }
+    d->mTree.build(move(points));
+}
+
+size_t GridInterpolator::setSamples(const list<Station> &stations, Measures::Field field) {
+    vector<kdtree::Point> points;
+    d->mValues.clear();
+    for (const Station &station: stations) {
+        const Place &place = station.placeRef();
+        if (!place.hasLocation()) {
+            continue;
+        }
+        const Module *source = nullptr;
+        for (const Module &module: station.modulesRef()) {
+            if (module.measures().hasValue(field)) {
+                bool indoor = module.type() == Module::sTypeBase || module.type() == Module::sTypeIndoor;
+                if (!indoor) {
+                    source = &module;
+                    break;
+                }
+                source = source ? source : &module;
+            }
+        }
+        if (source) {
+            d->add(place.mLatitude, place.mLongitude, source->measures().value(field), points);
+        }
+    }
+    d->mTree.build(move(points));
+    return d->mValues.size();
+}
+
+size_t GridInterpolator::setSamples(const vector<PublicStation> &stations, Measures::Field field) {
+    vector<kdtree::Point> points;
+    d->mValues.clear();
+    for (const PublicStation &station: stations) {
+        if (station.mMeasures.hasValue(field)) {
+            d->add(station.mLatitude, station.mLongitude, station.mMeasures.value(field), points);
+        }
+    }
+    d->mTree.build(move(points));
+    return d->mValues.size();
+}
+
+size_t GridInterpolator::sampleCount() const {
+    return d->mValues.size();
+}
+
+Raster GridInterpolator::interpolate(const BoundingBox &region, size_t rows, size_t columns, size_t threadCount) const {
+    Raster raster(region, rows, columns);
+    if (d->mValues.empty() || raster.mValues.empty()) {
+        return raster;
+    }
+    size_t neighbours = d->mMethod == nearestNeighbour ? 1 : min(d->mNeighbours, d->mValues.size());
+    double limit = d->mMaxDistance > 0
+            ? kdtree::toSquaredChord(d->mMaxDistance / StationIndex::sEarthRadius)
+            : numeric_limits<double>::infinity();
+    if (threadCount == 0) {
+        threadCount = max<size_t>(thread::hardware_concurrency(), 1);
+    }
+    threadCount = min(threadCount, rows);
+    atomic<size_t> next(0);
+    auto worker = [&]() {
+        vector<double> squared, values, result;
+        for (size_t row = next++; row < rows; row = next++) {
+            d->interpolateRow(raster, row, neighbours, limit, squared, values, result);
+        }
+    };
+    vector<thread> threads;
+    try {
+        for (size_t i = 1; i < threadCount; ++i) {
+            threads.emplace_back(worker);
+        }
+    } catch (...) {
+        // The started threads must be joined before they are destroyed.
+        next = rows;
+        for (thread &t: threads) {
+            t.join();
+        }
+        throw;
+    }
+    worker();
+    for (thread &t: threads) {
+        t.join();
+    }
+    return raster;
+}
+
+GridInterpolator &GridInterpolator::operator =(const GridInterpolator &o) {
+    d.reset(new GridInterpolatorPrivate(*o.d));
+    return *this;
+}
+
+GridInterpolator &GridInterpolator::operator =(GridInterpolator &&o) noexcept {
+    d = move(o.d);
+    return *this;
+}
+
+}
@@ -0,0 +1,245 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GRIDINTERPOLATOR_H
+#define GRIDINTERPOLATOR_H
+
+#include "model/boundingbox.h"
+#include "model/measures.h"
+#include "model/publicstation.h"
+#include "model/raster.h"
+#include "model/station.h"
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <vector>
+
+namespace netatmoapi {
+
+struct GridInterpolatorPrivate;
+
+/**
+ * @brief Interpolates station measures to a dense raster.
+ *
+ * The samples are stored in the same k-d tree as in StationIndex. For
+ * every cell of the raster, the nearest samples are looked up in the tree
+ * and weighted. The rows of the raster are distributed over threads, and
+ * the weighting of the cells of a row is vectorized with SSE2, where
+ * available.
+ *
+ * With the method inverseDistance, the value of a cell is the weighted
+ * mean of the nearest neighbours() samples with the weight
+ * distance^-power(). The distance is the straight line distance through
+ * the earth, which differs from the great circle distance by less than
+ * 0.1 % below 500 km. With the method nearestNeighbour, the value of a
+ * cell is the value of its nearest sample.
+ *
+ * If maxDistance() is set, only samples up to that distance are used, and
+ * cells without such a sample are NaN.
+ *
+ * interpolate() is const and can run concurrently, but not concurrently
+ * with the setters.
+ */
+class GridInterpolator {
+public:
+    /**
+     * @brief The interpolation method.
+     */
+    enum Method {
+        /// The value of the nearest sample.
+        nearestNeighbour,
+        /// The inverse distance weighted mean of the nearest samples.
+        inverseDistance
+    };
+
+    /**
+     * @brief A value at a location.
+     */
+    struct Sample {
+        /**
+         * The latitude in degrees.
+         */
+        double  mLatitude;
+
+        /**
+         * The longitude in degrees.
+         */
+        double  mLongitude;
+
+        /**
+         * The value.
+         */
+        double  mValue;
+    };
+
+    /**
+     * Constructor.
+     * Constructs an interpolator without samples.
+     * @param method The interpolation method.
+     */
+    explicit GridInterpolator(Method method = inverseDistance);
+
+    /**
+     * Copy constructor.
+     * @param o The element to copy.
+     */
+    GridInterpolator(const GridInterpolator &o);
+
+    /**
+     * Move constructor.
+     * @param o The element to move.
+     */
+    GridInterpolator(GridInterpolator &&o) noexcept;
+
+    /**
+     * Destructor.
+     * Is default.
+     */
+    virtual ~GridInterpolator() noexcept;
+
+    /**
+     * Returns the interpolation method.
+     * @return The method.
+     */
+    Method method() const;
+
+    /**
+     * Sets the interpolation method.
+     * @param method The method.
+     */
+    void setMethod(Method method);
+
+    /**
+     * Returns the number of samples, which are weighted by inverseDistance.
+     * Default: [sDefaultNeighbours](@ref netatmoapi::GridInterpolator::sDefaultNeighbours)
+     * @return The number of samples per cell.
+     */
+    std::size_t neighbours() const;
+
+    /**
+     * Sets the number of samples, which are weighted by inverseDistance.
+     * @param neighbours The number of samples per cell, at least 1.
+     * @throw std::invalid_argument If neighbours is 0.
+     */
+    void setNeighbours(std::size_t neighbours);
+
+    /**
+     * Returns the power of the distance in the weights of inverseDistance.
+     * Default: [sDefaultPower](@ref netatmoapi::GridInterpolator::sDefaultPower)
+     * @return The power.
+     */
+    double power() const;
+
+    /**
+     * Sets the power of the distance in the weights of inverseDistance.
+     * @param power The power, must be positive.
+     * @throw std::invalid_argument If power is not positive.
+     */
+    void setPower(double power);
+
+    /**
+     * Returns the maximum distance of the samples of a cell.
+     * @return The distance in km, 0 for no limit.
+     */
+    double maxDistance() const;
+
+    /**
+     * Sets the maximum distance of the samples of a cell.
+     * @param maxDistance The distance in km, 0 for no limit.
+     */
+    void setMaxDistance(double maxDistance);
+
+    /**
+     * Replaces the samples.
+     * @param samples The samples.
+     */
+    void setSamples(const std::vector<Sample> &samples);
+
+    /**
+     * Replaces the samples with a field of stations.
+     *
+     * A station is used, if it has a location. The value is taken from
+     * the first outdoor module with the field, or otherwise from the first
+     * module with the field. So the outdoor temperature of a station is
+     * preferred to the temperature of the base station.
+     *
+     * @param stations The stations, e.g. from utils::parseDevices().
+     * @param field The field to interpolate.
+     * @return The number of samples.
+     */
+    std::size_t setSamples(const std::list<Station> &stations, Measures::Field field);
+
+    /**
+     * Replaces the samples with a field of public stations.
+     * Stations without the field are skipped.
+     * @param stations The stations, e.g. from NAPublicApiClient::requestPublicStations().
+     * @param field The field to interpolate.
+     * @return The number of samples.
+     */
+    std::size_t setSamples(const std::vector<PublicStation> &stations, Measures::Field field);
+
+    /**
+     * Returns the number of samples.
+     * @return The number of samples.
+     */
+    std::size_t sampleCount() const;
+
+    /**
+     * Interpolates the samples to a raster.
+     * @param region The region of the raster.
+     * @param rows The number of rows.
+     * @param columns The number of columns.
+     * @param threadCount The number of threads, 0 for the number of cores.
+     * @return The raster. All cells are NaN, if there are no samples.
+     */
+    Raster interpolate(const BoundingBox &region, std::size_t rows, std::size_t columns, std::size_t threadCount = 0) const;
+
+    /**
+     * Copy assignment operator.
+     * @param o The element to copy.
+     * @return This element as reference.
+     */
+    GridInterpolator &operator =(const GridInterpolator &o);
+
+    /**
+     * Move assignment operator.
+     * @param o The element to move.
+     * @return This element as reference.
+     */
+    GridInterpolator &operator =(GridInterpolator &&o) noexcept;
+
+    /**
+     * The default number of samples per cell.
+     * Value: 8
+     */
+    static const std::size_t sDefaultNeighbours;
+
+    /**
+     * The default power of the distance.
+     * Value: 2
+     */
+    static const double sDefaultPower;
+
+private:
+    std::unique_ptr<GridInterpolatorPrivate> d;
+};
+
+}
+
+#endif /* GRIDINTERPOLATOR_H */
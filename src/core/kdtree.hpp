@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef KDTREE_HPP
+#define KDTREE_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace netatmoapi {
+
+namespace kdtree {
+
+// A location as 3D unit vector and the index of its payload.
+struct Point {
+    double          mCoordinates[3];
+    std::uint32_t   mIndex;
+};
+
+// A found point as pair of squared chord and index.
+using Candidate = std::pair<double, std::uint32_t>;
+
+inline Point toPoint(double latitude, double longitude, std::uint32_t index)
+{
+    const double radians = 3.14159265358979323846 / 180;
+    double phi = latitude * radians;
+    double lambda = longitude * radians;
+    return { { std::cos(phi) * std::cos(lambda), std::cos(phi) * std::sin(lambda), std::sin(phi) }, index };
+}
+
+inline double squaredChord(const Point &a, const Point &b)
+{
+    double x = a.mCoordinates[0] - b.mCoordinates[0];
+    double y = a.mCoordinates[1] - b.mCoordinates[1];
+    double z = a.mCoordinates[2] - b.mCoordinates[2];
+    return x * x + y * y + z * z;
+}
+
+// Converts the squared chord on the unit sphere to the central angle in radians.
+inline double toAngle(double squaredChord)
+{
+    return 2 * std::asin(std::min(std::sqrt(squaredChord) / 2, 1.0));
+}
+
+// Converts the central angle in radians to the squared chord on the unit sphere.
+inline double toSquaredChord(double angle)
+{
+    if (angle >= 3.14159265358979323846) {
+        return 4;
+    }
+    double chord = 2 * std::sin(std::max(angle, 0.0) / 2);
+    return chord * chord;
+}
+
+// Keeps the count nearest candidates in a max heap.
+inline void offer(double distance, std::uint32_t index, std::size_t count, std::priority_queue<Candidate> &heap)
+{
+    if (heap.size() < count) {
+        heap.emplace(distance, index);
+    } else if (distance < heap.top().first) {
+        heap.pop();
+        heap.emplace(distance, index);
+    }
+}
+
+// Implicit k-d tree: the middle point of every range is the root of the
+// range and splits it at the axis with the largest extent.
+class Tree {
+public:
+    void build(std::vector<Point> &&points)
+    {
+        mPoints = std::move(points);
+        mAxes.assign(mPoints.size(), 0);
+        build(0, mPoints.size());
+    }
+    void clear()
+    {
+        mPoints.clear();
+        mAxes.clear();
+    }
+    const std::vector<Point> &points() const
+    {
+        return mPoints;
+    }
+    std::size_t size() const
+    {
+        return mPoints.size();
+    }
+    // Appends the accepted points within the squared chord limit to candidates.
+    template <typename Accept>
+    void radius(const Point &query, double limit, const Accept &accept, std::vector<Candidate> &candidates) const
+    {
+        radius(0, mPoints.size(), query, limit, accept, candidates);
+    }
+    // Offers the accepted points within the squared chord limit to the heap of the count nearest.
+    template <typename Accept>
+    void nearest(const Point &query, std::size_t count, double limit, const Accept &accept, std::priority_queue<Candidate> &heap) const
+    {
+        if (count > 0) {
+            nearest(0, mPoints.size(), query, count, limit, accept, heap);
+        }
+    }
+private:
+    void build(std::size_t begin, std::size_t end)
+    {
+        while (end - begin > 1) {
+            double low[3] = { 2, 2, 2 }, high[3] = { -2, -2, -2 };
+            for (std::size_t i = begin; i < end; ++i) {
+                for (int axis = 0; axis < 3; ++axis) {
+                    low[axis] = std::min(low[axis], mPoints[i].mCoordinates[axis]);
+                    high[axis] = std::max(high[axis], mPoints[i].mCoordinates[axis]);
+                }
+            }
+            std::uint8_t axis = 0;
+            for (std::uint8_t a = 1; a < 3; ++a) {
+                if (high[a] - low[a] > high[axis] - low[axis]) {
+                    axis = a;
+                }
+            }
+            std::size_t middle = begin + (end - begin) / 2;
+            std::nth_element(mPoints.begin() + begin, mPoints.begin() + middle, mPoints.begin() + end, [axis](const Point &a, const Point &b) {
+                return a.mCoordinates[axis] < b.mCoordinates[axis];
+            });
+            mAxes[middle] = axis;
+            build(begin, middle);
+            begin = middle + 1;
+        }
+    }
+    template <typename Accept>
+    void radius(std::size_t begin, std::size_t end, const Point &query, double limit, const Accept &accept, std::vector<Candidate> &candidates) const
+    {
+        while (begin < end) {
+            std::size_t middle = begin + (end - begin) / 2;
+            const Point &point = mPoints[middle];
+            double distance = squaredChord(point, query);
+            if (distance <= limit && accept(point.mIndex)) {
+                candidates.emplace_back(distance, point.mIndex);
+            }
+            double difference = query.mCoordinates[mAxes[middle]] - point.mCoordinates[mAxes[middle]];
+            if (difference <= 0) {
+                if (difference * difference <= limit) {
+                    radius(middle + 1, end, query, limit, accept, candidates);
+                }
+                end = middle;
+            } else {
+                if (difference * difference <= limit) {
+                    radius(begin, middle, query, limit, accept, candidates);
+                }
+                begin = middle + 1;
+            }
+        }
+    }
+    template <typename Accept>
+    void nearest(std::size_t begin, std::size_t end, const Point &query, std::size_t count, double limit, const Accept &accept, std::priority_queue<Candidate> &heap) const
+    {
+        while (begin < end) {
+            std::size_t middle = begin + (end - begin) / 2;
+            const Point &point = mPoints[middle];
+            double distance = squaredChord(point, query);
+            if (distance <= limit && accept(point.mIndex)) {
+                offer(distance, point.mIndex, count, heap);
+            }
+            double difference = query.mCoordinates[mAxes[middle]] - point.mCoordinates[mAxes[middle]];
+            std::size_t nearBegin = begin, nearEnd = middle, farBegin = middle + 1, farEnd = end;
+            if (difference > 0) {
+                std::swap(nearBegin, farBegin);
+                std::swap(nearEnd, farEnd);
+            }
+            nearest(nearBegin, nearEnd, query, count, limit, accept, heap);
+            double bound = heap.size() == count ? heap.top().first : limit;
+            if (difference * difference > bound) {
+                return;
+            }
+            begin = farBegin;
+            end = farEnd;
+        }
+    }
+    std::vector<Point> mPoints;
+    std::vector<std::uint8_t> mAxes;
+};
+
+}
+
+}
+
+#endif /* KDTREE_HPP */
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MAPPEDFILE_HPP
+#define MAPPEDFILE_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace netatmoapi {
+
+class MappedFile {
+public:
+    MappedFile() :
+        mData(nullptr),
+        mSize(0)
+        {}
+    explicit MappedFile(const std::string &path) :
+        MappedFile()
+    {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "Can not open " + path);
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), "Can not stat " + path);
+        }
+        mSize = static_cast<std::size_t>(st.st_size);
+        if (mSize > 0) {
+            void *data = ::mmap(nullptr, mSize, PROT_READ, MAP_SHARED, fd, 0);
+            if (data == MAP_FAILED) {
+                int error = errno;
+                ::close(fd);
+                throw std::system_error(error, std::generic_category(), "Can not map " + path);
+            }
+            mData = static_cast<const char *>(data);
+        }
+        ::close(fd);
+    }
+    MappedFile(const MappedFile &) = delete;
+    MappedFile(MappedFile &&o) noexcept :
+        mData(o.mData),
+        mSize(o.mSize)
+    {
+        o.mData = nullptr;
+        o.mSize = 0;
+    }
+    ~MappedFile()
+    {
+        if (mData) {
+            ::munmap(const_cast<char *>(mData), mSize);
+        }
+    }
+    MappedFile &operator =(const MappedFile &) = delete;
+    MappedFile &operator =(MappedFile &&o) noexcept
+    {
+        std::swap(mData, o.mData);
+        std::swap(mSize, o.mSize);
+        return *this;
+    }
+    const char *data() const noexcept
+    {
+        return mData;
+    }
+    std::size_t size() const noexcept
+    {
+        return mSize;
+    }
+private:
+    const char *mData;
+    std::size_t mSize;
+};
+
+}
+
+#endif /* MAPPEDFILE_HPP */
@@ -0,0 +1,705 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "measurelog.h"
+#include "mappedfile.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+#include <unordered_map>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace netatmoapi {
+
+namespace {
+
+const char cMagic[8] = { 'N', 'A', 'L', 'O', 'G', '\0', '\0', '\0' };
+const uint32_t cByteOrder = 0x01020304;
+// Number of records per entry of the sparse time index.
+const size_t cIndexInterval = 128;
+// Appended records are written, when the buffer holds this many bytes.
+const size_t cFlushSize = 1 << 20;
+const char cOpenSuffix[] = ".open";
+const char cSealedSuffix[] = ".seg";
+const char cTmpSuffix[] = ".tmp";
+// The file with the last time stamp of every module, which is written, when a segment is sealed.
+const char cModulesName[] = "modules";
+const char cModulesMagic[8] = { 'N', 'A', 'L', 'O', 'G', 'M', 'O', 'D' };
+
+struct LogHeader {
+    char mMagic[8];
+    uint32_t mVersion;
+    uint32_t mByteOrder;
+    uint32_t mFieldCount;
+    uint32_t mRecordSize;
+    // The following members are 0 in an open segment.
+    uint64_t mRecordCount;
+    uint64_t mIndexOffset;
+    uint64_t mIndexCount;
+    uint64_t mMinTimeStamp;
+    uint64_t mMaxTimeStamp;
+};
+
+struct LogRecord {
+    char mModuleId[24];
+    uint64_t mTimeStamp;
+    double mValues[Measures::fieldCount];
+    uint64_t mCheckSum;
+};
+
+struct LogIndexEntry {
+    uint64_t mMinTimeStamp;
+    uint64_t mMaxTimeStamp;
+};
+
+struct LogModulesHeader {
+    char mMagic[8];
+    uint32_t mByteOrder;
+    uint32_t mEntrySize;
+    uint64_t mCount;
+};
+
+struct LogModuleEntry {
+    char mModuleId[24];
+    uint64_t mLastTimeStamp;
+};
+
+uint64_t checkSum(const LogRecord &record) {
+    const char *data = reinterpret_cast<const char *>(&record);
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t offset = 0; offset < sizeof(LogRecord) - sizeof(uint64_t); offset += sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, data + offset, sizeof(word));
+        hash = (hash ^ word) * 0x100000001b3ULL;
+    }
+    // A zeroed record, e.g. after a crash, is never valid.
+    return hash | 1;
+}
+
+LogHeader makeHeader() {
+    LogHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.mMagic, cMagic, sizeof(cMagic));
+    header.mVersion = MeasureLog::sVersion;
+    header.mByteOrder = cByteOrder;
+    header.mFieldCount = Measures::fieldCount;
+    header.mRecordSize = sizeof(LogRecord);
+    return header;
+}
+
+bool isValidHeader(const LogHeader &header) {
+    return memcmp(header.mMagic, cMagic, sizeof(cMagic)) == 0 && header.mVersion == MeasureLog::sVersion &&
+            header.mByteOrder == cByteOrder && header.mFieldCount == Measures::fieldCount &&
+            header.mRecordSize == sizeof(LogRecord);
+}
+
+void writeAll(int fd, const void *data, size_t size, const string &path) {
+    const char *bytes = static_cast<const char *>(data);
+    while (size > 0) {
+        ssize_t written = ::write(fd, bytes, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw system_error(errno, generic_category(), "Can not write " + path);
+        }
+        bytes += written;
+        size -= static_cast<size_t>(written);
+    }
+}
+
+void syncDirectory(const string &directory) {
+    int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        throw system_error(errno, generic_category(), "Can not open " + directory);
+    }
+    int result = ::fsync(fd);
+    int error = errno;
+    ::close(fd);
+    if (result != 0) {
+        throw system_error(error, generic_category(), "Can not sync " + directory);
+    }
+}
+
+void updateIndex(vector<LogIndexEntry> &index, size_t recordNumber, uint64_t timeStamp) {
+    if (recordNumber % cIndexInterval == 0) {
+        index.push_back({ timeStamp, timeStamp });
+    } else {
+        LogIndexEntry &entry = index.back();
+        entry.mMinTimeStamp = min(entry.mMinTimeStamp, timeStamp);
+        entry.mMaxTimeStamp = max(entry.mMaxTimeStamp, timeStamp);
+    }
+}
+
+Measures toMeasures(const LogRecord &record) {
+    Measures measures;
+    measures.mTimeStamp = record.mTimeStamp;
+    for (size_t i = 0; i < Measures::fieldCount; ++i) {
+        measures.setValue(static_cast<Measures::Field>(i), record.mValues[i]);
+    }
+    return measures;
+}
+
+size_t scanRecords(const LogRecord *records, size_t recordCount, const LogIndexEntry *index, size_t indexCount,
+                   const char *moduleId, uint64_t begin, uint64_t end, const function<void (const Measures &)> &callback) {
+    size_t count = 0;
+    for (size_t i = 0; i < indexCount; ++i) {
+        if (index[i].mMaxTimeStamp < begin || index[i].mMinTimeStamp > end) {
+            continue;
+        }
+        size_t last = min(recordCount, (i + 1) * cIndexInterval);
+        for (size_t j = i * cIndexInterval; j < last; ++j) {
+            const LogRecord &record = records[j];
+            if (record.mTimeStamp >= begin && record.mTimeStamp <= end &&
+                    memcmp(record.mModuleId, moduleId, sizeof(record.mModuleId)) == 0) {
+                callback(toMeasures(record));
+                ++count;
+            }
+        }
+    }
+    return count;
+}
+
+}
+
+struct LogSegment {
+    uint64_t mSequence;
+    MappedFile mFile;
+    const LogHeader *mHeader;
+    const LogRecord *mRecords;
+    const LogIndexEntry *mIndex;
+};
+
+struct MeasureLogPrivate {
+    MeasureLogPrivate(const string &directory, size_t segmentRecords) :
+        mDirectory(directory),
+        mSegmentRecords(max<size_t>(segmentRecords, 1)),
+        mRetention(0),
+        mOpenSequence(0),
+        mOpenFd(-1),
+        mOpenRecords(0),
+        mNewestTimeStamp(0)
+    {}
+    ~MeasureLogPrivate() {
+        if (mOpenFd >= 0) {
+            try {
+                flush();
+            } catch (...) {
+                // The open segment is recovered on the next start.
+            }
+            ::close(mOpenFd);
+        }
+    }
+    string path(uint64_t sequence, const char *suffix) const;
+    void open();
+    LogSegment mapSegment(uint64_t sequence) const;
+    void openSegment(uint64_t sequence);
+    void closeSegment();
+    void updateLastTimeStamp(const char *moduleId, uint64_t timeStamp);
+    bool readModules();
+    void writeModules();
+    void append(const char *moduleId, size_t length, const Measures &measures);
+    void flush();
+    void seal();
+    size_t removeBefore(uint64_t timeStamp);
+
+    string mDirectory;
+    size_t mSegmentRecords;
+    uint64_t mRetention;
+    // Sealed segments, ordered by sequence number.
+    vector<LogSegment> mSegments;
+    uint64_t mOpenSequence;
+    int mOpenFd;
+    // Records in the open segment file, without the buffered records.
+    size_t mOpenRecords;
+    vector<LogRecord> mBuffer;
+    vector<LogIndexEntry> mOpenIndex;
+    uint64_t mNewestTimeStamp;
+    unordered_map<string, uint64_t> mLastTimeStamps;
+};
+
+string MeasureLogPrivate::path(uint64_t sequence, const char *suffix) const {
+    char name[32];
+    snprintf(name, sizeof(name), "/%010llu", static_cast<unsigned long long>(sequence));
+    return mDirectory + name + suffix;
+}
+
+void MeasureLogPrivate::open() {
+    if (::mkdir(mDirectory.c_str(), 0755) != 0 && errno != EEXIST) {
+        throw system_error(errno, generic_category(), "Can not create " + mDirectory);
+    }
+    DIR *dir = ::opendir(mDirectory.c_str());
+    if (!dir) {
+        throw system_error(errno, generic_category(), "Can not open " + mDirectory);
+    }
+    vector<uint64_t> sealed;
+    vector<uint64_t> open;
+    while (struct dirent *entry = ::readdir(dir)) {
+        if (strcmp(entry->d_name, string(cModulesName).append(cTmpSuffix).c_str()) == 0) {
+            // An incomplete write of the modules file, the old one still exists.
+            ::unlink((mDirectory + "/" + entry->d_name).c_str());
+            continue;
+        }
+        char *suffix = nullptr;
+        uint64_t sequence = strtoull(entry->d_name, &suffix, 10);
+        if (suffix == entry->d_name) {
+            continue;
+        }
+        if (strcmp(suffix, cSealedSuffix) == 0) {
+            sealed.push_back(sequence);
+        } else if (strcmp(suffix, cOpenSuffix) == 0) {
+            open.push_back(sequence);
+        } else if (strcmp(suffix, string(cSealedSuffix).append(cTmpSuffix).c_str()) == 0) {
+            // An incomplete seal, the open segment still exists.
+            ::unlink((mDirectory + "/" + entry->d_name).c_str());
+        }
+    }
+    ::closedir(dir);
+    sort(sealed.begin(), sealed.end());
+    sort(open.begin(), open.end());
+
+    for (uint64_t sequence: sealed) {
+        mSegments.push_back(mapSegment(sequence));
+        mNewestTimeStamp = max(mNewestTimeStamp, mSegments.back().mHeader->mMaxTimeStamp);
+    }
+    // The modules file holds the last time stamps up to the newest sealed
+    // segment, or up to the segment before, if the process died after the
+    // rename of the segment. Without it all sealed segments are read.
+    bool hasModules = readModules();
+    for (size_t i = hasModules && mSegments.size() > 1 ? mSegments.size() - 1 : 0; i < mSegments.size(); ++i) {
+        const LogSegment &segment = mSegments[i];
+        for (size_t j = 0; j < segment.mHeader->mRecordCount; ++j) {
+            updateLastTimeStamp(segment.mRecords[j].mModuleId, segment.mRecords[j].mTimeStamp);
+        }
+    }
+    for (auto it = open.begin(); it != open.end();) {
+        if (binary_search(sealed.begin(), sealed.end(), *it)) {
+            // The seal was complete, only the open segment was not removed.
+            ::unlink(path(*it, cOpenSuffix).c_str());
+            it = open.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    if (open.empty()) {
+        openSegment(sealed.empty() ? 1 : sealed.back() + 1);
+        return;
+    }
+    // Only the newest open segment stays open.
+    for (size_t i = 0; i + 1 < open.size(); ++i) {
+        openSegment(open[i]);
+        closeSegment();
+    }
+    sort(mSegments.begin(), mSegments.end(), [](const LogSegment &a, const LogSegment &b) {
+        return a.mSequence < b.mSequence;
+    });
+    openSegment(open.back());
+}
+
+LogSegment MeasureLogPrivate::mapSegment(uint64_t sequence) const {
+    string segmentPath = path(sequence, cSealedSuffix);
+    LogSegment segment;
+    segment.mSequence = sequence;
+    segment.mFile = MappedFile(segmentPath);
+    size_t size = segment.mFile.size();
+    if (size < sizeof(LogHeader)) {
+        throw runtime_error("Invalid measure log segment: " + segmentPath);
+    }
+    segment.mHeader = reinterpret_cast<const LogHeader *>(segment.mFile.data());
+    const LogHeader &header = *segment.mHeader;
+    if (!isValidHeader(header)) {
+        throw runtime_error("Invalid measure log segment: " + segmentPath);
+    }
+    uint64_t recordCount = header.mRecordCount;
+    if (recordCount > (size - sizeof(LogHeader)) / sizeof(LogRecord) ||
+            header.mIndexOffset != sizeof(LogHeader) + recordCount * sizeof(LogRecord) ||
+            header.mIndexCount != (recordCount + cIndexInterval - 1) / cIndexInterval ||
+            header.mIndexCount > (size - header.mIndexOffset) / sizeof(LogIndexEntry)) {
+        throw runtime_error("Invalid measure log segment: " + segmentPath);
+    }
+    segment.mRecords = reinterpret_cast<const LogRecord *>(segment.mFile.data() + sizeof(LogHeader));
+    segment.mIndex = reinterpret_cast<const LogIndexEntry *>(segment.mFile.data() + header.mIndexOffset);
+    return segment;
+}
+
+void MeasureLogPrivate::openSegment(uint64_t sequence) {
+    string openPath = path(sequence, cOpenSuffix);
+    size_t recordCount = 0;
+    mOpenIndex.clear();
+    {
+        int fd = ::open(openPath.c_str(), O_RDONLY | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            throw system_error(errno, generic_category(), "Can not open " + openPath);
+        }
+        ::close(fd);
+        MappedFile file(openPath);
+        if (file.size() >= sizeof(LogHeader) && isValidHeader(*reinterpret_cast<const LogHeader *>(file.data()))) {
+            // Keep the records up to the first incomplete one.
+            const LogRecord *records = reinterpret_cast<const LogRecord *>(file.data() + sizeof(LogHeader));
+            size_t maxCount = (file.size() - sizeof(LogHeader)) / sizeof(LogRecord);
+            while (recordCount < maxCount && records[recordCount].mCheckSum == checkSum(records[recordCount])) {
+                const LogRecord &record = records[recordCount];
+                updateIndex(mOpenIndex, recordCount, record.mTimeStamp);
+                mNewestTimeStamp = max(mNewestTimeStamp, record.mTimeStamp);
+                updateLastTimeStamp(record.mModuleId, record.mTimeStamp);
+                ++recordCount;
+            }
+        }
+    }
+    int fd = ::open(openPath.c_str(), O_WRONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw system_error(errno, generic_category(), "Can not open " + openPath);
+    }
+    try {
+        if (recordCount == 0) {
+            LogHeader header = makeHeader();
+            if (::ftruncate(fd, 0) != 0) {
+                throw system_error(errno, generic_category(), "Can not truncate " + openPath);
+            }
+            writeAll(fd, &header, sizeof(header), openPath);
+        } else {
+            off_t size = static_cast<off_t>(sizeof(LogHeader) + recordCount * sizeof(LogRecord));
+            if (::ftruncate(fd, size) != 0 || ::lseek(fd, size, SEEK_SET) != size) {
+                throw system_error(errno, generic_category(), "Can not truncate " + openPath);
+            }
+        }
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    mOpenFd = fd;
+    mOpenSequence = sequence;
+    mOpenRecords = recordCount;
+    mBuffer.reserve(cFlushSize / sizeof(LogRecord));
+}
+
+void MeasureLogPrivate::updateLastTimeStamp(const char *moduleId, uint64_t timeStamp) {
+    uint64_t &lastTimeStamp = mLastTimeStamps[string(moduleId, strnlen(moduleId, sizeof(LogRecord::mModuleId)))];
+    lastTimeStamp = max(lastTimeStamp, timeStamp);
+}
+
+bool MeasureLogPrivate::readModules() {
+    string modulesPath = mDirectory + "/" + cModulesName;
+    if (::access(modulesPath.c_str(), F_OK) != 0) {
+        return false;
+    }
+    MappedFile file(modulesPath);
+    if (file.size() < sizeof(LogModulesHeader)) {
+        return false;
+    }
+    const LogModulesHeader &header = *reinterpret_cast<const LogModulesHeader *>(file.data());
+    if (memcmp(header.mMagic, cModulesMagic, sizeof(cModulesMagic)) != 0 || header.mByteOrder != cByteOrder ||
+            header.mEntrySize != sizeof(LogModuleEntry) ||
+            header.mCount != (file.size() - sizeof(LogModulesHeader)) / sizeof(LogModuleEntry)) {
+        return false;
+    }
+    const LogModuleEntry *entries = reinterpret_cast<const LogModuleEntry *>(file.data() + sizeof(LogModulesHeader));
+    for (size_t i = 0; i < header.mCount; ++i) {
+        updateLastTimeStamp(entries[i].mModuleId, entries[i].mLastTimeStamp);
+    }
+    return true;
+}
+
+void MeasureLogPrivate::writeModules() {
+    LogModulesHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.mMagic, cModulesMagic, sizeof(cModulesMagic));
+    header.mByteOrder = cByteOrder;
+    header.mEntrySize = sizeof(LogModuleEntry);
+    header.mCount = mLastTimeStamps.size();
+    vector<LogModuleEntry> entries(mLastTimeStamps.size());
+    size_t i = 0;
+    for (const auto &lastTimeStamp: mLastTimeStamps) {
+        LogModuleEntry &entry = entries[i++];
+        memset(&entry, 0, sizeof(entry));
+        memcpy(entry.mModuleId, lastTimeStamp.first.data(), lastTimeStamp.first.size());
+        entry.mLastTimeStamp = lastTimeStamp.second;
+    }
+
+    string modulesPath = mDirectory + "/" + cModulesName;
+    string tmpPath = modulesPath + cTmpSuffix;
+    int fd = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw system_error(errno, generic_category(), "Can not open " + tmpPath);
+    }
+    try {
+        writeAll(fd, &header, sizeof(header), tmpPath);
+        writeAll(fd, entries.data(), entries.size() * sizeof(LogModuleEntry), tmpPath);
+        if (::fsync(fd) != 0) {
+            throw system_error(errno, generic_category(), "Can not sync " + tmpPath);
+        }
+    } catch (...) {
+        ::close(fd);
+        ::unlink(tmpPath.c_str());
+        throw;
+    }
+    ::close(fd);
+    if (::rename(tmpPath.c_str(), modulesPath.c_str()) != 0) {
+        int error = errno;
+        ::unlink(tmpPath.c_str());
+        throw system_error(error, generic_category(), "Can not rename " + tmpPath);
+    }
+}
+
+void MeasureLogPrivate::append(const char *moduleId, size_t length, const Measures &measures) {
+    mBuffer.push_back(LogRecord());
+    LogRecord &record = mBuffer.back();
+    memcpy(record.mModuleId, moduleId, length);
+    record.mTimeStamp = measures.mTimeStamp;
+    for (size_t i = 0; i < Measures::fieldCount; ++i) {
+        record.mValues[i] = measures.value(static_cast<Measures::Field>(i));
+    }
+    record.mCheckSum = checkSum(record);
+    updateIndex(mOpenIndex, mOpenRecords + mBuffer.size() - 1, record.mTimeStamp);
+    mNewestTimeStamp = max(mNewestTimeStamp, record.mTimeStamp);
+
+    if (mOpenRecords + mBuffer.size() >= mSegmentRecords) {
+        seal();
+    } else if (mBuffer.size() * sizeof(LogRecord) >= cFlushSize) {
+        flush();
+    }
+}
+
+void MeasureLogPrivate::flush() {
+    if (mBuffer.empty()) {
+        return;
+    }
+    writeAll(mOpenFd, mBuffer.data(), mBuffer.size() * sizeof(LogRecord), path(mOpenSequence, cOpenSuffix));
+    mOpenRecords += mBuffer.size();
+    mBuffer.clear();
+}
+
+void MeasureLogPrivate::seal() {
+    flush();
+    if (mOpenRecords == 0) {
+        return;
+    }
+    closeSegment();
+    openSegment(mOpenSequence + 1);
+
+    if (mRetention > 0 && mNewestTimeStamp > mRetention) {
+        removeBefore(mNewestTimeStamp - mRetention);
+    }
+}
+
+void MeasureLogPrivate::closeSegment() {
+    flush();
+    string openPath = path(mOpenSequence, cOpenSuffix);
+    if (mOpenRecords == 0) {
+        ::close(mOpenFd);
+        mOpenFd = -1;
+        ::unlink(openPath.c_str());
+        return;
+    }
+    string sealedPath = path(mOpenSequence, cSealedSuffix);
+    string tmpPath = sealedPath + cTmpSuffix;
+
+    LogHeader header = makeHeader();
+    header.mRecordCount = mOpenRecords;
+    header.mIndexOffset = sizeof(LogHeader) + mOpenRecords * sizeof(LogRecord);
+    header.mIndexCount = mOpenIndex.size();
+    header.mMinTimeStamp = numeric_limits<uint64_t>::max();
+    for (const LogIndexEntry &entry: mOpenIndex) {
+        header.mMinTimeStamp = min(header.mMinTimeStamp, entry.mMinTimeStamp);
+        header.mMaxTimeStamp = max(header.mMaxTimeStamp, entry.mMaxTimeStamp);
+    }
+
+    {
+        MappedFile openFile(openPath);
+        int fd = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            throw system_error(errno, generic_category(), "Can not open " + tmpPath);
+        }
+        try {
+            writeAll(fd, &header, sizeof(header), tmpPath);
+            writeAll(fd, openFile.data() + sizeof(LogHeader), mOpenRecords * sizeof(LogRecord), tmpPath);
+            writeAll(fd, mOpenIndex.data(), mOpenIndex.size() * sizeof(LogIndexEntry), tmpPath);
+            if (::fsync(fd) != 0) {
+                throw system_error(errno, generic_category(), "Can not sync " + tmpPath);
+            }
+        } catch (...) {
+            ::close(fd);
+            ::unlink(tmpPath.c_str());
+            throw;
+        }
+        ::close(fd);
+    }
+    if (::rename(tmpPath.c_str(), sealedPath.c_str()) != 0) {
+        int error = errno;
+        ::unlink(tmpPath.c_str());
+        throw system_error(error, generic_category(), "Can not rename " + tmpPath);
+    }
+    writeModules();
+    syncDirectory(mDirectory);
+
+    ::close(mOpenFd);
+    mOpenFd = -1;
+    ::unlink(openPath.c_str());
+    mSegments.push_back(mapSegment(mOpenSequence));
+}
+
+size_t MeasureLogPrivate::removeBefore(uint64_t timeStamp) {
+    size_t count = 0;
+    for (auto it = mSegments.begin(); it != mSegments.end();) {
+        if (it->mHeader->mMaxTimeStamp < timeStamp) {
+            string segmentPath = path(it->mSequence, cSealedSuffix);
+            if (::unlink(segmentPath.c_str()) != 0 && errno != ENOENT) {
+                throw system_error(errno, generic_category(), "Can not remove " + segmentPath);
+            }
+            it = mSegments.erase(it);
+            ++count;
+        } else {
+            ++it;
+        }
+    }
+    return count;
+}
+
+const uint32_t MeasureLog::sVersion = 1;
+const size_t MeasureLog::sDefaultSegmentRecords = 262144;
+const size_t MeasureLog::sMaxModuleIdLength = sizeof(LogRecord::mModuleId) - 1;
+
+MeasureLog::MeasureLog(const string &directory, size_t segmentRecords) :
+    d(new MeasureLogPrivate(directory, segmentRecords)) {
+    d->open();
+}
+
+MeasureLog::MeasureLog(MeasureLog &&o) noexcept :
+    d(move(o.d)) {
+}
+
+MeasureLog::~MeasureLog() noexcept = default;
+
+bool MeasureLog::append(const string &moduleId, const Measures &measures) {
+    if (moduleId.size() > sMaxModuleIdLength) {
+        throw length_error("Module id too long for the measure log: " + moduleId);
+    }
+    auto it = d->mLastTimeStamps.find(moduleId);
+    if (it == d->mLastTimeStamps.end()) {
+        it = d->mLastTimeStamps.emplace(moduleId, 0).first;
+    }
+    if (measures.mTimeStamp <= it->second) {
+        return false;
+    }
+    // Updated first, so a seal by this append writes the time stamp to the modules file.
+    it->second = measures.mTimeStamp;
+    d->append(moduleId.data(), moduleId.size(), measures);
+    return true;
+}
+
+size_t MeasureLog::append(const list<Station> &stations) {
+    size_t count = 0;
+    for (const Station &station: stations) {
+        for (const Module &module: station.modulesRef()) {
+            if (append(module.id(), module.measures())) {
+                ++count;
+            }
+        }
+    }
+    d->flush();
+    return count;
+}
+
+size_t MeasureLog::query(const string &moduleId, uint64_t begin, uint64_t end, const function<void (const Measures &)> &callback) {
+    if (moduleId.size() > sMaxModuleIdLength || begin > end) {
+        return 0;
+    }
+    char id[sizeof(LogRecord::mModuleId)] = {};
+    memcpy(id, moduleId.data(), moduleId.size());
+
+    size_t count = 0;
+    for (const LogSegment &segment: d->mSegments) {
+        const LogHeader &header = *segment.mHeader;
+        if (header.mMaxTimeStamp < begin || header.mMinTimeStamp > end) {
+            continue;
+        }
+        count += scanRecords(segment.mRecords, header.mRecordCount, segment.mIndex, header.mIndexCount, id, begin, end, callback);
+    }
+    d->flush();
+    if (d->mOpenRecords > 0) {
+        MappedFile openFile(d->path(d->mOpenSequence, cOpenSuffix));
+        const LogRecord *records = reinterpret_cast<const LogRecord *>(openFile.data() + sizeof(LogHeader));
+        count += scanRecords(records, d->mOpenRecords, d->mOpenIndex.data(), d->mOpenIndex.size(), id, begin, end, callback);
+    }
+    return count;
+}
+
+vector<Measures> MeasureLog::query(const string &moduleId, uint64_t begin, uint64_t end) {
+    vector<Measures> result;
+    query(moduleId, begin, end, [&result](const Measures &measures) {
+        result.push_back(measures);
+    });
+    return result;
+}
+
+void MeasureLog::flush() {
+    d->flush();
+}
+
+void MeasureLog::sync() {
+    d->flush();
+    if (::fsync(d->mOpenFd) != 0) {
+        throw system_error(errno, generic_category(), "Can not sync " + d->path(d->mOpenSequence, cOpenSuffix));
+    }
+}
+
+void MeasureLog::seal() {
+    d->seal();
+}
+
+void MeasureLog::setRetention(uint64_t seconds) {
+    d->mRetention = seconds;
+}
+
+uint64_t MeasureLog::retention() const {
+    return d->mRetention;
+}
+
+size_t MeasureLog::removeBefore(uint64_t timeStamp) {
+    return d->removeBefore(timeStamp);
+}
+
+size_t MeasureLog::segmentCount() const {
+    return d->mSegments.size() + 1;
+}
+
+uint64_t MeasureLog::size() const {
+    uint64_t size = d->mOpenRecords + d->mBuffer.size();
+    for (const LogSegment &segment: d->mSegments) {
+        size += segment.mHeader->mRecordCount;
+    }
+    return size;
+}
+
+MeasureLog &MeasureLog::operator =(MeasureLog &&o) noexcept {
+    d = move(o.d);
+    return *this;
+}
+
+}
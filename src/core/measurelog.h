@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MEASURELOG_H
+#define MEASURELOG_H
+
+#include "model/station.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace netatmoapi {
+
+struct MeasureLogPrivate;
+
+/**
+ * @brief This class stores the measures of all modules in an append-only log on disk.
+ *
+ * The log is a directory of segment files. New measures are appended as
+ * fixed-size records, keyed by the module id and the time stamp, to the
+ * open segment. A full segment is sealed: it is copied together with a
+ * sparse time index to a temporary file, which is synced and renamed.
+ * Sealed segments are never changed again and are read by mapping them
+ * into memory. A seal also writes the last time stamp of every module to
+ * a modules file, which restores the duplicate detection of append() on
+ * the next start, also after the retention removed the segments.
+ *
+ * Opening the log recovers from a crash: an incomplete seal is discarded
+ * and the open segment is cut after the last complete record.
+ *
+ * Appends are buffered. flush() writes them to the open segment, sync()
+ * also writes them to the disk. The files are written in the byte order
+ * of the host and are not portable between hosts with different byte order.
+ */
+class MeasureLog {
+public:
+    /**
+     * Constructor.
+     * Opens or creates the log in the directory.
+     * @param directory The directory of the log. Is created, if it does not exist.
+     * @param segmentRecords The number of records, after which a segment is sealed.
+     * @throw std::system_error If a file can not be read or written.
+     * @throw std::runtime_error If a sealed segment is invalid.
+     */
+    explicit MeasureLog(const std::string &directory, std::size_t segmentRecords = sDefaultSegmentRecords);
+
+    MeasureLog(const MeasureLog &) = delete;
+
+    /**
+     * Move constructor.
+     * @param o The element to move.
+     */
+    MeasureLog(MeasureLog &&o) noexcept;
+
+    /**
+     * Destructor.
+     * Flushes the appended measures, but does not seal the open segment.
+     */
+    virtual ~MeasureLog() noexcept;
+
+    /**
+     * Appends the measures of a module.
+     *
+     * Polling returns the same measures until the module sends new ones,
+     * so measures, which are not newer than the last appended measures
+     * of the module, are ignored.
+     *
+     * @param moduleId The id of the module. At most sMaxModuleIdLength characters.
+     * @param measures The measures of the module.
+     * @return True, if the measures were appended.
+     * @throw std::length_error If the module id is too long.
+     * @throw std::system_error If the log can not be written.
+     */
+    bool append(const std::string &moduleId, const Measures &measures);
+
+    /**
+     * Appends the measures of all modules of a fleet and flushes them.
+     * @param stations The fleet, e.g. the result of utils::parseDevices().
+     * @return The number of appended measures.
+     * @throw std::length_error If a module id is too long.
+     * @throw std::system_error If the log can not be written.
+     */
+    std::size_t append(const std::list<Station> &stations);
+
+    /**
+     * Calls callback for all measures of a module with begin <= time stamp <= end, in time order.
+     * Flushes the appended measures before.
+     * @param moduleId The id of the module.
+     * @param begin The begin of the range.
+     * @param end The end of the range.
+     * @param callback Called with the measures.
+     * @return The number of measures in the range.
+     * @throw std::system_error If the log can not be read or written.
+     */
+    std::size_t query(const std::string &moduleId, std::uint64_t begin, std::uint64_t end, const std::function<void (const Measures &)> &callback);
+
+    /**
+     * Returns all measures of a module with begin <= time stamp <= end, in time order.
+     * Flushes the appended measures before.
+     * @param moduleId The id of the module.
+     * @param begin The begin of the range.
+     * @param end The end of the range.
+     * @return The measures.
+     * @throw std::system_error If the log can not be read or written.
+     */
+    std::vector<Measures> query(const std::string &moduleId, std::uint64_t begin, std::uint64_t end);
+
+    /**
+     * Writes the appended measures to the open segment.
+     * @throw std::system_error If the log can not be written.
+     */
+    void flush();
+
+    /**
+     * Writes the appended measures to the open segment and syncs it to the disk.
+     * @throw std::system_error If the log can not be written.
+     */
+    void sync();
+
+    /**
+     * Seals the open segment, if it is not empty, and applies the retention.
+     * @throw std::system_error If the log can not be written.
+     */
+    void seal();
+
+    /**
+     * Sets the retention.
+     * Sealed segments, which only contain measures older than the newest
+     * measure minus the retention, are removed on every seal.
+     * @param seconds The retention in seconds. 0 keeps all segments.
+     */
+    void setRetention(std::uint64_t seconds);
+
+    /**
+     * Returns the retention.
+     * @return The retention in seconds, 0 if all segments are kept.
+     */
+    std::uint64_t retention() const;
+
+    /**
+     * Removes all sealed segments, which only contain measures older than timeStamp.
+     * @param timeStamp The oldest time stamp to keep.
+     * @return The number of removed segments.
+     * @throw std::system_error If a segment can not be removed.
+     */
+    std::size_t removeBefore(std::uint64_t timeStamp);
+
+    /**
+     * Returns the number of segments, including the open segment.
+     * @return The number of segments.
+     */
+    std::size_t segmentCount() const;
+
+    /**
+     * Returns the number of records in all segments.
+     * @return The number of records.
+     */
+    std::uint64_t size() const;
+
+    MeasureLog &operator =(const MeasureLog &) = delete;
+
+    /**
+     * Move assignment operator.
+     * @param o The element to move.
+     * @return This element as reference.
+     */
+    MeasureLog &operator =(MeasureLog &&o) noexcept;
+
+    /**
+     * The version of the segment format.
+     */
+    static const std::uint32_t sVersion;
+
+    /**
+     * The default number of records per segment.
+     *
+     * Value: 262144
+     */
+    static const std::size_t sDefaultSegmentRecords;
+
+    /**
+     * The maximum length of a module id.
+     *
+     * Value: 23
+     */
+    static const std::size_t sMaxModuleIdLength;
+
+private:
+    std::unique_ptr<MeasureLogPrivate> d;
+};
+
+}
+
+#endif /* MEASURELOG_H */
@@ -17,38 +17,52 @@
  * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "naapiclient.h"
-#include "utils.h"
-#include "scopeexit.hpp"
+#include "curltransport.h"
+#include "ratelimiter.hpp"
 
 #include <ctime>
-#include <curl/curl.h>
 #include <iostream>
 
 using namespace std;
 
 namespace netatmoapi {
 
-size_t writeCallback(char *buffer, size_t size, size_t nmemb, void *userp) {
-    if (userp) {
-        ostream *os = static_cast<ostream *>(userp);
-        size_t len = size * nmemb;
-        if (os->write(buffer, streamsize (len))) {
-            return len;
+namespace {
+
+// Parses a response body and throws the error of the api, if it contains one.
+json parseResponse(const string &rawResponse) {
+    json jsonResponse = json::parse(rawResponse);
+
+    if (jsonResponse.find("error") != jsonResponse.end()) {
+        json jsonError = jsonResponse["error"];
+        if (jsonError.is_string()) {
+            throw ResponseException("OAuth error.", jsonError);
+        }
+        if (jsonError.is_object()) {
+            throw ResponseException("API error.", jsonError["message"]);
         }
     }
 
-    return 0;
+    return jsonResponse;
+}
+
 }
 
 struct NAApiClientPrivate {
     explicit NAApiClientPrivate(int64_t expiresIn) :
-        mExpiresIn(expiresIn) {
+        mExpiresIn(expiresIn),
+        mRateLimiter(newRateLimiter()),
+        mTransport(make_shared<CurlTransport>()),
+        mUrlBase(NAApiClient::sUrlBase) {
     }
 
     explicit NAApiClientPrivate(const string &clientId, const string &clientSecret, int64_t expiresIn) :
         mClientId(clientId),
         mClientSecret(clientSecret),
-        mExpiresIn(expiresIn) {
+        mExpiresIn(expiresIn),
+        mRateLimiter(newRateLimiter()),
+        mTransport(make_shared<CurlTransport>()),
+        mUrlBase(NAApiClient::sUrlBase) {
     }
 
     explicit NAApiClientPrivate(const string &username, const string &password, const string &clientId, const string &clientSecret, const string &accessToken, const string &refreshToken, int64_t expiresIn) :
@@ -58,7 +72,10 @@ struct NAApiClientPrivate {
         mClientSecret(clientSecret),
         mAccessToken(accessToken),
         mRefreshToken(refreshToken),
-        mExpiresIn(expiresIn) {
+        mExpiresIn(expiresIn),
+        mRateLimiter(newRateLimiter()),
+        mTransport(make_shared<CurlTransport>()),
+        mUrlBase(NAApiClient::sUrlBase) {
     }
 
     NAApiClientPrivate(const NAApiClientPrivate &o) :
@@ -68,7 +85,14 @@ struct NAApiClientPrivate {
         mClientSecret(o.mClientSecret),
         mAccessToken(o.mAccessToken),
         mRefreshToken(o.mRefreshToken),
-        mExpiresIn(o.mExpiresIn) {
+        mExpiresIn(o.mExpiresIn),
+        mRateLimiter(o.mRateLimiter),
+        mTransport(o.mTransport),
+        mUrlBase(o.mUrlBase) {
+    }
+
+    static shared_ptr<RateLimiter> newRateLimiter() {
+        return make_shared<RateLimiter>(NAApiClient::sDefaultRateLimitRequests, chrono::seconds(NAApiClient::sDefaultRateLimitPeriod));
     }
 
     string mUsername;
@@ -78,10 +102,18 @@ struct NAApiClientPrivate {
     string mAccessToken;
     string mRefreshToken;
     int64_t mExpiresIn;
+    // Shared between copies, they use the same account.
+    shared_ptr<RateLimiter> mRateLimiter;
+    // Shared between copies, like the rate limiter.
+    shared_ptr<Transport> mTransport;
+    string mUrlBase;
 };
 
 const string NAApiClient::sUrlBase = "https://api.netatmo.net";
-const string NAApiClient::sUrlRequestToken = NAApiClient::sUrlBase + "/oauth2/token";
+const string NAApiClient::sPathRequestToken = "/oauth2/token";
+const string NAApiClient::sUrlRequestToken = NAApiClient::sUrlBase + NAApiClient::sPathRequestToken;
+const size_t NAApiClient::sDefaultRateLimitRequests = 50;
+const int64_t NAApiClient::sDefaultRateLimitPeriod = 10;
 
 NAApiClient::NAApiClient() :
     d(new NAApiClientPrivate(0)) {
@@ -161,6 +193,34 @@ void NAApiClient::setExpiresIn(int64_t expiresIn) {
     d->mExpiresIn = expiresIn;
 }
 
+void NAApiClient::setRateLimit(size_t maxRequests, int64_t period) {
+    d->mRateLimiter->setLimit(maxRequests, chrono::seconds(period));
+}
+
+size_t NAApiClient::rateLimitRequests() const {
+    return d->mRateLimiter->maxRequests();
+}
+
+int64_t NAApiClient::rateLimitPeriod() const {
+    return chrono::duration_cast<chrono::seconds>(d->mRateLimiter->period()).count();
+}
+
+shared_ptr<Transport> NAApiClient::transport() const {
+    return d->mTransport;
+}
+
+void NAApiClient::setTransport(shared_ptr<Transport> transport) {
+    d->mTransport = transport ? move(transport) : make_shared<CurlTransport>();
+}
+
+string NAApiClient::urlBase() const {
+    return d->mUrlBase;
+}
+
+void NAApiClient::setUrlBase(const string &urlBase) {
+    d->mUrlBase = urlBase.empty() ? NAApiClient::sUrlBase : urlBase;
+}
+
 void NAApiClient::login() {
     if (username().empty()) {
         throw LoginException("Username not set.", LoginException::username);
@@ -185,7 +245,7 @@ void NAApiClient::login() {
 
     json response;
     try {
-        response = post(NAApiClient::sUrlRequestToken, params);
+        response = post(urlBase() + NAApiClient::sPathRequestToken, params);
     } catch (const exception &ex) {
 #if !defined(NDEBUG)
         cerr << "Error received in file: " << __FILE__ << ", function: " << __FUNCTION__ << ", in line: " << __LINE__ << "\n";
@@ -198,7 +258,7 @@ void NAApiClient::login() {
         setAccessToken(response["access_token"]);
     }
     if (response.find("expires_in") != response.end()) {
-        setExpiresIn(response["expires_in"]);
+        setExpiresIn(time(nullptr) + response["expires_in"].get<int64_t>());
     }
     if (response.find("refresh_token") != response.end()) {
         setRefreshToken(response["refresh_token"]);
@@ -226,7 +286,7 @@ void NAApiClient::updateSession() {
     json response;
 
     try {
-        response = post(NAApiClient::sUrlRequestToken, params);
+        response = post(urlBase() + NAApiClient::sPathRequestToken, params);
     } catch (const exception &ex) {
 #if !defined(NDEBUG)
         cerr << "Error received in file: " << __FILE__ << ", function: " << __FUNCTION__ << ", in line: " << __LINE__ << "\n";
@@ -239,7 +299,7 @@ void NAApiClient::updateSession() {
         setAccessToken(response["access_token"]);
     }
     if(response.find("expires_in") != response.end()) {
-        setExpiresIn(response["expires_in"]);
+        setExpiresIn(time(nullptr) + response["expires_in"].get<int64_t>());
     }
     if(response.find("refresh_token") != response.end()) {
         setRefreshToken(response["refresh_token"]);
@@ -256,83 +316,28 @@ NAApiClient &NAApiClient::operator =(NAApiClient &&o) noexcept {
     return *this;
 }
 
-json NAApiClient::get(const string &url, const std::map<string, string> &params) {
-    CURL *curl;
-    CURLcode res;
-
-    string getUrl = url + '?' + utils::buildUrlQuery(params, '&');
-    ostringstream rawResponse;
-
-    curl_global_init(CURL_GLOBAL_ALL);
-    curl = curl_easy_init();
-    auto cleanup = makeScopeExit([=]() mutable { if (curl) {curl_easy_cleanup(curl);} curl_global_cleanup(); });
-    if (curl) {
-        curl_easy_setopt(curl, CURLOPT_URL, getUrl.c_str());
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, &writeCallback);
-        curl_easy_setopt(curl, CURLOPT_FILE, &rawResponse);
-        res = curl_easy_perform(curl);
-        if (res != CURLE_OK) {
-            throw CurlException("Curl error", int {res});
+void NAApiClient::checkSession() {
+    try {
+        if (time(nullptr) >= expiresIn()) {
+            updateSession();
         }
-    }
-
+    } catch (const LoginException &ex) {
 #if !defined(NDEBUG)
-    cout << rawResponse.str() << "\n";
+        cerr << "Error received in file: " << __FILE__ << ", function: " << __FUNCTION__ << ", in line: " << __LINE__ << "\n";
+        cerr << "Error: " << ex.what() << "\n";
 #endif
-
-    json jsonResponse = json::parse(rawResponse.str());
-
-    if (jsonResponse.find("error") != jsonResponse.end()) {
-        json jsonError = jsonResponse["error"];
-        if (jsonError.is_string()) {
-            throw ResponseException("OAuth error.", jsonError);
-        }
-        if (jsonError.is_object()) {
-            throw ResponseException("API error.", jsonError["message"]);
-        }
+        throw;
     }
+}
 
-    return jsonResponse;
+json NAApiClient::get(const string &url, const std::map<string, string> &params) {
+    d->mRateLimiter->acquire();
+    return parseResponse(d->mTransport->get(url, params));
 }
 
 json NAApiClient::post(const string &url, const std::map<string, string> &params) {
-    CURL *curl;
-    CURLcode res;
-
-    string postField = utils::buildUrlQuery(params, '&');
-    ostringstream rawResponse;
-
-    curl_global_init(CURL_GLOBAL_ALL);
-    curl = curl_easy_init();
-    auto cleanup = makeScopeExit([=]() mutable { if (curl) {curl_easy_cleanup(curl);} curl_global_cleanup(); });
-    if (curl) {
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, &writeCallback);
-        curl_easy_setopt(curl, CURLOPT_FILE, &rawResponse);
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, postField.c_str());
-        res = curl_easy_perform(curl);
-        if (res != CURLE_OK) {
-            throw CurlException("Curl error", int {res});
-        }
-    }
-
-#if !defined(NDEBUG)
-    cout << rawResponse.str() << "\n";
-#endif
-
-    json jsonResponse = json::parse(rawResponse.str());
-
-    if (jsonResponse.find("error") != jsonResponse.end()) {
-        json jsonError = jsonResponse["error"];
-        if (jsonError.is_string()) {
-            throw ResponseException("OAuth error.", jsonError);
-        }
-        if (jsonError.is_object()) {
-            throw ResponseException("API error.", jsonError["message"]);
-        }
-    }
-
-    return jsonResponse;
+    d->mRateLimiter->acquire();
+    return parseResponse(d->mTransport->post(url, params));
 }
 
 } /* end namespace */
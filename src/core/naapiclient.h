@@ -19,6 +19,7 @@
 #ifndef NAAPICLIENT_H
 #define NAAPICLIENT_H
 
+#include "transport.h"
 #include "model/measures.h"
 #include "exceptions/loginexception.hpp"
 #include "exceptions/curlexception.hpp"
@@ -27,6 +28,7 @@
 #include <memory>
 #include <string>
 #include <map>
+#include <cstddef>
 #include <cstdint>
 #include <nlohmann/json.hpp>
 
@@ -55,6 +57,9 @@ struct NAApiClientPrivate;
  * updateSession() function is called. It's not recommended to set
  * these values via the set functions. These functions are provided, e.g.
  * to write and read this three properties from or to disk.
+ *
+ * All requests of a client and its copies share one rate limit, see
+ * setRateLimit(). The requests may be performed from several threads.
  */
 class NAApiClient {
 public:
@@ -173,16 +178,70 @@ public:
 
     /**
      * Returns the stored expire time.
-     * @return The expire time.
+     * @return The expire time of the access token as unix time stamp.
      */
     std::int64_t expiresIn() const;
 
     /**
      * Sets the stored expire time.
-     * @param expiresIn The expire time.
+     * @param expiresIn The expire time of the access token as unix time stamp.
      */
     void setExpiresIn(std::int64_t expiresIn);
 
+    /**
+     * Sets the rate limit of the client.
+     *
+     * get() and post() block until the request fits into the limit. The
+     * default is sDefaultRateLimitRequests requests per
+     * sDefaultRateLimitPeriod seconds.
+     *
+     * @param maxRequests The maximum number of requests per period, 0 disables the limit.
+     * @param period The period in seconds.
+     */
+    void setRateLimit(std::size_t maxRequests, std::int64_t period);
+
+    /**
+     * Returns the maximum number of requests per rate limit period.
+     * @return The maximum number of requests, 0 if the limit is disabled.
+     */
+    std::size_t rateLimitRequests() const;
+
+    /**
+     * Returns the rate limit period.
+     * @return The period in seconds.
+     */
+    std::int64_t rateLimitPeriod() const;
+
+    /**
+     * Returns the transport of the client.
+     * @return The transport, a CurlTransport by default.
+     */
+    std::shared_ptr<Transport> transport() const;
+
+    /**
+     * Sets the transport of the client.
+     *
+     * get() and post() send their requests with the transport. Copies of
+     * the client share the transport, like the rate limit. A transport
+     * with canned responses runs the parsing without network. Exceptions
+     * of the transport are passed through get() and post().
+     *
+     * @param transport The transport, nullptr for a new CurlTransport.
+     */
+    void setTransport(std::shared_ptr<Transport> transport);
+
+    /**
+     * Returns the base url of the requests.
+     * @return The base url, sUrlBase by default.
+     */
+    std::string urlBase() const;
+
+    /**
+     * Sets the base url of the requests, e.g. the url of a local mock server.
+     * @param urlBase The base url without a trailing slash, an empty string for sUrlBase.
+     */
+    void setUrlBase(const std::string &urlBase);
+
     /**
      * This function logges in the user via the request token api.
      * @throw LoginException Is thrown if the username, the password, the client id or the client secret is not set.
@@ -213,9 +272,39 @@ public:
      */
     NAApiClient &operator =(NAApiClient &&o) noexcept;
 
+    /**
+     * The default maximum number of requests per rate limit period.
+     *
+     * Value: 50
+     */
+    static const std::size_t sDefaultRateLimitRequests;
+
+    /**
+     * The default rate limit period in seconds.
+     *
+     * Value: 10
+     */
+    static const std::int64_t sDefaultRateLimitPeriod;
+
+    /**
+     * The base netatmo api url.
+     *
+     * Value: "https://api.netatmo.net"
+     */
+    static const std::string sUrlBase;
+
 protected:
     /**
-     * Perfoms a http get request via libcurl.
+     * Updates the session with updateSession(), if the access token expired.
+     * Called by the requests of the derived clients.
+     * @throw LoginException Rethrown from updateSession().
+     * @throw CurlException Rethrown from updateSession().
+     * @throw ResponseException Rethrown from updateSession().
+     */
+    void checkSession();
+
+    /**
+     * Perfoms a http get request with the transport.
      * @param url The request url.
      * @param params The request get parameters as std::map with a std::string as key and std::string as value.
      * @return The jeson encoded response from the netatmo api.
@@ -225,7 +314,7 @@ protected:
     json get(const std::string &url, const std::map<std::string, std::string> &params);
 
     /**
-     * Performs a http post request via libcurl.
+     * Performs a http post request with the transport.
      * @param url The request url.
      * @param params The request post parameters as std::map with a std::string as key and std::string as value.
      * @return The jeson encoded response from the netatmo api.
@@ -235,18 +324,18 @@ protected:
     json post(const std::string &url, const std::map<std::string, std::string> &params);
 
     /**
-     * The base netatmo api url.
+     * The request token api url with the default base url.
      *
-     * Value: "https://api.netatmo.net"
+     * Value: sUrlBase + sPathRequestToken
      */
-    static const std::string sUrlBase;
+    static const std::string sUrlRequestToken;
 
     /**
-     * The request token api url.
+     * The request token api path, relative to urlBase().
      *
-     * Value: sUrlBase + "/oauth2/token"
+     * Value: "/oauth2/token"
      */
-    static const std::string sUrlRequestToken;
+    static const std::string sPathRequestToken;
 
 private:
     std::unique_ptr<NAApiClientPrivate> d;
@@ -0,0 +1,252 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "napublicapiclient.h"
+#include "utils.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+using namespace std;
+
+namespace netatmoapi {
+
+const string NAPublicApiClient::sPathGetPublicData = "/api/getpublicdata";
+const size_t NAPublicApiClient::sDefaultResultCap = 500;
+const double NAPublicApiClient::sDefaultTileSize = 0.5;
+const double NAPublicApiClient::sMinTileSize = 0.001;
+
+NAPublicApiClient::NAPublicApiClient() :
+    NAApiClient(),
+    mResultCap(sDefaultResultCap),
+    mRequestedTiles(0),
+    mTruncatedTiles(0) {
+}
+
+NAPublicApiClient::NAPublicApiClient(const string &clientId, const string &clientSecret) :
+    NAApiClient(clientId, clientSecret),
+    mResultCap(sDefaultResultCap),
+    mRequestedTiles(0),
+    mTruncatedTiles(0) {
+}
+
+NAPublicApiClient::NAPublicApiClient(const string &username, const string &password, const string &clientId, const string &clientSecret, const string &accessToken, const string &refreshToken) :
+    NAApiClient(username, password, clientId, clientSecret, accessToken, refreshToken),
+    mResultCap(sDefaultResultCap),
+    mRequestedTiles(0),
+    mTruncatedTiles(0) {
+}
+
+NAPublicApiClient::NAPublicApiClient(const NAPublicApiClient &o) :
+    NAApiClient(o),
+    mResultCap(o.mResultCap),
+    mRequestedTiles(o.mRequestedTiles),
+    mTruncatedTiles(o.mTruncatedTiles) {
+}
+
+NAPublicApiClient::NAPublicApiClient(NAPublicApiClient &&o) noexcept :
+    NAApiClient(move(o)),
+    mResultCap(o.mResultCap),
+    mRequestedTiles(o.mRequestedTiles),
+    mTruncatedTiles(o.mTruncatedTiles) {
+}
+
+size_t NAPublicApiClient::resultCap() const {
+    return mResultCap;
+}
+
+void NAPublicApiClient::setResultCap(size_t resultCap) {
+    mResultCap = max<size_t>(resultCap, 1);
+}
+
+json NAPublicApiClient::requestPublicData(const BoundingBox &box, const string &requiredData, bool filter) {
+    checkSession();
+    return getPublicData(box, requiredData, filter);
+}
+
+json NAPublicApiClient::getPublicData(const BoundingBox &box, const string &requiredData, bool filter) {
+    map<string, string> params;
+    params.emplace("access_token", accessToken());
+    params.emplace("lat_ne", to_string(box.mNorth));
+    params.emplace("lon_ne", to_string(box.mEast));
+    params.emplace("lat_sw", to_string(box.mSouth));
+    params.emplace("lon_sw", to_string(box.mWest));
+    if (!requiredData.empty()) {
+        params.emplace("required_data", requiredData);
+    }
+    if (filter) {
+        params.emplace("filter", "true");
+    }
+
+    try {
+        return get(urlBase() + NAPublicApiClient::sPathGetPublicData, params);
+    } catch (const exception &ex) {
+#if !defined(NDEBUG)
+        cerr << "Error received in file: " << __FILE__ << ", function: " << __FUNCTION__ << ", in line: " << __LINE__ << "\n";
+        cerr << "Error: " << ex.what() << "\n";
+#endif
+        throw;
+    }
+}
+
+vector<PublicStation> NAPublicApiClient::requestPublicStations(const BoundingBox &region, double tileSize, size_t maxConcurrentRequests) {
+    checkSession();
+
+    deque<BoundingBox> queue;
+    for (const BoundingBox &tile: region.tiles(tileSize)) {
+        queue.push_back(tile);
+    }
+    mRequestedTiles = 0;
+    mTruncatedTiles = 0;
+
+    vector<PublicStation> stations;
+    unordered_map<string, size_t> index;
+    size_t active = 0;
+    exception_ptr error;
+    mutex queueMutex;
+    condition_variable queueChanged;
+
+    // Split tiles are pushed back into the queue, so a worker only stops,
+    // when the queue is empty and no other worker can add tiles.
+    auto worker = [&]() {
+        unique_lock<mutex> lock(queueMutex);
+        while (true) {
+            queueChanged.wait(lock, [&]() { return !queue.empty() || active == 0 || error; });
+            if (error || queue.empty()) {
+                break;
+            }
+            BoundingBox tile = queue.front();
+            queue.pop_front();
+            ++active;
+            ++mRequestedTiles;
+            lock.unlock();
+
+            vector<PublicStation> tileStations;
+            exception_ptr tileError;
+            try {
+                tileStations = requestTile(tile);
+            } catch (const exception &ex) {
+#if !defined(NDEBUG)
+                cerr << "Error received in file: " << __FILE__ << ", function: " << __FUNCTION__ << ", in line: " << __LINE__ << "\n";
+                cerr << "Error: " << ex.what() << "\n";
+#endif
+                tileError = current_exception();
+            }
+
+            lock.lock();
+            --active;
+            if (tileError) {
+                if (!error) {
+                    error = tileError;
+                }
+            } else {
+                if (tileStations.size() >= mResultCap) {
+                    if (tile.height() / 2 >= sMinTileSize && tile.width() / 2 >= sMinTileSize) {
+                        for (const BoundingBox &quarter: tile.split()) {
+                            queue.push_back(quarter);
+                        }
+                    } else {
+                        // The api may have dropped stations of this tile.
+                        ++mTruncatedTiles;
+                    }
+                }
+                for (PublicStation &station: tileStations) {
+                    if (!region.contains(station.mLatitude, station.mLongitude)) {
+                        continue;
+                    }
+                    auto it = index.find(station.mId);
+                    if (it == index.end()) {
+                        index.emplace(station.mId, stations.size());
+                        stations.push_back(move(station));
+                    } else if (station.mMeasures.mTimeStamp > stations[it->second].mMeasures.mTimeStamp) {
+                        stations[it->second] = move(station);
+                    }
+                }
+            }
+            queueChanged.notify_all();
+        }
+    };
+
+    vector<thread> threads;
+    try {
+        for (size_t i = 1; i < max<size_t>(maxConcurrentRequests, 1); ++i) {
+            threads.emplace_back(worker);
+        }
+    } catch (...) {
+        // The started threads must be joined before they are destroyed.
+        {
+            lock_guard<mutex> lock(queueMutex);
+            if (!error) {
+                error = current_exception();
+            }
+        }
+        queueChanged.notify_all();
+        for (thread &t: threads) {
+            t.join();
+        }
+        throw;
+    }
+    worker();
+    for (thread &t: threads) {
+        t.join();
+    }
+    if (error) {
+        rethrow_exception(error);
+    }
+
+    sort(stations.begin(), stations.end(), [](const PublicStation &a, const PublicStation &b) {
+        return a.mId < b.mId;
+    });
+    return stations;
+}
+
+size_t NAPublicApiClient::requestedTiles() const {
+    return mRequestedTiles;
+}
+
+size_t NAPublicApiClient::truncatedTiles() const {
+    return mTruncatedTiles;
+}
+
+NAPublicApiClient &NAPublicApiClient::operator =(const NAPublicApiClient &o) {
+    NAApiClient::operator =(o);
+    mResultCap = o.mResultCap;
+    mRequestedTiles = o.mRequestedTiles;
+    mTruncatedTiles = o.mTruncatedTiles;
+    return *this;
+}
+
+NAPublicApiClient &NAPublicApiClient::operator =(NAPublicApiClient &&o) noexcept {
+    NAApiClient::operator =(move(o));
+    mResultCap = o.mResultCap;
+    mRequestedTiles = o.mRequestedTiles;
+    mTruncatedTiles = o.mTruncatedTiles;
+    return *this;
+}
+
+vector<PublicStation> NAPublicApiClient::requestTile(const BoundingBox &tile) {
+    return utils::parsePublicData(getPublicData(tile, string(), false));
+}
+
+}
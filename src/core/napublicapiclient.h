@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef NAPUBLICAPICLIENT_H
+#define NAPUBLICAPICLIENT_H
+
+#include "naapiclient.h"
+#include "model/boundingbox.h"
+#include "model/publicstation.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace netatmoapi {
+
+/**
+ * @brief This class handles the public data part of the netatmo api.
+ *
+ * The getpublicdata api returns the public weather stations in a
+ * bounding box, but only up to a maximum number of stations per request.
+ * requestPublicStations() covers large regions: it splits the region
+ * into tiles, requests them in parallel within the rate limit of the
+ * client, splits tiles, which hit the result cap, into quarters and
+ * merges the stations of all tiles.
+ */
+class NAPublicApiClient: public NAApiClient {
+public:
+    /**
+     * Default constructor.
+     */
+    NAPublicApiClient();
+
+    /**
+     * Constructor with initialization of client id and client secret.
+     * @param clientId The app developers client id.
+     * @param clientSecret The app developers client secret.
+     */
+    explicit NAPublicApiClient(const std::string &clientId, const std::string &clientSecret);
+
+    /**
+     * Constructor with initialization of all credential values.
+     * @param username The users username.
+     * @param password The users password.
+     * @param clientId The app developers client id.
+     * @param clientSecret The app developers client secret.
+     * @param accessToken The access token, e.g. restored from disk.
+     * @param refreshToken The refresh token, e.g. restored from disk.
+     */
+    explicit NAPublicApiClient(const std::string &username, const std::string &password, const std::string &clientId, const std::string &clientSecret, const std::string &accessToken = std::string(), const std::string &refreshToken = std::string());
+
+    /**
+     * Copy constructor.
+     * @param o The Element to copy.
+     */
+    NAPublicApiClient(const NAPublicApiClient &o);
+
+    /**
+     * Move constructor
+     * @param o The element to move.
+     */
+    NAPublicApiClient(NAPublicApiClient &&o) noexcept;
+
+    /**
+     * Destructor
+     * Is default.
+     */
+    ~NAPublicApiClient() noexcept override = default;
+
+    /**
+     * Returns the number of stations, at which the api caps a response.
+     * @return The result cap.
+     */
+    std::size_t resultCap() const;
+
+    /**
+     * Sets the number of stations, at which the api caps a response.
+     * A tile with at least this number of stations is split.
+     * @param resultCap The result cap, at least 1.
+     */
+    void setResultCap(std::size_t resultCap);
+
+    /**
+     * Requests the public weather stations in a bounding box via the netatmo getpublicdata api.
+     * @param box The bounding box.
+     * @param requiredData Only stations with these measures, e.g. "rain". Empty for all stations.
+     * @param filter True to exclude stations with unusual values.
+     * @return The json response from api.
+     * @throw LoginException Rethrown from updateSession().
+     * @throw CurlException Rethrown from updateSession() and get().
+     * @throw ResponseException Rethrown from updateSession() and get().
+     */
+    json requestPublicData(const BoundingBox &box, const std::string &requiredData = std::string(), bool filter = false);
+
+    /**
+     * Requests all public weather stations in a region.
+     *
+     * The region is split into tiles of tileSize degrees, which are
+     * requested with up to maxConcurrentRequests parallel requests. A tile
+     * with resultCap() or more stations is split into quarters, until the
+     * quarters are smaller than sMinTileSize, see truncatedTiles().
+     * A region across the antimeridian is tiled on both sides of it.
+     * Stations, which are returned for more than one tile, are merged by
+     * id, and stations outside of the region are dropped.
+     *
+     * The session is updated once before the first request, a crawl
+     * does not take longer than an access token is valid.
+     *
+     * @param region The region.
+     * @param tileSize The size of the initial tiles in degrees.
+     * @param maxConcurrentRequests The maximum number of parallel requests.
+     * @return The stations of the region, ordered by id.
+     * @throw LoginException Rethrown from updateSession().
+     * @throw CurlException Rethrown from updateSession() and get().
+     * @throw ResponseException Rethrown from updateSession() and get().
+     */
+    std::vector<PublicStation> requestPublicStations(const BoundingBox &region, double tileSize = sDefaultTileSize, std::size_t maxConcurrentRequests = 4);
+
+    /**
+     * Returns the number of tiles requested by the last call of requestPublicStations().
+     * @return The number of requested tiles, including split tiles.
+     */
+    std::size_t requestedTiles() const;
+
+    /**
+     * Returns the number of tiles of the last call of requestPublicStations(),
+     * which reached resultCap(), but were not split, because they are at
+     * sMinTileSize. The result may miss stations of these tiles.
+     * @return The number of truncated tiles.
+     */
+    std::size_t truncatedTiles() const;
+
+    /**
+     * Copy assignment operator.
+     * @param o The element to copy.
+     * @return This element as reference.
+     */
+    NAPublicApiClient &operator =(const NAPublicApiClient &o);
+
+    /**
+     * Move assignment operator.
+     * @param o The element to move.
+     * @return This element as reference.
+     */
+    NAPublicApiClient &operator =(NAPublicApiClient &&o) noexcept;
+
+    /**
+     * The default number of stations, at which the api caps a response.
+     * Value: 500
+     */
+    static const std::size_t sDefaultResultCap;
+
+    /**
+     * The default size of the initial tiles in degrees.
+     * Value: 0.5
+     */
+    static const double sDefaultTileSize;
+
+    /**
+     * The minimum size of a tile in degrees, smaller tiles are not split.
+     * Value: 0.001
+     */
+    static const double sMinTileSize;
+
+protected:
+    /**
+     * Requests the public stations of one tile.
+     * Called concurrently by requestPublicStations(), after the session was checked.
+     * @param tile The tile.
+     * @return The stations of the tile.
+     */
+    virtual std::vector<PublicStation> requestTile(const BoundingBox &tile);
+
+private:
+    json getPublicData(const BoundingBox &box, const std::string &requiredData, bool filter);
+
+    std::size_t mResultCap;
+    std::size_t mRequestedTiles;
+    std::size_t mTruncatedTiles;
+
+    static const std::string sPathGetPublicData;
+};
+
+}
+
+#endif /* NAPUBLICAPICLIENT_H */
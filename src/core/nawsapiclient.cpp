@@ -17,14 +17,22 @@
  * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "nawsapiclient.h"
+#include "utils.h"
+#include "model/params.h"
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
 #include <iostream>
+#include <mutex>
+#include <thread>
 
 using namespace std;
 
 namespace netatmoapi {
 
-const string NAWSApiClient::sUrlGetStationsData = NAApiClient::sUrlBase + "/api/getstationsdata";
+const string NAWSApiClient::sPathGetStationsData = "/api/getstationsdata";
+const string NAWSApiClient::sPathGetMeasure = "/api/getmeasure";
 
 NAWSApiClient::NAWSApiClient() :
     NAApiClient() {
@@ -47,17 +55,7 @@ NAWSApiClient::NAWSApiClient(NAWSApiClient &&o) noexcept :
 }
 
 json NAWSApiClient::requestStationsData(const string &deviceId, bool getFavorites) {
-    try {
-        if (time(nullptr) >= expiresIn()) {
-            updateSession();
-        }
-    } catch (const LoginException &ex) {
-#if !defined(NDEBUG)
-        cerr << "Error received in file: " << __FILE__ << ", function: " << __FUNCTION__ << ", in line: " << __LINE__ << "\n";
-        cerr << "Error: " << ex.what() << "\n";
-#endif
-        throw;
-    }
+    checkSession();
 
     map<string, string> params;
     params.emplace("access_token", accessToken());
@@ -69,7 +67,7 @@ json NAWSApiClient::requestStationsData(const string &deviceId, bool getFavorite
     }
 
     try {
-        return get(NAWSApiClient::sUrlGetStationsData, params);
+        return get(urlBase() + NAWSApiClient::sPathGetStationsData, params);
     } catch (const exception &ex) {
 #if !defined(NDEBUG)
         cerr << "Error received in file: " << __FILE__ << ", function: " << __FUNCTION__ << ", in line: " << __LINE__ << "\n";
@@ -79,6 +77,112 @@ json NAWSApiClient::requestStationsData(const string &deviceId, bool getFavorite
     }
 }
 
+json NAWSApiClient::requestMeasures(const string &deviceId, const string &moduleId, const string &scale, const vector<string> &types, uint64_t begin, uint64_t end, size_t maxConcurrentRequests) {
+    if (types.empty()) {
+        throw invalid_argument("No measure types.");
+    }
+    vector<pair<uint64_t, uint64_t>> chunks = utils::splitTimeRange(begin, end, scale, params::cMaxMeasuresPerRequest);
+
+    checkSession();
+
+    map<string, string> params;
+    params.emplace("access_token", accessToken());
+    params.emplace("device_id", deviceId);
+    if (!moduleId.empty()) {
+        params.emplace("module_id", moduleId);
+    }
+    params.emplace("scale", scale);
+    string type;
+    for (const string &t: types) {
+        if (!type.empty()) {
+            type.push_back(',');
+        }
+        type.append(t);
+    }
+    params.emplace("type", type);
+    params.emplace("limit", to_string(params::cMaxMeasuresPerRequest));
+    params.emplace("optimize", "true");
+    const string url = urlBase() + NAWSApiClient::sPathGetMeasure;
+
+    vector<json> results(chunks.size(), json::array());
+    atomic<size_t> nextChunk(0);
+    atomic<bool> failed(false);
+    exception_ptr error;
+    mutex errorMutex;
+
+    auto worker = [&]() {
+        map<string, string> chunkParams = params;
+        for (size_t i = nextChunk++; i < chunks.size() && !failed; i = nextChunk++) {
+            uint64_t chunkBegin = chunks[i].first;
+            const uint64_t chunkEnd = chunks[i].second;
+            try {
+                // Irregular measures may exceed the limit of a chunk, the rest is requested afterwards.
+                while (chunkBegin <= chunkEnd) {
+                    chunkParams["date_begin"] = to_string(chunkBegin);
+                    chunkParams["date_end"] = to_string(chunkEnd);
+                    json response = get(url, chunkParams);
+                    size_t count = 0;
+                    uint64_t last = 0;
+                    for (json &block: response["body"]) {
+                        uint64_t blockBegin = block["beg_time"];
+                        uint64_t step = block.find("step_time") != block.end() ? block["step_time"].get<uint64_t>() : 0;
+                        size_t size = block["value"].size();
+                        count += size;
+                        if (size > 0) {
+                            last = max(last, blockBegin + step * (size - 1));
+                        }
+                        results[i].push_back(move(block));
+                    }
+                    if (count < params::cMaxMeasuresPerRequest || last < chunkBegin) {
+                        break;
+                    }
+                    chunkBegin = last + 1;
+                }
+            } catch (const exception &ex) {
+#if !defined(NDEBUG)
+                cerr << "Error received in file: " << __FILE__ << ", function: " << __FUNCTION__ << ", in line: " << __LINE__ << "\n";
+                cerr << "Error: " << ex.what() << "\n";
+#endif
+                lock_guard<mutex> lock(errorMutex);
+                if (!error) {
+                    error = current_exception();
+                }
+                failed = true;
+            }
+        }
+    };
+
+    vector<thread> threads;
+    size_t threadCount = min(max<size_t>(maxConcurrentRequests, 1), chunks.size());
+    try {
+        for (size_t i = 1; i < threadCount; ++i) {
+            threads.emplace_back(worker);
+        }
+    } catch (...) {
+        // The started threads must be joined before they are destroyed.
+        failed = true;
+        for (thread &t: threads) {
+            t.join();
+        }
+        throw;
+    }
+    worker();
+    for (thread &t: threads) {
+        t.join();
+    }
+    if (error) {
+        rethrow_exception(error);
+    }
+
+    json blocks = json::array();
+    for (json &result: results) {
+        for (json &block: result) {
+            blocks.push_back(move(block));
+        }
+    }
+    return blocks;
+}
+
 NAWSApiClient &NAWSApiClient::operator =(const NAWSApiClient &o) {
     NAApiClient::operator =(o);
     return *this;
@@ -21,6 +21,11 @@
 
 #include "naapiclient.h"
 
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
 namespace netatmoapi {
 
 /**
@@ -83,6 +88,35 @@ public:
      */
     json requestStationsData(const std::string &deviceId = std::string(), bool getFavorites = false);
 
+    /**
+     * Requests the measures of a module via the netatmo getmeasure api.
+     *
+     * The time range is split into chunks, which fit into the limit of
+     * params::cMaxMeasuresPerRequest measures per request, see
+     * utils::splitTimeRange(). Up to maxConcurrentRequests chunks are
+     * requested in parallel, within the rate limit of the client.
+     *
+     * The measures are requested in the compact format (optimize=true).
+     * The result is one json array of measure blocks, ordered by time.
+     * Every block is an object with the keys "beg_time", "step_time"
+     * (missing for blocks with one measure) and "value". "value" is an
+     * array with one array of values per measure, in the order of types.
+     *
+     * @param deviceId Weather station mac address.
+     * @param moduleId Module mac address, empty for the main module.
+     * @param scale The interval of the measures, e.g. params::cScaleMax.
+     * @param types The measure types, e.g. params::cTypeTemperature.
+     * @param begin The begin of the time range as unix time stamp.
+     * @param end The end of the time range as unix time stamp.
+     * @param maxConcurrentRequests The maximum number of parallel requests.
+     * @return The json array of measure blocks.
+     * @throw std::invalid_argument If the scale is unknown or types is empty.
+     * @throw LoginException Rethrown from updateSession().
+     * @throw CurlException Rethrown from updateSession() and get().
+     * @throw ResponseException Rethrown from updateSession() and get().
+     */
+    json requestMeasures(const std::string &deviceId, const std::string &moduleId, const std::string &scale, const std::vector<std::string> &types, std::uint64_t begin, std::uint64_t end, std::size_t maxConcurrentRequests = 4);
+
     /**
      * Copy assignment operator.
      * @param o The element to copy.
@@ -98,7 +132,8 @@ public:
     NAWSApiClient &operator =(NAWSApiClient &&o) noexcept;
 
 private:
-    static const std::string sUrlGetStationsData;
+    static const std::string sPathGetStationsData;
+    static const std::string sPathGetMeasure;
 };
 
 }
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef RATELIMITER_HPP
+#define RATELIMITER_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace netatmoapi {
+
+class RateLimiter {
+public:
+    RateLimiter(std::size_t maxRequests, std::chrono::milliseconds period) :
+        mMaxRequests(maxRequests),
+        mPeriod(period)
+        {}
+    void setLimit(std::size_t maxRequests, std::chrono::milliseconds period)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mMaxRequests = maxRequests;
+        mPeriod = period;
+    }
+    std::size_t maxRequests() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mMaxRequests;
+    }
+    std::chrono::milliseconds period() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mPeriod;
+    }
+    // Blocks until one more request fits into the sliding window.
+    void acquire()
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        for (;;) {
+            if (mMaxRequests == 0) {
+                return;
+            }
+            auto now = std::chrono::steady_clock::now();
+            while (!mRequests.empty() && now - mRequests.front() >= mPeriod) {
+                mRequests.pop_front();
+            }
+            if (mRequests.size() < mMaxRequests) {
+                mRequests.push_back(now);
+                return;
+            }
+            auto wakeUp = mRequests.front() + mPeriod;
+            lock.unlock();
+            std::this_thread::sleep_until(wakeUp);
+            lock.lock();
+        }
+    }
+private:
+    mutable std::mutex mMutex;
+    std::size_t mMaxRequests;
+    std::chrono::milliseconds mPeriod;
+    std::deque<std::chrono::steady_clock::time_point> mRequests;
+};
+
+}
+
+#endif /* RATELIMITER_HPP */
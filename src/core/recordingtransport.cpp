@@ -0,0 +1,340 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "recordingtransport.h"
+#include "curltransport.h"
+#include "mappedfile.hpp"
+#include "exceptions/curlexception.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+#include <unordered_map>
+#include <fcntl.h>
+#include <unistd.h>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+using namespace std;
+
+namespace netatmoapi {
+
+namespace {
+
+const char cMagic[8] = { 'N', 'A', 'R', 'E', 'C', '\0', '\0', '\0' };
+// Longer strings, i.e. response bodies, are not put into the string table.
+const size_t cMaxTableString = 256;
+
+void putVarint(string &out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+// Writes a string once and references it afterwards: the varint is the
+// length shifted by one for a new string, or the table index shifted by
+// one with the lowest bit set for a known string.
+void putString(string &out, const string &value, unordered_map<string, uint64_t> &table) {
+    auto known = table.find(value);
+    if (known != table.end()) {
+        putVarint(out, (known->second << 1) | 1);
+        return;
+    }
+    putVarint(out, uint64_t(value.size()) << 1);
+    out.append(value);
+    if (value.size() <= cMaxTableString) {
+        table.emplace(value, table.size());
+    }
+}
+
+class Reader {
+public:
+    Reader(const char *data, size_t size) :
+        mData(data),
+        mSize(size),
+        mOffset(0)
+    {}
+
+    bool atEnd() const {
+        return mOffset >= mSize;
+    }
+
+    // Returns the next size bytes and skips them, nullptr if there are less.
+    const char *take(size_t size) {
+        if (size > mSize - mOffset) {
+            return nullptr;
+        }
+        const char *data = mData + mOffset;
+        mOffset += size;
+        return data;
+    }
+
+    bool varint(uint64_t &value) {
+        value = 0;
+        for (unsigned shift = 0; shift < 64 && mOffset < mSize; shift += 7) {
+            uint8_t byte = static_cast<uint8_t>(mData[mOffset++]);
+            value |= uint64_t(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool bytes(size_t size, string &value) {
+        const char *data = take(size);
+        if (!data) {
+            return false;
+        }
+        value.assign(data, size);
+        return true;
+    }
+
+    bool str(string &value, vector<string> &table) {
+        uint64_t tag;
+        if (!varint(tag)) {
+            return false;
+        }
+        if (tag & 1) {
+            if ((tag >> 1) >= table.size()) {
+                return false;
+            }
+            value = table[tag >> 1];
+            return true;
+        }
+        if (!bytes(tag >> 1, value)) {
+            return false;
+        }
+        if (value.size() <= cMaxTableString) {
+            table.push_back(value);
+        }
+        return true;
+    }
+
+private:
+    const char *mData;
+    size_t mSize;
+    size_t mOffset;
+};
+
+bool readRecord(Reader &reader, vector<string> &table, RecordingTransport::Record &record) {
+    uint64_t method, error, code, count, size;
+    if (!reader.varint(method) || !reader.varint(error) || !reader.varint(code)
+            || !reader.varint(record.mStart) || !reader.varint(record.mDuration)
+            || !reader.str(record.mUrl, table) || !reader.varint(count)) {
+        return false;
+    }
+    record.mMethod = method == 0 ? RecordingTransport::Record::get : RecordingTransport::Record::post;
+    record.mError = static_cast<RecordingTransport::Record::Error>(min<uint64_t>(error, RecordingTransport::Record::otherError));
+    record.mErrorCode = static_cast<int>(code);
+    record.mParams.clear();
+    for (uint64_t i = 0; i < count; ++i) {
+        string key, value;
+        if (!reader.str(key, table) || !reader.str(value, table)) {
+            return false;
+        }
+        record.mParams.emplace(move(key), move(value));
+    }
+    return reader.varint(size) && reader.bytes(size, record.mResponse);
+}
+
+// Token responses hold the access and the refresh token.
+string redactResponse(const string &response) {
+    if (response.find("_token") == string::npos) {
+        return response;
+    }
+    json parsed = json::parse(response, nullptr, false);
+    if (!parsed.is_object()) {
+        return response;
+    }
+    bool redacted = false;
+    for (auto it = parsed.begin(); it != parsed.end(); ++it) {
+        if (RecordingTransport::isCredential(it.key())) {
+            it.value() = RecordingTransport::sRedacted;
+            redacted = true;
+        }
+    }
+    return redacted ? parsed.dump() : response;
+}
+
+}
+
+struct RecordingTransportPrivate {
+    RecordingTransportPrivate(const string &path, shared_ptr<Transport> &&transport) :
+        mPath(path),
+        mTransport(transport ? move(transport) : make_shared<CurlTransport>()),
+        mStartTime(chrono::steady_clock::now()),
+        mRecordCount(0)
+    {
+        mFd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+        if (mFd < 0) {
+            throw system_error(errno, generic_category(), "Can not create " + path);
+        }
+        string header(cMagic, sizeof(cMagic));
+        putVarint(header, RecordingTransport::sVersion);
+        writeAll(header);
+    }
+
+    ~RecordingTransportPrivate() {
+        ::close(mFd);
+    }
+
+    void writeAll(const string &data) {
+        const char *bytes = data.data();
+        size_t size = data.size();
+        while (size > 0) {
+            ssize_t written = ::write(mFd, bytes, size);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw system_error(errno, generic_category(), "Can not write " + mPath);
+            }
+            bytes += written;
+            size -= static_cast<size_t>(written);
+        }
+    }
+
+    string perform(RecordingTransport::Record::Method method, const string &url, const map<string, string> &params) {
+        RecordingTransport::Record record;
+        record.mMethod = method;
+        record.mError = RecordingTransport::Record::none;
+        record.mErrorCode = 0;
+        auto start = chrono::steady_clock::now();
+        string response;
+        try {
+            response = method == RecordingTransport::Record::get ? mTransport->get(url, params) : mTransport->post(url, params);
+            record.mResponse = redactResponse(response);
+        } catch (const CurlException &ex) {
+            record.mError = RecordingTransport::Record::curlError;
+            record.mErrorCode = ex.code();
+            record.mResponse = ex.what();
+            write(record, url, params, start);
+            throw;
+        } catch (const exception &ex) {
+            record.mError = RecordingTransport::Record::otherError;
+            record.mResponse = ex.what();
+            write(record, url, params, start);
+            throw;
+        }
+        write(record, url, params, start);
+        return response;
+    }
+
+    void write(RecordingTransport::Record &record, const string &url, const map<string, string> &params, chrono::steady_clock::time_point start) {
+        auto end = chrono::steady_clock::now();
+        record.mStart = static_cast<uint64_t>(chrono::duration_cast<chrono::microseconds>(start - mStartTime).count());
+        record.mDuration = static_cast<uint64_t>(chrono::duration_cast<chrono::microseconds>(end - start).count());
+
+        lock_guard<mutex> lock(mMutex);
+        string body;
+        putVarint(body, record.mMethod);
+        putVarint(body, record.mError);
+        putVarint(body, static_cast<uint32_t>(record.mErrorCode));
+        putVarint(body, record.mStart);
+        putVarint(body, record.mDuration);
+        putString(body, url, mTable);
+        putVarint(body, params.size());
+        for (const auto &param: params) {
+            putString(body, param.first, mTable);
+            putString(body, RecordingTransport::isCredential(param.first) ? RecordingTransport::sRedacted : param.second, mTable);
+        }
+        putVarint(body, record.mResponse.size());
+        string out;
+        putVarint(out, body.size() + record.mResponse.size());
+        out.append(body);
+        out.append(record.mResponse);
+        writeAll(out);
+        ++mRecordCount;
+    }
+
+    string mPath;
+    shared_ptr<Transport> mTransport;
+    chrono::steady_clock::time_point mStartTime;
+    int mFd;
+    mutable mutex mMutex;
+    unordered_map<string, uint64_t> mTable;
+    size_t mRecordCount;
+};
+
+const string RecordingTransport::sRedacted = "redacted";
+const uint32_t RecordingTransport::sVersion = 1;
+
+RecordingTransport::RecordingTransport(const string &path, shared_ptr<Transport> transport) :
+    d(new RecordingTransportPrivate(path, move(transport))) {
+}
+
+RecordingTransport::~RecordingTransport() noexcept = default;
+
+string RecordingTransport::get(const string &url, const map<string, string> &params) {
+    return d->perform(Record::get, url, params);
+}
+
+string RecordingTransport::post(const string &url, const map<string, string> &params) {
+    return d->perform(Record::post, url, params);
+}
+
+size_t RecordingTransport::recordCount() const {
+    lock_guard<mutex> lock(d->mMutex);
+    return d->mRecordCount;
+}
+
+vector<RecordingTransport::Record> RecordingTransport::read(const string &path) {
+    MappedFile file(path);
+    Reader reader(file.data(), file.size());
+    string magic;
+    uint64_t version;
+    if (!reader.bytes(sizeof(cMagic), magic) || memcmp(magic.data(), cMagic, sizeof(cMagic)) != 0 || !reader.varint(version)) {
+        throw runtime_error("Invalid recording file: " + path);
+    }
+    if (version != sVersion) {
+        throw runtime_error("Unsupported recording version: " + path);
+    }
+    vector<Record> records;
+    vector<string> table;
+    while (!reader.atEnd()) {
+        // An incomplete last record is ignored.
+        uint64_t size;
+        if (!reader.varint(size)) {
+            break;
+        }
+        const char *data = reader.take(size);
+        if (!data) {
+            break;
+        }
+        Reader recordReader(data, size);
+        Record record;
+        if (!readRecord(recordReader, table, record)) {
+            throw runtime_error("Corrupt recording file: " + path);
+        }
+        records.push_back(move(record));
+    }
+    return records;
+}
+
+bool RecordingTransport::isCredential(const string &name) {
+    return name == "username" || name == "password" || name == "client_id" || name == "client_secret"
+            || name == "access_token" || name == "refresh_token";
+}
+
+}
@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef RECORDINGTRANSPORT_H
+#define RECORDINGTRANSPORT_H
+
+#include "transport.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace netatmoapi {
+
+struct RecordingTransportPrivate;
+
+/**
+ * @brief Transport, which records all requests to a file.
+ *
+ * The requests are passed to another transport, and every request is
+ * appended to the file with its url, parameters, response body, start
+ * time and duration. Failed requests are recorded with their error.
+ * The recording is replayed with ReplayTransport.
+ *
+ * Credentials are never written: the values of the parameters and of
+ * the token response members, for which isCredential() is true, are
+ * replaced by sRedacted.
+ *
+ * The file is a compact binary format: a header and one length prefixed
+ * record per request with variable length integers. Urls, parameter
+ * names and values are written once and referenced afterwards. Every
+ * record is written, when its request is done, and an incomplete last
+ * record, e.g. after a crash, is ignored by read().
+ *
+ * All methods are thread safe.
+ */
+class RecordingTransport : public Transport {
+public:
+    /**
+     * @brief A recorded request.
+     */
+    struct Record {
+        /**
+         * @brief The http method of a request.
+         */
+        enum Method {
+            /// A get request.
+            get,
+            /// A post request.
+            post
+        };
+
+        /**
+         * @brief The result of a request.
+         */
+        enum Error {
+            /// The request returned a response.
+            none,
+            /// The request threw a CurlException.
+            curlError,
+            /// The request threw another exception.
+            otherError
+        };
+
+        /**
+         * The http method.
+         */
+        Method                              mMethod;
+
+        /**
+         * The request url.
+         */
+        std::string                         mUrl;
+
+        /**
+         * The parameters with redacted credentials.
+         */
+        std::map<std::string, std::string>  mParams;
+
+        /**
+         * The result of the request.
+         */
+        Error                               mError;
+
+        /**
+         * The code of a CurlException.
+         */
+        int                                 mErrorCode;
+
+        /**
+         * The response body, or the message of the error.
+         */
+        std::string                         mResponse;
+
+        /**
+         * The start of the request in microseconds since the start of the recording.
+         */
+        std::uint64_t                       mStart;
+
+        /**
+         * The duration of the request in microseconds.
+         */
+        std::uint64_t                       mDuration;
+    };
+
+    /**
+     * Constructor.
+     * Creates or truncates the recording file.
+     * @param path The path of the recording file.
+     * @param transport The transport, which performs the requests, nullptr for a new CurlTransport.
+     * @throw std::system_error If the file can not be created.
+     */
+    explicit RecordingTransport(const std::string &path, std::shared_ptr<Transport> transport = nullptr);
+
+    RecordingTransport(const RecordingTransport &) = delete;
+
+    /**
+     * Destructor.
+     * Closes the file.
+     */
+    ~RecordingTransport() noexcept override;
+
+    /**
+     * Performs a http get request with the transport and records it.
+     * @param url The request url without query.
+     * @param params The query parameters.
+     * @return The response body.
+     * @throw std::system_error If the record can not be written.
+     */
+    std::string get(const std::string &url, const std::map<std::string, std::string> &params) override;
+
+    /**
+     * Performs a http post request with the transport and records it.
+     * @param url The request url.
+     * @param params The post parameters.
+     * @return The response body.
+     * @throw std::system_error If the record can not be written.
+     */
+    std::string post(const std::string &url, const std::map<std::string, std::string> &params) override;
+
+    /**
+     * Returns the number of recorded requests.
+     * @return The number of records.
+     */
+    std::size_t recordCount() const;
+
+    /**
+     * Reads a recording.
+     * @param path The path of the recording file.
+     * @return The records in the order of their completion.
+     * @throw std::system_error If the file can not be read.
+     * @throw std::runtime_error If the file is not a recording.
+     */
+    static std::vector<Record> read(const std::string &path);
+
+    /**
+     * Returns true, if a parameter or response member holds a credential.
+     * These are the user name, the password, the client id and secret and the tokens.
+     * @param name The name of the parameter or member.
+     * @return True for a credential.
+     */
+    static bool isCredential(const std::string &name);
+
+    RecordingTransport &operator =(const RecordingTransport &) = delete;
+
+    /**
+     * The value of redacted credentials.
+     * Value: "redacted"
+     */
+    static const std::string sRedacted;
+
+    /**
+     * The version of the file format.
+     * Value: 1
+     */
+    static const std::uint32_t sVersion;
+
+private:
+    std::unique_ptr<RecordingTransportPrivate> d;
+};
+
+}
+
+#endif /* RECORDINGTRANSPORT_H */
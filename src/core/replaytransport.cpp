@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "replaytransport.h"
+#include "exceptions/curlexception.hpp"
+
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+using namespace std;
+
+namespace netatmoapi {
+
+namespace {
+
+// Method, url and the parameters without credentials identify a request.
+string requestKey(RecordingTransport::Record::Method method, const string &url, const map<string, string> &params) {
+    string key(1, method == RecordingTransport::Record::get ? 'G' : 'P');
+    key += url;
+    for (const auto &param: params) {
+        if (!RecordingTransport::isCredential(param.first)) {
+            key += '\n';
+            key += param.first;
+            key += '=';
+            key += param.second;
+        }
+    }
+    return key;
+}
+
+struct Responses {
+    vector<size_t> mRecords;
+    size_t mNext = 0;
+    bool mWrapped = false;
+};
+
+}
+
+struct ReplayTransportPrivate {
+    ReplayTransportPrivate(vector<RecordingTransport::Record> &&records, ReplayTransport::Timing timing) :
+        mRecords(move(records)),
+        mTiming(timing),
+        mReplayCount(0),
+        mStarted(false),
+        mFirstStart(0)
+    {
+        for (size_t i = 0; i < mRecords.size(); ++i) {
+            const RecordingTransport::Record &record = mRecords[i];
+            mResponses[requestKey(record.mMethod, record.mUrl, record.mParams)].mRecords.push_back(i);
+        }
+        if (!mRecords.empty()) {
+            mFirstStart = mRecords.front().mStart;
+            for (const RecordingTransport::Record &record: mRecords) {
+                mFirstStart = min(mFirstStart, record.mStart);
+            }
+        }
+    }
+
+    string serve(RecordingTransport::Record::Method method, const string &url, const map<string, string> &params) {
+        auto requested = chrono::steady_clock::now();
+        const RecordingTransport::Record *record;
+        bool firstPass;
+        ReplayTransport::Timing timing;
+        {
+            lock_guard<mutex> lock(mMutex);
+            auto responses = mResponses.find(requestKey(method, url, params));
+            if (responses == mResponses.end()) {
+                throw runtime_error("No recorded response for " + url);
+            }
+            Responses &queue = responses->second;
+            record = &mRecords[queue.mRecords[queue.mNext]];
+            firstPass = !queue.mWrapped;
+            if (++queue.mNext == queue.mRecords.size()) {
+                queue.mNext = 0;
+                queue.mWrapped = true;
+            }
+            if (!mStarted) {
+                mStarted = true;
+                mStartTime = requested;
+            }
+            timing = mTiming;
+            ++mReplayCount;
+        }
+
+        if (timing == ReplayTransport::originalTiming) {
+            auto done = requested + chrono::microseconds(record->mDuration);
+            if (firstPass) {
+                done = max(done, mStartTime + chrono::microseconds(record->mStart - mFirstStart + record->mDuration));
+            }
+            this_thread::sleep_until(done);
+        }
+
+        switch (record->mError) {
+        case RecordingTransport::Record::curlError:
+            throw CurlException(record->mResponse, record->mErrorCode);
+        case RecordingTransport::Record::otherError:
+            throw runtime_error(record->mResponse);
+        default:
+            return record->mResponse;
+        }
+    }
+
+    vector<RecordingTransport::Record> mRecords;
+    unordered_map<string, Responses> mResponses;
+    ReplayTransport::Timing mTiming;
+    mutable mutex mMutex;
+    size_t mReplayCount;
+    bool mStarted;
+    chrono::steady_clock::time_point mStartTime;
+    uint64_t mFirstStart;
+};
+
+ReplayTransport::ReplayTransport(const string &path, Timing timing) :
+    d(new ReplayTransportPrivate(RecordingTransport::read(path), timing)) {
+}
+
+ReplayTransport::ReplayTransport(vector<RecordingTransport::Record> &&records, Timing timing) :
+    d(new ReplayTransportPrivate(move(records), timing)) {
+}
+
+ReplayTransport::~ReplayTransport() noexcept = default;
+
+string ReplayTransport::get(const string &url, const map<string, string> &params) {
+    return d->serve(RecordingTransport::Record::get, url, params);
+}
+
+string ReplayTransport::post(const string &url, const map<string, string> &params) {
+    return d->serve(RecordingTransport::Record::post, url, params);
+}
+
+ReplayTransport::Timing ReplayTransport::timing() const {
+    lock_guard<mutex> lock(d->mMutex);
+    return d->mTiming;
+}
+
+void ReplayTransport::setTiming(Timing timing) {
+    lock_guard<mutex> lock(d->mMutex);
+    d->mTiming = timing;
+}
+
+const vector<RecordingTransport::Record> &ReplayTransport::records() const {
+    return d->mRecords;
+}
+
+size_t ReplayTransport::replayCount() const {
+    lock_guard<mutex> lock(d->mMutex);
+    return d->mReplayCount;
+}
+
+}
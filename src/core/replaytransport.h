@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef REPLAYTRANSPORT_H
+#define REPLAYTRANSPORT_H
+
+#include "recordingtransport.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace netatmoapi {
+
+struct ReplayTransportPrivate;
+
+/**
+ * @brief Transport, which serves the responses of a recording.
+ *
+ * A request is answered with the next recorded response of the same
+ * method, url and parameters. Credentials are not compared, because
+ * they are redacted in the recording. The responses of a request are
+ * served in the recorded order and start again with the first one, when
+ * all were served, so a recording can be replayed in a loop. A recorded
+ * error is thrown again, a CurlException as CurlException and other
+ * errors as std::runtime_error.
+ *
+ * With fullSpeed, the responses are returned immediately. With
+ * originalTiming, a response is returned after its recorded duration,
+ * and the first pass through the recording keeps the recorded start
+ * times relative to the first request.
+ *
+ * All methods are thread safe.
+ */
+class ReplayTransport : public Transport {
+public:
+    /**
+     * @brief The timing of the responses.
+     */
+    enum Timing {
+        /// The responses are returned immediately.
+        fullSpeed,
+        /// The responses are returned with the recorded timing.
+        originalTiming
+    };
+
+    /**
+     * Constructor.
+     * Reads a recording of RecordingTransport.
+     * @param path The path of the recording file.
+     * @param timing The timing of the responses.
+     * @throw std::system_error If the file can not be read.
+     * @throw std::runtime_error If the file is not a recording.
+     */
+    explicit ReplayTransport(const std::string &path, Timing timing = fullSpeed);
+
+    /**
+     * Constructor.
+     * @param records The records, e.g. from RecordingTransport::read().
+     * @param timing The timing of the responses.
+     */
+    explicit ReplayTransport(std::vector<RecordingTransport::Record> &&records, Timing timing = fullSpeed);
+
+    ReplayTransport(const ReplayTransport &) = delete;
+
+    /**
+     * Destructor.
+     * Is default.
+     */
+    ~ReplayTransport() noexcept override;
+
+    /**
+     * Serves the next recorded response of a get request.
+     * @param url The request url without query.
+     * @param params The query parameters.
+     * @return The recorded response body.
+     * @throw CurlException If a CurlException was recorded.
+     * @throw std::runtime_error If there is no recorded request or another error was recorded.
+     */
+    std::string get(const std::string &url, const std::map<std::string, std::string> &params) override;
+
+    /**
+     * Serves the next recorded response of a post request.
+     * @param url The request url.
+     * @param params The post parameters.
+     * @return The recorded response body.
+     * @throw CurlException If a CurlException was recorded.
+     * @throw std::runtime_error If there is no recorded request or another error was recorded.
+     */
+    std::string post(const std::string &url, const std::map<std::string, std::string> &params) override;
+
+    /**
+     * Returns the timing of the responses.
+     * @return The timing.
+     */
+    Timing timing() const;
+
+    /**
+     * Sets the timing of the responses.
+     * @param timing The timing.
+     */
+    void setTiming(Timing timing);
+
+    /**
+     * Returns the records.
+     * @return The records in the recorded order.
+     */
+    const std::vector<RecordingTransport::Record> &records() const;
+
+    /**
+     * Returns the number of served responses.
+     * @return The number of served responses and errors.
+     */
+    std::size_t replayCount() const;
+
+    ReplayTransport &operator =(const ReplayTransport &) = delete;
+
+private:
+    std::unique_ptr<ReplayTransportPrivate> d;
+};
+
+}
+
+#endif /* REPLAYTRANSPORT_H */
@@ -0,0 +1,320 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef SIMD_HPP
+#define SIMD_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace netatmoapi {
+
+namespace simd {
+
+// Running minimum, maximum, sum and count of the values, which are not missing.
+struct Reduction {
+    Reduction() :
+        mMin(std::numeric_limits<double>::infinity()),
+        mMax(-std::numeric_limits<double>::infinity()),
+        mSum(0),
+        mCount(0)
+        {}
+    double mMin;
+    double mMax;
+    double mSum;
+    std::size_t mCount;
+};
+
+inline void reduceScalar(const double *values, std::size_t count, double missing, Reduction &reduction)
+{
+    for (std::size_t i = 0; i < count; ++i) {
+        double value = values[i];
+        if (value == missing) {
+            continue;
+        }
+        reduction.mMin = value < reduction.mMin ? value : reduction.mMin;
+        reduction.mMax = value > reduction.mMax ? value : reduction.mMax;
+        reduction.mSum += value;
+        ++reduction.mCount;
+    }
+}
+
+// result = value * scale + offset, missing values stay missing.
+inline void linearScalar(const double *values, double *result, std::size_t count, double scale, double offset, double missing)
+{
+    for (std::size_t i = 0; i < count; ++i) {
+        double value = values[i];
+        result[i] = value == missing ? missing : value * scale + offset;
+    }
+}
+
+// Returns power, if it is an integer from 1 to 16, otherwise 0. Such
+// powers of the distance are computed from the squared distance by
+// multiplications and a square root instead of exp and log.
+inline int integerPower(double power)
+{
+    return power == static_cast<int>(power) && power >= 1 && power <= 16 ? static_cast<int>(power) : 0;
+}
+
+inline double inverseDistanceWeightScalar(double squared, double power, int exponent)
+{
+    if (exponent == 0) {
+        return std::exp(-0.5 * power * std::log(squared));
+    }
+    double product = exponent & 1 ? std::sqrt(squared) : 1;
+    for (int i = 1; i < exponent; i += 2) {
+        product *= squared;
+    }
+    return 1 / product;
+}
+
+// Inverse distance weighting of count cells with the given number of
+// neighbours. The neighbours are stored neighbour major, i.e. the squared
+// distance and the value of neighbour j of cell i are at j * stride + i.
+// The weight is squared^(-power / 2), an infinite squared distance marks
+// an unused neighbour. Squared distances are clamped to minSquared, so a
+// neighbour at the cell dominates. A cell without neighbours is NaN.
+inline void inverseDistanceScalar(const double *squared, const double *values, std::size_t stride, std::size_t count,
+                                  std::size_t neighbours, double power, double minSquared, double *result)
+{
+    const int exponent = integerPower(power);
+    for (std::size_t i = 0; i < count; ++i) {
+        double weightSum = 0;
+        double valueSum = 0;
+        for (std::size_t j = 0; j < neighbours; ++j) {
+            double distance = squared[j * stride + i];
+            if (distance == std::numeric_limits<double>::infinity()) {
+                continue;
+            }
+            double weight = inverseDistanceWeightScalar(distance < minSquared ? minSquared : distance, power, exponent);
+            weightSum += weight;
+            valueSum += weight * values[j * stride + i];
+        }
+        result[i] = valueSum / weightSum;
+    }
+}
+
+#ifdef __SSE2__
+
+inline __m128d select(__m128d mask, __m128d a, __m128d b)
+{
+    return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b));
+}
+
+inline double horizontalMin(__m128d value)
+{
+    return _mm_cvtsd_f64(_mm_min_sd(value, _mm_unpackhi_pd(value, value)));
+}
+
+inline double horizontalMax(__m128d value)
+{
+    return _mm_cvtsd_f64(_mm_max_sd(value, _mm_unpackhi_pd(value, value)));
+}
+
+inline double horizontalSum(__m128d value)
+{
+    return _mm_cvtsd_f64(_mm_add_sd(value, _mm_unpackhi_pd(value, value)));
+}
+
+// Missing values are replaced by the neutral element of each reduction.
+// Two independent accumulators hide the latency of the additions.
+inline void reduce(const double *values, std::size_t count, double missing, Reduction &reduction)
+{
+    const __m128d vMissing = _mm_set1_pd(missing);
+    const __m128d vInfinity = _mm_set1_pd(std::numeric_limits<double>::infinity());
+    const __m128d vNegInfinity = _mm_set1_pd(-std::numeric_limits<double>::infinity());
+    __m128d vMin0 = vInfinity, vMin1 = vInfinity;
+    __m128d vMax0 = vNegInfinity, vMax1 = vNegInfinity;
+    __m128d vSum0 = _mm_setzero_pd(), vSum1 = _mm_setzero_pd();
+    std::size_t valid = 0;
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128d v0 = _mm_loadu_pd(values + i);
+        __m128d v1 = _mm_loadu_pd(values + i + 2);
+        __m128d mask0 = _mm_cmpneq_pd(v0, vMissing);
+        __m128d mask1 = _mm_cmpneq_pd(v1, vMissing);
+        vMin0 = _mm_min_pd(vMin0, select(mask0, v0, vInfinity));
+        vMin1 = _mm_min_pd(vMin1, select(mask1, v1, vInfinity));
+        vMax0 = _mm_max_pd(vMax0, select(mask0, v0, vNegInfinity));
+        vMax1 = _mm_max_pd(vMax1, select(mask1, v1, vNegInfinity));
+        vSum0 = _mm_add_pd(vSum0, _mm_and_pd(mask0, v0));
+        vSum1 = _mm_add_pd(vSum1, _mm_and_pd(mask1, v1));
+        int bits = _mm_movemask_pd(mask0) | (_mm_movemask_pd(mask1) << 2);
+        valid += static_cast<std::size_t>((bits & 1) + ((bits >> 1) & 1) + ((bits >> 2) & 1) + ((bits >> 3) & 1));
+    }
+    if (valid > 0) {
+        double minimum = horizontalMin(_mm_min_pd(vMin0, vMin1));
+        double maximum = horizontalMax(_mm_max_pd(vMax0, vMax1));
+        reduction.mMin = minimum < reduction.mMin ? minimum : reduction.mMin;
+        reduction.mMax = maximum > reduction.mMax ? maximum : reduction.mMax;
+        reduction.mSum += horizontalSum(_mm_add_pd(vSum0, vSum1));
+        reduction.mCount += valid;
+    }
+    reduceScalar(values + i, count - i, missing, reduction);
+}
+
+inline void linear(const double *values, double *result, std::size_t count, double scale, double offset, double missing)
+{
+    const __m128d vMissing = _mm_set1_pd(missing);
+    const __m128d vScale = _mm_set1_pd(scale);
+    const __m128d vOffset = _mm_set1_pd(offset);
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128d v0 = _mm_loadu_pd(values + i);
+        __m128d v1 = _mm_loadu_pd(values + i + 2);
+        __m128d r0 = _mm_add_pd(_mm_mul_pd(v0, vScale), vOffset);
+        __m128d r1 = _mm_add_pd(_mm_mul_pd(v1, vScale), vOffset);
+        _mm_storeu_pd(result + i, select(_mm_cmpneq_pd(v0, vMissing), r0, vMissing));
+        _mm_storeu_pd(result + i + 2, select(_mm_cmpneq_pd(v1, vMissing), r1, vMissing));
+    }
+    linearScalar(values + i, result + i, count - i, scale, offset, missing);
+}
+
+// exp(x) with a relative error below 1e-15. The argument is reduced to
+// r = x - n * ln(2) with |r| <= ln(2) / 2, exp(r) is the rational
+// approximation of Cephes and 2^n is built in the exponent bits.
+// x is clamped to [-708, 709].
+inline __m128d exp(__m128d x)
+{
+    x = _mm_min_pd(_mm_max_pd(x, _mm_set1_pd(-708.0)), _mm_set1_pd(709.0));
+    __m128i n = _mm_cvtpd_epi32(_mm_mul_pd(x, _mm_set1_pd(1.4426950408889634)));
+    __m128d nd = _mm_cvtepi32_pd(n);
+    __m128d r = _mm_sub_pd(x, _mm_mul_pd(nd, _mm_set1_pd(6.93145751953125e-1)));
+    r = _mm_sub_pd(r, _mm_mul_pd(nd, _mm_set1_pd(1.42860682030941723212e-6)));
+    __m128d r2 = _mm_mul_pd(r, r);
+    __m128d p = _mm_set1_pd(1.26177193074810590878e-4);
+    p = _mm_add_pd(_mm_mul_pd(p, r2), _mm_set1_pd(3.02994407707441961300e-2));
+    p = _mm_add_pd(_mm_mul_pd(p, r2), _mm_set1_pd(9.99999999999999999910e-1));
+    p = _mm_mul_pd(p, r);
+    __m128d q = _mm_set1_pd(3.00198505138664455042e-6);
+    q = _mm_add_pd(_mm_mul_pd(q, r2), _mm_set1_pd(2.52448340349684104192e-3));
+    q = _mm_add_pd(_mm_mul_pd(q, r2), _mm_set1_pd(2.27265548208155028766e-1));
+    q = _mm_add_pd(_mm_mul_pd(q, r2), _mm_set1_pd(2.00000000000000000009e0));
+    __m128d result = _mm_div_pd(p, _mm_sub_pd(q, p));
+    result = _mm_add_pd(_mm_set1_pd(1.0), _mm_add_pd(result, result));
+    __m128i exponent = _mm_add_epi32(n, _mm_set1_epi32(1023));
+    exponent = _mm_slli_epi64(_mm_unpacklo_epi32(exponent, _mm_setzero_si128()), 52);
+    return _mm_mul_pd(result, _mm_castsi128_pd(exponent));
+}
+
+// log(x) for positive, normal x with a relative error below 1e-14.
+// x = 2^e * m with sqrt(2) / 2 < m <= sqrt(2), and
+// log(m) = 2 * atanh(s) with s = (m - 1) / (m + 1) as odd series.
+inline __m128d log(__m128d x)
+{
+    const __m128d one = _mm_set1_pd(1.0);
+    __m128i exponent = _mm_srli_epi64(_mm_castpd_si128(x), 52);
+    exponent = _mm_shuffle_epi32(exponent, _MM_SHUFFLE(3, 1, 2, 0));
+    __m128d e = _mm_sub_pd(_mm_cvtepi32_pd(exponent), _mm_set1_pd(1023.0));
+    __m128d m = _mm_or_pd(_mm_and_pd(x, _mm_castsi128_pd(_mm_set1_epi64x(0x000FFFFFFFFFFFFFLL))), one);
+    __m128d large = _mm_cmpgt_pd(m, _mm_set1_pd(1.4142135623730951));
+    m = select(large, _mm_mul_pd(m, _mm_set1_pd(0.5)), m);
+    e = _mm_add_pd(e, _mm_and_pd(large, one));
+    __m128d s = _mm_div_pd(_mm_sub_pd(m, one), _mm_add_pd(m, one));
+    __m128d s2 = _mm_mul_pd(s, s);
+    __m128d p = _mm_set1_pd(1.0 / 19);
+    p = _mm_add_pd(_mm_mul_pd(p, s2), _mm_set1_pd(1.0 / 17));
+    p = _mm_add_pd(_mm_mul_pd(p, s2), _mm_set1_pd(1.0 / 15));
+    p = _mm_add_pd(_mm_mul_pd(p, s2), _mm_set1_pd(1.0 / 13));
+    p = _mm_add_pd(_mm_mul_pd(p, s2), _mm_set1_pd(1.0 / 11));
+    p = _mm_add_pd(_mm_mul_pd(p, s2), _mm_set1_pd(1.0 / 9));
+    p = _mm_add_pd(_mm_mul_pd(p, s2), _mm_set1_pd(1.0 / 7));
+    p = _mm_add_pd(_mm_mul_pd(p, s2), _mm_set1_pd(1.0 / 5));
+    p = _mm_add_pd(_mm_mul_pd(p, s2), _mm_set1_pd(1.0 / 3));
+    p = _mm_add_pd(_mm_mul_pd(p, s2), one);
+    __m128d result = _mm_mul_pd(_mm_set1_pd(2.0), _mm_mul_pd(s, p));
+    result = _mm_add_pd(result, _mm_mul_pd(e, _mm_set1_pd(1.42860682030941723212e-6)));
+    return _mm_add_pd(result, _mm_mul_pd(e, _mm_set1_pd(6.93145751953125e-1)));
+}
+
+// Weights of two cells for inverseDistance().
+inline __m128d inverseDistanceWeight(__m128d squared, __m128d power, __m128d minSquared, int exponent)
+{
+    __m128d used = _mm_cmpneq_pd(squared, _mm_set1_pd(std::numeric_limits<double>::infinity()));
+    squared = _mm_max_pd(squared, minSquared);
+    __m128d weight;
+    if (exponent == 0) {
+        weight = exp(_mm_mul_pd(_mm_mul_pd(_mm_set1_pd(-0.5), power), log(squared)));
+    } else {
+        __m128d product = exponent & 1 ? _mm_sqrt_pd(squared) : _mm_set1_pd(1.0);
+        for (int i = 1; i < exponent; i += 2) {
+            product = _mm_mul_pd(product, squared);
+        }
+        weight = _mm_div_pd(_mm_set1_pd(1.0), product);
+    }
+    return _mm_and_pd(used, weight);
+}
+
+// Every lane is one cell, so the weights of four cells are computed at once.
+inline void inverseDistance(const double *squared, const double *values, std::size_t count,
+                            std::size_t neighbours, double power, double minSquared, double *result)
+{
+    const __m128d vPower = _mm_set1_pd(power);
+    const __m128d vMinSquared = _mm_set1_pd(minSquared);
+    const int exponent = integerPower(power);
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128d weightSum0 = _mm_setzero_pd(), weightSum1 = _mm_setzero_pd();
+        __m128d valueSum0 = _mm_setzero_pd(), valueSum1 = _mm_setzero_pd();
+        for (std::size_t j = 0; j < neighbours; ++j) {
+            const double *s = squared + j * count + i;
+            const double *v = values + j * count + i;
+            __m128d w0 = inverseDistanceWeight(_mm_loadu_pd(s), vPower, vMinSquared, exponent);
+            __m128d w1 = inverseDistanceWeight(_mm_loadu_pd(s + 2), vPower, vMinSquared, exponent);
+            weightSum0 = _mm_add_pd(weightSum0, w0);
+            weightSum1 = _mm_add_pd(weightSum1, w1);
+            valueSum0 = _mm_add_pd(valueSum0, _mm_mul_pd(w0, _mm_loadu_pd(v)));
+            valueSum1 = _mm_add_pd(valueSum1, _mm_mul_pd(w1, _mm_loadu_pd(v + 2)));
+        }
+        _mm_storeu_pd(result + i, _mm_div_pd(valueSum0, weightSum0));
+        _mm_storeu_pd(result + i + 2, _mm_div_pd(valueSum1, weightSum1));
+    }
+    inverseDistanceScalar(squared + i, values + i, count, count - i, neighbours, power, minSquared, result + i);
+}
+
+#else
+
+inline void reduce(const double *values, std::size_t count, double missing, Reduction &reduction)
+{
+    reduceScalar(values, count, missing, reduction);
+}
+
+inline void linear(const double *values, double *result, std::size_t count, double scale, double offset, double missing)
+{
+    linearScalar(values, result, count, scale, offset, missing);
+}
+
+inline void inverseDistance(const double *squared, const double *values, std::size_t count,
+                            std::size_t neighbours, double power, double minSquared, double *result)
+{
+    inverseDistanceScalar(squared, values, count, count, neighbours, power, minSquared, result);
+}
+
+#endif
+
+}
+
+}
+
+#endif /* SIMD_HPP */
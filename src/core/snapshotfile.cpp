@@ -0,0 +1,513 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "snapshotfile.h"
+#include "mappedfile.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace netatmoapi {
+
+namespace {
+
+const char cMagic[8] = { 'N', 'A', 'S', 'N', 'A', 'P', '\0', '\0' };
+const uint32_t cByteOrder = 0x01020304;
+
+// Makes the temporary file names of the writers of a process unique.
+atomic<unsigned long> sTmpCounter(0);
+
+// The directory of a path, which is synced after a rename().
+string parentDirectory(const string &path) {
+    size_t slash = path.rfind('/');
+    if (slash == string::npos) {
+        return ".";
+    }
+    return slash == 0 ? string("/") : path.substr(0, slash);
+}
+
+void syncDirectory(const string &directory) {
+    int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        throw system_error(errno, generic_category(), "Can not open " + directory);
+    }
+    int result = ::fsync(fd);
+    int error = errno;
+    ::close(fd);
+    if (result != 0) {
+        throw system_error(error, generic_category(), "Can not sync " + directory);
+    }
+}
+
+struct SnapshotHeader {
+    char mMagic[8];
+    uint32_t mVersion;
+    uint32_t mByteOrder;
+    uint32_t mFieldCount;
+    uint32_t mReserved;
+    uint64_t mStationCount;
+    uint64_t mModuleCount;
+    uint64_t mStationsOffset;
+    uint64_t mModulesOffset;
+    uint64_t mIndexOffset;
+    uint64_t mStringsOffset;
+    uint64_t mStringsSize;
+};
+
+struct SnapshotIndexEntry {
+    uint32_t mId;
+    uint32_t mModule;
+};
+
+size_t align8(size_t size) {
+    return (size + 7) & ~size_t(7);
+}
+
+}
+
+struct SnapshotStationRecord {
+    uint32_t mName;
+    uint32_t mId;
+    uint32_t mFirstModule;
+    uint32_t mModuleCount;
+    // The place of the station, since version 2.
+    double mLatitude;
+    double mLongitude;
+    double mAltitude;
+    uint32_t mCity;
+    uint32_t mCountry;
+    uint32_t mTimeZone;
+    uint32_t mReserved;
+};
+
+struct SnapshotModuleRecord {
+    uint32_t mName;
+    uint32_t mId;
+    uint32_t mType;
+    uint32_t mStation;
+    int16_t mBatteryPercent;
+    int16_t mRfStatus;
+    uint32_t mReserved;
+    uint64_t mTimeStamp;
+    double mValues[Measures::fieldCount];
+};
+
+struct SnapshotFilePrivate {
+    SnapshotFilePrivate() :
+        mStations(nullptr),
+        mModules(nullptr),
+        mIndex(nullptr),
+        mStrings(nullptr),
+        mStationCount(0),
+        mModuleCount(0)
+    {}
+    void open(const string &path);
+    MappedFile mFile;
+    const SnapshotStationRecord *mStations;
+    const SnapshotModuleRecord *mModules;
+    const SnapshotIndexEntry *mIndex;
+    const char *mStrings;
+    size_t mStationCount;
+    size_t mModuleCount;
+};
+
+void SnapshotFilePrivate::open(const string &path) {
+    mFile = MappedFile(path);
+    const char *data = mFile.data();
+    size_t size = mFile.size();
+    if (size < sizeof(SnapshotHeader)) {
+        throw runtime_error("Invalid snapshot file: " + path);
+    }
+    const SnapshotHeader *header = reinterpret_cast<const SnapshotHeader *>(data);
+    if (memcmp(header->mMagic, cMagic, sizeof(cMagic)) != 0 || header->mByteOrder != cByteOrder) {
+        throw runtime_error("Invalid snapshot file: " + path);
+    }
+    if (header->mVersion != SnapshotFile::sVersion || header->mFieldCount != Measures::fieldCount) {
+        throw runtime_error("Unsupported snapshot version: " + path);
+    }
+
+    auto sectionFits = [size](uint64_t offset, uint64_t count, uint64_t elementSize) {
+        return offset % 8 == 0 && offset <= size && count <= (size - offset) / elementSize;
+    };
+    if (!sectionFits(header->mStationsOffset, header->mStationCount, sizeof(SnapshotStationRecord))
+            || !sectionFits(header->mModulesOffset, header->mModuleCount, sizeof(SnapshotModuleRecord))
+            || !sectionFits(header->mIndexOffset, header->mModuleCount, sizeof(SnapshotIndexEntry))
+            || header->mStringsOffset > size || header->mStringsSize > size - header->mStringsOffset
+            || header->mStringsSize == 0 || data[header->mStringsOffset + header->mStringsSize - 1] != '\0') {
+        throw runtime_error("Corrupt snapshot file: " + path);
+    }
+
+    mStationCount = header->mStationCount;
+    mModuleCount = header->mModuleCount;
+    mStations = reinterpret_cast<const SnapshotStationRecord *>(data + header->mStationsOffset);
+    mModules = reinterpret_cast<const SnapshotModuleRecord *>(data + header->mModulesOffset);
+    mIndex = reinterpret_cast<const SnapshotIndexEntry *>(data + header->mIndexOffset);
+    mStrings = data + header->mStringsOffset;
+
+    // Check the references once, so the accessors do not need to.
+    uint64_t stringsSize = header->mStringsSize;
+    for (size_t i = 0; i < mStationCount; ++i) {
+        const SnapshotStationRecord &station = mStations[i];
+        if (station.mName >= stringsSize || station.mId >= stringsSize || station.mCity >= stringsSize
+                || station.mCountry >= stringsSize || station.mTimeZone >= stringsSize
+                || station.mFirstModule > mModuleCount || station.mModuleCount > mModuleCount - station.mFirstModule) {
+            throw runtime_error("Corrupt snapshot file: " + path);
+        }
+    }
+    for (size_t i = 0; i < mModuleCount; ++i) {
+        const SnapshotModuleRecord &module = mModules[i];
+        if (module.mName >= stringsSize || module.mId >= stringsSize || module.mType >= stringsSize
+                || module.mStation >= mStationCount || mIndex[i].mId >= stringsSize || mIndex[i].mModule >= mModuleCount) {
+            throw runtime_error("Corrupt snapshot file: " + path);
+        }
+    }
+}
+
+const uint32_t SnapshotFile::sVersion = 2;
+
+SnapshotFile::ModuleView::ModuleView() :
+    mStrings(nullptr),
+    mRecord(nullptr) {
+}
+
+SnapshotFile::ModuleView::ModuleView(const char *strings, const SnapshotModuleRecord *record) :
+    mStrings(strings),
+    mRecord(record) {
+}
+
+bool SnapshotFile::ModuleView::isNull() const {
+    return mRecord == nullptr;
+}
+
+const char *SnapshotFile::ModuleView::name() const {
+    return mStrings + mRecord->mName;
+}
+
+const char *SnapshotFile::ModuleView::id() const {
+    return mStrings + mRecord->mId;
+}
+
+const char *SnapshotFile::ModuleView::type() const {
+    return mStrings + mRecord->mType;
+}
+
+int16_t SnapshotFile::ModuleView::batteryPercent() const {
+    return mRecord->mBatteryPercent;
+}
+
+int16_t SnapshotFile::ModuleView::rfStatus() const {
+    return mRecord->mRfStatus;
+}
+
+uint64_t SnapshotFile::ModuleView::timeStamp() const {
+    return mRecord->mTimeStamp;
+}
+
+double SnapshotFile::ModuleView::value(Measures::Field field) const {
+    return mRecord->mValues[field];
+}
+
+Measures SnapshotFile::ModuleView::measures() const {
+    Measures measures;
+    measures.mTimeStamp = mRecord->mTimeStamp;
+    for (int field = 0; field < Measures::fieldCount; ++field) {
+        measures.setValue(static_cast<Measures::Field>(field), mRecord->mValues[field]);
+    }
+    return measures;
+}
+
+size_t SnapshotFile::ModuleView::stationIndex() const {
+    return mRecord->mStation;
+}
+
+Module SnapshotFile::ModuleView::toModule() const {
+    Module module(name(), id(), type(), mRecord->mBatteryPercent, mRecord->mRfStatus);
+    module.setMeasures(measures());
+    return module;
+}
+
+SnapshotFile::StationView::StationView() :
+    mStrings(nullptr),
+    mRecord(nullptr),
+    mModules(nullptr) {
+}
+
+SnapshotFile::StationView::StationView(const char *strings, const SnapshotStationRecord *record, const SnapshotModuleRecord *modules) :
+    mStrings(strings),
+    mRecord(record),
+    mModules(modules) {
+}
+
+bool SnapshotFile::StationView::isNull() const {
+    return mRecord == nullptr;
+}
+
+const char *SnapshotFile::StationView::name() const {
+    return mStrings + mRecord->mName;
+}
+
+const char *SnapshotFile::StationView::id() const {
+    return mStrings + mRecord->mId;
+}
+
+Place SnapshotFile::StationView::place() const {
+    Place place;
+    place.mLatitude = mRecord->mLatitude;
+    place.mLongitude = mRecord->mLongitude;
+    place.mAltitude = mRecord->mAltitude;
+    place.mCity = mStrings + mRecord->mCity;
+    place.mCountry = mStrings + mRecord->mCountry;
+    place.mTimeZone = mStrings + mRecord->mTimeZone;
+    return place;
+}
+
+size_t SnapshotFile::StationView::moduleCount() const {
+    return mRecord->mModuleCount;
+}
+
+SnapshotFile::ModuleView SnapshotFile::StationView::module(size_t index) const {
+    return ModuleView(mStrings, mModules + mRecord->mFirstModule + index);
+}
+
+Station SnapshotFile::StationView::toStation() const {
+    Station station(name(), id());
+    station.setPlace(place());
+    for (size_t i = 0; i < moduleCount(); ++i) {
+        station.addModule(module(i).toModule());
+    }
+    return station;
+}
+
+SnapshotFile::SnapshotFile() :
+    d(new SnapshotFilePrivate) {
+}
+
+SnapshotFile::SnapshotFile(const string &path) :
+    d(new SnapshotFilePrivate) {
+    d->open(path);
+}
+
+SnapshotFile::SnapshotFile(SnapshotFile &&o) noexcept :
+    d(move(o.d)) {
+}
+
+SnapshotFile::~SnapshotFile() noexcept = default;
+
+size_t SnapshotFile::stationCount() const {
+    return d->mStationCount;
+}
+
+size_t SnapshotFile::moduleCount() const {
+    return d->mModuleCount;
+}
+
+SnapshotFile::StationView SnapshotFile::station(size_t index) const {
+    return StationView(d->mStrings, d->mStations + index, d->mModules);
+}
+
+SnapshotFile::ModuleView SnapshotFile::module(size_t index) const {
+    return ModuleView(d->mStrings, d->mModules + index);
+}
+
+SnapshotFile::StationView SnapshotFile::findStation(const string &id) const {
+    ModuleView module = findModule(id);
+    if (module.isNull()) {
+        return StationView();
+    }
+    StationView station = this->station(module.stationIndex());
+    if (id != station.id()) {
+        return StationView();
+    }
+    return station;
+}
+
+SnapshotFile::ModuleView SnapshotFile::findModule(const string &id) const {
+    const SnapshotIndexEntry *begin = d->mIndex;
+    const SnapshotIndexEntry *end = d->mIndex + d->mModuleCount;
+    const char *strings = d->mStrings;
+    const SnapshotIndexEntry *it = lower_bound(begin, end, id.c_str(), [strings](const SnapshotIndexEntry &entry, const char *value) {
+        return strcmp(strings + entry.mId, value) < 0;
+    });
+    if (it == end || strcmp(strings + it->mId, id.c_str()) != 0) {
+        return ModuleView();
+    }
+    return module(it->mModule);
+}
+
+list<Station> SnapshotFile::toStations() const {
+    list<Station> stations;
+    for (size_t i = 0; i < d->mStationCount; ++i) {
+        stations.emplace_back(station(i).toStation());
+    }
+    return stations;
+}
+
+SnapshotFile &SnapshotFile::operator =(SnapshotFile &&o) noexcept {
+    d = move(o.d);
+    return *this;
+}
+
+void SnapshotFile::write(const string &path, const list<Station> &stations) {
+    vector<SnapshotStationRecord> stationRecords;
+    vector<SnapshotModuleRecord> moduleRecords;
+    string strings;
+    unordered_map<string, uint32_t> stringOffsets;
+    auto addString = [&strings, &stringOffsets](string &&value) {
+        auto it = stringOffsets.find(value);
+        if (it != stringOffsets.end()) {
+            return it->second;
+        }
+        if (strings.size() + value.size() + 1 > numeric_limits<uint32_t>::max()) {
+            throw length_error("Snapshot string table too large.");
+        }
+        uint32_t offset = static_cast<uint32_t>(strings.size());
+        strings.append(value);
+        strings.push_back('\0');
+        stringOffsets.emplace(move(value), offset);
+        return offset;
+    };
+
+    stationRecords.reserve(stations.size());
+    for (const Station &station: stations) {
+        const list<Module> &modules = station.modulesRef();
+        if (moduleRecords.size() + modules.size() > numeric_limits<uint32_t>::max()) {
+            throw length_error("Snapshot has too many modules.");
+        }
+        SnapshotStationRecord stationRecord;
+        stationRecord.mName = addString(station.name());
+        stationRecord.mId = addString(station.id());
+        stationRecord.mFirstModule = static_cast<uint32_t>(moduleRecords.size());
+        stationRecord.mModuleCount = static_cast<uint32_t>(modules.size());
+        const Place &place = station.placeRef();
+        stationRecord.mLatitude = place.mLatitude;
+        stationRecord.mLongitude = place.mLongitude;
+        stationRecord.mAltitude = place.mAltitude;
+        stationRecord.mCity = addString(string(place.mCity));
+        stationRecord.mCountry = addString(string(place.mCountry));
+        stationRecord.mTimeZone = addString(string(place.mTimeZone));
+        stationRecord.mReserved = 0;
+        for (const Module &module: modules) {
+            Measures measures = module.measures();
+            SnapshotModuleRecord moduleRecord;
+            moduleRecord.mName = addString(module.name());
+            moduleRecord.mId = addString(module.id());
+            moduleRecord.mType = addString(module.type());
+            moduleRecord.mStation = static_cast<uint32_t>(stationRecords.size());
+            moduleRecord.mBatteryPercent = module.batteryPercent();
+            moduleRecord.mRfStatus = module.rfStatus();
+            moduleRecord.mReserved = 0;
+            moduleRecord.mTimeStamp = measures.mTimeStamp;
+            for (int field = 0; field < Measures::fieldCount; ++field) {
+                moduleRecord.mValues[field] = measures.value(static_cast<Measures::Field>(field));
+            }
+            moduleRecords.push_back(moduleRecord);
+        }
+        stationRecords.push_back(stationRecord);
+    }
+    if (strings.empty()) {
+        strings.push_back('\0');
+    }
+
+    vector<SnapshotIndexEntry> index(moduleRecords.size());
+    for (size_t i = 0; i < moduleRecords.size(); ++i) {
+        index[i].mId = moduleRecords[i].mId;
+        index[i].mModule = static_cast<uint32_t>(i);
+    }
+    const char *stringData = strings.data();
+    stable_sort(index.begin(), index.end(), [stringData](const SnapshotIndexEntry &a, const SnapshotIndexEntry &b) {
+        return strcmp(stringData + a.mId, stringData + b.mId) < 0;
+    });
+
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.mMagic, cMagic, sizeof(cMagic));
+    header.mVersion = sVersion;
+    header.mByteOrder = cByteOrder;
+    header.mFieldCount = Measures::fieldCount;
+    header.mStationCount = stationRecords.size();
+    header.mModuleCount = moduleRecords.size();
+    header.mStationsOffset = align8(sizeof(header));
+    header.mModulesOffset = align8(header.mStationsOffset + stationRecords.size() * sizeof(SnapshotStationRecord));
+    header.mIndexOffset = align8(header.mModulesOffset + moduleRecords.size() * sizeof(SnapshotModuleRecord));
+    header.mStringsOffset = align8(header.mIndexOffset + index.size() * sizeof(SnapshotIndexEntry));
+    header.mStringsSize = strings.size();
+
+    string buffer(header.mStringsOffset + header.mStringsSize, '\0');
+    memcpy(&buffer[0], &header, sizeof(header));
+    if (!stationRecords.empty()) {
+        memcpy(&buffer[header.mStationsOffset], stationRecords.data(), stationRecords.size() * sizeof(SnapshotStationRecord));
+    }
+    if (!moduleRecords.empty()) {
+        memcpy(&buffer[header.mModulesOffset], moduleRecords.data(), moduleRecords.size() * sizeof(SnapshotModuleRecord));
+        memcpy(&buffer[header.mIndexOffset], index.data(), index.size() * sizeof(SnapshotIndexEntry));
+    }
+    memcpy(&buffer[header.mStringsOffset], strings.data(), strings.size());
+
+    // Concurrent writers of the same path, in this or other processes, use their own temporary file.
+    string tmpPath = path + ".tmp." + to_string(::getpid()) + "." + to_string(sTmpCounter++);
+    int fd = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw system_error(errno, generic_category(), "Can not open " + tmpPath);
+    }
+    const char *data = buffer.data();
+    size_t remaining = buffer.size();
+    while (remaining > 0) {
+        ssize_t written = ::write(fd, data, remaining);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            int error = errno;
+            ::close(fd);
+            ::unlink(tmpPath.c_str());
+            throw system_error(error, generic_category(), "Can not write " + tmpPath);
+        }
+        data += written;
+        remaining -= static_cast<size_t>(written);
+    }
+    // The file is closed even if fsync() fails, the first error is reported.
+    int error = ::fsync(fd) != 0 ? errno : 0;
+    if (::close(fd) != 0 && error == 0) {
+        error = errno;
+    }
+    if (error != 0) {
+        ::unlink(tmpPath.c_str());
+        throw system_error(error, generic_category(), "Can not write " + tmpPath);
+    }
+    if (::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        int error = errno;
+        ::unlink(tmpPath.c_str());
+        throw system_error(error, generic_category(), "Can not rename " + tmpPath);
+    }
+    // Makes the rename durable.
+    syncDirectory(parentDirectory(path));
+}
+
+}
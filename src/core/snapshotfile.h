@@ -0,0 +1,307 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef SNAPSHOTFILE_H
+#define SNAPSHOTFILE_H
+
+#include "model/station.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+
+namespace netatmoapi {
+
+struct SnapshotFilePrivate;
+struct SnapshotStationRecord;
+struct SnapshotModuleRecord;
+
+/**
+ * @brief This class provides read access to a binary snapshot of a parsed fleet.
+ *
+ * A snapshot is written with write() and stores a std::list<Station> in a
+ * versioned binary format: a header, fixed-size station and module
+ * records, an index of the module ids and a string table.
+ *
+ * Opening a snapshot maps the file into memory and checks the header
+ * and the record bounds. There is no deserialization step, the accessors
+ * of StationView and ModuleView read directly from the mapped file. The
+ * file is written in the byte order of the host and is not portable
+ * between hosts with different byte order.
+ *
+ * The views are valid as long as the SnapshotFile exists.
+ */
+class SnapshotFile {
+public:
+    /**
+     * @brief Read-only view of a module record.
+     */
+    class ModuleView {
+    public:
+        /**
+         * Constructs a null view.
+         */
+        ModuleView();
+
+        /**
+         * Returns true, if the view does not refer to a module, e.g. if findModule() failed.
+         * @return True for a null view.
+         */
+        bool isNull() const;
+
+        /**
+         * Returns the name of the module.
+         * @return The name.
+         */
+        const char *name() const;
+
+        /**
+         * Returns the id of the module.
+         * @return The id.
+         */
+        const char *id() const;
+
+        /**
+         * Returns the type of the module.
+         * @return The type.
+         */
+        const char *type() const;
+
+        /**
+         * Returns the battery state of the module.
+         * @return The battery state.
+         */
+        std::int16_t batteryPercent() const;
+
+        /**
+         * Returns the wifi state of the module.
+         * @return The wifi state.
+         */
+        std::int16_t rfStatus() const;
+
+        /**
+         * Returns the measure timestamp of the module.
+         * @return The timestamp.
+         */
+        std::uint64_t timeStamp() const;
+
+        /**
+         * Returns a single measure value of the module.
+         * @param field The measure value.
+         * @return The value, see Measures::value().
+         */
+        double value(Measures::Field field) const;
+
+        /**
+         * Returns the measures of the module.
+         * @return The measures.
+         */
+        Measures measures() const;
+
+        /**
+         * Returns the index of the station of the module.
+         * @return The station index.
+         */
+        std::size_t stationIndex() const;
+
+        /**
+         * Converts the record into a Module.
+         * @return The module.
+         */
+        Module toModule() const;
+
+    private:
+        friend class SnapshotFile;
+        ModuleView(const char *strings, const SnapshotModuleRecord *record);
+        const char *mStrings;
+        const SnapshotModuleRecord *mRecord;
+    };
+
+    /**
+     * @brief Read-only view of a station record.
+     */
+    class StationView {
+    public:
+        /**
+         * Constructs a null view.
+         */
+        StationView();
+
+        /**
+         * Returns true, if the view does not refer to a station, e.g. if findStation() failed.
+         * @return True for a null view.
+         */
+        bool isNull() const;
+
+        /**
+         * Returns the name of the station.
+         * @return The name.
+         */
+        const char *name() const;
+
+        /**
+         * Returns the id of the station.
+         * @return The id.
+         */
+        const char *id() const;
+
+        /**
+         * Returns the place of the station.
+         * @return The place, without location, if the station had none.
+         */
+        Place place() const;
+
+        /**
+         * Returns the number of modules of the station, including the main module.
+         * @return The number of modules.
+         */
+        std::size_t moduleCount() const;
+
+        /**
+         * Returns a module of the station.
+         * @param index The index of the module in the station, less than moduleCount().
+         * @return The module.
+         */
+        ModuleView module(std::size_t index) const;
+
+        /**
+         * Converts the record into a Station with all modules.
+         * @return The station.
+         */
+        Station toStation() const;
+
+    private:
+        friend class SnapshotFile;
+        StationView(const char *strings, const SnapshotStationRecord *record, const SnapshotModuleRecord *modules);
+        const char *mStrings;
+        const SnapshotStationRecord *mRecord;
+        const SnapshotModuleRecord *mModules;
+    };
+
+    /**
+     * Default constructor.
+     * Constructs an empty snapshot.
+     */
+    SnapshotFile();
+
+    /**
+     * Constructor, which opens a snapshot file.
+     * @param path The path of the snapshot file.
+     * @throw std::system_error If the file can not be opened or mapped.
+     * @throw std::runtime_error If the file is not a valid snapshot.
+     */
+    explicit SnapshotFile(const std::string &path);
+
+    SnapshotFile(const SnapshotFile &o) = delete;
+
+    /**
+     * Move constructor.
+     * @param o The element to move.
+     */
+    SnapshotFile(SnapshotFile &&o) noexcept;
+
+    /**
+     * Destructor.
+     * Unmaps the file.
+     */
+    virtual ~SnapshotFile() noexcept;
+
+    /**
+     * Returns the number of stations.
+     * @return The number of stations.
+     */
+    std::size_t stationCount() const;
+
+    /**
+     * Returns the number of modules of all stations.
+     * @return The number of modules.
+     */
+    std::size_t moduleCount() const;
+
+    /**
+     * Returns a station.
+     * @param index The index of the station, less than stationCount().
+     * @return The station.
+     */
+    StationView station(std::size_t index) const;
+
+    /**
+     * Returns a module.
+     * @param index The index of the module, less than moduleCount().
+     * @return The module.
+     */
+    ModuleView module(std::size_t index) const;
+
+    /**
+     * Looks up a station by id.
+     * @param id The station id.
+     * @return The station, or a null view if the id is unknown.
+     */
+    StationView findStation(const std::string &id) const;
+
+    /**
+     * Looks up a module by id.
+     * @param id The module id.
+     * @return The module, or a null view if the id is unknown.
+     */
+    ModuleView findModule(const std::string &id) const;
+
+    /**
+     * Converts the snapshot into a list of Stations.
+     * @return The list of Stations.
+     */
+    std::list<Station> toStations() const;
+
+    SnapshotFile &operator =(const SnapshotFile &o) = delete;
+
+    /**
+     * Move assignment operator.
+     * @param o The element to move.
+     * @return This element as reference.
+     */
+    SnapshotFile &operator =(SnapshotFile &&o) noexcept;
+
+    /**
+     * Writes a snapshot file.
+     *
+     * The snapshot is written to a temporary file with a unique name
+     * first, which replaces the file at path afterwards, and the directory
+     * is synced. Processes, which have mapped the old file, keep reading
+     * the old snapshot.
+     *
+     * @param path The path of the snapshot file.
+     * @param stations The stations to write.
+     * @throw std::system_error If the file can not be written.
+     * @throw std::length_error If the fleet is too large for the format.
+     */
+    static void write(const std::string &path, const std::list<Station> &stations);
+
+    /**
+     * The version of the snapshot format.
+     */
+    static const std::uint32_t sVersion;
+
+private:
+    std::unique_ptr<SnapshotFilePrivate> d;
+};
+
+}
+
+#endif /* SNAPSHOTFILE_H */
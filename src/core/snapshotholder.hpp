@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef SNAPSHOTHOLDER_HPP
+#define SNAPSHOTHOLDER_HPP
+
+#include "model/station.h"
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <utility>
+
+namespace netatmoapi {
+
+/**
+ * @brief This class publishes immutable snapshots to concurrent readers.
+ *
+ * A writer builds a new value, e.g. the result of utils::parseDevices(),
+ * and publishes it with a single atomic pointer swap. Readers call load()
+ * and get a reference counted handle to the current snapshot. The handle
+ * stays valid after a newer snapshot is published, and an old snapshot is
+ * destroyed as soon as the last handle to it is released.
+ *
+ * Readers and writers only synchronize on the pointer swap and the
+ * reference count update. A reader never waits for a writer to build or
+ * destroy a snapshot, and a snapshot is never copied.
+ */
+template <typename T>
+class SnapshotHolder {
+public:
+    /**
+     * Handle to a published snapshot.
+     */
+    using Handle = std::shared_ptr<const T>;
+
+    /**
+     * Default constructor.
+     * Publishes a default constructed snapshot.
+     */
+    SnapshotHolder() :
+        mSnapshot(std::make_shared<const T>()) {
+    }
+
+    /**
+     * Constructor with initialization of the first snapshot.
+     * @param snapshot The first snapshot.
+     */
+    explicit SnapshotHolder(T &&snapshot) :
+        mSnapshot(std::make_shared<const T>(std::move(snapshot))) {
+    }
+
+    SnapshotHolder(const SnapshotHolder &) = delete;
+    SnapshotHolder &operator =(const SnapshotHolder &) = delete;
+
+    /**
+     * Returns a handle to the current snapshot.
+     * @return The current snapshot, never nullptr.
+     */
+    Handle load() const noexcept {
+        return std::atomic_load_explicit(&mSnapshot, std::memory_order_acquire);
+    }
+
+    /**
+     * Publishes a new snapshot.
+     * @param snapshot The new snapshot.
+     */
+    void publish(T &&snapshot) {
+        publish(std::make_shared<const T>(std::move(snapshot)));
+    }
+
+    /**
+     * Publishes a new snapshot.
+     * @param snapshot The new snapshot. A nullptr is ignored.
+     */
+    void publish(Handle snapshot) noexcept {
+        if (snapshot) {
+            std::atomic_store_explicit(&mSnapshot, std::move(snapshot), std::memory_order_release);
+        }
+    }
+
+    /**
+     * Publishes a new snapshot and returns the previous one.
+     * @param snapshot The new snapshot. A nullptr is ignored, like in publish().
+     * @return The previous snapshot, or the current snapshot, if snapshot is nullptr.
+     */
+    Handle exchange(Handle snapshot) noexcept {
+        if (!snapshot) {
+            return load();
+        }
+        return std::atomic_exchange_explicit(&mSnapshot, std::move(snapshot), std::memory_order_acq_rel);
+    }
+
+private:
+    Handle mSnapshot;
+};
+
+/**
+ * Snapshot holder for the parsed result of NAWSApiClient::requestStationsData().
+ */
+using StationsSnapshotHolder = SnapshotHolder<std::list<Station>>;
+
+}
+
+#endif /* SNAPSHOTHOLDER_HPP */
@@ -0,0 +1,307 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "stationindex.h"
+#include "kdtree.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+
+using namespace std;
+
+namespace netatmoapi {
+
+namespace {
+
+// The buffer and the removed stations may grow to a fraction of the tree before it is rebuilt.
+const size_t cMinRebuildSize = 256;
+const size_t cBufferFraction = 8;
+const size_t cRemovedFraction = 4;
+
+using kdtree::Candidate;
+using kdtree::Point;
+
+}
+
+struct StationIndexPrivate {
+    StationIndexPrivate() :
+        mTreeIndexCount(0),
+        mRemovedInTree(0)
+    {}
+
+    void clear() {
+        mTree.clear();
+        mBuffer.clear();
+        mIds.clear();
+        mAlive.clear();
+        mBufferPositions.clear();
+        mIndexById.clear();
+        mTreeIndexCount = 0;
+        mRemovedInTree = 0;
+    }
+
+    void add(const string &id, double latitude, double longitude) {
+        uint32_t index = static_cast<uint32_t>(mIds.size());
+        auto it = mIndexById.find(id);
+        if (it != mIndexById.end()) {
+            mAlive[it->second] = 0;
+            it->second = index;
+        } else {
+            mIndexById.emplace(id, index);
+        }
+        mIds.push_back(id);
+        mAlive.push_back(1);
+        mBufferPositions.push_back(static_cast<uint32_t>(mBuffer.size()));
+        mBuffer.push_back(kdtree::toPoint(latitude, longitude, index));
+    }
+
+    // Compacts the indices of the living stations and builds the tree.
+    void rebuild() {
+        vector<Point> points;
+        points.reserve(mIndexById.size());
+        vector<string> ids;
+        ids.reserve(mIndexById.size());
+        const vector<Point> *sources[] = { &mTree.points(), &mBuffer };
+        for (const vector<Point> *source: sources) {
+            for (const Point &point: *source) {
+                if (!mAlive[point.mIndex]) {
+                    continue;
+                }
+                Point moved = point;
+                moved.mIndex = static_cast<uint32_t>(ids.size());
+                ids.push_back(move(mIds[point.mIndex]));
+                points.push_back(moved);
+            }
+        }
+        mIds = move(ids);
+        mAlive.assign(mIds.size(), 1);
+        mBufferPositions.assign(mIds.size(), 0);
+        mIndexById.clear();
+        mIndexById.reserve(mIds.size());
+        for (uint32_t i = 0; i < mIds.size(); ++i) {
+            mIndexById.emplace(mIds[i], i);
+        }
+        mBuffer.clear();
+        mTree.build(move(points));
+        mTreeIndexCount = mTree.size();
+        mRemovedInTree = 0;
+    }
+
+    void rebuildIfNeeded() {
+        if (mBuffer.size() > max(cMinRebuildSize, mTree.size() / cBufferFraction)
+                || mRemovedInTree > max(cMinRebuildSize, mTree.size() / cRemovedFraction)) {
+            rebuild();
+        }
+    }
+
+    vector<StationIndex::Result> toResults(vector<Candidate> &candidates) const {
+        sort(candidates.begin(), candidates.end());
+        vector<StationIndex::Result> results;
+        results.reserve(candidates.size());
+        for (const Candidate &candidate: candidates) {
+            results.push_back({ mIds[candidate.second], kdtree::toAngle(candidate.first) * StationIndex::sEarthRadius });
+        }
+        return results;
+    }
+
+    kdtree::Tree mTree;
+    vector<Point> mBuffer;
+    vector<string> mIds;
+    vector<uint8_t> mAlive;
+    // Position of a station in the buffer, only meaningful for indices in the buffer.
+    vector<uint32_t> mBufferPositions;
+    unordered_map<string, uint32_t> mIndexById;
+    // Indices below are in the tree, the others in the buffer.
+    size_t mTreeIndexCount;
+    size_t mRemovedInTree;
+};
+
+namespace {
+
+template <typename Query>
+vector<vector<StationIndex::Result>> runBatch(size_t size, size_t threadCount, const Query &query) {
+    vector<vector<StationIndex::Result>> results(size);
+    if (threadCount == 0) {
+        threadCount = max<size_t>(thread::hardware_concurrency(), 1);
+    }
+    const size_t chunk = 64;
+    atomic<size_t> next(0);
+    auto worker = [&]() {
+        for (size_t begin = next.fetch_add(chunk); begin < size; begin = next.fetch_add(chunk)) {
+            for (size_t i = begin; i < min(begin + chunk, size); ++i) {
+                results[i] = query(i);
+            }
+        }
+    };
+    vector<thread> threads;
+    threadCount = min(threadCount, (size + chunk - 1) / chunk);
+    try {
+        for (size_t i = 1; i < threadCount; ++i) {
+            threads.emplace_back(worker);
+        }
+    } catch (...) {
+        // The started threads must be joined before they are destroyed.
+        next = size;
+        for (thread &t: threads) {
+            t.join();
+        }
+        throw;
+    }
+    worker();
+    for (thread &t: threads) {
+        t.join();
+    }
+    return results;
+}
+
+}
+
+const double StationIndex::sEarthRadius = 6371.0088;
+
+StationIndex::StationIndex() :
+    d(new StationIndexPrivate) {
+}
+
+StationIndex::StationIndex(const StationIndex &o) :
+    d(new StationIndexPrivate(*o.d)) {
+}
+
+StationIndex::StationIndex(StationIndex &&o) noexcept :
+    d(move(o.d)) {
+}
+
+StationIndex::~StationIndex() noexcept = default;
+
+void StationIndex::build(const list<Station> &stations) {
+    d->clear();
+    d->mBuffer.reserve(stations.size());
+    for (const Station &station: stations) {
+        const Place &place = station.placeRef();
+        if (place.hasLocation()) {
+            d->add(station.id(), place.mLatitude, place.mLongitude);
+        }
+    }
+    d->rebuild();
+}
+
+void StationIndex::build(const vector<PublicStation> &stations) {
+    d->clear();
+    d->mBuffer.reserve(stations.size());
+    for (const PublicStation &station: stations) {
+        d->add(station.mId, station.mLatitude, station.mLongitude);
+    }
+    d->rebuild();
+}
+
+void StationIndex::insert(const string &id, double latitude, double longitude) {
+    remove(id);
+    d->add(id, latitude, longitude);
+    d->rebuildIfNeeded();
+}
+
+bool StationIndex::remove(const string &id) {
+    auto it = d->mIndexById.find(id);
+    if (it == d->mIndexById.end()) {
+        return false;
+    }
+    uint32_t index = it->second;
+    d->mIndexById.erase(it);
+    d->mAlive[index] = 0;
+    if (index < d->mTreeIndexCount) {
+        ++d->mRemovedInTree;
+        d->rebuildIfNeeded();
+    } else {
+        uint32_t position = d->mBufferPositions[index];
+        d->mBuffer[position] = d->mBuffer.back();
+        d->mBufferPositions[d->mBuffer[position].mIndex] = position;
+        d->mBuffer.pop_back();
+    }
+    return true;
+}
+
+void StationIndex::rebuild() {
+    d->rebuild();
+}
+
+size_t StationIndex::size() const {
+    return d->mIndexById.size();
+}
+
+vector<StationIndex::Result> StationIndex::radius(double latitude, double longitude, double radius) const {
+    Point query = kdtree::toPoint(latitude, longitude, 0);
+    double limit = kdtree::toSquaredChord(radius / sEarthRadius);
+    const vector<uint8_t> &alive = d->mAlive;
+    vector<Candidate> candidates;
+    d->mTree.radius(query, limit, [&alive](uint32_t index) { return alive[index] != 0; }, candidates);
+    for (const Point &point: d->mBuffer) {
+        double distance = kdtree::squaredChord(point, query);
+        if (distance <= limit) {
+            candidates.emplace_back(distance, point.mIndex);
+        }
+    }
+    return d->toResults(candidates);
+}
+
+vector<StationIndex::Result> StationIndex::nearest(double latitude, double longitude, size_t count) const {
+    if (count == 0) {
+        return vector<Result>();
+    }
+    Point query = kdtree::toPoint(latitude, longitude, 0);
+    const vector<uint8_t> &alive = d->mAlive;
+    priority_queue<Candidate> heap;
+    for (const Point &point: d->mBuffer) {
+        kdtree::offer(kdtree::squaredChord(point, query), point.mIndex, count, heap);
+    }
+    d->mTree.nearest(query, count, numeric_limits<double>::infinity(), [&alive](uint32_t index) { return alive[index] != 0; }, heap);
+    vector<Candidate> candidates;
+    candidates.reserve(heap.size());
+    while (!heap.empty()) {
+        candidates.push_back(heap.top());
+        heap.pop();
+    }
+    return d->toResults(candidates);
+}
+
+vector<vector<StationIndex::Result>> StationIndex::radius(const vector<Location> &locations, double radius, size_t threadCount) const {
+    return runBatch(locations.size(), threadCount, [&](size_t i) {
+        return this->radius(locations[i].first, locations[i].second, radius);
+    });
+}
+
+vector<vector<StationIndex::Result>> StationIndex::nearest(const vector<Location> &locations, size_t count, size_t threadCount) const {
+    return runBatch(locations.size(), threadCount, [&](size_t i) {
+        return this->nearest(locations[i].first, locations[i].second, count);
+    });
+}
+
+StationIndex &StationIndex::operator =(const StationIndex &o) {
+    d.reset(new StationIndexPrivate(*o.d));
+    return *this;
+}
+
+StationIndex &StationIndex::operator =(StationIndex &&o) noexcept {
+    d = move(o.d);
+    return *this;
+}
+
+}
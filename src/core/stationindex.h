@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef STATIONINDEX_H
+#define STATIONINDEX_H
+
+#include "model/publicstation.h"
+#include "model/station.h"
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace netatmoapi {
+
+struct StationIndexPrivate;
+
+/**
+ * @brief Spatial index for radius and nearest neighbour queries over stations.
+ *
+ * The locations are stored as 3D unit vectors in a static k-d tree, so
+ * the index has no problems at the poles or the antimeridian, and the
+ * straight line distance in the tree is monotonic to the great circle
+ * distance. Distances are great circle distances in km on a sphere with
+ * the mean earth radius.
+ *
+ * build() replaces the content and builds the tree in O(n log n).
+ * insert() and remove() update the index incrementally: new locations
+ * go into a small buffer, which is searched linearly, and removed
+ * stations are only marked. The tree is rebuilt, when the buffer or the
+ * removed stations exceed a fraction of the tree.
+ *
+ * Queries are const and can run concurrently, but not concurrently with
+ * build(), insert() or remove().
+ */
+class StationIndex {
+public:
+    /**
+     * @brief A station found by a query.
+     */
+    struct Result {
+        /**
+         * The id of the station.
+         */
+        std::string mId;
+
+        /**
+         * The great circle distance to the query location in km.
+         */
+        double      mDistance;
+    };
+
+    /**
+     * A query location as pair of latitude and longitude in degrees.
+     */
+    using Location = std::pair<double, double>;
+
+    /**
+     * Constructor.
+     * Constructs an empty index.
+     */
+    StationIndex();
+
+    /**
+     * Copy constructor.
+     * @param o The element to copy.
+     */
+    StationIndex(const StationIndex &o);
+
+    /**
+     * Move constructor.
+     * @param o The element to move.
+     */
+    StationIndex(StationIndex &&o) noexcept;
+
+    /**
+     * Destructor.
+     * Is default.
+     */
+    virtual ~StationIndex() noexcept;
+
+    /**
+     * Replaces the content with the stations, which have a location.
+     * @param stations The stations, e.g. from utils::parseDevices().
+     */
+    void build(const std::list<Station> &stations);
+
+    /**
+     * Replaces the content with public stations.
+     * @param stations The stations, e.g. from NAPublicApiClient::requestPublicStations().
+     */
+    void build(const std::vector<PublicStation> &stations);
+
+    /**
+     * Inserts a station or moves it to a new location.
+     * @param id The id of the station.
+     * @param latitude The latitude in degrees.
+     * @param longitude The longitude in degrees.
+     */
+    void insert(const std::string &id, double latitude, double longitude);
+
+    /**
+     * Removes a station.
+     * @param id The id of the station.
+     * @return True, if the station was in the index.
+     */
+    bool remove(const std::string &id);
+
+    /**
+     * Rebuilds the tree with all buffered and without all removed stations.
+     */
+    void rebuild();
+
+    /**
+     * Returns the number of stations.
+     * @return The number of stations.
+     */
+    std::size_t size() const;
+
+    /**
+     * Returns all stations within a radius.
+     * @param latitude The latitude of the query location in degrees.
+     * @param longitude The longitude of the query location in degrees.
+     * @param radius The radius in km.
+     * @return The stations, ordered by distance.
+     */
+    std::vector<Result> radius(double latitude, double longitude, double radius) const;
+
+    /**
+     * Returns the nearest stations.
+     * @param latitude The latitude of the query location in degrees.
+     * @param longitude The longitude of the query location in degrees.
+     * @param count The maximum number of stations.
+     * @return The stations, ordered by distance.
+     */
+    std::vector<Result> nearest(double latitude, double longitude, std::size_t count) const;
+
+    /**
+     * Runs radius() for many locations in parallel.
+     * @param locations The query locations.
+     * @param radius The radius in km.
+     * @param threadCount The number of threads, 0 for the number of cores.
+     * @return The results, one per location.
+     */
+    std::vector<std::vector<Result>> radius(const std::vector<Location> &locations, double radius, std::size_t threadCount = 0) const;
+
+    /**
+     * Runs nearest() for many locations in parallel.
+     * @param locations The query locations.
+     * @param count The maximum number of stations per location.
+     * @param threadCount The number of threads, 0 for the number of cores.
+     * @return The results, one per location.
+     */
+    std::vector<std::vector<Result>> nearest(const std::vector<Location> &locations, std::size_t count, std::size_t threadCount = 0) const;
+
+    /**
+     * Copy assignment operator.
+     * @param o The element to copy.
+     * @return This element as reference.
+     */
+    StationIndex &operator =(const StationIndex &o);
+
+    /**
+     * Move assignment operator.
+     * @param o The element to move.
+     * @return This element as reference.
+     */
+    StationIndex &operator =(StationIndex &&o) noexcept;
+
+    /**
+     * The mean earth radius in km.
+     * Value: 6371.0088
+     */
+    static const double sEarthRadius;
+
+private:
+    std::unique_ptr<StationIndexPrivate> d;
+};
+
+}
+
+#endif /* STATIONINDEX_H */
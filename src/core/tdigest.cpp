@@ -0,0 +1,414 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "tdigest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+namespace netatmoapi {
+
+namespace {
+
+const char cMagic[4] = { 'N', 'A', 'T', 'D' };
+const uint32_t cVersion = 1;
+// The buffer holds this many values per unit of compression.
+const size_t cBufferFactor = 5;
+const double cPi = 3.14159265358979323846;
+
+struct Centroid {
+    double mMean;
+    double mWeight;
+};
+
+struct SerializedHeader {
+    char mMagic[4];
+    uint32_t mVersion;
+    double mCompression;
+    double mMin;
+    double mMax;
+    uint64_t mCentroidCount;
+};
+
+bool isMissing(double value) {
+    return std::isnan(value) || value == numeric_limits<double>::min();
+}
+
+}
+
+struct TDigestPrivate {
+    explicit TDigestPrivate(double compression) :
+        mCompression(compression),
+        mWeight(0),
+        mMin(numeric_limits<double>::infinity()),
+        mMax(-numeric_limits<double>::infinity())
+    {
+        mBuffer.reserve(bufferSize());
+    }
+    size_t bufferSize() const {
+        return static_cast<size_t>(mCompression) * cBufferFactor;
+    }
+    // Scale function k1, which keeps the centroids small at the tails.
+    double k(double q) const {
+        return mCompression / (2 * cPi) * asin(2 * q - 1);
+    }
+    double q(double k) const {
+        return (sin(min(k, mCompression / 4) * 2 * cPi / mCompression) + 1) / 2;
+    }
+    void compress();
+
+    double mCompression;
+    double mWeight;
+    double mMin;
+    double mMax;
+    vector<Centroid> mCentroids;
+    vector<Centroid> mBuffer;
+};
+
+void TDigestPrivate::compress() {
+    if (mBuffer.empty()) {
+        return;
+    }
+    mBuffer.insert(mBuffer.end(), mCentroids.begin(), mCentroids.end());
+    sort(mBuffer.begin(), mBuffer.end(), [](const Centroid &a, const Centroid &b) {
+        return a.mMean < b.mMean;
+    });
+    double total = 0;
+    for (const Centroid &centroid: mBuffer) {
+        total += centroid.mWeight;
+    }
+
+    mCentroids.clear();
+    Centroid current = mBuffer.front();
+    double weightSoFar = 0;
+    double weightLimit = total * q(k(0) + 1);
+    for (size_t i = 1; i < mBuffer.size(); ++i) {
+        const Centroid &next = mBuffer[i];
+        if (weightSoFar + current.mWeight + next.mWeight <= weightLimit) {
+            current.mWeight += next.mWeight;
+            current.mMean += (next.mMean - current.mMean) * next.mWeight / current.mWeight;
+        } else {
+            weightSoFar += current.mWeight;
+            mCentroids.push_back(current);
+            weightLimit = total * q(k(weightSoFar / total) + 1);
+            current = next;
+        }
+    }
+    mCentroids.push_back(current);
+    mWeight = total;
+    mBuffer.clear();
+}
+
+const double TDigest::sDefaultCompression = 100;
+
+TDigest::TDigest(double compression) {
+    if (!(compression >= 10)) {
+        throw invalid_argument("The compression must be at least 10.");
+    }
+    d.reset(new TDigestPrivate(compression));
+}
+
+TDigest::TDigest(const TDigest &o) :
+    d(new TDigestPrivate(*o.d)) {
+}
+
+TDigest::TDigest(TDigest &&o) noexcept :
+    d(move(o.d)) {
+}
+
+TDigest::~TDigest() noexcept = default;
+
+void TDigest::add(double value, double weight) {
+    if (isMissing(value) || !(weight > 0)) {
+        return;
+    }
+    d->mBuffer.push_back({ value, weight });
+    d->mMin = std::min(d->mMin, value);
+    d->mMax = std::max(d->mMax, value);
+    if (d->mBuffer.size() >= d->bufferSize()) {
+        d->compress();
+    }
+}
+
+void TDigest::add(const Measures &measures, Measures::Field field) {
+    if (measures.hasValue(field)) {
+        add(measures.value(field));
+    }
+}
+
+void TDigest::merge(const TDigest &o) {
+    if (this == &o) {
+        TDigest copy(o);
+        merge(copy);
+        return;
+    }
+    d->mBuffer.insert(d->mBuffer.end(), o.d->mCentroids.begin(), o.d->mCentroids.end());
+    d->mBuffer.insert(d->mBuffer.end(), o.d->mBuffer.begin(), o.d->mBuffer.end());
+    d->mMin = std::min(d->mMin, o.d->mMin);
+    d->mMax = std::max(d->mMax, o.d->mMax);
+    if (d->mBuffer.size() >= d->bufferSize()) {
+        d->compress();
+    }
+}
+
+double TDigest::quantile(double q) const {
+    d->compress();
+    const vector<Centroid> &centroids = d->mCentroids;
+    if (centroids.empty()) {
+        return numeric_limits<double>::min();
+    }
+    if (q <= 0) {
+        return d->mMin;
+    }
+    if (q >= 1) {
+        return d->mMax;
+    }
+    if (centroids.size() == 1) {
+        return centroids.front().mMean;
+    }
+
+    // Interpolate between the centers of the centroids and the extremes.
+    double index = q * d->mWeight;
+    const Centroid &first = centroids.front();
+    if (index < first.mWeight / 2) {
+        return d->mMin + (first.mMean - d->mMin) * index / (first.mWeight / 2);
+    }
+    double weightSoFar = first.mWeight / 2;
+    for (size_t i = 0; i + 1 < centroids.size(); ++i) {
+        double distance = (centroids[i].mWeight + centroids[i + 1].mWeight) / 2;
+        if (weightSoFar + distance > index) {
+            double t = (index - weightSoFar) / distance;
+            return centroids[i].mMean + (centroids[i + 1].mMean - centroids[i].mMean) * t;
+        }
+        weightSoFar += distance;
+    }
+    const Centroid &last = centroids.back();
+    double t = (index - weightSoFar) / (last.mWeight / 2);
+    return last.mMean + (d->mMax - last.mMean) * std::min(t, 1.0);
+}
+
+double TDigest::cdf(double value) const {
+    d->compress();
+    const vector<Centroid> &centroids = d->mCentroids;
+    if (centroids.empty()) {
+        return 0;
+    }
+    if (value < d->mMin) {
+        return 0;
+    }
+    if (value >= d->mMax) {
+        return 1;
+    }
+    const Centroid &first = centroids.front();
+    if (value < first.mMean) {
+        double span = first.mMean - d->mMin;
+        return span > 0 ? (value - d->mMin) / span * first.mWeight / 2 / d->mWeight : 0;
+    }
+    double weightSoFar = first.mWeight / 2;
+    for (size_t i = 0; i + 1 < centroids.size(); ++i) {
+        const Centroid &left = centroids[i];
+        const Centroid &right = centroids[i + 1];
+        double distance = (left.mWeight + right.mWeight) / 2;
+        if (value < right.mMean) {
+            double span = right.mMean - left.mMean;
+            double t = span > 0 ? (value - left.mMean) / span : 0.5;
+            return (weightSoFar + distance * t) / d->mWeight;
+        }
+        weightSoFar += distance;
+    }
+    const Centroid &last = centroids.back();
+    double span = d->mMax - last.mMean;
+    double t = span > 0 ? (value - last.mMean) / span : 0;
+    return (weightSoFar + last.mWeight / 2 * t) / d->mWeight;
+}
+
+double TDigest::weight() const {
+    d->compress();
+    return d->mWeight;
+}
+
+double TDigest::min() const {
+    return d->mMin <= d->mMax ? d->mMin : numeric_limits<double>::min();
+}
+
+double TDigest::max() const {
+    return d->mMin <= d->mMax ? d->mMax : numeric_limits<double>::min();
+}
+
+size_t TDigest::centroidCount() const {
+    d->compress();
+    return d->mCentroids.size();
+}
+
+double TDigest::compression() const {
+    return d->mCompression;
+}
+
+void TDigest::clear() {
+    d.reset(new TDigestPrivate(d->mCompression));
+}
+
+string TDigest::serialize() const {
+    d->compress();
+    SerializedHeader header;
+    memcpy(header.mMagic, cMagic, sizeof(cMagic));
+    header.mVersion = cVersion;
+    header.mCompression = d->mCompression;
+    header.mMin = d->mMin;
+    header.mMax = d->mMax;
+    header.mCentroidCount = d->mCentroids.size();
+    string data(sizeof(header) + d->mCentroids.size() * sizeof(Centroid), '\0');
+    memcpy(&data[0], &header, sizeof(header));
+    if (!d->mCentroids.empty()) {
+        memcpy(&data[sizeof(header)], d->mCentroids.data(), d->mCentroids.size() * sizeof(Centroid));
+    }
+    return data;
+}
+
+TDigest TDigest::deserialize(const string &data) {
+    SerializedHeader header;
+    if (data.size() < sizeof(header)) {
+        throw invalid_argument("Invalid serialized t-digest.");
+    }
+    memcpy(&header, data.data(), sizeof(header));
+    if (memcmp(header.mMagic, cMagic, sizeof(cMagic)) != 0 || header.mVersion != cVersion ||
+            header.mCentroidCount != (data.size() - sizeof(header)) / sizeof(Centroid) ||
+            (data.size() - sizeof(header)) % sizeof(Centroid) != 0 || !(header.mCompression >= 10)) {
+        throw invalid_argument("Invalid serialized t-digest.");
+    }
+    TDigest digest(header.mCompression);
+    digest.d->mMin = header.mMin;
+    digest.d->mMax = header.mMax;
+    digest.d->mCentroids.resize(header.mCentroidCount);
+    if (header.mCentroidCount > 0) {
+        memcpy(digest.d->mCentroids.data(), data.data() + sizeof(header), header.mCentroidCount * sizeof(Centroid));
+    }
+    for (const Centroid &centroid: digest.d->mCentroids) {
+        digest.d->mWeight += centroid.mWeight;
+    }
+    return digest;
+}
+
+TDigest &TDigest::operator =(const TDigest &o) {
+    d.reset(new TDigestPrivate(*o.d));
+    return *this;
+}
+
+TDigest &TDigest::operator =(TDigest &&o) noexcept {
+    d = move(o.d);
+    return *this;
+}
+
+struct SlidingTDigestPrivate {
+    SlidingTDigestPrivate(uint64_t windowSize, uint64_t paneSize, double compression) :
+        mPaneCount(windowSize / paneSize),
+        mPaneSize(paneSize),
+        mCompression(compression),
+        mFirstPane(0)
+    {}
+    uint64_t mPaneCount;
+    uint64_t mPaneSize;
+    double mCompression;
+    deque<TDigest> mPanes;
+    // Pane index of mPanes.front().
+    uint64_t mFirstPane;
+};
+
+SlidingTDigest::SlidingTDigest(uint64_t windowSize, uint64_t paneSize, double compression) {
+    if (windowSize == 0 || paneSize == 0 || windowSize % paneSize != 0) {
+        throw invalid_argument("The window size must be a multiple of the pane size.");
+    }
+    if (!(compression >= 10)) {
+        throw invalid_argument("The compression must be at least 10.");
+    }
+    d.reset(new SlidingTDigestPrivate(windowSize, paneSize, compression));
+}
+
+SlidingTDigest::SlidingTDigest(const SlidingTDigest &o) :
+    d(new SlidingTDigestPrivate(*o.d)) {
+}
+
+SlidingTDigest::SlidingTDigest(SlidingTDigest &&o) noexcept :
+    d(move(o.d)) {
+}
+
+SlidingTDigest::~SlidingTDigest() noexcept = default;
+
+bool SlidingTDigest::add(uint64_t timeStamp, double value) {
+    uint64_t pane = timeStamp / d->mPaneSize;
+    deque<TDigest> &panes = d->mPanes;
+    if (!panes.empty() && pane < d->mFirstPane) {
+        return false;
+    }
+    if (panes.empty() || pane >= d->mFirstPane + panes.size()) {
+        // Move the window to the new pane.
+        uint64_t firstPane = pane + 1 >= d->mPaneCount ? pane + 1 - d->mPaneCount : 0;
+        if (panes.empty() || firstPane >= d->mFirstPane + panes.size()) {
+            panes.clear();
+            d->mFirstPane = pane;
+        } else {
+            while (d->mFirstPane < firstPane) {
+                panes.pop_front();
+                ++d->mFirstPane;
+            }
+        }
+        while (d->mFirstPane + panes.size() <= pane) {
+            panes.emplace_back(d->mCompression);
+        }
+    }
+    panes[pane - d->mFirstPane].add(value);
+    return true;
+}
+
+bool SlidingTDigest::add(const Measures &measures, Measures::Field field) {
+    if (!measures.hasValue(field)) {
+        return false;
+    }
+    return add(measures.mTimeStamp, measures.value(field));
+}
+
+TDigest SlidingTDigest::digest() const {
+    TDigest digest(d->mCompression);
+    for (const TDigest &pane: d->mPanes) {
+        digest.merge(pane);
+    }
+    return digest;
+}
+
+double SlidingTDigest::quantile(double q) const {
+    return digest().quantile(q);
+}
+
+SlidingTDigest &SlidingTDigest::operator =(const SlidingTDigest &o) {
+    d.reset(new SlidingTDigestPrivate(*o.d));
+    return *this;
+}
+
+SlidingTDigest &SlidingTDigest::operator =(SlidingTDigest &&o) noexcept {
+    d = move(o.d);
+    return *this;
+}
+
+}
@@ -0,0 +1,271 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef TDIGEST_H
+#define TDIGEST_H
+
+#include "model/measures.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace netatmoapi {
+
+struct TDigestPrivate;
+struct SlidingTDigestPrivate;
+
+/**
+ * @brief This class estimates quantiles of a stream of values with a t-digest.
+ *
+ * The digest keeps a bounded number of centroids. The centroids are small
+ * at the tails and large at the median, so the extreme quantiles, e.g. p99,
+ * are much more accurate than the median. The number of centroids is about
+ * the compression, independent of the number of values.
+ *
+ * New values are buffered and merged into the centroids, when the buffer
+ * is full or when a quantile is requested. Digests of several modules or
+ * hosts can be merged, e.g. for the quantiles of a site, and serialized
+ * to be sent to another host.
+ *
+ * A digest is not thread safe, also the const methods may merge the buffer.
+ */
+class TDigest {
+public:
+    /**
+     * Constructor.
+     * @param compression The compression. Higher values are more accurate and use more memory.
+     * @throw std::invalid_argument If compression is smaller than 10.
+     */
+    explicit TDigest(double compression = sDefaultCompression);
+
+    /**
+     * Copy constructor.
+     * @param o The element to copy.
+     */
+    TDigest(const TDigest &o);
+
+    /**
+     * Move constructor.
+     * @param o The element to move.
+     */
+    TDigest(TDigest &&o) noexcept;
+
+    /**
+     * Destructor.
+     * Is default.
+     */
+    virtual ~TDigest() noexcept;
+
+    /**
+     * Adds a value.
+     * NaN and missing values, i.e. std::numeric_limits<double>::min(), are ignored.
+     * @param value The value.
+     * @param weight The weight of the value.
+     */
+    void add(double value, double weight = 1);
+
+    /**
+     * Adds a value of measures.
+     * @param measures The measures.
+     * @param field The measure value to add.
+     */
+    void add(const Measures &measures, Measures::Field field);
+
+    /**
+     * Merges another digest into this digest.
+     * @param o The other digest.
+     */
+    void merge(const TDigest &o);
+
+    /**
+     * Returns the estimated quantile.
+     * @param q The quantile, from 0 to 1, e.g. 0.99 for p99.
+     * @return The estimated value, std::numeric_limits<double>::min() for an empty digest.
+     */
+    double quantile(double q) const;
+
+    /**
+     * Returns the estimated fraction of the values, which are smaller than or equal to a value.
+     * @param value The value.
+     * @return The fraction from 0 to 1, 0 for an empty digest.
+     */
+    double cdf(double value) const;
+
+    /**
+     * Returns the sum of the weights of all values.
+     * @return The total weight.
+     */
+    double weight() const;
+
+    /**
+     * Returns the smallest value.
+     * @return The smallest value, std::numeric_limits<double>::min() for an empty digest.
+     */
+    double min() const;
+
+    /**
+     * Returns the largest value.
+     * @return The largest value, std::numeric_limits<double>::min() for an empty digest.
+     */
+    double max() const;
+
+    /**
+     * Returns the number of centroids after merging the buffer.
+     * @return The number of centroids.
+     */
+    std::size_t centroidCount() const;
+
+    /**
+     * Returns the compression.
+     * @return The compression.
+     */
+    double compression() const;
+
+    /**
+     * Removes all values.
+     */
+    void clear();
+
+    /**
+     * Serializes the digest into a binary string in the byte order of the host.
+     * @return The serialized digest.
+     */
+    std::string serialize() const;
+
+    /**
+     * Deserializes a digest.
+     * @param data The result of serialize().
+     * @return The digest.
+     * @throw std::invalid_argument If data is not a serialized digest.
+     */
+    static TDigest deserialize(const std::string &data);
+
+    /**
+     * Copy assignment operator.
+     * @param o The element to copy.
+     * @return This element as reference.
+     */
+    TDigest &operator =(const TDigest &o);
+
+    /**
+     * Move assignment operator.
+     * @param o The element to move.
+     * @return This element as reference.
+     */
+    TDigest &operator =(TDigest &&o) noexcept;
+
+    /**
+     * The default compression.
+     *
+     * Value: 100
+     */
+    static const double sDefaultCompression;
+
+private:
+    std::unique_ptr<TDigestPrivate> d;
+};
+
+/**
+ * @brief This class estimates quantiles of the values in a sliding time window.
+ *
+ * The window is divided into panes, every pane has its own TDigest. A
+ * value is added to the digest of its pane, and the digest of the window
+ * is merged from the digests of the panes. Panes, which are older than
+ * the window before the newest value, are dropped.
+ */
+class SlidingTDigest {
+public:
+    /**
+     * Constructor.
+     * @param windowSize The size of the window in seconds.
+     * @param paneSize The size of a pane in seconds. The window moves in steps of a pane.
+     * @param compression The compression of the digests.
+     * @throw std::invalid_argument If a size is 0, the window is not a multiple of the pane or compression is smaller than 10.
+     */
+    explicit SlidingTDigest(std::uint64_t windowSize, std::uint64_t paneSize, double compression = TDigest::sDefaultCompression);
+
+    /**
+     * Copy constructor.
+     * @param o The element to copy.
+     */
+    SlidingTDigest(const SlidingTDigest &o);
+
+    /**
+     * Move constructor.
+     * @param o The element to move.
+     */
+    SlidingTDigest(SlidingTDigest &&o) noexcept;
+
+    /**
+     * Destructor.
+     * Is default.
+     */
+    virtual ~SlidingTDigest() noexcept;
+
+    /**
+     * Adds a value.
+     * @param timeStamp The time stamp of the value.
+     * @param value The value. Missing values are ignored.
+     * @return True, if the value was added, false if it is older than the window.
+     */
+    bool add(std::uint64_t timeStamp, double value);
+
+    /**
+     * Adds a value of measures at the time stamp of the measures.
+     * @param measures The measures.
+     * @param field The measure value to add.
+     * @return True, if the value was added, false if it is older than the window.
+     */
+    bool add(const Measures &measures, Measures::Field field);
+
+    /**
+     * Returns the digest of the window, which ends with the pane of the newest value.
+     * @return The merged digest of all panes in the window.
+     */
+    TDigest digest() const;
+
+    /**
+     * Returns the estimated quantile of the window.
+     * @param q The quantile, from 0 to 1.
+     * @return The estimated value, std::numeric_limits<double>::min() for an empty window.
+     */
+    double quantile(double q) const;
+
+    /**
+     * Copy assignment operator.
+     * @param o The element to copy.
+     * @return This element as reference.
+     */
+    SlidingTDigest &operator =(const SlidingTDigest &o);
+
+    /**
+     * Move assignment operator.
+     * @param o The element to move.
+     * @return This element as reference.
+     */
+    SlidingTDigest &operator =(SlidingTDigest &&o) noexcept;
+
+private:
+    std::unique_ptr<SlidingTDigestPrivate> d;
+};
+
+}
+
+#endif /* TDIGEST_H */
@@ -0,0 +1,608 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "timeseries.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <unordered_map>
+
+using namespace std;
+
+namespace netatmoapi {
+
+namespace {
+
+// Marks that the next value is stored with a new window of meaningful bits.
+const uint8_t cNoWindow = 0xFF;
+// The values of a block are stored as XOR of the previous value, not as decimals.
+const uint8_t cXorValues = 0xFF;
+// The api sends values with up to 3 decimal places, e.g. rain in mm.
+const uint8_t cMaxDecimals = 3;
+const double cPowersOf10[cMaxDecimals + 1] = { 1, 10, 100, 1000 };
+// Larger values are stored as XOR, their scaled value may not fit into 64 bits.
+const double cMaxDecimalValue = 1125899906842624.0; // 2^50
+
+uint64_t doubleToBits(double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+double bitsToDouble(uint64_t bits) {
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Appends the low count bits of value (1 <= count <= 64), most significant bit first.
+void writeBits(vector<uint64_t> &words, uint64_t &bitCount, uint64_t value, unsigned count) {
+    unsigned offset = bitCount & 63;
+    if (offset == 0) {
+        words.push_back(0);
+    }
+    unsigned free = 64 - offset;
+    if (count <= free) {
+        words.back() |= value << (free - count);
+    } else {
+        unsigned rest = count - free;
+        words.back() |= value >> rest;
+        words.push_back(value << (64 - rest));
+    }
+    bitCount += count;
+}
+
+class BitReader {
+public:
+    explicit BitReader(const uint64_t *words) :
+        mWords(words),
+        mPosition(0) {
+    }
+
+    bool readBit() {
+        bool bit = (mWords[mPosition >> 6] >> (63 - (mPosition & 63))) & 1;
+        ++mPosition;
+        return bit;
+    }
+
+    // Reads count bits (1 <= count <= 64).
+    uint64_t readBits(unsigned count) {
+        size_t index = mPosition >> 6;
+        unsigned offset = mPosition & 63;
+        unsigned available = 64 - offset;
+        uint64_t value = (mWords[index] << offset) >> (64 - count);
+        if (count > available) {
+            value |= mWords[index + 1] >> (64 - (count - available));
+        }
+        mPosition += count;
+        return value;
+    }
+
+private:
+    const uint64_t *mWords;
+    uint64_t mPosition;
+};
+
+// Returns true and the value multiplied by 10^decimals, if the value is
+// restored bit by bit by dividing the integer by 10^decimals.
+bool toScaled(double value, uint8_t decimals, int64_t &scaled) {
+    if (!(fabs(value) < cMaxDecimalValue)) {
+        return false;
+    }
+    scaled = llround(value * cPowersOf10[decimals]);
+    return doubleToBits(double(scaled) / cPowersOf10[decimals]) == doubleToBits(value);
+}
+
+// Returns the smallest number of decimals from decimals on, which stores the value, or cXorValues.
+uint8_t fitDecimals(double value, uint8_t decimals) {
+    int64_t scaled;
+    for (; decimals <= cMaxDecimals; ++decimals) {
+        if (toScaled(value, decimals, scaled)) {
+            return decimals;
+        }
+    }
+    return cXorValues;
+}
+
+unsigned countLeadingZeros(uint64_t value) {
+    return static_cast<unsigned>(__builtin_clzll(value));
+}
+
+unsigned countTrailingZeros(uint64_t value) {
+    return static_cast<unsigned>(__builtin_ctzll(value));
+}
+
+}
+
+struct TimeSeriesBlock {
+    explicit TimeSeriesBlock(uint64_t timeStamp) :
+        mFirstTimeStamp(timeStamp),
+        mLastTimeStamp(timeStamp),
+        mCount(0),
+        mBitCount(0),
+        mDecimals(0)
+    {}
+    uint64_t mFirstTimeStamp;
+    uint64_t mLastTimeStamp;
+    size_t mCount;
+    uint64_t mBitCount;
+    vector<uint64_t> mWords;
+    // The values are stored as delta of value * 10^mDecimals, or cXorValues.
+    uint8_t mDecimals;
+};
+
+struct TimeSeriesPrivate {
+    TimeSeriesPrivate() :
+        mSize(0),
+        mPreviousDelta(0),
+        mPreviousBits(0),
+        mPreviousScaled(0),
+        mLeadingZeros(cNoWindow),
+        mTrailingZeros(0)
+    {}
+    vector<TimeSeriesBlock> mBlocks;
+    size_t mSize;
+    // Encoder state of the last block.
+    int64_t mPreviousDelta;
+    uint64_t mPreviousBits;
+    int64_t mPreviousScaled;
+    uint8_t mLeadingZeros;
+    uint8_t mTrailingZeros;
+
+    void startBlock(TimeSeriesBlock &block, uint8_t decimals, double value);
+    bool appendToBlock(TimeSeriesBlock &block, uint64_t timeStamp, double value);
+    void reencodeBlock(TimeSeriesBlock &block, double value);
+    void encodeTimeStamp(TimeSeriesBlock &block, uint64_t timeStamp);
+    void encodeValue(TimeSeriesBlock &block, uint64_t bits);
+    void encodeScaledValue(TimeSeriesBlock &block, int64_t scaled);
+    template <typename Callback>
+    size_t decode(uint64_t begin, uint64_t end, Callback &&callback) const;
+};
+
+void TimeSeriesPrivate::startBlock(TimeSeriesBlock &block, uint8_t decimals, double value) {
+    block.mDecimals = decimals;
+    mPreviousDelta = 0;
+    int64_t scaled;
+    if (decimals != cXorValues && toScaled(value, decimals, scaled)) {
+        writeBits(block.mWords, block.mBitCount, static_cast<uint64_t>(scaled), 64);
+        mPreviousScaled = scaled;
+    } else {
+        block.mDecimals = cXorValues;
+        uint64_t bits = doubleToBits(value);
+        writeBits(block.mWords, block.mBitCount, bits, 64);
+        mPreviousBits = bits;
+        mLeadingZeros = cNoWindow;
+        mTrailingZeros = 0;
+    }
+}
+
+bool TimeSeriesPrivate::appendToBlock(TimeSeriesBlock &block, uint64_t timeStamp, double value) {
+    int64_t scaled = 0;
+    if (block.mDecimals != cXorValues && !toScaled(value, block.mDecimals, scaled)) {
+        return false;
+    }
+    encodeTimeStamp(block, timeStamp);
+    if (block.mDecimals == cXorValues) {
+        encodeValue(block, doubleToBits(value));
+    } else {
+        encodeScaledValue(block, scaled);
+    }
+    block.mLastTimeStamp = timeStamp;
+    return true;
+}
+
+void TimeSeriesPrivate::reencodeBlock(TimeSeriesBlock &block, double value) {
+    vector<uint64_t> timeStamps;
+    vector<double> values;
+    timeStamps.reserve(block.mCount);
+    values.reserve(block.mCount);
+    TimeSeriesPrivate single;
+    single.mBlocks.push_back(move(block));
+    single.decode(0, numeric_limits<uint64_t>::max(), [&timeStamps, &values](uint64_t timeStamp, double blockValue) {
+        timeStamps.push_back(timeStamp);
+        values.push_back(blockValue);
+    });
+
+    // The fewest decimals, which store all values of the block and the new value.
+    uint8_t decimals = fitDecimals(value, single.mBlocks.front().mDecimals);
+    for (size_t i = 0; i < values.size() && decimals != cXorValues; ++i) {
+        decimals = fitDecimals(values[i], decimals);
+    }
+    block = TimeSeriesBlock(timeStamps.front());
+    startBlock(block, decimals, values.front());
+    for (size_t i = 1; i < values.size(); ++i) {
+        appendToBlock(block, timeStamps[i], values[i]);
+    }
+    block.mCount = values.size();
+}
+
+void TimeSeriesPrivate::encodeTimeStamp(TimeSeriesBlock &block, uint64_t timeStamp) {
+    int64_t delta = static_cast<int64_t>(timeStamp - block.mLastTimeStamp);
+    int64_t deltaOfDelta = delta - mPreviousDelta;
+    mPreviousDelta = delta;
+    if (deltaOfDelta == 0) {
+        writeBits(block.mWords, block.mBitCount, 0x0, 1);
+    } else if (deltaOfDelta >= -63 && deltaOfDelta <= 64) {
+        writeBits(block.mWords, block.mBitCount, 0x2, 2);
+        writeBits(block.mWords, block.mBitCount, static_cast<uint64_t>(deltaOfDelta + 63), 7);
+    } else if (deltaOfDelta >= -255 && deltaOfDelta <= 256) {
+        writeBits(block.mWords, block.mBitCount, 0x6, 3);
+        writeBits(block.mWords, block.mBitCount, static_cast<uint64_t>(deltaOfDelta + 255), 9);
+    } else if (deltaOfDelta >= -2047 && deltaOfDelta <= 2048) {
+        writeBits(block.mWords, block.mBitCount, 0xE, 4);
+        writeBits(block.mWords, block.mBitCount, static_cast<uint64_t>(deltaOfDelta + 2047), 12);
+    } else {
+        writeBits(block.mWords, block.mBitCount, 0xF, 4);
+        writeBits(block.mWords, block.mBitCount, static_cast<uint64_t>(deltaOfDelta), 64);
+    }
+}
+
+void TimeSeriesPrivate::encodeValue(TimeSeriesBlock &block, uint64_t bits) {
+    uint64_t xorBits = bits ^ mPreviousBits;
+    mPreviousBits = bits;
+    if (xorBits == 0) {
+        writeBits(block.mWords, block.mBitCount, 0x0, 1);
+        return;
+    }
+    unsigned leadingZeros = min(countLeadingZeros(xorBits), 31u);
+    unsigned trailingZeros = countTrailingZeros(xorBits);
+    if (mLeadingZeros != cNoWindow && leadingZeros >= mLeadingZeros && trailingZeros >= mTrailingZeros) {
+        // The meaningful bits fit into the window of the previous value.
+        writeBits(block.mWords, block.mBitCount, 0x2, 2);
+        writeBits(block.mWords, block.mBitCount, xorBits >> mTrailingZeros, 64 - mLeadingZeros - mTrailingZeros);
+    } else {
+        unsigned meaningfulBits = 64 - leadingZeros - trailingZeros;
+        writeBits(block.mWords, block.mBitCount, 0x3, 2);
+        writeBits(block.mWords, block.mBitCount, leadingZeros, 5);
+        writeBits(block.mWords, block.mBitCount, meaningfulBits - 1, 6);
+        writeBits(block.mWords, block.mBitCount, xorBits >> trailingZeros, meaningfulBits);
+        mLeadingZeros = static_cast<uint8_t>(leadingZeros);
+        mTrailingZeros = static_cast<uint8_t>(trailingZeros);
+    }
+}
+
+void TimeSeriesPrivate::encodeScaledValue(TimeSeriesBlock &block, int64_t scaled) {
+    // Zigzag encoding, small positive and negative deltas get small codes.
+    uint64_t delta = static_cast<uint64_t>(scaled) - static_cast<uint64_t>(mPreviousScaled);
+    uint64_t code = (delta << 1) ^ (0 - (delta >> 63));
+    mPreviousScaled = scaled;
+    if (code == 0) {
+        writeBits(block.mWords, block.mBitCount, 0x0, 1);
+    } else if (code <= 8) {
+        writeBits(block.mWords, block.mBitCount, 0x2, 2);
+        writeBits(block.mWords, block.mBitCount, code - 1, 3);
+    } else if (code <= 128) {
+        writeBits(block.mWords, block.mBitCount, 0x6, 3);
+        writeBits(block.mWords, block.mBitCount, code - 1, 7);
+    } else if (code <= 16384) {
+        writeBits(block.mWords, block.mBitCount, 0xE, 4);
+        writeBits(block.mWords, block.mBitCount, code - 1, 14);
+    } else {
+        writeBits(block.mWords, block.mBitCount, 0xF, 4);
+        writeBits(block.mWords, block.mBitCount, code, 64);
+    }
+}
+
+template <typename Callback>
+size_t TimeSeriesPrivate::decode(uint64_t begin, uint64_t end, Callback &&callback) const {
+    size_t count = 0;
+    for (const TimeSeriesBlock &block: mBlocks) {
+        if (block.mLastTimeStamp < begin) {
+            continue;
+        }
+        if (block.mFirstTimeStamp > end) {
+            break;
+        }
+        // The whole block is in the range, so no time stamp has to be compared.
+        bool inside = block.mFirstTimeStamp >= begin && block.mLastTimeStamp <= end;
+
+        BitReader reader(block.mWords.data());
+        uint64_t timeStamp = block.mFirstTimeStamp;
+        int64_t delta = 0;
+        const bool xorValues = block.mDecimals == cXorValues;
+        const double divisor = xorValues ? 1 : cPowersOf10[block.mDecimals];
+        uint64_t bits = reader.readBits(64);
+        double value = xorValues ? bitsToDouble(bits) : double(static_cast<int64_t>(bits)) / divisor;
+        unsigned leadingZeros = 0;
+        unsigned trailingZeros = 0;
+        for (size_t i = 0; i < block.mCount; ++i) {
+            if (i > 0) {
+                if (reader.readBit()) {
+                    int64_t deltaOfDelta;
+                    if (!reader.readBit()) {
+                        deltaOfDelta = static_cast<int64_t>(reader.readBits(7)) - 63;
+                    } else if (!reader.readBit()) {
+                        deltaOfDelta = static_cast<int64_t>(reader.readBits(9)) - 255;
+                    } else if (!reader.readBit()) {
+                        deltaOfDelta = static_cast<int64_t>(reader.readBits(12)) - 2047;
+                    } else {
+                        deltaOfDelta = static_cast<int64_t>(reader.readBits(64));
+                    }
+                    delta += deltaOfDelta;
+                }
+                timeStamp += static_cast<uint64_t>(delta);
+
+                if (xorValues) {
+                    if (reader.readBit()) {
+                        if (reader.readBit()) {
+                            leadingZeros = static_cast<unsigned>(reader.readBits(5));
+                            unsigned meaningfulBits = static_cast<unsigned>(reader.readBits(6)) + 1;
+                            trailingZeros = 64 - leadingZeros - meaningfulBits;
+                        }
+                        bits ^= reader.readBits(64 - leadingZeros - trailingZeros) << trailingZeros;
+                        value = bitsToDouble(bits);
+                    }
+                } else if (reader.readBit()) {
+                    uint64_t code;
+                    if (!reader.readBit()) {
+                        code = reader.readBits(3) + 1;
+                    } else if (!reader.readBit()) {
+                        code = reader.readBits(7) + 1;
+                    } else if (!reader.readBit()) {
+                        code = reader.readBits(14) + 1;
+                    } else {
+                        code = reader.readBits(64);
+                    }
+                    // Here bits holds the scaled value.
+                    bits += (code >> 1) ^ (0 - (code & 1));
+                    value = double(static_cast<int64_t>(bits)) / divisor;
+                }
+            }
+            if (inside || (timeStamp >= begin && timeStamp <= end)) {
+                callback(timeStamp, value);
+                ++count;
+            } else if (timeStamp > end) {
+                break;
+            }
+        }
+    }
+    return count;
+}
+
+const size_t TimeSeries::sBlockSize = 1024;
+
+TimeSeries::TimeSeries() :
+    d(new TimeSeriesPrivate) {
+}
+
+TimeSeries::TimeSeries(const TimeSeries &o) :
+    d(new TimeSeriesPrivate(*o.d)) {
+}
+
+TimeSeries::TimeSeries(TimeSeries &&o) noexcept :
+    d(move(o.d)) {
+}
+
+TimeSeries::~TimeSeries() noexcept = default;
+
+bool TimeSeries::append(uint64_t timeStamp, double value) {
+    vector<TimeSeriesBlock> &blocks = d->mBlocks;
+    if (!blocks.empty() && timeStamp <= blocks.back().mLastTimeStamp) {
+        return false;
+    }
+    if (blocks.empty() || blocks.back().mCount == sBlockSize) {
+        // A new block starts with the decimals of the previous one, so a
+        // value like 21.0 does not need a reencoding at the next value.
+        uint8_t decimals = 0;
+        if (!blocks.empty()) {
+            // The block is sealed, give back the spare capacity.
+            blocks.back().mWords.shrink_to_fit();
+            decimals = blocks.back().mDecimals == cXorValues ? 0 : blocks.back().mDecimals;
+        }
+        blocks.emplace_back(timeStamp);
+        d->startBlock(blocks.back(), fitDecimals(value, decimals), value);
+    } else if (!d->appendToBlock(blocks.back(), timeStamp, value)) {
+        // The value needs more decimals or XOR, at most 4 times per block.
+        d->reencodeBlock(blocks.back(), value);
+        d->appendToBlock(blocks.back(), timeStamp, value);
+    }
+    ++blocks.back().mCount;
+    ++d->mSize;
+    return true;
+}
+
+size_t TimeSeries::scan(uint64_t begin, uint64_t end, const function<void (uint64_t, double)> &callback) const {
+    return d->decode(begin, end, callback);
+}
+
+size_t TimeSeries::read(uint64_t begin, uint64_t end, vector<uint64_t> &timeStamps, vector<double> &values) const {
+    return d->decode(begin, end, [&timeStamps, &values](uint64_t timeStamp, double value) {
+        timeStamps.push_back(timeStamp);
+        values.push_back(value);
+    });
+}
+
+void TimeSeries::removeBefore(uint64_t timeStamp) {
+    vector<TimeSeriesBlock> &blocks = d->mBlocks;
+    auto it = blocks.begin();
+    // The last block holds the encoder state and is never removed.
+    while (it != blocks.end() && next(it) != blocks.end() && it->mLastTimeStamp < timeStamp) {
+        d->mSize -= it->mCount;
+        ++it;
+    }
+    blocks.erase(blocks.begin(), it);
+}
+
+size_t TimeSeries::size() const {
+    return d->mSize;
+}
+
+uint64_t TimeSeries::firstTimeStamp() const {
+    return d->mBlocks.empty() ? 0 : d->mBlocks.front().mFirstTimeStamp;
+}
+
+uint64_t TimeSeries::lastTimeStamp() const {
+    return d->mBlocks.empty() ? 0 : d->mBlocks.back().mLastTimeStamp;
+}
+
+size_t TimeSeries::memoryUsage() const {
+    size_t usage = sizeof(TimeSeries) + sizeof(TimeSeriesPrivate) + d->mBlocks.capacity() * sizeof(TimeSeriesBlock);
+    for (const TimeSeriesBlock &block: d->mBlocks) {
+        usage += block.mWords.capacity() * sizeof(uint64_t);
+    }
+    return usage;
+}
+
+TimeSeries &TimeSeries::operator =(const TimeSeries &o) {
+    d.reset(new TimeSeriesPrivate(*o.d));
+    return *this;
+}
+
+TimeSeries &TimeSeries::operator =(TimeSeries &&o) noexcept {
+    d = move(o.d);
+    return *this;
+}
+
+struct TimeSeriesStorePrivate {
+    // A series is only created for the measure values, which a module provides.
+    using ModuleSeries = array<unique_ptr<TimeSeries>, Measures::fieldCount>;
+
+    TimeSeriesStorePrivate() = default;
+    TimeSeriesStorePrivate(const TimeSeriesStorePrivate &o) {
+        mModules.reserve(o.mModules.size());
+        for (const auto &module: o.mModules) {
+            ModuleSeries &series = mModules[module.first];
+            for (size_t i = 0; i < series.size(); ++i) {
+                if (module.second[i]) {
+                    series[i].reset(new TimeSeries(*module.second[i]));
+                }
+            }
+        }
+    }
+    unordered_map<string, ModuleSeries> mModules;
+};
+
+TimeSeriesStore::TimeSeriesStore() :
+    d(new TimeSeriesStorePrivate) {
+}
+
+TimeSeriesStore::TimeSeriesStore(const TimeSeriesStore &o) :
+    d(new TimeSeriesStorePrivate(*o.d)) {
+}
+
+TimeSeriesStore::TimeSeriesStore(TimeSeriesStore &&o) noexcept :
+    d(move(o.d)) {
+}
+
+TimeSeriesStore::~TimeSeriesStore() noexcept = default;
+
+size_t TimeSeriesStore::append(const string &moduleId, const Measures &measures) {
+    if (measures.mTimeStamp == 0) {
+        return 0;
+    }
+    TimeSeriesStorePrivate::ModuleSeries *series = nullptr;
+    size_t count = 0;
+    for (size_t i = 0; i < Measures::fieldCount; ++i) {
+        Measures::Field field = static_cast<Measures::Field>(i);
+        if (!measures.hasValue(field)) {
+            continue;
+        }
+        double value = measures.value(field);
+        if (!series) {
+            series = &d->mModules[moduleId];
+        }
+        unique_ptr<TimeSeries> &fieldSeries = (*series)[i];
+        if (!fieldSeries) {
+            fieldSeries.reset(new TimeSeries);
+        }
+        if (fieldSeries->append(measures.mTimeStamp, value)) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+size_t TimeSeriesStore::append(const list<Station> &stations) {
+    size_t count = 0;
+    for (const Station &station: stations) {
+        for (const Module &module: station.modulesRef()) {
+            count += append(module.id(), module.measures());
+        }
+    }
+    return count;
+}
+
+const TimeSeries *TimeSeriesStore::series(const string &moduleId, Measures::Field field) const {
+    if (field < 0 || field >= Measures::fieldCount) {
+        return nullptr;
+    }
+    auto it = d->mModules.find(moduleId);
+    if (it == d->mModules.end()) {
+        return nullptr;
+    }
+    return it->second[field].get();
+}
+
+vector<string> TimeSeriesStore::moduleIds() const {
+    vector<string> ids;
+    ids.reserve(d->mModules.size());
+    for (const auto &module: d->mModules) {
+        ids.push_back(module.first);
+    }
+    return ids;
+}
+
+void TimeSeriesStore::removeBefore(uint64_t timeStamp) {
+    for (auto &module: d->mModules) {
+        for (unique_ptr<TimeSeries> &series: module.second) {
+            if (series) {
+                series->removeBefore(timeStamp);
+            }
+        }
+    }
+}
+
+size_t TimeSeriesStore::size() const {
+    size_t size = 0;
+    for (const auto &module: d->mModules) {
+        for (const unique_ptr<TimeSeries> &series: module.second) {
+            if (series) {
+                size += series->size();
+            }
+        }
+    }
+    return size;
+}
+
+size_t TimeSeriesStore::memoryUsage() const {
+    size_t usage = sizeof(TimeSeriesStore) + sizeof(TimeSeriesStorePrivate);
+    for (const auto &module: d->mModules) {
+        usage += sizeof(module) + module.first.capacity();
+        for (const unique_ptr<TimeSeries> &series: module.second) {
+            if (series) {
+                usage += series->memoryUsage();
+            }
+        }
+    }
+    return usage;
+}
+
+TimeSeriesStore &TimeSeriesStore::operator =(const TimeSeriesStore &o) {
+    d.reset(new TimeSeriesStorePrivate(*o.d));
+    return *this;
+}
+
+TimeSeriesStore &TimeSeriesStore::operator =(TimeSeriesStore &&o) noexcept {
+    d = move(o.d);
+    return *this;
+}
+
+}
@@ -0,0 +1,264 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef TIMESERIES_H
+#define TIMESERIES_H
+
+#include "model/station.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace netatmoapi {
+
+struct TimeSeriesPrivate;
+struct TimeSeriesStorePrivate;
+
+/**
+ * @brief This class stores a compressed time series of one measure value.
+ *
+ * The time stamps are stored as delta of deltas, like in the Gorilla
+ * paper of Facebook. Values with up to 3 decimal places, like the values
+ * of the api, are stored as delta of the value times 10^decimals, with the
+ * fewest decimals, which restore all values of a block bit by bit. Other
+ * values, e.g. NaN or -0.0, are stored as XOR of the previous value. A
+ * noisy 5 minute series with one decimal place needs about 1 byte per
+ * measure instead of 16.
+ *
+ * The measures are stored in blocks of up to sBlockSize measures. Every
+ * block knows its first and last time stamp, so a ranged scan only
+ * decodes the blocks in the range.
+ */
+class TimeSeries {
+public:
+    /**
+     * Default constructor.
+     */
+    TimeSeries();
+
+    /**
+     * Copy constructor.
+     * @param o The element to copy.
+     */
+    TimeSeries(const TimeSeries &o);
+
+    /**
+     * Move constructor.
+     * @param o The element to move.
+     */
+    TimeSeries(TimeSeries &&o) noexcept;
+
+    /**
+     * Destructor.
+     * Is default.
+     */
+    virtual ~TimeSeries() noexcept;
+
+    /**
+     * Appends a measure.
+     *
+     * Polling returns the same measure until the module sends a new one,
+     * so a measure with a time stamp, which is not newer than the last
+     * one, is ignored.
+     *
+     * @param timeStamp The time stamp of the measure.
+     * @param value The value of the measure.
+     * @return True, if the measure was appended.
+     */
+    bool append(std::uint64_t timeStamp, double value);
+
+    /**
+     * Calls callback for every measure with begin <= time stamp <= end, in time order.
+     * @param begin The begin of the range.
+     * @param end The end of the range.
+     * @param callback Called with the time stamp and the value of each measure.
+     * @return The number of measures in the range.
+     */
+    std::size_t scan(std::uint64_t begin, std::uint64_t end, const std::function<void (std::uint64_t, double)> &callback) const;
+
+    /**
+     * Appends every measure with begin <= time stamp <= end to the columns, in time order.
+     * @param begin The begin of the range.
+     * @param end The end of the range.
+     * @param timeStamps The column to append the time stamps to.
+     * @param values The column to append the values to.
+     * @return The number of measures in the range.
+     */
+    std::size_t read(std::uint64_t begin, std::uint64_t end, std::vector<std::uint64_t> &timeStamps, std::vector<double> &values) const;
+
+    /**
+     * Removes all blocks, which only contain measures older than timeStamp.
+     * @param timeStamp The oldest time stamp to keep.
+     */
+    void removeBefore(std::uint64_t timeStamp);
+
+    /**
+     * Returns the number of measures.
+     * @return The number of measures.
+     */
+    std::size_t size() const;
+
+    /**
+     * Returns the time stamp of the first measure.
+     * @return The time stamp, 0 if the series is empty.
+     */
+    std::uint64_t firstTimeStamp() const;
+
+    /**
+     * Returns the time stamp of the last measure.
+     * @return The time stamp, 0 if the series is empty.
+     */
+    std::uint64_t lastTimeStamp() const;
+
+    /**
+     * Returns the memory, which is used by the series.
+     * @return The memory usage in bytes.
+     */
+    std::size_t memoryUsage() const;
+
+    /**
+     * Copy assignment operator.
+     * @param o The element to copy.
+     * @return This element as reference.
+     */
+    TimeSeries &operator =(const TimeSeries &o);
+
+    /**
+     * Move assignment operator.
+     * @param o The element to move.
+     * @return This element as reference.
+     */
+    TimeSeries &operator =(TimeSeries &&o) noexcept;
+
+    /**
+     * The maximum number of measures per block.
+     *
+     * Value: 1024
+     */
+    static const std::size_t sBlockSize;
+
+private:
+    std::unique_ptr<TimeSeriesPrivate> d;
+};
+
+/**
+ * @brief This class stores compressed time series per module and measure value.
+ *
+ * The store is fed with the Measures of a module, e.g. from
+ * utils::parseMeasures() or utils::parseDevices(). Every measure value,
+ * which is not missing, is appended to the TimeSeries of the module and
+ * the Measures::Field.
+ */
+class TimeSeriesStore {
+public:
+    /**
+     * Default constructor.
+     */
+    TimeSeriesStore();
+
+    /**
+     * Copy constructor.
+     * @param o The element to copy.
+     */
+    TimeSeriesStore(const TimeSeriesStore &o);
+
+    /**
+     * Move constructor.
+     * @param o The element to move.
+     */
+    TimeSeriesStore(TimeSeriesStore &&o) noexcept;
+
+    /**
+     * Destructor.
+     * Is default.
+     */
+    virtual ~TimeSeriesStore() noexcept;
+
+    /**
+     * Appends the measures of a module.
+     * @param moduleId The id of the module.
+     * @param measures The measures of the module.
+     * @return The number of appended measure values.
+     */
+    std::size_t append(const std::string &moduleId, const Measures &measures);
+
+    /**
+     * Appends the measures of all modules of a fleet.
+     * @param stations The fleet, e.g. the result of utils::parseDevices().
+     * @return The number of appended measure values.
+     */
+    std::size_t append(const std::list<Station> &stations);
+
+    /**
+     * Returns the time series of a module and a measure value.
+     * @param moduleId The id of the module.
+     * @param field The measure value.
+     * @return The time series, or nullptr if there are no measures.
+     */
+    const TimeSeries *series(const std::string &moduleId, Measures::Field field) const;
+
+    /**
+     * Returns the ids of all modules in the store.
+     * @return The module ids.
+     */
+    std::vector<std::string> moduleIds() const;
+
+    /**
+     * Removes all blocks, which only contain measures older than timeStamp.
+     * @param timeStamp The oldest time stamp to keep.
+     */
+    void removeBefore(std::uint64_t timeStamp);
+
+    /**
+     * Returns the number of measure values of all series.
+     * @return The number of measure values.
+     */
+    std::size_t size() const;
+
+    /**
+     * Returns the memory, which is used by the store.
+     * @return The memory usage in bytes.
+     */
+    std::size_t memoryUsage() const;
+
+    /**
+     * Copy assignment operator.
+     * @param o The element to copy.
+     * @return This element as reference.
+     */
+    TimeSeriesStore &operator =(const TimeSeriesStore &o);
+
+    /**
+     * Move assignment operator.
+     * @param o The element to move.
+     * @return This element as reference.
+     */
+    TimeSeriesStore &operator =(TimeSeriesStore &&o) noexcept;
+
+private:
+    std::unique_ptr<TimeSeriesStorePrivate> d;
+};
+
+}
+
+#endif /* TIMESERIES_H */
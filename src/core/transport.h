@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+#include <map>
+#include <string>
+
+namespace netatmoapi {
+
+/**
+ * @brief Interface of the http transport of the api clients.
+ *
+ * A transport sends a request and returns the raw response body. The
+ * client builds the parameters, applies the rate limit, parses the json
+ * and maps api errors to exceptions, so a transport only moves bytes.
+ *
+ * The default transport of a client is CurlTransport. Other transports,
+ * e.g. with canned responses, are set with NAApiClient::setTransport().
+ * The clients call get() and post() concurrently from many threads, so
+ * implementations must be thread safe.
+ */
+class Transport {
+public:
+    /**
+     * Destructor.
+     * Is default.
+     */
+    virtual ~Transport() noexcept = default;
+
+    /**
+     * Performs a http get request.
+     * @param url The request url without query.
+     * @param params The query parameters.
+     * @return The response body.
+     * @throw std::exception An implementation specific exception, if the request failed, e.g. CurlException.
+     */
+    virtual std::string get(const std::string &url, const std::map<std::string, std::string> &params) = 0;
+
+    /**
+     * Performs a http post request with url encoded parameters.
+     * @param url The request url.
+     * @param params The post parameters.
+     * @return The response body.
+     * @throw std::exception An implementation specific exception, if the request failed, e.g. CurlException.
+     */
+    virtual std::string post(const std::string &url, const std::map<std::string, std::string> &params) = 0;
+};
+
+}
+
+#endif /* TRANSPORT_H */
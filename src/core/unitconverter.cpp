@@ -0,0 +1,237 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "unitconverter.h"
+#include "simd.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+using namespace std;
+
+namespace netatmoapi {
+
+namespace {
+
+const double cMissing = numeric_limits<double>::min();
+
+// Lower bounds of the Beaufort numbers 1 to 12 in km/h.
+const double cBeaufortLimits[] = { 1, 6, 12, 20, 29, 39, 50, 62, 75, 89, 103, 118 };
+
+double toBeaufort(double kph) {
+    if (kph == cMissing) {
+        return cMissing;
+    }
+    double number = 0;
+    for (double limit: cBeaufortLimits) {
+        number += kph >= limit ? 1 : 0;
+    }
+    return number;
+}
+
+void toBeaufort(const double *values, double *result, size_t count) {
+    size_t i = 0;
+#ifdef __SSE2__
+    // Counts the exceeded limits, a true compare is all bits set, i.e. 1.0 after the and.
+    const __m128d missing = _mm_set1_pd(cMissing);
+    const __m128d one = _mm_set1_pd(1.0);
+    for (; i + 2 <= count; i += 2) {
+        __m128d value = _mm_loadu_pd(values + i);
+        __m128d number = _mm_setzero_pd();
+        for (double limit: cBeaufortLimits) {
+            number = _mm_add_pd(number, _mm_and_pd(_mm_cmpge_pd(value, _mm_set1_pd(limit)), one));
+        }
+        _mm_storeu_pd(result + i, simd::select(_mm_cmpneq_pd(value, missing), number, missing));
+    }
+#endif
+    for (; i < count; ++i) {
+        result[i] = toBeaufort(values[i]);
+    }
+}
+
+}
+
+UnitConverter::UnitConverter(const UserSettings &settings) :
+    mSettings(settings)
+{
+    mConversions.fill({ identity, 1, 0 });
+    if (settings.mUnit == UserSettings::imperial) {
+        for (Measures::Field field: { Measures::temperature, Measures::minTemperature, Measures::maxTemperature }) {
+            mConversions[field] = { linear, 1.8, 32 };
+        }
+        for (Measures::Field field: { Measures::rain, Measures::sumRain1, Measures::sumRain24 }) {
+            mConversions[field] = { linear, 1 / 25.4, 0 };
+        }
+    }
+
+    Conversion pressure = { identity, 1, 0 };
+    if (settings.mPressureUnit == UserSettings::inHg) {
+        pressure = { linear, 0.029529983071445, 0 };
+    } else if (settings.mPressureUnit == UserSettings::mmHg) {
+        pressure = { linear, 0.750061682704170, 0 };
+    }
+    mConversions[Measures::pressure] = pressure;
+    mConversions[Measures::absolutePressure] = pressure;
+
+    Conversion wind = { identity, 1, 0 };
+    if (settings.mWindUnit == UserSettings::mph) {
+        wind = { linear, 1 / 1.609344, 0 };
+    } else if (settings.mWindUnit == UserSettings::ms) {
+        wind = { linear, 1 / 3.6, 0 };
+    } else if (settings.mWindUnit == UserSettings::knot) {
+        wind = { linear, 1 / 1.852, 0 };
+    } else if (settings.mWindUnit == UserSettings::beaufort) {
+        wind = { beaufort, 1, 0 };
+    }
+    for (Measures::Field field: { Measures::windStrength, Measures::gustStrength, Measures::maxWindStrength }) {
+        mConversions[field] = wind;
+    }
+}
+
+const UserSettings &UnitConverter::settings() const {
+    return mSettings;
+}
+
+bool UnitConverter::converts(Measures::Field field) const {
+    return field >= 0 && field < Measures::fieldCount && mConversions[field].mKind != identity;
+}
+
+string UnitConverter::unit(Measures::Field field) const {
+    switch (field) {
+    case Measures::temperature:
+    case Measures::minTemperature:
+    case Measures::maxTemperature:
+        return mSettings.mUnit == UserSettings::imperial ? "°F" : "°C";
+    case Measures::rain:
+    case Measures::sumRain1:
+    case Measures::sumRain24:
+        return mSettings.mUnit == UserSettings::imperial ? "in" : "mm";
+    case Measures::pressure:
+    case Measures::absolutePressure:
+        switch (mSettings.mPressureUnit) {
+        case UserSettings::inHg:
+            return "inHg";
+        case UserSettings::mmHg:
+            return "mmHg";
+        default:
+            return "mbar";
+        }
+    case Measures::windStrength:
+    case Measures::gustStrength:
+    case Measures::maxWindStrength:
+        switch (mSettings.mWindUnit) {
+        case UserSettings::mph:
+            return "mph";
+        case UserSettings::ms:
+            return "m/s";
+        case UserSettings::beaufort:
+            return "bft";
+        case UserSettings::knot:
+            return "kn";
+        default:
+            return "km/h";
+        }
+    case Measures::windAngle:
+    case Measures::gustAngle:
+    case Measures::maxWindAngle:
+        return "°";
+    case Measures::co2:
+        return "ppm";
+    case Measures::humidity:
+        return "%";
+    case Measures::noise:
+        return "dB";
+    default:
+        return "";
+    }
+}
+
+double UnitConverter::convert(Measures::Field field, double value) const {
+    double result = value;
+    convert(field, &value, &result, 1);
+    return result;
+}
+
+void UnitConverter::convert(Measures::Field field, const double *values, double *result, size_t count) const {
+    Kind kind = converts(field) ? mConversions[field].mKind : identity;
+    switch (kind) {
+    case linear:
+        simd::linear(values, result, count, mConversions[field].mScale, mConversions[field].mOffset, cMissing);
+        break;
+    case beaufort:
+        toBeaufort(values, result, count);
+        break;
+    case identity:
+        if (result != values) {
+            copy(values, values + count, result);
+        }
+        break;
+    }
+}
+
+Measures UnitConverter::convert(const Measures &measures) const {
+    Measures result = measures;
+    for (int i = 0; i < Measures::fieldCount; ++i) {
+        Measures::Field field = static_cast<Measures::Field>(i);
+        if (mConversions[i].mKind != identity) {
+            result.setValue(field, convert(field, measures.value(field)));
+        }
+    }
+    return result;
+}
+
+MeasureColumns UnitConverter::convert(const MeasureColumns &columns, const vector<Measures::Field> &fields) const {
+    if (fields.size() != columns.mValues.size()) {
+        throw invalid_argument("Number of fields does not match the number of columns.");
+    }
+    MeasureColumns result;
+    result.mTimeStamps = columns.mTimeStamps;
+    result.mValues.resize(columns.mValues.size());
+    for (size_t i = 0; i < fields.size(); ++i) {
+        const vector<double> &column = columns.mValues[i];
+        result.mValues[i].resize(column.size());
+        convert(fields[i], column.data(), result.mValues[i].data(), column.size());
+    }
+    return result;
+}
+
+MeasureColumns UnitConverter::convert(const list<Station> &stations) const {
+    MeasureColumns result(Measures::fieldCount);
+    size_t size = 0;
+    for (const Station &station: stations) {
+        size += station.modulesRef().size();
+    }
+    result.reserve(size);
+    for (const Station &station: stations) {
+        for (const Module &module: station.modulesRef()) {
+            Measures measures = module.measures();
+            result.mTimeStamps.push_back(measures.mTimeStamp);
+            for (int i = 0; i < Measures::fieldCount; ++i) {
+                result.mValues[i].push_back(measures.value(static_cast<Measures::Field>(i)));
+            }
+        }
+    }
+    for (int i = 0; i < Measures::fieldCount; ++i) {
+        vector<double> &column = result.mValues[i];
+        convert(static_cast<Measures::Field>(i), column.data(), column.data(), column.size());
+    }
+    return result;
+}
+
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef UNITCONVERTER_H
+#define UNITCONVERTER_H
+
+#include "model/measurecolumns.h"
+#include "model/measures.h"
+#include "model/station.h"
+#include "model/usersettings.h"
+
+#include <array>
+#include <cstddef>
+#include <list>
+#include <string>
+#include <vector>
+
+namespace netatmoapi {
+
+/**
+ * @brief This class converts metric measures into the units of a user.
+ *
+ * The conversion of every field is looked up once in the constructor.
+ * Temperatures, rain, pressures and wind strengths are converted, all
+ * other fields, e.g. humidity, angles, trends and dates, are copied.
+ * Missing values, i.e. std::numeric_limits<double>::min(), stay missing.
+ *
+ * The converter never modifies its input. Fleets and time series are
+ * converted into new columns in one vectorized pass per column, so the
+ * parsed metric data can still be diffed, stored and aggregated.
+ */
+class UnitConverter {
+public:
+    /**
+     * Constructor.
+     * @param settings The settings of the user, e.g. from utils::parseUserSettings().
+     */
+    explicit UnitConverter(const UserSettings &settings = UserSettings());
+
+    /**
+     * Returns the settings of the user.
+     * @return The settings.
+     */
+    const UserSettings &settings() const;
+
+    /**
+     * Returns true, if the field is converted.
+     * @param field The field.
+     * @return False, if the user unit is the metric unit of the api.
+     */
+    bool converts(Measures::Field field) const;
+
+    /**
+     * Returns the unit symbol of a field in the units of the user.
+     * @param field The field.
+     * @return The symbol, e.g. "°F" or "km/h". Empty for trends and dates.
+     */
+    std::string unit(Measures::Field field) const;
+
+    /**
+     * Converts a value.
+     * @param field The field of the value.
+     * @param value The metric value.
+     * @return The value in the unit of the user.
+     */
+    double convert(Measures::Field field, double value) const;
+
+    /**
+     * Converts a column of values.
+     * @param field The field of the values.
+     * @param values The metric values.
+     * @param result The converted values, may be values.
+     * @param count The number of values.
+     */
+    void convert(Measures::Field field, const double *values, double *result, std::size_t count) const;
+
+    /**
+     * Converts all fields of a measure.
+     * @param measures The metric measures.
+     * @return The measures in the units of the user.
+     */
+    Measures convert(const Measures &measures) const;
+
+    /**
+     * Converts a time series, e.g. from utils::decodeMeasureBlocks().
+     * @param columns The metric time series.
+     * @param fields The field of every column of columns.
+     * @return The time series in the units of the user.
+     * @throw std::invalid_argument If there is not one field per column.
+     */
+    MeasureColumns convert(const MeasureColumns &columns, const std::vector<Measures::Field> &fields) const;
+
+    /**
+     * Converts the current measures of a fleet.
+     *
+     * The result has one row per module in the order of the stations and
+     * of Station::modulesRef(), and one column per field, i.e.
+     * mValues[field][row]. The time stamps are the time stamps of the
+     * measures.
+     *
+     * @param stations The fleet, e.g. from utils::parseDevices().
+     * @return The measures of all modules in the units of the user.
+     */
+    MeasureColumns convert(const std::list<Station> &stations) const;
+
+private:
+    enum Kind {
+        identity,
+        linear,
+        beaufort
+    };
+
+    struct Conversion {
+        Kind    mKind;
+        double  mScale;
+        double  mOffset;
+    };
+
+    UserSettings                                        mSettings;
+    std::array<Conversion, Measures::fieldCount>        mConversions;
+};
+
+}
+
+#endif /* UNITCONVERTER_H */
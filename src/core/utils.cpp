@@ -24,6 +24,9 @@
 #include <iomanip>
 #include <cstdlib>
 #include <iostream>
+#include <unordered_map>
+#include <limits>
+#include <algorithm>
 
 using namespace std;
 
@@ -65,40 +68,282 @@ string urlEncode(const string &toEncode) {
     return escaped.str();
 }
 
+uint64_t scaleInterval(const string &scale) {
+    if (scale == params::cScaleMax) {
+        return 5 * 60;
+    } else if (scale == params::cScale30Min) {
+        return 30 * 60;
+    } else if (scale == params::cScale1Hour) {
+        return 60 * 60;
+    } else if (scale == params::cScale3Hours) {
+        return 3 * 60 * 60;
+    } else if (scale == params::cScale1Day) {
+        return 24 * 60 * 60;
+    } else if (scale == params::cScale1Week) {
+        return 7 * 24 * 60 * 60;
+    } else if (scale == params::cScale1Month) {
+        return 31 * 24 * 60 * 60;
+    }
+    throw invalid_argument("Unknown scale.");
+}
+
+vector<pair<uint64_t, uint64_t>> splitTimeRange(uint64_t begin, uint64_t end, const string &scale, size_t maxMeasures) {
+    if (maxMeasures == 0) {
+        throw invalid_argument("Invalid maximum number of measures.");
+    }
+    uint64_t chunkLength = scaleInterval(scale) * maxMeasures;
+    vector<pair<uint64_t, uint64_t>> chunks;
+    if (end < begin) {
+        return chunks;
+    }
+    chunks.reserve((end - begin) / chunkLength + 1);
+    for (uint64_t chunkBegin = begin; ; chunkBegin += chunkLength) {
+        if (end - chunkBegin < chunkLength) {
+            chunks.emplace_back(chunkBegin, end);
+            break;
+        }
+        chunks.emplace_back(chunkBegin, chunkBegin + chunkLength - 1);
+    }
+    return chunks;
+}
+
+namespace {
+
+template <typename T>
+typename list<T>::iterator takeById(list<T> &elements, typename list<T>::iterator pos, const string &id, bool *found = nullptr) {
+    for (auto it = pos; it != elements.end(); ++it) {
+        if (it->hasId(id)) {
+            if (it != pos) {
+                elements.splice(pos, elements, it);
+            }
+            if (found) {
+                *found = true;
+            }
+            return it;
+        }
+    }
+    if (found) {
+        *found = false;
+    }
+    return elements.emplace(pos);
+}
+
+void updateModule(Module &module, const json &jsonModule, const string &id, const string &type, bool isMainModule) {
+    if (!module.hasId(id)) {
+        module.setId(id);
+    }
+    module.setName(jsonModule["module_name"].get_ref<const string &>());
+    module.setType(type);
+    if (!isMainModule) {
+        module.setBatteryPercent(jsonModule["battery_percent"]);
+        module.setRfStatus(jsonModule["rf_status"]);
+    }
+    const json &dashboardData = jsonModule["dashboard_data"];
+    module.setMeasures(parseMeasures(dashboardData, type));
+    if (type == Module::sTypeWindGauge) {
+        parseWindHistoric(dashboardData, module.windHistory());
+    }
+}
+
+// Assigns into the existing place, so the strings keep their storage across polls.
+void updatePlace(Place &place, const json &jsonPlace) {
+    auto location = jsonPlace.find("location");
+    if (location != jsonPlace.end() && location->size() >= 2) {
+        place.mLongitude = (*location)[0];
+        place.mLatitude = (*location)[1];
+    } else {
+        place.mLatitude = numeric_limits<double>::min();
+        place.mLongitude = numeric_limits<double>::min();
+    }
+    place.mAltitude = jsonPlace.value("altitude", numeric_limits<double>::min());
+    auto assign = [&jsonPlace](const char *key, string &value) {
+        auto it = jsonPlace.find(key);
+        if (it != jsonPlace.end() && it->is_string()) {
+            value = it->get_ref<const string &>();
+        } else {
+            value.clear();
+        }
+    };
+    assign("city", place.mCity);
+    assign("country", place.mCountry);
+    assign("timezone", place.mTimeZone);
+}
+
+void updateStation(Station &station, const json &jsonStation) {
+    const string &id = jsonStation["_id"].get_ref<const string &>();
+    if (!station.hasId(id)) {
+        station.setId(id);
+    }
+    station.setName(jsonStation["station_name"].get_ref<const string &>());
+    auto jsonPlace = jsonStation.find("place");
+    if (jsonPlace != jsonStation.end()) {
+        updatePlace(station.placeRef(), *jsonPlace);
+    }
+
+    list<Module> &modules = station.modulesRef();
+    auto pos = modules.begin();
+    auto mainModule = takeById(modules, pos, id);
+    updateModule(*mainModule, jsonStation, id, jsonStation["type"].get_ref<const string &>(), true);
+    pos = next(mainModule);
+
+    auto jsonModules = jsonStation.find("modules");
+    if (jsonModules != jsonStation.end()) {
+        for (const json &jsonModule: *jsonModules) {
+            const string &moduleId = jsonModule["_id"].get_ref<const string &>();
+            auto module = takeById(modules, pos, moduleId);
+            updateModule(*module, jsonModule, moduleId, jsonModule["type"].get_ref<const string &>(), false);
+            pos = next(module);
+        }
+    }
+    modules.erase(pos, modules.end());
+}
+
+}
+
 list<Station> parseDevices(const json &response) {
     list<Station> devices;
+    parseDevices(response, devices);
+    return devices;
+}
 
-    if (response.find("body") != response.end()) {
-        json jsonBody = response["body"];
-        if (jsonBody.find("devices") != jsonBody.end()) {
-            json jsonStations = jsonBody["devices"];
-            for (const json &jsonStation: jsonStations) {
-                Measures measures = parseMeasures(jsonStation["dashboard_data"], jsonStation["type"]);
-                Station station(forward<string>(jsonStation["station_name"]), forward<string>(jsonStation["_id"]));
-                Module mainModule(forward<string>(jsonStation["module_name"]), forward<string>(jsonStation["_id"]), forward<string>(jsonStation["type"]));
-                mainModule.setMeasures(move(measures));
-                station.addModule(move(mainModule));
-
-                json jsonModules = jsonStation["modules"];
-                for (const json &jsonModule: jsonModules) {
-                    string name = jsonModule["module_name"];
-                    string id = jsonModule["_id"];
-                    string type = jsonModule["type"];
-                    int16_t batteryPercent = jsonModule["battery_percent"];
-                    int16_t rfStatus = jsonModule["rf_status"];
-
-                    Measures measures = parseMeasures(jsonModule["dashboard_data"], type);
-                    Module module(move(name), move(id), move(type), batteryPercent, rfStatus);
-                    module.setMeasures(move(measures));
-                    station.addModule(move(module));
+void parseDevices(const json &response, list<Station> &stations) {
+    parseDevices(response, stations, function<bool (const json &)>());
+}
+
+void parseDevices(const json &response, list<Station> &stations, const function<bool (const json &)> &isUnchanged) {
+    auto pos = stations.begin();
+
+    auto jsonBody = response.find("body");
+    if (jsonBody != response.end()) {
+        auto jsonStations = jsonBody->find("devices");
+        if (jsonStations != jsonBody->end()) {
+            for (const json &jsonStation: *jsonStations) {
+                bool found;
+                auto station = takeById(stations, pos, jsonStation["_id"].get_ref<const string &>(), &found);
+                bool unchanged = isUnchanged && isUnchanged(jsonStation);
+                if (!found || !unchanged) {
+                    updateStation(*station, jsonStation);
                 }
+                pos = next(station);
+            }
+        }
+    }
+
+    stations.erase(pos, stations.end());
+}
 
-                devices.emplace_back(move(station));
+vector<PublicStation> parsePublicData(const json &response) {
+    vector<PublicStation> stations;
+    parsePublicData(response, stations);
+    return stations;
+}
+
+void parsePublicData(const json &response, vector<PublicStation> &stations) {
+    static const unordered_map<string, Measures::Field> cResTypes = {
+        { "temperature", Measures::temperature },
+        { "humidity", Measures::humidity },
+        { "pressure", Measures::pressure }
+    };
+
+    auto jsonBody = response.find("body");
+    if (jsonBody == response.end() || !jsonBody->is_array()) {
+        return;
+    }
+    stations.reserve(stations.size() + jsonBody->size());
+    for (const json &jsonStation: *jsonBody) {
+        auto id = jsonStation.find("_id");
+        auto place = jsonStation.find("place");
+        if (id == jsonStation.end() || place == jsonStation.end()) {
+            continue;
+        }
+        auto location = place->find("location");
+        if (location == place->end() || location->size() < 2) {
+            continue;
+        }
+        PublicStation station;
+        station.mId = id->get<string>();
+        station.mLongitude = (*location)[0];
+        station.mLatitude = (*location)[1];
+        station.mAltitude = place->value("altitude", numeric_limits<double>::min());
+
+        Measures &measures = station.mMeasures;
+        auto jsonMeasures = jsonStation.find("measures");
+        if (jsonMeasures != jsonStation.end()) {
+            for (const json &jsonModule: *jsonMeasures) {
+                auto res = jsonModule.find("res");
+                auto types = jsonModule.find("type");
+                if (res != jsonModule.end() && types != jsonModule.end()) {
+                    // Only the newest time stamp of a module.
+                    uint64_t newest = 0;
+                    const json *values = nullptr;
+                    for (auto it = res->begin(); it != res->end(); ++it) {
+                        uint64_t timeStamp = strtoull(it.key().c_str(), nullptr, 10);
+                        if (!values || timeStamp > newest) {
+                            newest = timeStamp;
+                            values = &it.value();
+                        }
+                    }
+                    if (!values) {
+                        continue;
+                    }
+                    for (size_t i = 0; i < types->size() && i < values->size(); ++i) {
+                        auto field = cResTypes.find((*types)[i].get_ref<const string &>());
+                        if (field != cResTypes.end() && (*values)[i].is_number()) {
+                            measures.setValue(field->second, (*values)[i]);
+                        }
+                    }
+                    measures.mTimeStamp = max(measures.mTimeStamp, newest);
+                } else if (jsonModule.find("rain_timeutc") != jsonModule.end()) {
+                    measures.mRain = jsonModule.value("rain_live", numeric_limits<double>::min());
+                    measures.mSumRain1 = jsonModule.value("rain_60min", numeric_limits<double>::min());
+                    measures.mSumRain24 = jsonModule.value("rain_24h", numeric_limits<double>::min());
+                    measures.mTimeStamp = max(measures.mTimeStamp, jsonModule["rain_timeutc"].get<uint64_t>());
+                } else if (jsonModule.find("wind_timeutc") != jsonModule.end()) {
+                    measures.mWindStrength = jsonModule.value("wind_strength", numeric_limits<double>::min());
+                    measures.mWindAngle = jsonModule.value("wind_angle", numeric_limits<double>::min());
+                    measures.mGustStrength = jsonModule.value("gust_strength", numeric_limits<double>::min());
+                    measures.mGustAngle = jsonModule.value("gust_angle", numeric_limits<double>::min());
+                    measures.mTimeStamp = max(measures.mTimeStamp, jsonModule["wind_timeutc"].get<uint64_t>());
+                }
             }
         }
+        stations.push_back(move(station));
     }
+}
 
-    return devices;
+UserSettings parseUserSettings(const json &response) {
+    UserSettings settings;
+    auto jsonBody = response.find("body");
+    if (jsonBody == response.end()) {
+        return settings;
+    }
+    auto jsonUser = jsonBody->find("user");
+    if (jsonUser == jsonBody->end()) {
+        return settings;
+    }
+    auto administrative = jsonUser->find("administrative");
+    if (administrative == jsonUser->end()) {
+        return settings;
+    }
+    int unit = administrative->value(params::cSettingUnit, 0);
+    if (unit >= UserSettings::metric && unit <= UserSettings::imperial) {
+        settings.mUnit = static_cast<UserSettings::Unit>(unit);
+    }
+    int windUnit = administrative->value(params::cSettingWindUnit, 0);
+    if (windUnit >= UserSettings::kph && windUnit <= UserSettings::knot) {
+        settings.mWindUnit = static_cast<UserSettings::WindUnit>(windUnit);
+    }
+    int pressureUnit = administrative->value(params::cSettingPressureUnit, 0);
+    if (pressureUnit >= UserSettings::mbar && pressureUnit <= UserSettings::mmHg) {
+        settings.mPressureUnit = static_cast<UserSettings::PressureUnit>(pressureUnit);
+    }
+    int feelLikeAlgorithm = administrative->value(params::cSettingFeelLikeAlgorithm, 0);
+    if (feelLikeAlgorithm >= UserSettings::humidex && feelLikeAlgorithm <= UserSettings::heatIndex) {
+        settings.mFeelLikeAlgorithm = static_cast<UserSettings::FeelLikeAlgorithm>(feelLikeAlgorithm);
+    }
+    settings.mLang = administrative->value(params::cSettingLang, string());
+    settings.mRegLocale = administrative->value(params::cSettingRegLocale, string());
+    return settings;
 }
 
 Measures parseMeasures(const json &dashbordData, const string &moduleType) {
@@ -134,9 +379,222 @@ Measures parseMeasures(const json &dashbordData, const string &moduleType) {
         measures.mWindAngle = dashbordData[params::cTypeWindAngle];
         measures.mGustStrength = dashbordData[params::cTypeGustStrength];
         measures.mGustAngle = dashbordData[params::cTypeGustAngle];
+        auto maxWindStrength = dashbordData.find(params::cTypeMaxWindStr);
+        if (maxWindStrength != dashbordData.end()) {
+            measures.mMaxWindStrength = *maxWindStrength;
+            measures.mMaxWindAngle = dashbordData.value(params::cTypeMaxWindAngle, numeric_limits<double>::min());
+            measures.mDateMaxWindStrength = dashbordData.value(params::cTypeDateMaxWindStr, uint64_t(0));
+        }
     }
     return measures;
 }
 
+size_t parseWindHistoric(const json &dashbordData, WindHistory &history) {
+    auto windHistoric = dashbordData.find(params::cTypeWindHistoric);
+    if (windHistoric == dashbordData.end()) {
+        return 0;
+    }
+    // Samples up to the newest one of the history were appended by an earlier poll.
+    const bool hasNewest = !history.empty();
+    const uint64_t newest = hasNewest ? history.back().mTimeStamp : 0;
+    auto isNew = [&](uint64_t timeStamp) {
+        return !hasNewest || timeStamp > newest;
+    };
+
+    // The samples are ordered by time and are appended directly. Only out
+    // of order samples are staged and sorted, because WindHistory::append()
+    // drops every sample older than the newest one.
+    bool ordered = true;
+    bool first = true;
+    uint64_t previous = 0;
+    for (const json &jsonSample: *windHistoric) {
+        uint64_t timeStamp = jsonSample[params::cTypeTimeUtc];
+        if (!isNew(timeStamp)) {
+            continue;
+        }
+        if (!first && timeStamp < previous) {
+            ordered = false;
+            break;
+        }
+        first = false;
+        previous = timeStamp;
+    }
+
+    size_t appended = 0;
+    for (const json &jsonSample: *windHistoric) {
+        WindSample sample;
+        sample.mTimeStamp = jsonSample[params::cTypeTimeUtc];
+        if (!isNew(sample.mTimeStamp)) {
+            continue;
+        }
+        sample.mWindStrength = jsonSample[params::cTypeWindStrength];
+        sample.mWindAngle = jsonSample[params::cTypeWindAngle];
+        if (!ordered) {
+            history.stage(sample);
+        } else if (history.append(sample)) {
+            ++appended;
+        }
+    }
+    if (!ordered) {
+        appended = history.appendStaged();
+    }
+    return appended;
+}
+
+void decodeMeasureBlocks(const json &blocks, MeasureColumns &columns) {
+    static const string cBegTime = "beg_time";
+    static const string cStepTime = "step_time";
+    static const string cValue = "value";
+    const double missing = numeric_limits<double>::min();
+
+    size_t size = columns.size();
+    for (const json &block: blocks) {
+        auto values = block.find(cValue);
+        if (values == block.end()) {
+            continue;
+        }
+        if (values->size() > 1 && block.find(cStepTime) == block.end()) {
+            throw invalid_argument("Measure block without step time.");
+        }
+        size += values->size();
+        if (columns.mValues.empty() && !values->empty()) {
+            columns.mValues.resize(values->front().size());
+            for (vector<double> &column: columns.mValues) {
+                column.resize(columns.mTimeStamps.size(), missing);
+            }
+        }
+    }
+    columns.reserve(size);
+
+    const size_t typeCount = columns.mValues.size();
+    for (const json &block: blocks) {
+        auto values = block.find(cValue);
+        if (values == block.end() || values->empty()) {
+            continue;
+        }
+        uint64_t timeStamp = block[cBegTime];
+        uint64_t step = 0;
+        auto stepTime = block.find(cStepTime);
+        if (stepTime != block.end()) {
+            step = *stepTime;
+        }
+
+        for (const json &row: *values) {
+            columns.mTimeStamps.push_back(timeStamp);
+            const size_t rowSize = row.size();
+            for (size_t type = 0; type < typeCount; ++type) {
+                double value = missing;
+                if (type < rowSize) {
+                    const json &jsonValue = row[type];
+                    if (jsonValue.is_number()) {
+                        value = jsonValue.get<double>();
+                    }
+                }
+                columns.mValues[type].push_back(value);
+            }
+            timeStamp += step;
+        }
+    }
+}
+
+MeasureColumns decodeMeasureBlocks(const json &blocks) {
+    MeasureColumns columns;
+    decodeMeasureBlocks(blocks, columns);
+    return columns;
+}
+
+void diffDevices(const list<Station> &oldStations, const list<Station> &newStations, const function<void (const Change &)> &callback) {
+    vector<const Module *> oldModules;
+    for (const Station &station: oldStations) {
+        for (const Module &module: station.modulesRef()) {
+            oldModules.push_back(&module);
+        }
+    }
+    vector<bool> matched(oldModules.size(), false);
+    unordered_map<string, size_t> oldIndex;
+    size_t cursor = 0;
+
+    Change change;
+    for (const Station &station: newStations) {
+        for (const Module &module: station.modulesRef()) {
+            const Module *oldModule = nullptr;
+            change.mModuleId = module.id();
+            // Most polls return the fleet in the same order, so the index is only built on demand.
+            if (cursor < oldModules.size() && !matched[cursor] && oldModules[cursor]->hasId(change.mModuleId)) {
+                oldModule = oldModules[cursor];
+                matched[cursor] = true;
+                ++cursor;
+            } else {
+                if (oldIndex.empty()) {
+                    oldIndex.reserve(oldModules.size());
+                    for (size_t i = 0; i < oldModules.size(); ++i) {
+                        oldIndex.emplace(oldModules[i]->id(), i);
+                    }
+                }
+                auto it = oldIndex.find(change.mModuleId);
+                if (it != oldIndex.end() && !matched[it->second]) {
+                    oldModule = oldModules[it->second];
+                    matched[it->second] = true;
+                    cursor = it->second + 1;
+                }
+            }
+
+            Measures measures = module.measures();
+            change.mField = Measures::fieldCount;
+            change.mTimeStamp = measures.mTimeStamp;
+            if (!oldModule) {
+                change.mKind = Change::moduleAdded;
+                change.mOldValue = 0;
+                change.mNewValue = 1;
+                callback(change);
+                continue;
+            }
+
+            if (oldModule->batteryPercent() != module.batteryPercent()) {
+                change.mKind = Change::batteryPercent;
+                change.mOldValue = oldModule->batteryPercent();
+                change.mNewValue = module.batteryPercent();
+                callback(change);
+            }
+            if (oldModule->rfStatus() != module.rfStatus()) {
+                change.mKind = Change::rfStatus;
+                change.mOldValue = oldModule->rfStatus();
+                change.mNewValue = module.rfStatus();
+                callback(change);
+            }
+            Measures oldMeasures = oldModule->measures();
+            change.mKind = Change::measure;
+            for (int field = 0; field < Measures::fieldCount; ++field) {
+                change.mField = static_cast<Measures::Field>(field);
+                change.mOldValue = oldMeasures.value(change.mField);
+                change.mNewValue = measures.value(change.mField);
+                if (change.mOldValue != change.mNewValue) {
+                    callback(change);
+                }
+            }
+        }
+    }
+
+    change.mKind = Change::moduleRemoved;
+    change.mField = Measures::fieldCount;
+    change.mOldValue = 1;
+    change.mNewValue = 0;
+    for (size_t i = 0; i < oldModules.size(); ++i) {
+        if (!matched[i]) {
+            change.mModuleId = oldModules[i]->id();
+            change.mTimeStamp = oldModules[i]->measures().mTimeStamp;
+            callback(change);
+        }
+    }
+}
+
+vector<Change> diffDevices(const list<Station> &oldStations, const list<Station> &newStations) {
+    vector<Change> changes;
+    diffDevices(oldStations, newStations, [&changes](const Change &change) {
+        changes.push_back(change);
+    });
+    return changes;
+}
+
 }
 }
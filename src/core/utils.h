@@ -20,10 +20,18 @@
 #define UTILS_H
 
 #include "model/station.h"
+#include "model/change.h"
+#include "model/measurecolumns.h"
+#include "model/usersettings.h"
+#include "model/publicstation.h"
 
 #include <string>
 #include <map>
 #include <list>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <functional>
 #include <nlohmann/json.hpp>
 #include <stdexcept>
 
@@ -52,6 +60,34 @@ std::string buildUrlQuery(const std::map<std::string, std::string> &params, char
  */
 std::string urlEncode(const std::string &toEncode);
 
+/**
+ * Returns the interval of a getmeasure scale.
+ *
+ * The interval of the scale "max" is 5 minutes, the interval of the
+ * scale "1month" is 31 days.
+ *
+ * @param scale The scale, e.g. params::cScaleMax.
+ * @return The interval in seconds.
+ * @throw std::invalid_argument exception if the scale is unknown.
+ */
+std::uint64_t scaleInterval(const std::string &scale);
+
+/**
+ * Splits a time range into chunks, which fit into one getmeasure request.
+ *
+ * The chunks are returned in order, they cover the range without gaps
+ * and do not overlap. Both, the begin and the end of a chunk are part of
+ * the chunk.
+ *
+ * @param begin The begin of the range as unix time stamp.
+ * @param end The end of the range as unix time stamp.
+ * @param scale The scale, e.g. params::cScaleMax.
+ * @param maxMeasures The maximum number of measures per chunk.
+ * @return The chunks as pairs of begin and end.
+ * @throw std::invalid_argument exception if the scale is unknown or maxMeasures is 0.
+ */
+std::vector<std::pair<std::uint64_t, std::uint64_t>> splitTimeRange(std::uint64_t begin, std::uint64_t end, const std::string &scale, std::size_t maxMeasures);
+
 /**
  * Parses the result of NAWSApiClient::requestStationsData() into a list of Stations.
  * @param response The json response from NAWSApiClient::requestStationsData().
@@ -59,6 +95,65 @@ std::string urlEncode(const std::string &toEncode);
  */
 std::list<Station> parseDevices(const json &response);
 
+/**
+ * Parses the result of NAWSApiClient::requestStationsData() into an existing list of Stations.
+ *
+ * Stations and modules are matched by id and updated in place, so the
+ * list nodes and the storage of names and ids are reused across polls.
+ * Only stations and modules, which are new in the response, are
+ * allocated. Stations and modules, which are missing in the response,
+ * are removed. Afterwards the list has the same content and order as the
+ * result of parseDevices(const json &).
+ *
+ * @param response The json response from NAWSApiClient::requestStationsData().
+ * @param stations The list of Stations to update, e.g. the result of the last poll.
+ */
+void parseDevices(const json &response, std::list<Station> &stations);
+
+/**
+ * Parses the result of NAWSApiClient::requestStationsData() into an existing list of Stations
+ * and skips stations, which did not change since the last poll.
+ *
+ * Works like parseDevices(const json &, std::list<Station> &), but for
+ * every station isUnchanged is called with the json station first. If it
+ * returns true and the station is already in the list, the station is
+ * kept as it is and its modules are not parsed.
+ *
+ * @see DevicesParser
+ *
+ * @param response The json response from NAWSApiClient::requestStationsData().
+ * @param stations The list of Stations to update, e.g. the result of the last poll.
+ * @param isUnchanged Returns true, if the json station equals the already parsed station.
+ */
+void parseDevices(const json &response, std::list<Station> &stations, const std::function<bool (const json &)> &isUnchanged);
+
+/**
+ * Parses the result of NAPublicApiClient::requestPublicData() into a list of PublicStations.
+ * @param response The json response from NAPublicApiClient::requestPublicData().
+ * @return The public stations in the order of the response.
+ */
+std::vector<PublicStation> parsePublicData(const json &response);
+
+/**
+ * Parses the result of NAPublicApiClient::requestPublicData() and appends the stations.
+ *
+ * Stations without id or location are skipped.
+ *
+ * @param response The json response from NAPublicApiClient::requestPublicData().
+ * @param stations The list to append the public stations to.
+ */
+void parsePublicData(const json &response, std::vector<PublicStation> &stations);
+
+/**
+ * Parses the administrative settings of the user from the result of NAWSApiClient::requestStationsData().
+ *
+ * Missing settings and unknown units keep their default value.
+ *
+ * @param response The json response from NAWSApiClient::requestStationsData().
+ * @return The settings of the user.
+ */
+UserSettings parseUserSettings(const json &response);
+
 /**
  * Parses the dashboard data of a module into a measure
  * @param dashbordData The dashboard data of the module.
@@ -68,6 +163,64 @@ std::list<Station> parseDevices(const json &response);
  */
 Measures parseMeasures(const json &dashbordData, const std::string &moduleType);
 
+/**
+ * Appends the "WindHistoric" samples of the dashboard data of a wind gauge to a wind history.
+ *
+ * Samples, which are not newer than the newest sample in the history,
+ * are skipped. The samples of consecutive polls overlap, so this keeps
+ * every sample exactly once.
+ *
+ * @param dashbordData The dashboard data of the wind gauge.
+ * @param history The wind history, e.g. Module::windHistory().
+ * @return The number of appended samples.
+ */
+std::size_t parseWindHistoric(const json &dashbordData, WindHistory &history);
+
+/**
+ * Decodes measure blocks of the getmeasure api in the compact format into columns.
+ *
+ * The measures are appended to the columns. Every block has its own
+ * begin and step time, so gaps between blocks and different steps are
+ * kept in the time stamp column. Missing values (null) are stored as
+ * std::numeric_limits<double>::min(). If the columns have no value
+ * column yet, one column per value of the first measure is created.
+ *
+ * @param blocks The json array of measure blocks, e.g. the result of NAWSApiClient::requestMeasures().
+ * @param columns The columns to append to.
+ * @throw std::invalid_argument exception if a block with more than one measure has no step time.
+ */
+void decodeMeasureBlocks(const json &blocks, MeasureColumns &columns);
+
+/**
+ * Decodes measure blocks of the getmeasure api in the compact format into columns.
+ * @param blocks The json array of measure blocks, e.g. the result of NAWSApiClient::requestMeasures().
+ * @return The decoded columns.
+ * @throw std::invalid_argument exception if a block with more than one measure has no step time.
+ */
+MeasureColumns decodeMeasureBlocks(const json &blocks);
+
+/**
+ * Compares two parsed fleets and reports every changed value.
+ *
+ * Modules are matched by id, so the fleets may be in different order.
+ * The run time is linear in the number of modules. The changes are
+ * reported in the order of the newer fleet, followed by the removed
+ * modules.
+ *
+ * @param oldStations The older fleet, e.g. the result of the last poll.
+ * @param newStations The newer fleet.
+ * @param callback Called once for every change.
+ */
+void diffDevices(const std::list<Station> &oldStations, const std::list<Station> &newStations, const std::function<void (const Change &)> &callback);
+
+/**
+ * Compares two parsed fleets and returns every changed value.
+ * @param oldStations The older fleet, e.g. the result of the last poll.
+ * @param newStations The newer fleet.
+ * @return The changes in the order of diffDevices(const std::list<Station> &, const std::list<Station> &, const std::function<void (const Change &)> &).
+ */
+std::vector<Change> diffDevices(const std::list<Station> &oldStations, const std::list<Station> &newStations);
+
 }
 }
 
@@ -0,0 +1,237 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "windowaggregator.h"
+#include "simd.hpp"
+
+#include <deque>
+#include <limits>
+#include <stdexcept>
+
+using namespace std;
+
+namespace netatmoapi {
+
+namespace {
+
+uint64_t greatestCommonDivisor(uint64_t a, uint64_t b) {
+    while (b != 0) {
+        uint64_t rest = a % b;
+        a = b;
+        b = rest;
+    }
+    return a;
+}
+
+}
+
+struct WindowAggregatorPrivate {
+    WindowAggregatorPrivate(uint64_t windowSize, uint64_t slide) :
+        mWindowSize(windowSize),
+        mSlide(slide),
+        mPaneSize(greatestCommonDivisor(windowSize, slide)),
+        mFirstPane(0),
+        mNextWindow(0)
+    {}
+    uint64_t windowBegin(uint64_t window) const {
+        return window * mSlide;
+    }
+    uint64_t firstWindowEndingAfter(uint64_t timeStamp) const {
+        return timeStamp < mWindowSize ? 0 : (timeStamp - mWindowSize) / mSlide + 1;
+    }
+    simd::Reduction *pane(uint64_t pane);
+    Aggregate window(uint64_t window) const;
+    void emit(uint64_t window);
+
+    uint64_t mWindowSize;
+    uint64_t mSlide;
+    uint64_t mPaneSize;
+    deque<simd::Reduction> mPanes;
+    // Pane index of mPanes.front().
+    uint64_t mFirstPane;
+    // The oldest window, which is not complete.
+    uint64_t mNextWindow;
+    vector<Aggregate> mWindows;
+};
+
+// Returns the pane, after completing all windows, which end before it, or nullptr for a pane of a completed window.
+simd::Reduction *WindowAggregatorPrivate::pane(uint64_t pane) {
+    if (pane * mPaneSize < windowBegin(mNextWindow) || (!mPanes.empty() && pane < mFirstPane)) {
+        return nullptr;
+    }
+    if (!mPanes.empty() && pane < mFirstPane + mPanes.size()) {
+        return &mPanes[pane - mFirstPane];
+    }
+    uint64_t paneBegin = pane * mPaneSize;
+    while (!mPanes.empty() && windowBegin(mNextWindow) + mWindowSize <= paneBegin) {
+        emit(mNextWindow++);
+        uint64_t firstPane = windowBegin(mNextWindow) / mPaneSize;
+        while (!mPanes.empty() && mFirstPane < firstPane) {
+            mPanes.pop_front();
+            ++mFirstPane;
+        }
+    }
+    if (mPanes.empty()) {
+        // Skip the windows in a gap of the time series.
+        mNextWindow = max(mNextWindow, firstWindowEndingAfter(paneBegin));
+        mFirstPane = pane;
+    }
+    mPanes.resize(pane - mFirstPane + 1);
+    return &mPanes.back();
+}
+
+Aggregate WindowAggregatorPrivate::window(uint64_t window) const {
+    Aggregate aggregate;
+    aggregate.mBegin = windowBegin(window);
+    aggregate.mEnd = aggregate.mBegin + mWindowSize;
+    uint64_t first = max(aggregate.mBegin / mPaneSize, mFirstPane);
+    uint64_t last = min(aggregate.mEnd / mPaneSize, mFirstPane + mPanes.size());
+    simd::Reduction reduction;
+    for (uint64_t i = first; i < last; ++i) {
+        const simd::Reduction &pane = mPanes[i - mFirstPane];
+        if (pane.mCount == 0) {
+            continue;
+        }
+        reduction.mMin = min(reduction.mMin, pane.mMin);
+        reduction.mMax = max(reduction.mMax, pane.mMax);
+        reduction.mSum += pane.mSum;
+        reduction.mCount += pane.mCount;
+    }
+    if (reduction.mCount > 0) {
+        aggregate.mCount = reduction.mCount;
+        aggregate.mMin = reduction.mMin;
+        aggregate.mMax = reduction.mMax;
+        aggregate.mSum = reduction.mSum;
+    }
+    return aggregate;
+}
+
+void WindowAggregatorPrivate::emit(uint64_t window) {
+    Aggregate aggregate = this->window(window);
+    if (aggregate.mCount > 0) {
+        mWindows.push_back(aggregate);
+    }
+}
+
+WindowAggregator::WindowAggregator(uint64_t windowSize, uint64_t slide) {
+    if (windowSize == 0) {
+        throw invalid_argument("The window size must not be 0.");
+    }
+    d.reset(new WindowAggregatorPrivate(windowSize, slide == 0 ? windowSize : slide));
+}
+
+WindowAggregator::WindowAggregator(const WindowAggregator &o) :
+    d(new WindowAggregatorPrivate(*o.d)) {
+}
+
+WindowAggregator::WindowAggregator(WindowAggregator &&o) noexcept :
+    d(move(o.d)) {
+}
+
+WindowAggregator::~WindowAggregator() noexcept = default;
+
+bool WindowAggregator::append(uint64_t timeStamp, double value) {
+    return append(&timeStamp, &value, 1) == 1;
+}
+
+size_t WindowAggregator::append(const uint64_t *timeStamps, const double *values, size_t count) {
+    const uint64_t paneSize = d->mPaneSize;
+    size_t accepted = 0;
+    size_t i = 0;
+    while (i < count) {
+        // Reduce the run of samples, which belong to the same pane, at once.
+        uint64_t paneIndex = timeStamps[i] / paneSize;
+        uint64_t paneBegin = paneIndex * paneSize;
+        uint64_t paneEnd = paneBegin + paneSize;
+        size_t end = i + 1;
+        while (end < count && timeStamps[end] >= paneBegin && timeStamps[end] < paneEnd) {
+            ++end;
+        }
+        simd::Reduction *pane = d->pane(paneIndex);
+        if (pane) {
+            simd::reduce(values + i, end - i, numeric_limits<double>::min(), *pane);
+            accepted += end - i;
+        }
+        i = end;
+    }
+    return accepted;
+}
+
+size_t WindowAggregator::append(const MeasureColumns &columns, size_t column) {
+    const vector<double> &values = columns.mValues.at(column);
+    return append(columns.mTimeStamps.data(), values.data(), min(columns.mTimeStamps.size(), values.size()));
+}
+
+void WindowAggregator::close() {
+    if (!d->mPanes.empty()) {
+        uint64_t end = (d->mFirstPane + d->mPanes.size()) * d->mPaneSize;
+        while (d->windowBegin(d->mNextWindow) < end) {
+            d->emit(d->mNextWindow++);
+        }
+        d->mFirstPane += d->mPanes.size();
+        d->mPanes.clear();
+    }
+}
+
+vector<Aggregate> WindowAggregator::takeWindows() {
+    vector<Aggregate> windows = move(d->mWindows);
+    d->mWindows.clear();
+    return windows;
+}
+
+vector<Aggregate> WindowAggregator::openWindows() const {
+    vector<Aggregate> windows;
+    if (!d->mPanes.empty()) {
+        uint64_t end = (d->mFirstPane + d->mPanes.size()) * d->mPaneSize;
+        for (uint64_t window = d->mNextWindow; d->windowBegin(window) < end; ++window) {
+            Aggregate aggregate = d->window(window);
+            if (aggregate.mCount > 0) {
+                windows.push_back(aggregate);
+            }
+        }
+    }
+    return windows;
+}
+
+uint64_t WindowAggregator::windowSize() const {
+    return d->mWindowSize;
+}
+
+uint64_t WindowAggregator::slide() const {
+    return d->mSlide;
+}
+
+vector<Aggregate> WindowAggregator::aggregate(const uint64_t *timeStamps, const double *values, size_t count,
+                                              uint64_t windowSize, uint64_t slide) {
+    WindowAggregator aggregator(windowSize, slide);
+    aggregator.append(timeStamps, values, count);
+    aggregator.close();
+    return aggregator.takeWindows();
+}
+
+WindowAggregator &WindowAggregator::operator =(const WindowAggregator &o) {
+    d.reset(new WindowAggregatorPrivate(*o.d));
+    return *this;
+}
+
+WindowAggregator &WindowAggregator::operator =(WindowAggregator &&o) noexcept {
+    d = move(o.d);
+    return *this;
+}
+
+}
@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef WINDOWAGGREGATOR_H
+#define WINDOWAGGREGATOR_H
+
+#include "model/aggregate.h"
+#include "model/measurecolumns.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace netatmoapi {
+
+struct WindowAggregatorPrivate;
+
+/**
+ * @brief This class aggregates a time series into tumbling or sliding windows.
+ *
+ * A window has a size and starts every slide seconds. The windows are
+ * aligned to the epoch, e.g. hourly windows start at a full hour. With a
+ * slide equal to the size the windows are tumbling, with a smaller slide
+ * they are sliding and overlap.
+ *
+ * The samples are reduced into panes of the greatest common divisor of
+ * size and slide, and a window is combined from its panes. So every
+ * sample is only reduced once, also for overlapping windows, and a new
+ * sample only updates the pane it belongs to. Missing values, i.e.
+ * std::numeric_limits<double>::min(), are skipped.
+ *
+ * A window is complete, when a sample after its end arrives, or by
+ * close(). Windows without values are not reported.
+ */
+class WindowAggregator {
+public:
+    /**
+     * Constructor.
+     * @param windowSize The size of the windows in seconds.
+     * @param slide The distance between the begin of two windows in seconds. 0 for tumbling windows.
+     * @throw std::invalid_argument If windowSize is 0.
+     */
+    explicit WindowAggregator(std::uint64_t windowSize, std::uint64_t slide = 0);
+
+    /**
+     * Copy constructor.
+     * @param o The element to copy.
+     */
+    WindowAggregator(const WindowAggregator &o);
+
+    /**
+     * Move constructor.
+     * @param o The element to move.
+     */
+    WindowAggregator(WindowAggregator &&o) noexcept;
+
+    /**
+     * Destructor.
+     * Is default.
+     */
+    virtual ~WindowAggregator() noexcept;
+
+    /**
+     * Appends a sample.
+     * @param timeStamp The time stamp of the sample.
+     * @param value The value of the sample.
+     * @return True, if the sample was accepted. Samples for a completed window are ignored.
+     */
+    bool append(std::uint64_t timeStamp, double value);
+
+    /**
+     * Appends samples, which should be ordered by time.
+     * @param timeStamps The time stamps of the samples.
+     * @param values The values of the samples.
+     * @param count The number of samples.
+     * @return The number of accepted samples. Samples for a completed window are ignored.
+     */
+    std::size_t append(const std::uint64_t *timeStamps, const double *values, std::size_t count);
+
+    /**
+     * Appends a column of measures, e.g. the result of utils::decodeMeasureBlocks().
+     * @param columns The measures.
+     * @param column The index of the value column.
+     * @return The number of accepted samples.
+     * @throw std::out_of_range If there is no such column.
+     */
+    std::size_t append(const MeasureColumns &columns, std::size_t column);
+
+    /**
+     * Completes all windows, e.g. at the end of the time series.
+     */
+    void close();
+
+    /**
+     * Returns the completed windows and removes them from the aggregator.
+     * @return The completed windows, ordered by time.
+     */
+    std::vector<Aggregate> takeWindows();
+
+    /**
+     * Returns the windows, which are not complete yet, with the samples so far.
+     * @return The open windows, ordered by time.
+     */
+    std::vector<Aggregate> openWindows() const;
+
+    /**
+     * Returns the size of the windows.
+     * @return The size in seconds.
+     */
+    std::uint64_t windowSize() const;
+
+    /**
+     * Returns the distance between the begin of two windows.
+     * @return The slide in seconds.
+     */
+    std::uint64_t slide() const;
+
+    /**
+     * Aggregates a complete time series.
+     * @param timeStamps The time stamps of the samples.
+     * @param values The values of the samples.
+     * @param count The number of samples.
+     * @param windowSize The size of the windows in seconds.
+     * @param slide The distance between the begin of two windows in seconds. 0 for tumbling windows.
+     * @return The windows, ordered by time.
+     * @throw std::invalid_argument If windowSize is 0.
+     */
+    static std::vector<Aggregate> aggregate(const std::uint64_t *timeStamps, const double *values, std::size_t count,
+                                            std::uint64_t windowSize, std::uint64_t slide = 0);
+
+    /**
+     * Copy assignment operator.
+     * @param o The element to copy.
+     * @return This element as reference.
+     */
+    WindowAggregator &operator =(const WindowAggregator &o);
+
+    /**
+     * Move assignment operator.
+     * @param o The element to move.
+     * @return This element as reference.
+     */
+    WindowAggregator &operator =(WindowAggregator &&o) noexcept;
+
+private:
+    std::unique_ptr<WindowAggregatorPrivate> d;
+};
+
+}
+
+#endif /* WINDOWAGGREGATOR_H */
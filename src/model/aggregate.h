@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef AGGREGATE_H
+#define AGGREGATE_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace netatmoapi {
+
+/**
+ * @brief The aggregated values of one time window.
+ *
+ * Missing values are not counted. If the window has no value, the
+ * minimum, the maximum and the mean are std::numeric_limits<double>::min(),
+ * like in Measures.
+ *
+ * @see WindowAggregator
+ */
+struct Aggregate {
+    /**
+     * Default constructor.
+     * Constructs an aggregate without values.
+     */
+    Aggregate();
+
+    /**
+     * Returns the mean of the values.
+     * @return The mean, or std::numeric_limits<double>::min() if there is no value.
+     */
+    double mean() const;
+
+    /**
+     * The begin of the window, inclusive.
+     */
+    std::uint64_t   mBegin;
+
+    /**
+     * The end of the window, exclusive.
+     */
+    std::uint64_t   mEnd;
+
+    /**
+     * The number of values, which are not missing.
+     */
+    std::size_t     mCount;
+
+    /**
+     * The minimum of the values.
+     */
+    double          mMin;
+
+    /**
+     * The maximum of the values.
+     */
+    double          mMax;
+
+    /**
+     * The sum of the values.
+     */
+    double          mSum;
+};
+
+}
+
+#endif /* AGGREGATE_H */
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "boundingbox.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace netatmoapi {
+
+namespace {
+
+// Maps a longitude east of the antimeridian back to [-180, 180].
+double normalizeLongitude(double longitude) {
+    return longitude > 180 ? longitude - 360 : longitude;
+}
+
+}
+
+BoundingBox::BoundingBox() :
+    mNorth(0),
+    mEast(0),
+    mSouth(0),
+    mWest(0)
+{
+
+}
+
+BoundingBox::BoundingBox(double north, double east, double south, double west) :
+    mNorth(north),
+    mEast(east),
+    mSouth(south),
+    mWest(west)
+{
+
+}
+
+double BoundingBox::height() const {
+    return mNorth - mSouth;
+}
+
+double BoundingBox::width() const {
+    return crossesAntimeridian() ? mEast - mWest + 360 : mEast - mWest;
+}
+
+bool BoundingBox::crossesAntimeridian() const {
+    return mWest > mEast;
+}
+
+bool BoundingBox::contains(double latitude, double longitude) const {
+    if (latitude < mSouth || latitude > mNorth) {
+        return false;
+    }
+    if (crossesAntimeridian()) {
+        return longitude >= mWest || longitude <= mEast;
+    }
+    return longitude >= mWest && longitude <= mEast;
+}
+
+array<BoundingBox, 4> BoundingBox::split() const {
+    double latitude = mSouth + height() / 2;
+    double longitude = normalizeLongitude(mWest + width() / 2);
+    return {{
+        BoundingBox(mNorth, mEast, latitude, longitude),
+        BoundingBox(mNorth, longitude, latitude, mWest),
+        BoundingBox(latitude, mEast, mSouth, longitude),
+        BoundingBox(latitude, longitude, mSouth, mWest)
+    }};
+}
+
+vector<BoundingBox> BoundingBox::tiles(double size) const {
+    vector<BoundingBox> result;
+    if (!(size > 0) || height() < 0) {
+        return result;
+    }
+    // A box across the antimeridian is tiled as its west part up to 180
+    // and its east part from -180, so no tile crosses the antimeridian.
+    const double westEast = crossesAntimeridian() ? 180 : mEast;
+    size_t rows = max<size_t>(static_cast<size_t>(ceil(height() / size)), 1);
+    size_t westColumns = max<size_t>(static_cast<size_t>(ceil((westEast - mWest) / size)), 1);
+    size_t eastColumns = crossesAntimeridian() ? max<size_t>(static_cast<size_t>(ceil((mEast + 180) / size)), 1) : 0;
+    result.reserve(rows * (westColumns + eastColumns));
+    for (size_t row = 0; row < rows; ++row) {
+        double north = mNorth - row * size;
+        double south = max(north - size, mSouth);
+        for (size_t column = 0; column < westColumns; ++column) {
+            double west = mWest + column * size;
+            double east = min(west + size, westEast);
+            result.emplace_back(north, east, south, west);
+        }
+        for (size_t column = 0; column < eastColumns; ++column) {
+            double west = -180 + column * size;
+            double east = min(west + size, mEast);
+            result.emplace_back(north, east, south, west);
+        }
+    }
+    return result;
+}
+
+}
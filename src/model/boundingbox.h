@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef BOUNDINGBOX_H
+#define BOUNDINGBOX_H
+
+#include <array>
+#include <vector>
+
+namespace netatmoapi {
+
+/**
+ * @brief A geographic bounding box in degrees.
+ *
+ * A box with mWest > mEast crosses the antimeridian, it reaches from
+ * mWest east to 180 and from -180 to mEast. Borders belong to the box.
+ */
+struct BoundingBox {
+    /**
+     * Default constructor.
+     * Constructs an empty box at 0, 0.
+     */
+    BoundingBox();
+
+    /**
+     * Constructor.
+     * @param north The latitude of the north east corner.
+     * @param east The longitude of the north east corner.
+     * @param south The latitude of the south west corner.
+     * @param west The longitude of the south west corner.
+     */
+    BoundingBox(double north, double east, double south, double west);
+
+    /**
+     * Returns the height of the box.
+     * @return The height in degrees of latitude.
+     */
+    double height() const;
+
+    /**
+     * Returns the width of the box.
+     * @return The width in degrees of longitude, also across the antimeridian.
+     */
+    double width() const;
+
+    /**
+     * Returns true, if the box crosses the antimeridian.
+     * @return True, if mWest > mEast.
+     */
+    bool crossesAntimeridian() const;
+
+    /**
+     * Returns true, if a location is in the box.
+     * @param latitude The latitude of the location.
+     * @param longitude The longitude of the location.
+     * @return True, if the location is in the box or on its border.
+     */
+    bool contains(double latitude, double longitude) const;
+
+    /**
+     * Splits the box into quarters.
+     * @return The north east, north west, south east and south west quarters.
+     */
+    std::array<BoundingBox, 4> split() const;
+
+    /**
+     * Splits the box into tiles.
+     *
+     * The tiles at the east and south border are smaller, if the box is
+     * not a multiple of the tile size. A box across the antimeridian is
+     * split there, no tile crosses it.
+     *
+     * @param size The maximum height and width of a tile in degrees.
+     * @return The tiles row by row from north west to south east, empty if size is not positive or mSouth > mNorth.
+     */
+    std::vector<BoundingBox> tiles(double size) const;
+
+    /**
+     * The latitude of the north east corner.
+     */
+    double  mNorth;
+
+    /**
+     * The longitude of the north east corner.
+     */
+    double  mEast;
+
+    /**
+     * The latitude of the south west corner.
+     */
+    double  mSouth;
+
+    /**
+     * The longitude of the south west corner.
+     */
+    double  mWest;
+};
+
+}
+
+#endif /* BOUNDINGBOX_H */
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CHANGE_H
+#define CHANGE_H
+
+#include "measures.h"
+
+#include <cstdint>
+#include <string>
+
+namespace netatmoapi {
+
+/**
+ * @brief Container for a changed value of a module between two polls.
+ *
+ * @see utils::diffDevices()
+ */
+struct Change {
+    /**
+     * @brief Enum for the kind of change.
+     */
+    enum Kind {
+        //! A measure value changed, see mField.
+        measure,
+        //! The battery state changed.
+        batteryPercent,
+        //! The wifi state changed.
+        rfStatus,
+        //! The module is new. The values are 0 and 1.
+        moduleAdded,
+        //! The module is gone. The values are 1 and 0.
+        moduleRemoved
+    };
+
+    /**
+     * The id of the changed module.
+     */
+    std::string     mModuleId;
+
+    /**
+     * The kind of change.
+     */
+    Kind            mKind;
+
+    /**
+     * The changed measure value, if mKind is Kind::measure.
+     */
+    Measures::Field mField;
+
+    /**
+     * The old value.
+     */
+    double          mOldValue;
+
+    /**
+     * The new value.
+     */
+    double          mNewValue;
+
+    /**
+     * The measure timestamp of the newer module.
+     */
+    std::uint64_t   mTimeStamp;
+};
+
+}
+
+#endif /* CHANGE_H */
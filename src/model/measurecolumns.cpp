@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "measurecolumns.h"
+
+using namespace std;
+
+namespace netatmoapi {
+
+MeasureColumns::MeasureColumns(size_t typeCount) :
+    mValues(typeCount)
+{
+
+}
+
+size_t MeasureColumns::size() const {
+    return mTimeStamps.size();
+}
+
+void MeasureColumns::reserve(size_t size) {
+    mTimeStamps.reserve(size);
+    for (vector<double> &column: mValues) {
+        column.reserve(size);
+    }
+}
+
+void MeasureColumns::clear() {
+    mTimeStamps.clear();
+    for (vector<double> &column: mValues) {
+        column.clear();
+    }
+}
+
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MEASURECOLUMNS_H
+#define MEASURECOLUMNS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace netatmoapi {
+
+/**
+ * @brief Container for a time series of measures in columns.
+ *
+ * The container has one column of time stamps and one column of values
+ * per measure type. All columns have the same size. A missing value is
+ * stored as std::numeric_limits<double>::min(), like in Measures.
+ *
+ * @see utils::decodeMeasureBlocks()
+ */
+struct MeasureColumns {
+    /**
+     * Constructor.
+     * @param typeCount The number of measure types.
+     */
+    explicit MeasureColumns(std::size_t typeCount = 0);
+
+    /**
+     * Returns the number of measures.
+     * @return The number of time stamps.
+     */
+    std::size_t size() const;
+
+    /**
+     * Reserves memory in all columns.
+     * @param size The number of measures.
+     */
+    void reserve(std::size_t size);
+
+    /**
+     * Removes all measures, but keeps the columns and their memory.
+     */
+    void clear();
+
+    /**
+     * The time stamps of the measures.
+     */
+    std::vector<std::uint64_t>          mTimeStamps;
+
+    /**
+     * The values, one column per measure type.
+     */
+    std::vector<std::vector<double>>    mValues;
+};
+
+}
+
+#endif /* MEASURECOLUMNS_H */
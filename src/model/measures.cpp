@@ -27,6 +27,7 @@ Measures::Measures() :
     mTimeStamp(0),
     mDateMinTemp(0),
     mDateMaxTemp(0),
+    mDateMaxWindStrength(0),
     mTemperature(numeric_limits<double>::min()),
     mCo2(numeric_limits<double>::min()),
     mHumidity(numeric_limits<double>::min()),
@@ -43,11 +44,205 @@ Measures::Measures() :
     mTemperatureTrend(Trend::noData),
     mPressureTrend(Trend::noData),
     mSumRain1(numeric_limits<double>::min()),
-    mSumRain24(numeric_limits<double>::min())
+    mSumRain24(numeric_limits<double>::min()),
+    mMaxWindStrength(numeric_limits<double>::min()),
+    mMaxWindAngle(numeric_limits<double>::min())
 {
 
 }
 
+bool Measures::hasValue(Measures::Field field) const {
+    double fieldValue = value(field);
+    switch (field) {
+    case temperatureTrend:
+    case pressureTrend:
+        return fieldValue != noData;
+    case dateMinTemp:
+    case dateMaxTemp:
+    case dateMaxWindStrength:
+        return fieldValue != 0;
+    default:
+        return fieldValue != numeric_limits<double>::min();
+    }
+}
+
+double Measures::value(Measures::Field field) const {
+    switch (field) {
+    case temperature:
+        return mTemperature;
+    case co2:
+        return mCo2;
+    case humidity:
+        return mHumidity;
+    case pressure:
+        return mPressure;
+    case absolutePressure:
+        return mAbsolutePressure;
+    case noise:
+        return mNoise;
+    case rain:
+        return mRain;
+    case windStrength:
+        return mWindStrength;
+    case windAngle:
+        return mWindAngle;
+    case gustStrength:
+        return mGustStrength;
+    case gustAngle:
+        return mGustAngle;
+    case minTemperature:
+        return mMinTemperature;
+    case maxTemperature:
+        return mMaxTemperature;
+    case temperatureTrend:
+        return mTemperatureTrend;
+    case pressureTrend:
+        return mPressureTrend;
+    case sumRain1:
+        return mSumRain1;
+    case sumRain24:
+        return mSumRain24;
+    case dateMinTemp:
+        return mDateMinTemp;
+    case dateMaxTemp:
+        return mDateMaxTemp;
+    case maxWindStrength:
+        return mMaxWindStrength;
+    case maxWindAngle:
+        return mMaxWindAngle;
+    case dateMaxWindStrength:
+        return mDateMaxWindStrength;
+    case fieldCount:
+        break;
+    }
+    return numeric_limits<double>::min();
+}
+
+void Measures::setValue(Measures::Field field, double value) {
+    switch (field) {
+    case temperature:
+        mTemperature = value;
+        break;
+    case co2:
+        mCo2 = value;
+        break;
+    case humidity:
+        mHumidity = value;
+        break;
+    case pressure:
+        mPressure = value;
+        break;
+    case absolutePressure:
+        mAbsolutePressure = value;
+        break;
+    case noise:
+        mNoise = value;
+        break;
+    case rain:
+        mRain = value;
+        break;
+    case windStrength:
+        mWindStrength = value;
+        break;
+    case windAngle:
+        mWindAngle = value;
+        break;
+    case gustStrength:
+        mGustStrength = value;
+        break;
+    case gustAngle:
+        mGustAngle = value;
+        break;
+    case minTemperature:
+        mMinTemperature = value;
+        break;
+    case maxTemperature:
+        mMaxTemperature = value;
+        break;
+    case temperatureTrend:
+        mTemperatureTrend = static_cast<Trend>(static_cast<int>(value));
+        break;
+    case pressureTrend:
+        mPressureTrend = static_cast<Trend>(static_cast<int>(value));
+        break;
+    case sumRain1:
+        mSumRain1 = value;
+        break;
+    case sumRain24:
+        mSumRain24 = value;
+        break;
+    case dateMinTemp:
+        mDateMinTemp = static_cast<uint64_t>(value);
+        break;
+    case dateMaxTemp:
+        mDateMaxTemp = static_cast<uint64_t>(value);
+        break;
+    case maxWindStrength:
+        mMaxWindStrength = value;
+        break;
+    case maxWindAngle:
+        mMaxWindAngle = value;
+        break;
+    case dateMaxWindStrength:
+        mDateMaxWindStrength = static_cast<uint64_t>(value);
+        break;
+    case fieldCount:
+        break;
+    }
+}
+
+string Measures::convertFieldToString(Measures::Field field) {
+    switch (field) {
+    case temperature:
+        return "temperature";
+    case co2:
+        return "co2";
+    case humidity:
+        return "humidity";
+    case pressure:
+        return "pressure";
+    case absolutePressure:
+        return "absolutePressure";
+    case noise:
+        return "noise";
+    case rain:
+        return "rain";
+    case windStrength:
+        return "windStrength";
+    case windAngle:
+        return "windAngle";
+    case gustStrength:
+        return "gustStrength";
+    case gustAngle:
+        return "gustAngle";
+    case minTemperature:
+        return "minTemperature";
+    case maxTemperature:
+        return "maxTemperature";
+    case temperatureTrend:
+        return "temperatureTrend";
+    case pressureTrend:
+        return "pressureTrend";
+    case sumRain1:
+        return "sumRain1";
+    case sumRain24:
+        return "sumRain24";
+    case dateMinTemp:
+        return "dateMinTemp";
+    case dateMaxTemp:
+        return "dateMaxTemp";
+    case maxWindStrength:
+        return "maxWindStrength";
+    case maxWindAngle:
+        return "maxWindAngle";
+    case dateMaxWindStrength:
+        return "dateMaxWindStrength";
+    case fieldCount:
+        break;
+    }
+    return "noField";
+}
+
 Measures::Trend Measures::convertTrendFromString(const std::string &trend) {
     if (trend == "up") {
         return Trend::up;
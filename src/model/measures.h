@@ -42,11 +42,103 @@ struct Measures {
         stable
     };
 
+    /**
+     * @brief Enum for the measure values.
+     *
+     * The time stamp is not a measure value.
+     */
+    enum Field {
+        //! The temperature value.
+        temperature,
+        //! The CO2 value.
+        co2,
+        //! The humidity value.
+        humidity,
+        //! The pressure value.
+        pressure,
+        //! The absolute pressure value.
+        absolutePressure,
+        //! The noise value.
+        noise,
+        //! The rain value.
+        rain,
+        //! The wind strength value.
+        windStrength,
+        //! The wind angle value.
+        windAngle,
+        //! The gust strength value.
+        gustStrength,
+        //! The gust angle value.
+        gustAngle,
+        //! The minimum temperature value.
+        minTemperature,
+        //! The maximum temperature value.
+        maxTemperature,
+        //! The temperature trend.
+        temperatureTrend,
+        //! The pressure trend.
+        pressureTrend,
+        //! The rain sum for the last hour.
+        sumRain1,
+        //! The rain sum for the last 24 hours.
+        sumRain24,
+        //! The min temp date.
+        dateMinTemp,
+        //! The max temp date.
+        dateMaxTemp,
+        //! The maximum wind strength of the day.
+        maxWindStrength,
+        //! The wind angle of the maximum wind strength.
+        maxWindAngle,
+        //! The max wind strength date.
+        dateMaxWindStrength,
+        //! Number of fields, not a field.
+        fieldCount
+    };
+
     /**
      * Constructor.
      */
     Measures();
 
+    /**
+     * Returns a measure value as double.
+     *
+     * Trends are returned as their enum value, dates as unix time stamp.
+     *
+     * @param field The measure value.
+     * @return The value.
+     */
+    double value(Field field) const;
+
+    /**
+     * Returns true, if a measure value is not missing.
+     *
+     * A value is missing, if it is std::numeric_limits<double>::min(), a
+     * trend is missing, if it is noData, and a date, if it is 0.
+     *
+     * @param field The measure value.
+     * @return True, if the value is set.
+     */
+    bool hasValue(Field field) const;
+
+    /**
+     * Sets a measure value from a double.
+     *
+     * Trends are set from their enum value, dates from a unix time stamp.
+     *
+     * @param field The measure value.
+     * @param value The value.
+     */
+    void setValue(Field field, double value);
+
+    /**
+     * Converts the field to string.
+     * @param field The field enum value.
+     * @return The field as string, e.g. "temperature".
+     */
+    static std::string convertFieldToString(Field field);
+
     /**
      * Converts the trend from string to Trend enum.
      * @param trend The trend string.
@@ -76,6 +168,11 @@ struct Measures {
      */
     std::uint64_t   mDateMaxTemp;
 
+    /**
+     * The max wind strength date.
+     */
+    std::uint64_t   mDateMaxWindStrength;
+
     /**
      * The temperature value.
      */
@@ -160,6 +257,16 @@ struct Measures {
      * he rain sum for the last 24 hours.
      */
     double          mSumRain24;
+
+    /**
+     * The maximum wind strength of the day.
+     */
+    double          mMaxWindStrength;
+
+    /**
+     * The wind angle of the maximum wind strength.
+     */
+    double          mMaxWindAngle;
 };
 
 }
@@ -40,7 +40,8 @@ struct ModulePrivate {
         mType(o.mType),
         mBatteryPercent(o.mBatteryPercent),
         mRfStatus(o.mRfStatus),
-        mMeasures(o.mMeasures)
+        mMeasures(o.mMeasures),
+        mWindHistory(o.mWindHistory)
     {}
     string mName;
     string mId;
@@ -48,6 +49,7 @@ struct ModulePrivate {
     int16_t mBatteryPercent;
     int16_t mRfStatus;
     Measures mMeasures;
+    WindHistory mWindHistory;
 };
 
 const string Module::sTypeBase = "NAMain";
@@ -83,6 +85,10 @@ void Module::setName(string &&name) {
     d->mName = move(name);
 }
 
+void Module::setName(const string &name) {
+    d->mName = name;
+}
+
 string Module::id() const {
     return d->mId;
 }
@@ -91,6 +97,14 @@ void Module::setId(string &&id) {
     d->mId = move(id);
 }
 
+void Module::setId(const string &id) {
+    d->mId = id;
+}
+
+bool Module::hasId(const string &id) const {
+    return d->mId == id;
+}
+
 string Module::type() const {
     return d->mType;
 }
@@ -99,6 +113,10 @@ void Module::setType(string &&type) {
     d->mType = move(type);
 }
 
+void Module::setType(const string &type) {
+    d->mType = type;
+}
+
 int16_t Module::batteryPercent() const {
     return d->mBatteryPercent;
 }
@@ -123,6 +141,14 @@ void Module::setMeasures(Measures &&measures) {
     d->mMeasures = move(measures);
 }
 
+const WindHistory &Module::windHistory() const {
+    return d->mWindHistory;
+}
+
+WindHistory &Module::windHistory() {
+    return d->mWindHistory;
+}
+
 Module &Module::operator =(const Module &o) {
     d.reset(new ModulePrivate(*o.d));
     return *this;
@@ -20,6 +20,7 @@
 #define MODULE_H
 
 #include "measures.h"
+#include "windhistory.h"
 
 #include <memory>
 #include <string>
@@ -83,6 +84,16 @@ public:
      */
     void setName(std::string &&name);
 
+    /**
+     * Sets the name of the module.
+     *
+     * The name is copied into the existing storage, so no memory is
+     * allocated if the old name had at least the same capacity.
+     *
+     * @param name The name.
+     */
+    void setName(const std::string &name);
+
     /**
      * Returns the id of the module.
      * @return The id.
@@ -95,6 +106,19 @@ public:
      */
     void setId(std::string &&id);
 
+    /**
+     * Sets the id of the module.
+     * @param id The id.
+     */
+    void setId(const std::string &id);
+
+    /**
+     * Checks the id of the module without copying it.
+     * @param id The id to compare with.
+     * @return True, if the module has the given id.
+     */
+    bool hasId(const std::string &id) const;
+
     /**
      * Returns the type the module.
      *
@@ -113,6 +137,16 @@ public:
      */
     void setType(std::string &&type);
 
+    /**
+     * Sets the type the module.
+     *
+     * The type is copied into the existing storage, so no memory is
+     * allocated if the old type had at least the same capacity.
+     *
+     * @param type The type.
+     */
+    void setType(const std::string &type);
+
     /**
      * Returns the battery state of the module.
      * @return The barrery state.
@@ -155,6 +189,22 @@ public:
      */
     void setMeasures(Measures &&measures);
 
+    /**
+     * Returns the wind history of the module.
+     *
+     * Only wind gauges have a wind history, it is filled from the
+     * "WindHistoric" dashboard data by utils::parseDevices().
+     *
+     * @return The wind history.
+     */
+    const WindHistory &windHistory() const;
+
+    /**
+     * Returns the wind history of the module for modification.
+     * @return The wind history.
+     */
+    WindHistory &windHistory();
+
     /**
      * Copy assignment operator.
      * @param o The element to copy.
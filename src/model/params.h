@@ -19,6 +19,7 @@
 #ifndef PARAMS_H
 #define PARAMS_H
 
+#include <cstddef>
 #include <string>
 
 namespace netatmoapi {
@@ -106,6 +107,26 @@ const std::string cTypeGustAngle = "GustAngle";
  */
 const std::string cTypeGustStrength = "GustStrength";
 
+/**
+ * Type wind history.
+ */
+const std::string cTypeWindHistoric = "WindHistoric";
+
+/**
+ * Type maximum wind strength of the day.
+ */
+const std::string cTypeMaxWindStr = "max_wind_str";
+
+/**
+ * Type wind angle of the maximum wind strength.
+ */
+const std::string cTypeMaxWindAngle = "max_wind_angle";
+
+/**
+ * Type date of the maximum wind strength.
+ */
+const std::string cTypeDateMaxWindStr = "date_max_wind_str";
+
 /**
  * Type temperature trend.
  */
@@ -131,6 +152,78 @@ const std::string cTypeDateMinTemp = "date_min_temp";
  */
 const std::string cTypeDateMaxTemp = "date_max_temp";
 
+// These are the scales of the getmeasure api.
+
+/**
+ * Scale max, every measure (about every 5 minutes).
+ */
+const std::string cScaleMax = "max";
+
+/**
+ * Scale 30 minutes.
+ */
+const std::string cScale30Min = "30min";
+
+/**
+ * Scale 1 hour.
+ */
+const std::string cScale1Hour = "1hour";
+
+/**
+ * Scale 3 hours.
+ */
+const std::string cScale3Hours = "3hours";
+
+/**
+ * Scale 1 day.
+ */
+const std::string cScale1Day = "1day";
+
+/**
+ * Scale 1 week.
+ */
+const std::string cScale1Week = "1week";
+
+/**
+ * Scale 1 month.
+ */
+const std::string cScale1Month = "1month";
+
+/**
+ * Setting unit system.
+ */
+const std::string cSettingUnit = "unit";
+
+/**
+ * Setting wind unit.
+ */
+const std::string cSettingWindUnit = "windunit";
+
+/**
+ * Setting pressure unit.
+ */
+const std::string cSettingPressureUnit = "pressureunit";
+
+/**
+ * Setting feel like algorithm.
+ */
+const std::string cSettingFeelLikeAlgorithm = "feel_like_algo";
+
+/**
+ * Setting language.
+ */
+const std::string cSettingLang = "lang";
+
+/**
+ * Setting regional locale.
+ */
+const std::string cSettingRegLocale = "reg_locale";
+
+/**
+ * Maximum number of measures per getmeasure request.
+ */
+const std::size_t cMaxMeasuresPerRequest = 1024;
+
 }
 }
 
@@ -0,0 +1,39 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "place.h"
+
+#include <limits>
+
+using namespace std;
+
+namespace netatmoapi {
+
+Place::Place() :
+    mLatitude(numeric_limits<double>::min()),
+    mLongitude(numeric_limits<double>::min()),
+    mAltitude(numeric_limits<double>::min())
+{
+
+}
+
+bool Place::hasLocation() const {
+    return mLatitude != numeric_limits<double>::min() && mLongitude != numeric_limits<double>::min();
+}
+
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef PLACE_H
+#define PLACE_H
+
+#include <string>
+
+namespace netatmoapi {
+
+/**
+ * @brief The location of a weather station.
+ *
+ * A missing location or altitude is std::numeric_limits<double>::min(),
+ * like a missing value in Measures.
+ */
+struct Place {
+    /**
+     * Constructor.
+     * Constructs a place without location.
+     */
+    Place();
+
+    /**
+     * Returns true, if the place has a location.
+     * @return True, if latitude and longitude are set.
+     */
+    bool hasLocation() const;
+
+    /**
+     * The latitude in degrees.
+     */
+    double          mLatitude;
+
+    /**
+     * The longitude in degrees.
+     */
+    double          mLongitude;
+
+    /**
+     * The altitude in meters.
+     */
+    double          mAltitude;
+
+    /**
+     * The city.
+     */
+    std::string     mCity;
+
+    /**
+     * The country code, e.g. "DE".
+     */
+    std::string     mCountry;
+
+    /**
+     * The time zone, e.g. "Europe/Berlin".
+     */
+    std::string     mTimeZone;
+};
+
+}
+
+#endif /* PLACE_H */
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef PUBLICSTATION_H
+#define PUBLICSTATION_H
+
+#include "measures.h"
+
+#include <string>
+
+namespace netatmoapi {
+
+/**
+ * @brief A public weather station of the getpublicdata api.
+ *
+ * Public stations are flat: the measures of all modules of the station
+ * are merged into one Measures. The time stamp of the measures is the
+ * newest time stamp of all modules. Only temperature, humidity,
+ * pressure, rain (rain_live, rain_60min and rain_24h as mRain, mSumRain1
+ * and mSumRain24) and wind are published.
+ *
+ * @see utils::parsePublicData()
+ */
+struct PublicStation {
+    /**
+     * Constructor.
+     */
+    PublicStation();
+
+    /**
+     * The id of the station, i.e. the mac address of the main module.
+     */
+    std::string     mId;
+
+    /**
+     * The latitude of the station.
+     */
+    double          mLatitude;
+
+    /**
+     * The longitude of the station.
+     */
+    double          mLongitude;
+
+    /**
+     * The altitude of the station in meters.
+     */
+    double          mAltitude;
+
+    /**
+     * The measures of the station.
+     */
+    Measures        mMeasures;
+};
+
+}
+
+#endif /* PUBLICSTATION_H */
@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "raster.h"
+
+#include <limits>
+
+using namespace std;
+
+namespace netatmoapi {
+
+Raster::Raster() :
+    mRows(0),
+    mColumns(0)
+{
+
+}
+
+Raster::Raster(const BoundingBox &region, size_t rows, size_t columns) :
+    mRegion(region),
+    mRows(rows),
+    mColumns(columns),
+    mValues(rows * columns, numeric_limits<float>::quiet_NaN())
+{
+
+}
+
+double Raster::latitude(size_t row) const {
+    return mRegion.mNorth - (row + 0.5) * mRegion.height() / mRows;
+}
+
+double Raster::longitude(size_t column) const {
+    double longitude = mRegion.mWest + (column + 0.5) * mRegion.width() / mColumns;
+    // Columns east of the antimeridian, if the region crosses it.
+    return longitude > 180 ? longitude - 360 : longitude;
+}
+
+float Raster::at(size_t row, size_t column) const {
+    return mValues[row * mColumns + column];
+}
+
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef RASTER_H
+#define RASTER_H
+
+#include "boundingbox.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace netatmoapi {
+
+/**
+ * @brief A dense grid of values over a geographic region.
+ *
+ * The region is divided into mRows rows from north to south and mColumns
+ * columns from west to east of equal size in degrees. The values are
+ * stored row by row from the north west cell, and a value belongs to the
+ * center of its cell. Cells without a value are NaN.
+ *
+ * @see GridInterpolator
+ */
+struct Raster {
+    /**
+     * Default constructor.
+     * Constructs an empty raster.
+     */
+    Raster();
+
+    /**
+     * Constructor.
+     * All values are NaN.
+     * @param region The region of the raster.
+     * @param rows The number of rows.
+     * @param columns The number of columns.
+     */
+    Raster(const BoundingBox &region, std::size_t rows, std::size_t columns);
+
+    /**
+     * Returns the latitude of the cell centers of a row.
+     * @param row The row.
+     * @return The latitude in degrees.
+     */
+    double latitude(std::size_t row) const;
+
+    /**
+     * Returns the longitude of the cell centers of a column.
+     * @param column The column.
+     * @return The longitude in degrees, from -180 to 180.
+     */
+    double longitude(std::size_t column) const;
+
+    /**
+     * Returns the value of a cell.
+     * @param row The row of the cell.
+     * @param column The column of the cell.
+     * @return The value, NaN if the cell has no value.
+     */
+    float at(std::size_t row, std::size_t column) const;
+
+    /**
+     * The region of the raster.
+     */
+    BoundingBox         mRegion;
+
+    /**
+     * The number of rows.
+     */
+    std::size_t         mRows;
+
+    /**
+     * The number of columns.
+     */
+    std::size_t         mColumns;
+
+    /**
+     * The values row by row, mRows * mColumns elements.
+     */
+    std::vector<float>  mValues;
+};
+
+}
+
+#endif /* RASTER_H */
@@ -29,10 +29,14 @@ struct StationPrivate {
         mId(forward<string>(id))
     {}
     StationPrivate(const StationPrivate &o) :
-        mId(o.mId)
+        mName(o.mName),
+        mId(o.mId),
+        mPlace(o.mPlace),
+        mModules(o.mModules)
     {}
     string mName;
     string mId;
+    Place mPlace;
     list<Module> mModules;
 };
 
@@ -63,6 +67,10 @@ void Station::setName(string &&name) {
     d->mName = move(name);
 }
 
+void Station::setName(const string &name) {
+    d->mName = name;
+}
+
 string Station::id() const {
     return d->mId;
 }
@@ -71,6 +79,30 @@ void Station::setId(string &&id) {
     d->mId = move(id);
 }
 
+void Station::setId(const string &id) {
+    d->mId = id;
+}
+
+bool Station::hasId(const string &id) const {
+    return d->mId == id;
+}
+
+Place Station::place() const {
+    return d->mPlace;
+}
+
+const Place &Station::placeRef() const {
+    return d->mPlace;
+}
+
+Place &Station::placeRef() {
+    return d->mPlace;
+}
+
+void Station::setPlace(Place &&place) {
+    d->mPlace = move(place);
+}
+
 list<Module> Station::modules() const {
     return d->mModules;
 }
@@ -79,6 +111,14 @@ void Station::setModules(list<Module> &&modules) {
     d->mModules = move(modules);
 }
 
+const list<Module> &Station::modulesRef() const {
+    return d->mModules;
+}
+
+list<Module> &Station::modulesRef() {
+    return d->mModules;
+}
+
 void Station::addModule(Module &&module) {
     d->mModules.emplace_back(move(module));
 }
@@ -20,6 +20,7 @@
 #define STATION_H
 
 #include "module.h"
+#include "place.h"
 
 #include <list>
 #include <string>
@@ -80,6 +81,16 @@ public:
      */
     void setName(std::string &&name);
 
+    /**
+     * Set the name of the station.
+     *
+     * The name is copied into the existing storage, so no memory is
+     * allocated if the old name had at least the same capacity.
+     *
+     * @param name The name.
+     */
+    void setName(const std::string &name);
+
     /**
      * Returns the id of the station.
      * @return The id.
@@ -92,6 +103,45 @@ public:
      */
     void setId(std::string &&id);
 
+    /**
+     * Sets the id of the station.
+     * @param id The id.
+     */
+    void setId(const std::string &id);
+
+    /**
+     * Checks the id of the station without copying it.
+     * @param id The id to compare with.
+     * @return True, if the station has the given id.
+     */
+    bool hasId(const std::string &id) const;
+
+    /**
+     * Returns the place of the station.
+     * @return The place.
+     */
+    Place place() const;
+
+    /**
+     * Returns a reference to the place of the station.
+     * The reference is valid as long as the station exists.
+     * @return The place.
+     */
+    const Place &placeRef() const;
+
+    /**
+     * Returns a reference to the place of the station, e.g. to update it in place.
+     * The reference is valid as long as the station exists.
+     * @return The place.
+     */
+    Place &placeRef();
+
+    /**
+     * Sets the place of the station.
+     * @param place The place.
+     */
+    void setPlace(Place &&place);
+
     /**
      * Returns the modules of the station.
      * @return A std::list with all [Modules](@ref netatmoapi::Module) of the station.
@@ -104,6 +154,25 @@ public:
      */
     void setModules(std::list<Module> &&modules);
 
+    /**
+     * Returns a reference to the modules of the station.
+     *
+     * In contrast to modules(), the modules are not copied. The reference
+     * is valid as long as the station exists.
+     *
+     * @return A std::list with all [Modules](@ref netatmoapi::Module) of the station.
+     */
+    const std::list<Module> &modulesRef() const;
+
+    /**
+     * Returns a reference to the modules of the station, e.g. to update them in place.
+     *
+     * The reference is valid as long as the station exists.
+     *
+     * @return A std::list with all [Modules](@ref netatmoapi::Module) of the station.
+     */
+    std::list<Module> &modulesRef();
+
     /**
      * Add a module to the station.
      * @param module The Module.
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef USERSETTINGS_H
+#define USERSETTINGS_H
+
+#include <string>
+
+namespace netatmoapi {
+
+/**
+ * @brief The administrative settings of a user.
+ *
+ * The api always returns metric values. The settings tell, in which
+ * units the user wants to see them.
+ *
+ * @see utils::parseUserSettings()
+ * @see UnitConverter
+ */
+struct UserSettings {
+    /**
+     * @brief Enum for the unit system of temperature and rain.
+     */
+    enum Unit {
+        //! °C and mm.
+        metric = 0,
+        //! °F and in.
+        imperial = 1
+    };
+
+    /**
+     * @brief Enum for the unit of the wind strength.
+     */
+    enum WindUnit {
+        //! Kilometers per hour.
+        kph = 0,
+        //! Miles per hour.
+        mph = 1,
+        //! Meters per second.
+        ms = 2,
+        //! Beaufort scale.
+        beaufort = 3,
+        //! Knots.
+        knot = 4
+    };
+
+    /**
+     * @brief Enum for the unit of the pressure.
+     */
+    enum PressureUnit {
+        //! Millibar, i.e. hPa.
+        mbar = 0,
+        //! Inches of mercury.
+        inHg = 1,
+        //! Millimeters of mercury.
+        mmHg = 2
+    };
+
+    /**
+     * @brief Enum for the algorithm of the felt temperature.
+     */
+    enum FeelLikeAlgorithm {
+        //! Humidex of Environment Canada.
+        humidex = 0,
+        //! Heat index of the US National Weather Service.
+        heatIndex = 1
+    };
+
+    /**
+     * Constructor.
+     * Constructs the default settings of the api, i.e. metric units in km/h and mbar.
+     */
+    UserSettings();
+
+    /**
+     * The unit system of temperature and rain.
+     */
+    Unit                mUnit;
+
+    /**
+     * The unit of the wind strength.
+     */
+    WindUnit            mWindUnit;
+
+    /**
+     * The unit of the pressure.
+     */
+    PressureUnit        mPressureUnit;
+
+    /**
+     * The algorithm of the felt temperature.
+     */
+    FeelLikeAlgorithm   mFeelLikeAlgorithm;
+
+    /**
+     * The language, e.g. "de-DE".
+     */
+    std::string         mLang;
+
+    /**
+     * The regional locale, e.g. "de-DE".
+     */
+    std::string         mRegLocale;
+};
+
+}
+
+#endif /* USERSETTINGS_H */
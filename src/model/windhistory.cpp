@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "windhistory.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+namespace netatmoapi {
+
+const size_t WindHistory::sDefaultCapacity = 288;
+
+WindHistory::WindHistory(size_t capacity) :
+    mCapacity(max<size_t>(capacity, 1)),
+    mFirst(0)
+{
+
+}
+
+bool WindHistory::append(const WindSample &sample) {
+    if (!mSamples.empty() && sample.mTimeStamp <= back().mTimeStamp) {
+        return false;
+    }
+    if (mSamples.size() < mCapacity) {
+        if (mSamples.empty()) {
+            mSamples.reserve(mCapacity);
+        }
+        mSamples.push_back(sample);
+    } else {
+        mSamples[mFirst] = sample;
+        mFirst = (mFirst + 1) % mCapacity;
+    }
+    return true;
+}
+
+void WindHistory::stage(const WindSample &sample) {
+    mStaged.push_back(sample);
+}
+
+size_t WindHistory::appendStaged() {
+    // Insertion sort, it is stable and does not allocate, and there are only a few samples per poll.
+    for (size_t i = 1; i < mStaged.size(); ++i) {
+        WindSample sample = mStaged[i];
+        size_t j = i;
+        for (; j > 0 && mStaged[j - 1].mTimeStamp > sample.mTimeStamp; --j) {
+            mStaged[j] = mStaged[j - 1];
+        }
+        mStaged[j] = sample;
+    }
+    size_t appended = 0;
+    for (const WindSample &sample: mStaged) {
+        if (append(sample)) {
+            ++appended;
+        }
+    }
+    mStaged.clear();
+    return appended;
+}
+
+const WindSample &WindHistory::at(size_t index) const {
+    if (index >= mSamples.size()) {
+        throw out_of_range("Invalid wind history index.");
+    }
+    return mSamples[(mFirst + index) % mSamples.size()];
+}
+
+const WindSample &WindHistory::back() const {
+    return mSamples[(mFirst + mSamples.size() - 1) % mSamples.size()];
+}
+
+vector<WindSample> WindHistory::samples(uint64_t begin, uint64_t end) const {
+    vector<WindSample> result;
+    for (size_t i = 0; i < mSamples.size(); ++i) {
+        const WindSample &sample = mSamples[(mFirst + i) % mSamples.size()];
+        if (sample.mTimeStamp > end) {
+            break;
+        }
+        if (sample.mTimeStamp >= begin) {
+            result.push_back(sample);
+        }
+    }
+    return result;
+}
+
+size_t WindHistory::size() const {
+    return mSamples.size();
+}
+
+bool WindHistory::empty() const {
+    return mSamples.empty();
+}
+
+size_t WindHistory::capacity() const {
+    return mCapacity;
+}
+
+void WindHistory::clear() {
+    mSamples.clear();
+    mFirst = 0;
+}
+
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef WINDHISTORY_H
+#define WINDHISTORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace netatmoapi {
+
+/**
+ * @brief A sample of the wind history of a wind gauge.
+ */
+struct WindSample {
+    /**
+     * The time stamp of the sample.
+     */
+    std::uint64_t   mTimeStamp;
+
+    /**
+     * The wind strength.
+     */
+    double          mWindStrength;
+
+    /**
+     * The wind angle.
+     */
+    double          mWindAngle;
+};
+
+/**
+ * @brief Ring buffer for the wind history of a wind gauge.
+ *
+ * The dashboard data of a wind gauge contains the samples of the last
+ * hour in "WindHistoric". Every poll returns mostly the same samples, so
+ * only samples newer than the newest sample in the history are appended.
+ * Continuous polling builds a wind history without gaps, as long as the
+ * polls are less than an hour apart.
+ *
+ * The history keeps the newest capacity() samples. Memory is allocated
+ * with the first sample, so a module without wind history needs none.
+ */
+class WindHistory {
+public:
+    /**
+     * Constructor.
+     * @param capacity The maximum number of samples.
+     */
+    explicit WindHistory(std::size_t capacity = sDefaultCapacity);
+
+    /**
+     * Appends a sample, if it is newer than the newest sample.
+     * If the history is full, the oldest sample is removed.
+     * @param sample The sample.
+     * @return True, if the sample was appended.
+     */
+    bool append(const WindSample &sample);
+
+    /**
+     * Stages a sample, which is appended by appendStaged().
+     * Used for samples, which arrive out of order.
+     * @param sample The sample.
+     */
+    void stage(const WindSample &sample);
+
+    /**
+     * Appends the staged samples ordered by time, like append(), and
+     * removes them from the stage. Samples with the same time stamp keep
+     * their staging order. The stage keeps its memory for the next call.
+     * @return The number of appended samples.
+     */
+    std::size_t appendStaged();
+
+    /**
+     * Returns a sample.
+     * @param index The index of the sample, 0 is the oldest sample.
+     * @return The sample.
+     * @throw std::out_of_range If index is not smaller than size().
+     */
+    const WindSample &at(std::size_t index) const;
+
+    /**
+     * Returns the newest sample.
+     * @return The newest sample. The history must not be empty.
+     */
+    const WindSample &back() const;
+
+    /**
+     * Returns the samples with begin <= time stamp <= end.
+     * @param begin The begin of the range.
+     * @param end The end of the range.
+     * @return The samples, the oldest first.
+     */
+    std::vector<WindSample> samples(std::uint64_t begin, std::uint64_t end) const;
+
+    /**
+     * Returns the number of samples.
+     * @return The number of samples.
+     */
+    std::size_t size() const;
+
+    /**
+     * Returns true, if there is no sample.
+     * @return True, if the history is empty.
+     */
+    bool empty() const;
+
+    /**
+     * Returns the maximum number of samples.
+     * @return The capacity.
+     */
+    std::size_t capacity() const;
+
+    /**
+     * Removes all samples.
+     */
+    void clear();
+
+    /**
+     * The default capacity, one day of 5 minute samples.
+     *
+     * Value: 288
+     */
+    static const std::size_t sDefaultCapacity;
+
+private:
+    std::vector<WindSample> mSamples;
+    std::size_t             mCapacity;
+    // Index of the oldest sample, once the buffer is full.
+    std::size_t             mFirst;
+    // Out of order samples of the current poll, see stage().
+    std::vector<WindSample> mStaged;
+};
+
+}
+
+#endif /* WINDHISTORY_H */
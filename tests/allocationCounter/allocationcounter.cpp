@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "allocationcounter.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+// Constant initialized, so they are usable in operator new before any constructor ran.
+thread_local std::size_t tAllocations = 0;
+thread_local std::size_t tBytes = 0;
+thread_local std::size_t tDeallocations = 0;
+
+void *allocate(std::size_t size) noexcept {
+    ++tAllocations;
+    tBytes += size;
+    while (true) {
+        void *p = std::malloc(size > 0 ? size : 1);
+        if (p) {
+            return p;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            return nullptr;
+        }
+        // May throw std::bad_alloc, which terminates in the noexcept variants, like a failed allocation would.
+        handler();
+    }
+}
+
+void deallocate(void *p) noexcept {
+    if (p) {
+        ++tDeallocations;
+        std::free(p);
+    }
+}
+
+}
+
+void *operator new(std::size_t size) {
+    void *p = allocate(size);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void *operator new[](std::size_t size) {
+    void *p = allocate(size);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+    return allocate(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+    return allocate(size);
+}
+
+void operator delete(void *p) noexcept {
+    deallocate(p);
+}
+
+void operator delete[](void *p) noexcept {
+    deallocate(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+    deallocate(p);
+}
+
+void operator delete[](void *p, std::size_t) noexcept {
+    deallocate(p);
+}
+
+void operator delete(void *p, const std::nothrow_t &) noexcept {
+    deallocate(p);
+}
+
+void operator delete[](void *p, const std::nothrow_t &) noexcept {
+    deallocate(p);
+}
+
+namespace netatmoapi {
+
+AllocationCounter::AllocationCounter() noexcept {
+    reset();
+}
+
+std::size_t AllocationCounter::allocations() const noexcept {
+    return tAllocations - mAllocations;
+}
+
+std::size_t AllocationCounter::bytes() const noexcept {
+    return tBytes - mBytes;
+}
+
+std::size_t AllocationCounter::deallocations() const noexcept {
+    return tDeallocations - mDeallocations;
+}
+
+void AllocationCounter::reset() noexcept {
+    mAllocations = tAllocations;
+    mBytes = tBytes;
+    mDeallocations = tDeallocations;
+}
+
+}
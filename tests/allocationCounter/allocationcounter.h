@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <cstddef>
+
+namespace netatmoapi {
+
+/**
+ * @brief This class counts the heap allocations of the current thread in a scope.
+ *
+ * Linking the allocationcounter library replaces the global operator new
+ * and operator delete of the executable, also for the allocations of the
+ * shared library. The replacement counts every allocation and its size per
+ * thread. A counter reports the allocations of its thread since it was
+ * constructed or reset, allocations of other threads are not counted.
+ *
+ * Counters can be nested, each one counts from its own start.
+ */
+class AllocationCounter {
+public:
+    /**
+     * Constructor.
+     * Starts counting.
+     */
+    AllocationCounter() noexcept;
+
+    AllocationCounter(const AllocationCounter &) = delete;
+    AllocationCounter &operator =(const AllocationCounter &) = delete;
+
+    /**
+     * Returns the number of allocations since the start.
+     * @return The number of allocations.
+     */
+    std::size_t allocations() const noexcept;
+
+    /**
+     * Returns the number of allocated bytes since the start.
+     * Freed memory is not subtracted.
+     * @return The number of bytes.
+     */
+    std::size_t bytes() const noexcept;
+
+    /**
+     * Returns the number of deallocations since the start.
+     * @return The number of deallocations.
+     */
+    std::size_t deallocations() const noexcept;
+
+    /**
+     * Restarts counting.
+     */
+    void reset() noexcept;
+
+private:
+    std::size_t mAllocations;
+    std::size_t mBytes;
+    std::size_t mDeallocations;
+};
+
+}
+
+#endif /* ALLOCATIONCOUNTER_H */
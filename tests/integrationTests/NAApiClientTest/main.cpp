@@ -18,6 +18,7 @@
  */
 
 #include "core/naapiclient.h"
+#include "mockserver.h"
 
 #include <gtest/gtest.h>
 #include <cstdlib>
@@ -27,8 +28,16 @@ using json = nlohmann::json;
 using namespace std;
 using namespace netatmoapi;
 
+MockServer server;
+
+const char *cUsername = "user@example.com";
+const char *cPassword = "password";
+const char *cClientId = "clientId";
+const char *cClientSecret = "clientSecret";
+
 TEST(NAApiClientTest, loginTest) {
     NAApiClient client;
+    client.setUrlBase(server.urlBase());
     EXPECT_THROW(client.login(), LoginException);
 
     client.setUsername("username");
@@ -37,31 +46,61 @@ TEST(NAApiClientTest, loginTest) {
     client.setClientSecret("clientSecret");
     EXPECT_THROW(client.login(), ResponseException);
 
-    client.setUsername(getenv("TEST_USERNAME"));
-    client.setPassword(getenv("TEST_PASSWORD"));
-    client.setClientId(getenv("TEST_CLIENTID"));
-    client.setClientSecret(getenv("TEST_CLIENTSECRET"));
+    client.setUsername(cUsername);
+    client.setPassword(cPassword);
+    client.setClientId(cClientId);
+    client.setClientSecret(cClientSecret);
     EXPECT_NO_THROW(client.login());
+    EXPECT_FALSE(client.accessToken().empty());
+    EXPECT_FALSE(client.refreshToken().empty());
+    EXPECT_GT(client.expiresIn(), time(nullptr));
 }
 
 TEST(NAApiClientTest, updateSessionTest) {
     NAApiClient client;
+    client.setUrlBase(server.urlBase());
     EXPECT_THROW(client.updateSession(), LoginException);
 
-    client.setUsername(getenv("TEST_USERNAME"));
-    client.setPassword(getenv("TEST_PASSWORD"));
-    client.setClientId(getenv("TEST_CLIENTID"));
-    client.setClientSecret(getenv("TEST_CLIENTSECRET"));
+    client.setUsername(cUsername);
+    client.setPassword(cPassword);
+    client.setClientId(cClientId);
+    client.setClientSecret(cClientSecret);
     EXPECT_NO_THROW(client.login());
 
+    string accessToken = client.accessToken();
     EXPECT_NO_THROW(client.updateSession());
+    EXPECT_NE(accessToken, client.accessToken());
+
+    client.setRefreshToken("unknown");
+    EXPECT_THROW(client.updateSession(), ResponseException);
 
     client.setClientId("");
     client.setClientSecret("");
     EXPECT_THROW(client.updateSession(), LoginException);
 }
 
+TEST(NAApiClientTest, urlBaseTest) {
+    NAApiClient client;
+    EXPECT_EQ("https://api.netatmo.net", client.urlBase());
+    client.setUrlBase(server.urlBase());
+    EXPECT_EQ(server.urlBase(), NAApiClient(client).urlBase());
+    client.setUrlBase("");
+    EXPECT_EQ("https://api.netatmo.net", client.urlBase());
+}
+
+TEST(NAApiClientTest, injectedErrorTest) {
+    NAApiClient client(cUsername, cPassword, cClientId, cClientSecret);
+    client.setUrlBase(server.urlBase());
+    server.failNext(1, MockServer::internalError);
+    EXPECT_THROW(client.login(), ResponseException);
+    server.failNext(1, MockServer::disconnect);
+    EXPECT_THROW(client.login(), CurlException);
+    EXPECT_NO_THROW(client.login());
+}
+
 int main (int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
+    server.setCredentials(cUsername, cPassword, cClientId, cClientSecret);
+    server.start();
     return RUN_ALL_TESTS();
 }
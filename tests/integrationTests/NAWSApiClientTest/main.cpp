@@ -18,27 +18,145 @@
  */
 
 #include "core/nawsapiclient.h"
+#include "core/utils.h"
+#include "mockserver.h"
 
 #include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
 #include <cstdlib>
 #include <nlohmann/json.hpp>
+#include <thread>
 
 using json = nlohmann::json;
 using namespace std;
 using namespace netatmoapi;
 
-TEST(NAWSApiClientTest, requestStationsDataTest) {
-    NAWSApiClient client;
-    client.setUsername(getenv("TEST_USERNAME"));
-    client.setPassword(getenv("TEST_PASSWORD"));
-    client.setClientId(getenv("TEST_CLIENTID"));
-    client.setClientSecret(getenv("TEST_CLIENTSECRET"));
-    EXPECT_NO_THROW(client.login());
+MockServer server;
 
-    EXPECT_NO_THROW(client.requestStationsData());
+class NAWSApiClientTest: public ::testing::Test {
+protected:
+    void SetUp() override {
+        server.setFleet(MockServer::sDefaultStationCount, MockServer::sDefaultModuleCount);
+        server.setLatency(chrono::milliseconds(0));
+        server.setErrorRate(0);
+        server.setTokenLifetime(MockServer::sDefaultTokenLifetime);
+        mClient = NAWSApiClient("user@example.com", "password", "clientId", "clientSecret");
+        mClient.setUrlBase(server.urlBase());
+        mClient.setRateLimit(0, 0);
+        mClient.login();
+    }
+
+    NAWSApiClient mClient;
+};
+
+TEST_F(NAWSApiClientTest, requestStationsDataTest) {
+    json response;
+    EXPECT_NO_THROW(response = mClient.requestStationsData());
+    list<Station> stations = utils::parseDevices(response);
+    ASSERT_EQ(MockServer::sDefaultStationCount, stations.size());
+    EXPECT_EQ(MockServer::stationId(0), stations.front().id());
+    // The base station and its modules.
+    EXPECT_EQ(MockServer::sDefaultModuleCount + 1, stations.front().modulesRef().size());
+    EXPECT_NE(numeric_limits<double>::min(), stations.front().place().mLatitude);
+
+    response = mClient.requestStationsData(MockServer::stationId(3));
+    stations = utils::parseDevices(response);
+    ASSERT_EQ(1, stations.size());
+    EXPECT_EQ(MockServer::stationId(3), stations.front().id());
+    EXPECT_THROW(mClient.requestStationsData(MockServer::stationId(MockServer::sDefaultStationCount)), ResponseException);
+}
+
+TEST_F(NAWSApiClientTest, fleetTest) {
+    server.setFleet(1000, 4);
+    list<Station> stations = utils::parseDevices(mClient.requestStationsData());
+    ASSERT_EQ(1000, stations.size());
+    EXPECT_EQ(5, stations.back().modulesRef().size());
+    EXPECT_EQ(MockServer::stationId(999), stations.back().id());
+}
+
+TEST_F(NAWSApiClientTest, requestMeasuresTest) {
+    // One week at the "max" scale needs two requests.
+    const uint64_t begin = 1509408000;
+    const uint64_t end = begin + 7 * 24 * 3600 - 1;
+    json blocks = mClient.requestMeasures(MockServer::stationId(0), "", "max", { "Temperature", "Humidity" }, begin, end, 2);
+    MeasureColumns columns = utils::decodeMeasureBlocks(blocks);
+    ASSERT_EQ(7 * 24 * 12, columns.size());
+    EXPECT_EQ(begin, columns.mTimeStamps.front());
+    EXPECT_EQ(end - 299, columns.mTimeStamps.back());
+    ASSERT_EQ(2, columns.mValues.size());
+    EXPECT_GT(columns.mValues[0][0], 15);
+    EXPECT_LT(columns.mValues[0][0], 30);
+
+    string moduleId = "02" + MockServer::stationId(0).substr(2);
+    columns = utils::decodeMeasureBlocks(mClient.requestMeasures(MockServer::stationId(0), moduleId, "1day", { "Temperature" }, begin, end));
+    EXPECT_EQ(7, columns.size());
+    EXPECT_THROW(mClient.requestMeasures(MockServer::stationId(0), "unknown", "1day", { "Temperature" }, begin, end), ResponseException);
+}
+
+TEST_F(NAWSApiClientTest, sessionTest) {
+    // The access token expires immediately, so every request refreshes it.
+    server.setTokenLifetime(0);
+    mClient.login();
+    size_t requests = server.requestCount();
+    EXPECT_NO_THROW(mClient.requestStationsData());
+    EXPECT_EQ(requests + 2, server.requestCount());
+
+    mClient.setAccessToken("invalid");
+    mClient.setExpiresIn(time(nullptr) + 3600);
+    EXPECT_THROW(mClient.requestStationsData(), ResponseException);
+}
+
+TEST_F(NAWSApiClientTest, injectedErrorTest) {
+    size_t errors = server.errorCount();
+    server.failNext(1, MockServer::usageLimit);
+    EXPECT_THROW(mClient.requestStationsData(), ResponseException);
+    server.failNext(1, MockServer::invalidToken);
+    EXPECT_THROW(mClient.requestStationsData(), ResponseException);
+    server.failNext(1, MockServer::disconnect);
+    EXPECT_THROW(mClient.requestStationsData(), CurlException);
+    EXPECT_EQ(errors + 3, server.errorCount());
+    EXPECT_NO_THROW(mClient.requestStationsData());
+
+    server.setErrorRate(1);
+    EXPECT_THROW(mClient.requestStationsData(), ResponseException);
+}
+
+TEST_F(NAWSApiClientTest, latencyTest) {
+    server.setLatency(chrono::milliseconds(50), chrono::milliseconds(60));
+    auto start = chrono::steady_clock::now();
+    mClient.requestStationsData();
+    EXPECT_GE(chrono::steady_clock::now() - start, chrono::milliseconds(50));
+}
+
+TEST_F(NAWSApiClientTest, concurrentClientsTest) {
+    server.setLatency(chrono::milliseconds(1), chrono::milliseconds(5));
+    const size_t threadCount = 4;
+    const size_t requestsPerThread = 20;
+    size_t requests = server.requestCount();
+    atomic<size_t> failures(0);
+    vector<thread> threads;
+    for (size_t i = 0; i < threadCount; ++i) {
+        threads.emplace_back([this, &failures]() {
+            NAWSApiClient client(mClient);
+            for (size_t j = 0; j < requestsPerThread; ++j) {
+                try {
+                    client.requestStationsData(MockServer::stationId(j % MockServer::sDefaultStationCount));
+                } catch (const exception &) {
+                    ++failures;
+                }
+            }
+        });
+    }
+    for (thread &t: threads) {
+        t.join();
+    }
+    EXPECT_EQ(0, failures);
+    EXPECT_EQ(requests + threadCount * requestsPerThread, server.requestCount());
 }
 
 int main (int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
+    server.start();
     return RUN_ALL_TESTS();
 }
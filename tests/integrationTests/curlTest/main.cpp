@@ -17,14 +17,22 @@
  * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "mockserver.h"
+
+#include <arpa/inet.h>
 #include <gtest/gtest.h>
+#include <netinet/in.h>
 #include <nlohmann/json.hpp>
 #include <curl/curl.h>
+#include <sys/socket.h>
+#include <unistd.h>
 #include <iostream>
 
 using json = nlohmann::json;
 using namespace std;
 
+netatmoapi::MockServer server;
+
 size_t writeCallback(char *buffer, size_t size, size_t nmemb, void *userp) {
     if (userp) {
         ostream *os = static_cast<ostream *>(userp);
@@ -37,11 +45,31 @@ size_t writeCallback(char *buffer, size_t size, size_t nmemb, void *userp) {
     return 0;
 }
 
+// Sends a raw request, e.g. with an invalid header, and returns the response until the server closes the connection.
+string rawRequest(const string &request) {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(server.port());
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    string response;
+    if (::connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0 &&
+            ::send(fd, request.data(), request.size(), 0) == ssize_t(request.size())) {
+        char buffer[4096];
+        ssize_t result;
+        while ((result = ::recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+            response.append(buffer, size_t(result));
+        }
+    }
+    ::close(fd);
+    return response;
+}
+
 TEST(CurlTest, getTest) {
     CURL *curl;
     CURLcode res;
 
-    string url = "http://httpbin.org/get?param1=key1&param2=key2";
+    string url = server.urlBase() + "/get?param1=key1&param2=key2";
     ostringstream response;
 
     curl_global_init(CURL_GLOBAL_ALL);
@@ -72,7 +100,7 @@ TEST(CurlTest, postTest) {
     CURL *curl;
     CURLcode res;
 
-    string url = "http://httpbin.org/post";
+    string url = server.urlBase() + "/post";
     string postField = "param1=key1&param2=key2";
     ostringstream response;
 
@@ -101,7 +129,19 @@ TEST(CurlTest, postTest) {
     EXPECT_STREQ(param2.c_str(), "key2");
 }
 
+TEST(CurlTest, invalidContentLength) {
+    EXPECT_EQ(0, rawRequest("POST /post HTTP/1.1\r\nContent-Length: abc\r\n\r\n").find("HTTP/1.1 400 "));
+    EXPECT_EQ(0, rawRequest("POST /post HTTP/1.1\r\nContent-Length: -1\r\n\r\n").find("HTTP/1.1 400 "));
+    EXPECT_EQ(0, rawRequest("POST /post HTTP/1.1\r\nContent-Length: 99999999999999999999999\r\n\r\n").find("HTTP/1.1 400 "));
+    EXPECT_EQ(0, rawRequest("POST /post HTTP/1.1\r\nContent-Length: 2000000\r\n\r\n").find("HTTP/1.1 413 "));
+    // The server still serves other requests.
+    string response = rawRequest("POST /post HTTP/1.0\r\nContent-Length: 3 \r\n\r\na=b");
+    EXPECT_EQ(0, response.find("HTTP/1.1 200 "));
+    EXPECT_NE(string::npos, response.find("\"a\":\"b\""));
+}
+
 int main (int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
+    server.start();
     return RUN_ALL_TESTS();
 }
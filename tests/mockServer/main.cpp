@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "mockserver.h"
+
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+using namespace netatmoapi;
+using namespace std;
+
+// Runs the mock server until SIGINT or SIGTERM, e.g. as target of a load test.
+int main(int argc, char **argv) {
+    MockServer server;
+    uint16_t port = 0;
+    size_t stations = MockServer::sDefaultStationCount;
+    size_t modules = MockServer::sDefaultModuleCount;
+    for (int i = 1; i < argc; ++i) {
+        const char *value = strchr(argv[i], '=');
+        value = value ? value + 1 : "";
+        if (strncmp(argv[i], "--port=", 7) == 0) {
+            port = uint16_t(atoi(value));
+        } else if (strncmp(argv[i], "--stations=", 11) == 0) {
+            stations = size_t(atol(value));
+        } else if (strncmp(argv[i], "--modules=", 10) == 0) {
+            modules = size_t(atol(value));
+        } else if (strncmp(argv[i], "--latency=", 10) == 0) {
+            // "<min>" or "<min>:<max>" in milliseconds.
+            const char *max = strchr(value, ':');
+            server.setLatency(chrono::milliseconds(atol(value)), chrono::milliseconds(max ? atol(max + 1) : 0));
+        } else if (strncmp(argv[i], "--error-rate=", 13) == 0) {
+            server.setErrorRate(atof(value));
+        } else if (strncmp(argv[i], "--seed=", 7) == 0) {
+            server.setSeed(uint32_t(atol(value)));
+        } else {
+            cerr << "Usage: " << argv[0] << " [--port=<port>] [--stations=<count>] [--modules=<0-4>]"
+                 << " [--latency=<min ms>[:<max ms>]] [--error-rate=<0-1>] [--seed=<seed>]\n";
+            return 1;
+        }
+    }
+
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    // Blocked before the server threads start, so they inherit the mask.
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    try {
+        server.setFleet(stations, modules);
+        server.start(port);
+    } catch (const exception &ex) {
+        cerr << ex.what() << "\n";
+        return 1;
+    }
+    cout << server.urlBase() << endl;
+
+    int signal;
+    sigwait(&signals, &signal);
+    server.stop();
+    cout << server.requestCount() << " requests, " << server.errorCount() << " errors\n";
+    return 0;
+}
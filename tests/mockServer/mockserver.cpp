@@ -0,0 +1,974 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "mockserver.h"
+#include "core/utils.h"
+#include "model/module.h"
+#include "model/params.h"
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fcntl.h>
+#include <limits>
+#include <list>
+#include <map>
+#include <mutex>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <nlohmann/json.hpp>
+#include <poll.h>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <system_error>
+#include <thread>
+#include <unistd.h>
+
+using json = nlohmann::json;
+using namespace std;
+
+namespace netatmoapi {
+
+namespace {
+
+const double cPi = 3.14159265358979323846;
+// Stations report every 5 minutes.
+const uint64_t cReportInterval = 5 * 60;
+const size_t cMaxHeaderSize = 64 * 1024;
+// Larger bodies are rejected with 413, the api only receives small forms.
+const size_t cMaxBodySize = 1024 * 1024;
+const char *cModuleTypes[] = { "NAModule1", "NAModule2", "NAModule3", "NAModule4" };
+const char *cModulePrefixes[] = { "02", "06", "05", "03" };
+const char *cModuleNames[] = { "Outdoor", "Wind", "Rain", "Bedroom" };
+
+struct Request {
+    string mMethod;
+    string mPath;
+    map<string, string> mQuery;
+    map<string, string> mForm;
+    bool mKeepAlive;
+};
+
+struct Response {
+    int mStatus;
+    string mBody;
+    bool mDisconnect;
+};
+
+struct Connection {
+    explicit Connection(int fd) :
+        mFd(fd),
+        mDone(false) {
+    }
+
+    int mFd;
+    thread mThread;
+    atomic<bool> mDone;
+};
+
+uint64_t mix(uint64_t value) {
+    // splitmix64 finalizer.
+    value += 0x9e3779b97f4a7c15ULL;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+    return value ^ (value >> 31);
+}
+
+// Returns a value from 0 to 1, which is fixed for a hash and a salt.
+double unit(uint64_t hash, uint64_t salt) {
+    return double(mix(hash ^ mix(salt)) >> 11) / double(1ULL << 53);
+}
+
+double round1(double value) {
+    return round(value * 10) / 10;
+}
+
+// Parses a decimal number without sign or trailing characters, unlike stoull().
+bool parseUnsigned(const string &value, uint64_t &result) {
+    if (value.empty() || !all_of(value.begin(), value.end(), [](unsigned char c) { return isdigit(c); })) {
+        return false;
+    }
+    errno = 0;
+    result = strtoull(value.c_str(), nullptr, 10);
+    return errno != ERANGE;
+}
+
+string urlDecode(const string &encoded) {
+    string decoded;
+    decoded.reserve(encoded.size());
+    for (size_t i = 0; i < encoded.size(); ++i) {
+        if (encoded[i] == '+') {
+            decoded.push_back(' ');
+        } else if (encoded[i] == '%' && i + 2 < encoded.size() && isxdigit(encoded[i + 1]) && isxdigit(encoded[i + 2])) {
+            decoded.push_back(char(stoi(encoded.substr(i + 1, 2), nullptr, 16)));
+            i += 2;
+        } else {
+            decoded.push_back(encoded[i]);
+        }
+    }
+    return decoded;
+}
+
+map<string, string> parseQuery(const string &query) {
+    map<string, string> params;
+    size_t begin = 0;
+    while (begin < query.size()) {
+        size_t end = query.find('&', begin);
+        if (end == string::npos) {
+            end = query.size();
+        }
+        size_t equal = query.find('=', begin);
+        if (equal != string::npos && equal < end) {
+            params[urlDecode(query.substr(begin, equal - begin))] = urlDecode(query.substr(equal + 1, end - equal - 1));
+        } else if (end > begin) {
+            params[urlDecode(query.substr(begin, end - begin))] = string();
+        }
+        begin = end + 1;
+    }
+    return params;
+}
+
+string lower(string value) {
+    transform(value.begin(), value.end(), value.begin(), [](unsigned char c) { return char(tolower(c)); });
+    return value;
+}
+
+const char *reason(int status) {
+    switch (status) {
+    case 200:
+        return "OK";
+    case 400:
+        return "Bad Request";
+    case 403:
+        return "Forbidden";
+    case 404:
+        return "Not Found";
+    case 413:
+        return "Payload Too Large";
+    default:
+        return "Internal Server Error";
+    }
+}
+
+Response apiError(int status, int code, const string &message) {
+    json body = { { "error", { { "code", code }, { "message", message } } } };
+    return Response { status, body.dump(), false };
+}
+
+Response oauthError(const string &error) {
+    json body = { { "error", error } };
+    return Response { 400, body.dump(), false };
+}
+
+Response ok(const json &body) {
+    return Response { 200, body.dump(), false };
+}
+
+// Returns the index of a station in the fleet, or stations if the id is unknown.
+size_t findStation(const string &id, size_t stations) {
+    unsigned int bytes[3];
+    if (id.size() != 17 || sscanf(id.c_str(), "70:ee:50:%2x:%2x:%2x", &bytes[0], &bytes[1], &bytes[2]) != 3) {
+        return stations;
+    }
+    size_t index = (size_t(bytes[0]) << 16) | (size_t(bytes[1]) << 8) | bytes[2];
+    return index < stations && MockServer::stationId(index) == id ? index : stations;
+}
+
+bool sendAll(int fd, const string &data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t result = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        sent += size_t(result);
+    }
+    return true;
+}
+
+// The synthetic weather. Every value is a smooth function of the time, which
+// is offset per station, so consecutive polls and measures look plausible.
+struct Weather {
+    Weather(uint64_t hash, double latitude) :
+        mHash(hash),
+        mLatitude(latitude) {
+    }
+
+    double value(const string &type, uint64_t time, bool indoor) const {
+        const double day = 2 * cPi * double(time % 86400) / 86400;
+        const double week = 2 * cPi * double(time % (7 * 86400)) / (7 * 86400);
+        const double phase = 2 * cPi * unit(mHash, 1);
+        if (type == params::cTypeTemperature || type == params::cTypeMinTemp || type == params::cTypeMaxTemp) {
+            double temperature = indoor ? 21 + unit(mHash, 2) * 2 + sin(day) : 20 - (mLatitude - 45) * 0.6 + 6 * sin(day - cPi / 2) + 3 * sin(week + phase);
+            if (type == params::cTypeMinTemp) {
+                temperature -= 3;
+            } else if (type == params::cTypeMaxTemp) {
+                temperature += 3;
+            }
+            return round1(temperature);
+        }
+        if (type == params::cTypeHumidity) {
+            return round((indoor ? 50 : 70) + 15 * sin(day + phase));
+        }
+        if (type == params::cTypeCo2) {
+            return round(600 + 300 * (1 + sin(day + phase)));
+        }
+        if (type == params::cTypeNoise) {
+            return round(40 + 8 * (1 + sin(day)));
+        }
+        if (type == params::cTypePressure || type == params::cTypeAbsolutePressure) {
+            double pressure = 1013 + 12 * sin(week + phase);
+            return round1(type == params::cTypePressure ? pressure : pressure - 25);
+        }
+        if (type == params::cTypeRain || type == params::cTypeRainSum1 || type == params::cTypeRainSum24) {
+            double rain = max(0.0, sin(week * 3 + phase) - 0.6) * 2;
+            return round1(type == params::cTypeRainSum24 ? rain * 24 : rain);
+        }
+        if (type == params::cTypeWindStrength || type == params::cTypeGustStrength) {
+            double wind = 10 + 8 * sin(week * 2 + phase) + 4 * sin(day);
+            return round(type == params::cTypeGustStrength ? wind * 1.6 : wind);
+        }
+        if (type == params::cTypeWindAngle || type == params::cTypeGustAngle) {
+            return double((uint64_t(unit(mHash, 3) * 360) + time / 3600 * 7) % 360);
+        }
+        return numeric_limits<double>::quiet_NaN();
+    }
+
+    uint64_t mHash;
+    double mLatitude;
+};
+
+}
+
+struct MockServerPrivate {
+    MockServerPrivate() :
+        mTokenLifetime(MockServer::sDefaultTokenLifetime),
+        mStationCount(MockServer::sDefaultStationCount),
+        mModuleCount(MockServer::sDefaultModuleCount),
+        mSeed(0),
+        mMinLatency(0),
+        mMaxLatency(0),
+        mErrorRate(0),
+        mRateError(MockServer::internalError),
+        mFailNext(0),
+        mNextError(MockServer::internalError),
+        mRequests(0),
+        mErrors(0),
+        mTokenCounter(0),
+        mDevicesSlot(0),
+        mListenFd(-1),
+        mPort(0),
+        mRunning(false) {
+        mWakePipe[0] = -1;
+        mWakePipe[1] = -1;
+    }
+
+    void acceptLoop();
+    void serve(Connection &connection);
+    Response handle(const Request &request);
+    Response requestToken(const Request &request);
+    Response getStationsData(const Request &request);
+    Response getMeasure(const Request &request);
+    Response checkAccessToken(const map<string, string> &params, bool *valid);
+    bool injectError(MockServer::Error *error);
+    chrono::milliseconds latency();
+    static json makeStation(size_t index, size_t modules, uint32_t seed, uint64_t time);
+    string issueToken(const char *prefix);
+
+    mutable mutex mMutex;
+    string mUsername;
+    string mPassword;
+    string mClientId;
+    string mClientSecret;
+    int64_t mTokenLifetime;
+    size_t mStationCount;
+    size_t mModuleCount;
+    uint32_t mSeed;
+    chrono::milliseconds mMinLatency;
+    chrono::milliseconds mMaxLatency;
+    double mErrorRate;
+    MockServer::Error mRateError;
+    size_t mFailNext;
+    MockServer::Error mNextError;
+    size_t mRequests;
+    size_t mErrors;
+    minstd_rand mRandom;
+    // The issued access tokens with their expiry, and the issued refresh tokens.
+    map<string, int64_t> mAccessTokens;
+    set<string> mRefreshTokens;
+    uint64_t mTokenCounter;
+    // The response of the whole fleet, built once per report interval.
+    string mDevicesBody;
+    uint64_t mDevicesSlot;
+
+    int mListenFd;
+    int mWakePipe[2];
+    uint16_t mPort;
+    atomic<bool> mRunning;
+    thread mAcceptor;
+    mutex mConnectionsMutex;
+    list<unique_ptr<Connection>> mConnections;
+};
+
+void MockServerPrivate::acceptLoop() {
+    while (true) {
+        pollfd fds[2] = { { mListenFd, POLLIN, 0 }, { mWakePipe[0], POLLIN, 0 } };
+        if (::poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        if (fds[1].revents != 0) {
+            return;
+        }
+        int fd = ::accept4(mListenFd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) {
+            continue;
+        }
+        int noDelay = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+        lock_guard<mutex> lock(mConnectionsMutex);
+        for (auto it = mConnections.begin(); it != mConnections.end();) {
+            if ((*it)->mDone) {
+                (*it)->mThread.join();
+                ::close((*it)->mFd);
+                it = mConnections.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        mConnections.emplace_back(new Connection(fd));
+        Connection &connection = *mConnections.back();
+        connection.mThread = thread([this, &connection]() {
+            try {
+                serve(connection);
+            } catch (const exception &) {
+                // A broken request only ends its connection.
+            }
+            // The descriptor is closed when the thread is joined, the peer sees the end of the connection now.
+            ::shutdown(connection.mFd, SHUT_RDWR);
+            connection.mDone = true;
+        });
+    }
+}
+
+void MockServerPrivate::serve(Connection &connection) {
+    string buffer;
+    char chunk[16 * 1024];
+    auto receive = [&]() {
+        while (true) {
+            ssize_t result = ::recv(connection.mFd, chunk, sizeof(chunk), 0);
+            if (result < 0 && errno == EINTR) {
+                continue;
+            }
+            if (result <= 0) {
+                return false;
+            }
+            buffer.append(chunk, size_t(result));
+            return true;
+        }
+    };
+
+    auto sendResponse = [&connection](const Response &response, bool keepAlive) {
+        string head = "HTTP/1.1 " + to_string(response.mStatus) + " " + reason(response.mStatus) + "\r\n"
+            "Content-Type: application/json\r\n"
+            "Content-Length: " + to_string(response.mBody.size()) + "\r\n"
+            "Connection: " + (keepAlive ? "keep-alive" : "close") + "\r\n\r\n";
+        return sendAll(connection.mFd, head) && sendAll(connection.mFd, response.mBody);
+    };
+
+    while (true) {
+        size_t headerEnd;
+        while ((headerEnd = buffer.find("\r\n\r\n")) == string::npos) {
+            if (buffer.size() > cMaxHeaderSize || !receive()) {
+                return;
+            }
+        }
+
+        Request request;
+        size_t lineEnd = buffer.find("\r\n");
+        string line = buffer.substr(0, lineEnd);
+        size_t space1 = line.find(' ');
+        size_t space2 = line.find(' ', space1 + 1);
+        if (space1 == string::npos || space2 == string::npos) {
+            return;
+        }
+        request.mMethod = line.substr(0, space1);
+        string target = line.substr(space1 + 1, space2 - space1 - 1);
+        string version = line.substr(space2 + 1);
+        size_t question = target.find('?');
+        request.mPath = target.substr(0, question);
+        if (question != string::npos) {
+            request.mQuery = parseQuery(target.substr(question + 1));
+        }
+
+        uint64_t contentLength = 0;
+        bool validContentLength = true;
+        request.mKeepAlive = version == "HTTP/1.1";
+        size_t pos = lineEnd + 2;
+        while (pos < headerEnd) {
+            size_t end = buffer.find("\r\n", pos);
+            size_t colon = buffer.find(':', pos);
+            if (colon != string::npos && colon < end) {
+                string name = lower(buffer.substr(pos, colon - pos));
+                string value = buffer.substr(colon + 1, end - colon - 1);
+                value.erase(0, value.find_first_not_of(' '));
+                if (name == "content-length") {
+                    value.erase(value.find_last_not_of(' ') + 1);
+                    validContentLength = parseUnsigned(value, contentLength);
+                } else if (name == "connection") {
+                    request.mKeepAlive = lower(value) == "keep-alive";
+                }
+            }
+            pos = end + 2;
+        }
+
+        // The connection is closed after an invalid or too large body, its end is unknown or not read.
+        if (!validContentLength) {
+            sendResponse(apiError(400, 400, "Invalid Content-Length"), false);
+            return;
+        }
+        if (contentLength > cMaxBodySize) {
+            sendResponse(apiError(413, 413, "Request body too large"), false);
+            return;
+        }
+        const size_t requestSize = headerEnd + 4 + size_t(contentLength);
+        while (buffer.size() < requestSize) {
+            if (!receive()) {
+                return;
+            }
+        }
+        if (contentLength > 0) {
+            request.mForm = parseQuery(buffer.substr(headerEnd + 4, size_t(contentLength)));
+        }
+        buffer.erase(0, requestSize);
+
+        Response response = handle(request);
+        if (response.mDisconnect) {
+            return;
+        }
+        if (!sendResponse(response, request.mKeepAlive) || !request.mKeepAlive) {
+            return;
+        }
+    }
+}
+
+Response MockServerPrivate::handle(const Request &request) {
+    {
+        lock_guard<mutex> lock(mMutex);
+        ++mRequests;
+    }
+
+    if (request.mPath == "/get" || request.mPath == "/post") {
+        json body = { { "args", request.mQuery }, { "form", request.mForm }, { "url", request.mPath } };
+        return ok(body);
+    }
+
+    bool isToken = request.mPath == "/oauth2/token";
+    bool isStationsData = request.mPath == "/api/getstationsdata";
+    bool isMeasure = request.mPath == "/api/getmeasure";
+    if (!isToken && !isStationsData && !isMeasure) {
+        return apiError(404, 404, "Not found");
+    }
+
+    this_thread::sleep_for(latency());
+    MockServer::Error error;
+    if (injectError(&error)) {
+        switch (error) {
+        case MockServer::usageLimit:
+            return apiError(403, 26, "User usage reached");
+        case MockServer::invalidToken:
+            return apiError(403, 2, "Invalid access token");
+        case MockServer::disconnect:
+            return Response { 0, string(), true };
+        default:
+            return apiError(500, 500, "Internal Server Error");
+        }
+    }
+
+    if (isToken) {
+        return requestToken(request);
+    }
+    if (isStationsData) {
+        return getStationsData(request);
+    }
+    return getMeasure(request);
+}
+
+Response MockServerPrivate::requestToken(const Request &request) {
+    const map<string, string> &form = request.mForm;
+    auto param = [&form](const char *name) {
+        auto it = form.find(name);
+        return it != form.end() ? it->second : string();
+    };
+
+    lock_guard<mutex> lock(mMutex);
+    if (param("client_id").empty() || param("client_secret").empty()
+            || (!mClientId.empty() && (param("client_id") != mClientId || param("client_secret") != mClientSecret))) {
+        return oauthError("invalid_client");
+    }
+    const string grantType = param("grant_type");
+    if (grantType == "password") {
+        if (param("username").empty() || param("password").empty()
+                || (!mUsername.empty() && (param("username") != mUsername || param("password") != mPassword))) {
+            return oauthError("invalid_grant");
+        }
+    } else if (grantType == "refresh_token") {
+        if (mRefreshTokens.find(param("refresh_token")) == mRefreshTokens.end()) {
+            return oauthError("invalid_grant");
+        }
+    } else {
+        return oauthError("unsupported_grant_type");
+    }
+
+    string accessToken = issueToken("access");
+    string refreshToken = issueToken("refresh");
+    mAccessTokens[accessToken] = time(nullptr) + mTokenLifetime;
+    mRefreshTokens.insert(refreshToken);
+    json body = {
+        { "access_token", accessToken },
+        { "refresh_token", refreshToken },
+        { "expires_in", mTokenLifetime },
+        { "scope", { "read_station" } }
+    };
+    return ok(body);
+}
+
+Response MockServerPrivate::checkAccessToken(const map<string, string> &params, bool *valid) {
+    *valid = false;
+    auto token = params.find("access_token");
+    if (token == params.end()) {
+        return apiError(400, 1, "Access token is missing");
+    }
+    lock_guard<mutex> lock(mMutex);
+    auto expiry = mAccessTokens.find(token->second);
+    if (expiry == mAccessTokens.end()) {
+        return apiError(403, 2, "Invalid access token");
+    }
+    if (expiry->second < time(nullptr)) {
+        return apiError(403, 3, "Access token expired");
+    }
+    *valid = true;
+    return Response { 200, string(), false };
+}
+
+Response MockServerPrivate::getStationsData(const Request &request) {
+    const map<string, string> &params = request.mMethod == "POST" ? request.mForm : request.mQuery;
+    bool valid;
+    Response error = checkAccessToken(params, &valid);
+    if (!valid) {
+        return error;
+    }
+
+    const uint64_t slot = uint64_t(time(nullptr)) / cReportInterval;
+    auto device = params.find("device_id");
+    unique_lock<mutex> lock(mMutex);
+    const size_t modules = mModuleCount;
+    const uint32_t seed = mSeed;
+    if (device != params.end()) {
+        size_t station = findStation(device->second, mStationCount);
+        if (station == mStationCount) {
+            return apiError(400, 9, "Device not found");
+        }
+        lock.unlock();
+        json body = { { "body", { { "devices", json::array({ makeStation(station, modules, seed, slot * cReportInterval) }) } } }, { "status", "ok" } };
+        return ok(body);
+    }
+    // Concurrent polls wait for the first one to build the response.
+    if (mDevicesBody.empty() || mDevicesSlot != slot) {
+        json devices = json::array();
+        for (size_t i = 0; i < mStationCount; ++i) {
+            devices.push_back(makeStation(i, modules, seed, slot * cReportInterval));
+        }
+        json body = { { "body", { { "devices", move(devices) } } }, { "status", "ok" } };
+        mDevicesBody = body.dump();
+        mDevicesSlot = slot;
+    }
+    return Response { 200, mDevicesBody, false };
+}
+
+Response MockServerPrivate::getMeasure(const Request &request) {
+    const map<string, string> &params = request.mMethod == "POST" ? request.mForm : request.mQuery;
+    bool valid;
+    Response error = checkAccessToken(params, &valid);
+    if (!valid) {
+        return error;
+    }
+    auto param = [&params](const char *name) {
+        auto it = params.find(name);
+        return it != params.end() ? it->second : string();
+    };
+
+    size_t stations;
+    size_t modules;
+    uint32_t seed;
+    {
+        lock_guard<mutex> lock(mMutex);
+        stations = mStationCount;
+        modules = mModuleCount;
+        seed = mSeed;
+    }
+    size_t station = findStation(param("device_id"), stations);
+    if (station == stations) {
+        return apiError(400, 9, "Device not found");
+    }
+    bool indoor = true;
+    uint64_t hash = mix(seed ^ mix(station));
+    const string moduleId = param("module_id");
+    if (!moduleId.empty() && moduleId != param("device_id")) {
+        size_t module = 0;
+        while (module < modules && moduleId != cModulePrefixes[module] + MockServer::stationId(station).substr(2)) {
+            ++module;
+        }
+        if (module == modules) {
+            return apiError(400, 9, "Device not found");
+        }
+        indoor = module == 3;
+        hash = mix(hash ^ (module + 1));
+    }
+
+    uint64_t step;
+    vector<string> types;
+    uint64_t begin;
+    uint64_t end;
+    size_t limit = params::cMaxMeasuresPerRequest;
+    try {
+        step = utils::scaleInterval(param("scale"));
+        string type = param("type");
+        for (size_t pos = 0; pos <= type.size();) {
+            size_t comma = min(type.find(',', pos), type.size());
+            if (comma > pos) {
+                types.push_back(type.substr(pos, comma - pos));
+            }
+            pos = comma + 1;
+        }
+    } catch (const exception &) {
+        return apiError(400, 21, "Invalid params");
+    }
+    end = uint64_t(time(nullptr));
+    if (!param("date_end").empty() && param("date_end") != "last" && !parseUnsigned(param("date_end"), end)) {
+        return apiError(400, 21, "Invalid params");
+    }
+    if (!param("limit").empty()) {
+        uint64_t value;
+        if (!parseUnsigned(param("limit"), value)) {
+            return apiError(400, 21, "Invalid params");
+        }
+        limit = size_t(min<uint64_t>(limit, value));
+    }
+    begin = end - min<uint64_t>(end, step * limit);
+    if (!param("date_begin").empty() && !parseUnsigned(param("date_begin"), begin)) {
+        return apiError(400, 21, "Invalid params");
+    }
+    if (types.empty()) {
+        return apiError(400, 21, "Invalid params");
+    }
+
+    Weather weather(hash, 45 + 10 * unit(mix(seed ^ mix(station)), 0));
+    const uint64_t first = (begin + step - 1) / step * step;
+    json values = json::array();
+    json byTime = json::object();
+    const bool optimize = param("optimize") != "false";
+    size_t count = 0;
+    for (uint64_t t = first; t <= end && count < limit; t += step, ++count) {
+        json row = json::array();
+        for (const string &type: types) {
+            double value = weather.value(type, t, indoor);
+            if (std::isnan(value)) {
+                row.push_back(nullptr);
+            } else {
+                row.push_back(value);
+            }
+        }
+        if (optimize) {
+            values.push_back(move(row));
+        } else {
+            byTime[to_string(t)] = move(row);
+        }
+    }
+
+    json body;
+    if (!optimize) {
+        body = move(byTime);
+    } else if (count > 0) {
+        body = json::array({ { { "beg_time", first }, { "step_time", step }, { "value", move(values) } } });
+    } else {
+        body = json::array();
+    }
+    return ok(json { { "body", move(body) }, { "status", "ok" } });
+}
+
+bool MockServerPrivate::injectError(MockServer::Error *error) {
+    lock_guard<mutex> lock(mMutex);
+    if (mFailNext > 0) {
+        --mFailNext;
+        *error = mNextError;
+    } else if (mErrorRate > 0 && uniform_real_distribution<double>(0, 1)(mRandom) < mErrorRate) {
+        *error = mRateError;
+    } else {
+        return false;
+    }
+    ++mErrors;
+    return true;
+}
+
+chrono::milliseconds MockServerPrivate::latency() {
+    lock_guard<mutex> lock(mMutex);
+    if (mMaxLatency <= mMinLatency) {
+        return mMinLatency;
+    }
+    uniform_int_distribution<chrono::milliseconds::rep> distribution(mMinLatency.count(), mMaxLatency.count());
+    return chrono::milliseconds(distribution(mRandom));
+}
+
+json MockServerPrivate::makeStation(size_t index, size_t modules, uint32_t seed, uint64_t time) {
+    const uint64_t hash = mix(seed ^ mix(index));
+    const string id = MockServer::stationId(index);
+    const double latitude = 45 + 10 * unit(hash, 0);
+    const double longitude = 5 + 10 * unit(hash, 4);
+    Weather weather(hash, latitude);
+
+    auto dashboard = [&time](const Weather &weather, const string &type, bool indoor) {
+        json data = { { params::cTypeTimeUtc, time - 30 } };
+        auto add = [&](const string &name) {
+            data[name] = weather.value(name, time, indoor);
+        };
+        if (type == Module::sTypeBase || type == Module::sTypeIndoor || type == Module::sTypeOutdoor) {
+            for (const string *name: { &params::cTypeTemperature, &params::cTypeHumidity, &params::cTypeMinTemp, &params::cTypeMaxTemp }) {
+                add(*name);
+            }
+            data[params::cTypeTemperatureTrend] = "stable";
+            data[params::cTypeDateMinTemp] = time - 6 * 3600;
+            data[params::cTypeDateMaxTemp] = time - 3600;
+        }
+        // The parser reads the same fields of indoor modules and base stations.
+        if (type == Module::sTypeBase || type == Module::sTypeIndoor) {
+            add(params::cTypeCo2);
+            for (const string *name: { &params::cTypePressure, &params::cTypeAbsolutePressure, &params::cTypeNoise }) {
+                add(*name);
+            }
+            data[params::cTypePressureTrend] = "stable";
+        } else if (type == Module::sTypeWindGauge) {
+            for (const string *name: { &params::cTypeWindStrength, &params::cTypeWindAngle, &params::cTypeGustStrength, &params::cTypeGustAngle }) {
+                add(*name);
+            }
+            data[params::cTypeMaxWindStr] = weather.value(params::cTypeGustStrength, time, false);
+            data[params::cTypeMaxWindAngle] = weather.value(params::cTypeGustAngle, time, false);
+            data[params::cTypeDateMaxWindStr] = time - 1800;
+        } else if (type == Module::sTypeRainGauge) {
+            for (const string *name: { &params::cTypeRain, &params::cTypeRainSum1, &params::cTypeRainSum24 }) {
+                add(*name);
+            }
+        }
+        return data;
+    };
+
+    json jsonModules = json::array();
+    for (size_t i = 0; i < modules; ++i) {
+        const uint64_t moduleHash = mix(hash ^ (i + 1));
+        jsonModules.push_back({
+            { "_id", cModulePrefixes[i] + id.substr(2) },
+            { "type", cModuleTypes[i] },
+            { "module_name", cModuleNames[i] },
+            { "battery_percent", 40 + int(unit(moduleHash, 5) * 60) },
+            { "rf_status", 60 + int(unit(moduleHash, 6) * 30) },
+            { "dashboard_data", dashboard(Weather(moduleHash, latitude), cModuleTypes[i], i == 3) }
+        });
+    }
+    return {
+        { "_id", id },
+        { "station_name", "Station " + to_string(index) },
+        { "module_name", "Indoor" },
+        { "type", Module::sTypeBase },
+        { "place", {
+            { "altitude", round(50 + 950 * unit(hash, 7)) },
+            { "city", "City " + to_string(index % 100) },
+            { "country", "DE" },
+            { "timezone", "Europe/Berlin" },
+            { "location", { longitude, latitude } }
+        } },
+        { "dashboard_data", dashboard(weather, Module::sTypeBase, true) },
+        { "modules", move(jsonModules) }
+    };
+}
+
+string MockServerPrivate::issueToken(const char *prefix) {
+    char token[64];
+    snprintf(token, sizeof(token), "%s|%016llx", prefix, static_cast<unsigned long long>(mix(++mTokenCounter ^ mix(mSeed))));
+    return token;
+}
+
+const int64_t MockServer::sDefaultTokenLifetime = 10800;
+const size_t MockServer::sDefaultStationCount = 10;
+const size_t MockServer::sDefaultModuleCount = 2;
+
+MockServer::MockServer() :
+    d(new MockServerPrivate) {
+}
+
+MockServer::~MockServer() noexcept {
+    stop();
+}
+
+void MockServer::start(uint16_t port) {
+    if (d->mRunning) {
+        throw logic_error("Mock server is already running.");
+    }
+    int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        throw system_error(errno, system_category(), "Could not create socket");
+    }
+    int reuse = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    socklen_t length = sizeof(address);
+    if (::bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0
+            || ::listen(fd, SOMAXCONN) != 0
+            || ::getsockname(fd, reinterpret_cast<sockaddr *>(&address), &length) != 0
+            || ::pipe2(d->mWakePipe, O_CLOEXEC) != 0) {
+        int error = errno;
+        ::close(fd);
+        throw system_error(error, system_category(), "Could not listen on port " + to_string(port));
+    }
+    d->mListenFd = fd;
+    d->mPort = ntohs(address.sin_port);
+    d->mRunning = true;
+    d->mAcceptor = thread(&MockServerPrivate::acceptLoop, d.get());
+}
+
+void MockServer::stop() noexcept {
+    if (!d->mRunning) {
+        return;
+    }
+    d->mRunning = false;
+    char wake = 0;
+    while (::write(d->mWakePipe[1], &wake, 1) < 0 && errno == EINTR) {
+    }
+    d->mAcceptor.join();
+
+    lock_guard<mutex> lock(d->mConnectionsMutex);
+    for (unique_ptr<Connection> &connection: d->mConnections) {
+        ::shutdown(connection->mFd, SHUT_RDWR);
+    }
+    for (unique_ptr<Connection> &connection: d->mConnections) {
+        connection->mThread.join();
+        ::close(connection->mFd);
+    }
+    d->mConnections.clear();
+    ::close(d->mListenFd);
+    ::close(d->mWakePipe[0]);
+    ::close(d->mWakePipe[1]);
+    d->mListenFd = -1;
+    d->mWakePipe[0] = -1;
+    d->mWakePipe[1] = -1;
+    d->mPort = 0;
+}
+
+bool MockServer::isRunning() const {
+    return d->mRunning;
+}
+
+uint16_t MockServer::port() const {
+    return d->mPort;
+}
+
+string MockServer::urlBase() const {
+    return "http://127.0.0.1:" + to_string(d->mPort);
+}
+
+void MockServer::setCredentials(const string &username, const string &password, const string &clientId, const string &clientSecret) {
+    lock_guard<mutex> lock(d->mMutex);
+    d->mUsername = username;
+    d->mPassword = password;
+    d->mClientId = clientId;
+    d->mClientSecret = clientSecret;
+}
+
+void MockServer::setTokenLifetime(int64_t seconds) {
+    lock_guard<mutex> lock(d->mMutex);
+    d->mTokenLifetime = seconds;
+}
+
+void MockServer::setFleet(size_t stations, size_t modules) {
+    if (modules > sizeof(cModuleTypes) / sizeof(cModuleTypes[0])) {
+        throw invalid_argument("Too many modules per station.");
+    }
+    lock_guard<mutex> lock(d->mMutex);
+    d->mStationCount = stations;
+    d->mModuleCount = modules;
+    d->mDevicesBody.clear();
+}
+
+void MockServer::setSeed(uint32_t seed) {
+    lock_guard<mutex> lock(d->mMutex);
+    d->mSeed = seed;
+    d->mRandom.seed(seed);
+    d->mDevicesBody.clear();
+}
+
+void MockServer::setLatency(chrono::milliseconds min, chrono::milliseconds max) {
+    lock_guard<mutex> lock(d->mMutex);
+    d->mMinLatency = min;
+    d->mMaxLatency = std::max(min, max);
+}
+
+void MockServer::setErrorRate(double rate, Error error) {
+    lock_guard<mutex> lock(d->mMutex);
+    d->mErrorRate = rate;
+    d->mRateError = error;
+}
+
+void MockServer::failNext(size_t count, Error error) {
+    lock_guard<mutex> lock(d->mMutex);
+    d->mFailNext = count;
+    d->mNextError = error;
+}
+
+size_t MockServer::requestCount() const {
+    lock_guard<mutex> lock(d->mMutex);
+    return d->mRequests;
+}
+
+size_t MockServer::errorCount() const {
+    lock_guard<mutex> lock(d->mMutex);
+    return d->mErrors;
+}
+
+string MockServer::stationId(size_t index) {
+    char id[18];
+    snprintf(id, sizeof(id), "70:ee:50:%02zx:%02zx:%02zx", (index >> 16) & 0xff, (index >> 8) & 0xff, index & 0xff);
+    return id;
+}
+
+}
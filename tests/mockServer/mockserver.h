@@ -0,0 +1,204 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MOCKSERVER_H
+#define MOCKSERVER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace netatmoapi {
+
+struct MockServerPrivate;
+
+/**
+ * @brief This class is a local http server, which fakes the netatmo api.
+ *
+ * The server answers the endpoints of the clients:
+ * - "/oauth2/token" with the grant types "password" and "refresh_token",
+ * - "/api/getstationsdata" with a synthetic fleet,
+ * - "/api/getmeasure" with synthetic measures of any time range,
+ * - "/get" and "/post", which echo the parameters like httpbin.org.
+ *
+ * The fleet is generated from the station count, the module count and the
+ * seed, so every run gets the same stations. The latency and the error
+ * injection apply to the api endpoints, including the token endpoint.
+ *
+ * The server listens on the loopback interface and serves every connection
+ * in its own thread. It speaks plain http, a client uses it with
+ * NAApiClient::setUrlBase(urlBase()). All methods are thread safe.
+ */
+class MockServer {
+public:
+    /**
+     * Injected errors.
+     */
+    enum Error {
+        internalError,  /**< Http status 500 with an api error. */
+        usageLimit,     /**< Http status 403 with the api error 26, the user usage limit. */
+        invalidToken,   /**< Http status 403 with the api error 2, an invalid access token. */
+        disconnect      /**< The connection is closed without a response. */
+    };
+
+    /**
+     * Default constructor.
+     * The server is not started.
+     */
+    MockServer();
+
+    MockServer(const MockServer &) = delete;
+    MockServer &operator =(const MockServer &) = delete;
+
+    /**
+     * Destructor.
+     * Stops the server.
+     */
+    ~MockServer() noexcept;
+
+    /**
+     * Starts the server.
+     * @param port The port, 0 for a free port.
+     * @throw std::system_error Is thrown if the server can not listen on the port.
+     */
+    void start(std::uint16_t port = 0);
+
+    /**
+     * Stops the server and closes all connections.
+     */
+    void stop() noexcept;
+
+    /**
+     * Returns whether the server is started.
+     * @return True if started.
+     */
+    bool isRunning() const;
+
+    /**
+     * Returns the port of the server.
+     * @return The port, 0 if not started.
+     */
+    std::uint16_t port() const;
+
+    /**
+     * Returns the base url of the server.
+     * @return The url, e.g. "http://127.0.0.1:8080".
+     */
+    std::string urlBase() const;
+
+    /**
+     * Sets the accepted credentials.
+     * By default every non-empty credential is accepted.
+     * @param username The username.
+     * @param password The password.
+     * @param clientId The client id.
+     * @param clientSecret The client secret.
+     */
+    void setCredentials(const std::string &username, const std::string &password, const std::string &clientId, const std::string &clientSecret);
+
+    /**
+     * Sets the lifetime of the issued access tokens.
+     * @param seconds The lifetime, sDefaultTokenLifetime by default.
+     */
+    void setTokenLifetime(std::int64_t seconds);
+
+    /**
+     * Sets the size of the fleet.
+     * @param stations The number of stations, sDefaultStationCount by default.
+     * @param modules The number of modules per station, at most 4, sDefaultModuleCount by default.
+     * @throw std::invalid_argument Is thrown if modules is greater than 4.
+     */
+    void setFleet(std::size_t stations, std::size_t modules);
+
+    /**
+     * Sets the seed of the generated values.
+     * @param seed The seed.
+     */
+    void setSeed(std::uint32_t seed);
+
+    /**
+     * Sets the latency of the api endpoints.
+     * Every request is delayed by a uniformly distributed time in the range.
+     * @param min The minimum latency.
+     * @param max The maximum latency, a value below min is min.
+     */
+    void setLatency(std::chrono::milliseconds min, std::chrono::milliseconds max = std::chrono::milliseconds(0));
+
+    /**
+     * Sets the rate of injected errors.
+     * @param rate The probability of an error per api request, from 0 to 1.
+     * @param error The injected error.
+     */
+    void setErrorRate(double rate, Error error = internalError);
+
+    /**
+     * Fails the next api requests.
+     * @param count The number of requests to fail.
+     * @param error The injected error.
+     */
+    void failNext(std::size_t count, Error error = internalError);
+
+    /**
+     * Returns the number of served requests.
+     * @return The number of requests, including failed ones.
+     */
+    std::size_t requestCount() const;
+
+    /**
+     * Returns the number of injected errors.
+     * @return The number of errors.
+     */
+    std::size_t errorCount() const;
+
+    /**
+     * Returns the id of a generated station.
+     * @param index The index of the station in the fleet.
+     * @return The id, e.g. "70:ee:50:00:00:01".
+     */
+    static std::string stationId(std::size_t index);
+
+    /**
+     * The default lifetime of access tokens in seconds.
+     *
+     * Value: 10800
+     */
+    static const std::int64_t sDefaultTokenLifetime;
+
+    /**
+     * The default number of stations.
+     *
+     * Value: 10
+     */
+    static const std::size_t sDefaultStationCount;
+
+    /**
+     * The default number of modules per station.
+     *
+     * Value: 2
+     */
+    static const std::size_t sDefaultModuleCount;
+
+private:
+    std::unique_ptr<MockServerPrivate> d;
+};
+
+}
+
+#endif /* MOCKSERVER_H */
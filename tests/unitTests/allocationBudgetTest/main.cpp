@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "allocationcounter.h"
+#include "core/nawsapiclient.h"
+#include "core/utils.h"
+#include "fixtures.hpp"
+
+#include <gtest/gtest.h>
+#include <ctime>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace netatmoapi;
+using namespace std;
+
+namespace {
+
+const size_t cStations = 10;
+
+// The budgets are the allocation counts of the current implementation with
+// a little headroom. An optimization should lower its budget, so that the
+// gain is kept. The counts are recorded as test properties, see
+// --gtest_output=xml.
+const size_t cParseDevicesBudget = 16 * cStations + 5;
+const size_t cParseDevicesInPlaceBudget = 0;
+const size_t cBuildUrlQueryBudget = 7;
+const size_t cRequestStationsDataBudget = 145 * cStations;
+const size_t cStationCopyBudget = 16;
+
+// Records the counts and returns the allocations, before the recording allocates itself.
+size_t record(const AllocationCounter &counter) {
+    const size_t allocations = counter.allocations();
+    const size_t bytes = counter.bytes();
+    ::testing::Test::RecordProperty("allocations", to_string(allocations));
+    ::testing::Test::RecordProperty("bytes", to_string(bytes));
+    return allocations;
+}
+
+// Stations with an outdoor module, a wind gauge with its wind history and a rain gauge.
+json makeResponse() {
+    return json::parse(benchmark::makeStationsResponse(cStations, 3));
+}
+
+}
+
+TEST(AllocationBudgetTest, counter) {
+    AllocationCounter counter;
+    int *value = new int(42);
+    EXPECT_EQ(1, counter.allocations());
+    EXPECT_EQ(sizeof(int), counter.bytes());
+    {
+        AllocationCounter nested;
+        vector<int> values(100);
+        EXPECT_EQ(1, nested.allocations());
+        EXPECT_EQ(100 * sizeof(int), nested.bytes());
+    }
+    EXPECT_EQ(2, counter.allocations());
+    EXPECT_EQ(1, counter.deallocations());
+    delete value;
+    EXPECT_EQ(2, counter.deallocations());
+
+    // Allocations of other threads are not counted.
+    thread other([]() {
+        vector<int> values(100);
+        EXPECT_EQ(100, values.size());
+    });
+    counter.reset();
+    other.join();
+    EXPECT_EQ(0, counter.allocations());
+}
+
+TEST(AllocationBudgetTest, parseDevices) {
+    const json response = makeResponse();
+    AllocationCounter counter;
+    list<Station> stations = utils::parseDevices(response);
+    ASSERT_EQ(cStations, stations.size());
+    EXPECT_LE(record(counter), cParseDevicesBudget);
+}
+
+TEST(AllocationBudgetTest, parseDevicesInPlace) {
+    const json response = makeResponse();
+    list<Station> stations = utils::parseDevices(response);
+    // The next poll reuses the stations, modules and strings.
+    AllocationCounter counter;
+    utils::parseDevices(response, stations);
+    ASSERT_EQ(cStations, stations.size());
+    EXPECT_LE(record(counter), cParseDevicesInPlaceBudget);
+}
+
+TEST(AllocationBudgetTest, buildUrlQuery) {
+    const map<string, string> params = {
+        { "access_token", "5a1b2c3d4e5f60718293a4b5|0123456789abcdef0123456789abcdef" },
+        { "device_id", "70:ee:50:00:00:01" },
+        { "get_favorites", "true" }
+    };
+    AllocationCounter counter;
+    string query = utils::buildUrlQuery(params, '&');
+    EXPECT_FALSE(query.empty());
+    EXPECT_LE(record(counter), cBuildUrlQueryBudget);
+}
+
+TEST(AllocationBudgetTest, requestStationsData) {
+    NAWSApiClient client("user", "password", "id", "secret", "access", "refresh");
+    client.setExpiresIn(time(nullptr) + 3600);
+    client.setRateLimit(0, 0);
+    client.setTransport(make_shared<benchmark::CannedTransport>(makeResponse().dump()));
+    // A round trip from the request to the parsed stations, the transport copies the canned response.
+    AllocationCounter counter;
+    list<Station> stations = utils::parseDevices(client.requestStationsData());
+    ASSERT_EQ(cStations, stations.size());
+    EXPECT_LE(record(counter), cRequestStationsDataBudget);
+}
+
+TEST(AllocationBudgetTest, stationCopy) {
+    const list<Station> stations = utils::parseDevices(makeResponse());
+    AllocationCounter counter;
+    Station copy(stations.front());
+    EXPECT_LE(record(counter), cStationCopyBudget);
+    EXPECT_EQ(stations.front().id(), copy.id());
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
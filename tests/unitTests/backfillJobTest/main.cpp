@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "core/backfillcheckpoint.h"
+#include "core/backfilljob.h"
+#include "core/transport.h"
+#include "fixtures.hpp"
+#include "model/module.h"
+#include "model/params.h"
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <unistd.h>
+
+using namespace netatmoapi;
+using namespace std;
+
+string tempPath(const string &name) {
+    const char *dir = getenv("TMPDIR");
+    return string(dir ? dir : "/tmp") + "/" + name + "." + to_string(::getpid());
+}
+
+// A single station without modules and one block of measures for every getmeasure request.
+shared_ptr<benchmark::CannedTransport> makeTransport() {
+    auto transport = make_shared<benchmark::CannedTransport>(R"({"body":[{"beg_time":1000,"step_time":3600,"value":[[21.1,56]]}],"status":"ok"})");
+    transport->setResponse("getstationsdata", benchmark::makeStationsResponse(1, 0));
+    return transport;
+}
+
+// Answers every getmeasure request with one measure at the begin of the requested range and fails on the n-th one.
+class FailingTransport: public benchmark::CannedTransport {
+public:
+    explicit FailingTransport(size_t failAt) :
+        CannedTransport(string()),
+        mFailAt(failAt) {
+        setResponse("getstationsdata", benchmark::makeStationsResponse(1, 0));
+    }
+    string get(const string &url, const map<string, string> &params) override {
+        if (url.find("getmeasure") == string::npos) {
+            return CannedTransport::get(url, params);
+        }
+        return measures(params);
+    }
+    string post(const string &url, const map<string, string> &params) override {
+        if (url.find("getmeasure") == string::npos) {
+            return CannedTransport::post(url, params);
+        }
+        return measures(params);
+    }
+
+    size_t mFailAt;
+    size_t mCalls = 0;
+    vector<uint64_t> mBegins;
+
+private:
+    string measures(const map<string, string> &params) {
+        if (++mCalls == mFailAt) {
+            throw runtime_error("Connection reset.");
+        }
+        const string &begin = params.at("date_begin");
+        mBegins.push_back(stoull(begin));
+        return R"({"body":[{"beg_time":)" + begin + R"(,"step_time":3600,"value":[[21.1,56]]}],"status":"ok"})";
+    }
+};
+
+TEST(BackfillJobTest, checkpoint) {
+    string path = tempPath("backfillJobTest");
+    {
+        BackfillCheckpoint checkpoint(path, params::cScaleMax, 1000, 2000);
+        EXPECT_EQ(0, checkpoint.size());
+        EXPECT_EQ(1000, checkpoint.next("70:ee:50:00:00:01", "02:00:00:00:00:01"));
+        checkpoint.update("70:ee:50:00:00:01", "02:00:00:00:00:01", 1500);
+        checkpoint.update("70:ee:50:00:00:01", "70:ee:50:00:00:01", 1200);
+        checkpoint.update("70:ee:50:00:00:01", "02:00:00:00:00:01", 2001);
+        EXPECT_TRUE(checkpoint.isDone("70:ee:50:00:00:01", "02:00:00:00:00:01"));
+        EXPECT_FALSE(checkpoint.isDone("70:ee:50:00:00:01", "70:ee:50:00:00:01"));
+    }
+    {
+        // An interrupted update.
+        ofstream file(path, ios::app);
+        file << "70:ee:50:00:00:01 70:ee:50:00:00:01 19";
+    }
+    {
+        BackfillCheckpoint checkpoint(path, params::cScaleMax, 1000, 2000);
+        EXPECT_EQ(2, checkpoint.size());
+        EXPECT_TRUE(checkpoint.isDone("70:ee:50:00:00:01", "02:00:00:00:00:01"));
+        EXPECT_EQ(1200, checkpoint.next("70:ee:50:00:00:01", "70:ee:50:00:00:01"));
+    }
+    // The file is compacted.
+    ifstream file(path);
+    string line;
+    size_t lines = 0;
+    while (getline(file, line)) {
+        ++lines;
+    }
+    EXPECT_EQ(3, lines);
+
+    EXPECT_THROW(BackfillCheckpoint(path, params::cScale1Hour, 1000, 2000), runtime_error);
+    EXPECT_THROW(BackfillCheckpoint(path, params::cScaleMax, 1000, 3000), runtime_error);
+    remove(path.c_str());
+}
+
+TEST(BackfillJobTest, measureTypes) {
+    EXPECT_EQ(5, BackfillJob::measureTypes(Module::sTypeBase).size());
+    EXPECT_EQ((vector<string>{ params::cTypeTemperature, params::cTypeHumidity }), BackfillJob::measureTypes(Module::sTypeOutdoor));
+    EXPECT_EQ(4, BackfillJob::measureTypes(Module::sTypeWindGauge).size());
+    EXPECT_EQ((vector<string>{ params::cTypeRain }), BackfillJob::measureTypes(Module::sTypeRainGauge));
+    EXPECT_EQ(3, BackfillJob::measureTypes(Module::sTypeIndoor).size());
+    EXPECT_TRUE(BackfillJob::measureTypes("NAPlug").empty());
+
+    EXPECT_THROW(BackfillJob(tempPath("backfillJobTestScale"), "2hours", 1000, 2000), invalid_argument);
+    BackfillJob job(tempPath("backfillJobTestProgress"), params::cScale1Hour, 1000, 2000);
+    BackfillJob::Progress progress = job.progress();
+    EXPECT_EQ(0, progress.mModules);
+    EXPECT_LT(progress.mEta, 0);
+}
+
+TEST(BackfillJobTest, callbacksCallProgress) {
+    string path = tempPath("backfillJobTestCallbacks");
+    NAWSApiClient client("user", "password", "id", "secret", "access", "refresh");
+    client.setExpiresIn(time(nullptr) + 3600);
+    client.setRateLimit(0, 0);
+    client.setTransport(makeTransport());
+
+    BackfillJob job(path, params::cScale1Hour, 1000, 2000);
+    job.addAccount(client);
+    size_t measuresCalls = 0;
+    size_t progressCalls = 0;
+    // The progress is not locked during the callbacks.
+    job.setMeasuresCallback([&](const string &, const string &, const vector<string> &, const json &) {
+        EXPECT_EQ(0, job.progress().mChunksDone);
+        ++measuresCalls;
+    });
+    job.setProgressCallback([&](const BackfillJob::Progress &progress) {
+        EXPECT_EQ(progress.mChunksDone, job.progress().mChunksDone);
+        ++progressCalls;
+    });
+    job.run();
+    EXPECT_EQ(1, measuresCalls);
+    EXPECT_EQ(1, progressCalls);
+    EXPECT_EQ(1, job.progress().mModulesDone);
+    EXPECT_EQ(1, job.progress().mMeasures);
+    remove(path.c_str());
+}
+
+TEST(BackfillJobTest, resume) {
+    string path = tempPath("backfillJobTestResume");
+    remove(path.c_str());
+    const uint64_t chunkLength = 3600 * params::cMaxMeasuresPerRequest;
+    const uint64_t begin = 1000;
+    const uint64_t end = begin + 5 * chunkLength - 1;
+    const string deviceId = "70:ee:50:00:00:00";
+    NAWSApiClient client("user", "password", "id", "secret", "access", "refresh");
+    client.setExpiresIn(time(nullptr) + 3600);
+    client.setRateLimit(0, 0);
+
+    set<uint64_t> received;
+    auto measuresCallback = [&received](const string &, const string &, const vector<string> &, const json &blocks) {
+        ASSERT_EQ(1, blocks.size());
+        EXPECT_TRUE(received.insert(blocks[0]["beg_time"].get<uint64_t>()).second);
+    };
+
+    // The third chunk fails.
+    auto failingTransport = make_shared<FailingTransport>(3);
+    client.setTransport(failingTransport);
+    BackfillJob job(path, params::cScale1Hour, begin, end);
+    job.addAccount(client);
+    job.setMeasuresCallback(measuresCallback);
+    EXPECT_THROW(job.run(), runtime_error);
+    EXPECT_EQ((vector<uint64_t>{ begin, begin + chunkLength }), failingTransport->mBegins);
+    BackfillJob::Progress progress = job.progress();
+    EXPECT_EQ(1, progress.mModules);
+    EXPECT_EQ(0, progress.mModulesDone);
+    EXPECT_EQ(5, progress.mChunks);
+    EXPECT_EQ(2, progress.mChunksDone);
+    EXPECT_EQ(2, progress.mMeasures);
+    EXPECT_EQ(begin + 2 * chunkLength, BackfillCheckpoint(path, params::cScale1Hour, begin, end).next(deviceId, deviceId));
+
+    // The second run starts at the checkpoint.
+    auto transport = make_shared<FailingTransport>(0);
+    client.setTransport(transport);
+    BackfillJob resumed(path, params::cScale1Hour, begin, end);
+    resumed.addAccount(client);
+    resumed.setMeasuresCallback(measuresCallback);
+    resumed.run();
+    EXPECT_EQ((vector<uint64_t>{ begin + 2 * chunkLength, begin + 3 * chunkLength, begin + 4 * chunkLength }), transport->mBegins);
+    BackfillJob::Progress resumedProgress = resumed.progress();
+    EXPECT_EQ(1, resumedProgress.mModules);
+    EXPECT_EQ(1, resumedProgress.mModulesDone);
+    EXPECT_EQ(3, resumedProgress.mChunks);
+    EXPECT_EQ(3, resumedProgress.mChunksDone);
+    EXPECT_EQ(progress.mChunks, progress.mChunksDone + resumedProgress.mChunks);
+    EXPECT_EQ(5, progress.mMeasures + resumedProgress.mMeasures);
+    EXPECT_EQ(5, received.size());
+    EXPECT_TRUE(BackfillCheckpoint(path, params::cScale1Hour, begin, end).isDone(deviceId, deviceId));
+    remove(path.c_str());
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
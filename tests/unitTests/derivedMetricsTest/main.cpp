@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "core/derivedmetrics.h"
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace netatmoapi;
+using namespace std;
+
+namespace {
+
+const double cMissing = numeric_limits<double>::min();
+
+void expectNear(double expected, double actual) {
+    if (expected == cMissing) {
+        EXPECT_EQ(cMissing, actual);
+    } else {
+        EXPECT_NEAR(expected, actual, 1e-9 * max(1.0, fabs(expected)));
+    }
+}
+
+}
+
+TEST(DerivedMetricsTest, referenceValues) {
+    EXPECT_NEAR(9.26, derived::dewPoint(20, 50), 0.01);
+    EXPECT_NEAR(20, derived::dewPoint(20, 100), 1e-9);
+    // NWS table: 90 °F and 70 % give 106 °F.
+    EXPECT_NEAR((106 - 32) / 1.8, derived::heatIndex((90 - 32) / 1.8, 70), 0.5);
+    // Below 80 °F the simple formula is used.
+    EXPECT_NEAR(20, derived::heatIndex(20, 50), 1);
+    // Environment Canada tables.
+    EXPECT_NEAR(34, derived::humidex(30, 40), 0.5);
+    EXPECT_NEAR(-18, derived::windChill(-10, 20), 0.5);
+    EXPECT_DOUBLE_EQ(15, derived::windChill(15, 30));
+    EXPECT_DOUBLE_EQ(-5, derived::windChill(-5, 3));
+}
+
+TEST(DerivedMetricsTest, missingValues) {
+    EXPECT_EQ(cMissing, derived::dewPoint(cMissing, 50));
+    EXPECT_EQ(cMissing, derived::dewPoint(20, cMissing));
+    EXPECT_EQ(cMissing, derived::dewPoint(20, 0));
+    EXPECT_EQ(cMissing, derived::heatIndex(cMissing, 50));
+    EXPECT_EQ(cMissing, derived::humidex(20, cMissing));
+    EXPECT_EQ(cMissing, derived::windChill(cMissing, 20));
+    EXPECT_EQ(cMissing, derived::windChill(-10, cMissing));
+
+    Measures outdoor, wind;
+    EXPECT_EQ(cMissing, derived::dewPoint(outdoor));
+    EXPECT_EQ(cMissing, derived::windChill(outdoor, wind));
+    outdoor.mTemperature = -10;
+    outdoor.mHumidity = 80;
+    wind.mWindStrength = 20;
+    EXPECT_DOUBLE_EQ(derived::dewPoint(-10, 80), derived::dewPoint(outdoor));
+    EXPECT_DOUBLE_EQ(derived::heatIndex(-10, 80), derived::heatIndex(outdoor));
+    EXPECT_DOUBLE_EQ(derived::humidex(-10, 80), derived::humidex(outdoor));
+    EXPECT_DOUBLE_EQ(derived::windChill(-10, 20), derived::windChill(outdoor, wind));
+}
+
+TEST(DerivedMetricsTest, batchMatchesScalar) {
+    const size_t count = 10001;
+    mt19937 random(42);
+    uniform_int_distribution<int> percent(0, 99);
+    uniform_real_distribution<double> temperature(-40, 50);
+    uniform_real_distribution<double> humidity(0, 100);
+    uniform_real_distribution<double> windStrength(0, 120);
+    vector<double> temperatures, humidities, windStrengths;
+    for (size_t i = 0; i < count; ++i) {
+        temperatures.push_back(percent(random) < 3 ? cMissing : temperature(random));
+        humidities.push_back(percent(random) < 3 ? cMissing : humidity(random));
+        windStrengths.push_back(percent(random) < 3 ? cMissing : windStrength(random));
+    }
+    humidities[10] = 0;
+    humidities[11] = 5;
+    temperatures[11] = 35;
+    humidities[12] = 90;
+    temperatures[12] = 29;
+
+    vector<double> result(count);
+    derived::dewPoint(temperatures.data(), humidities.data(), result.data(), count);
+    for (size_t i = 0; i < count; ++i) {
+        expectNear(derived::dewPoint(temperatures[i], humidities[i]), result[i]);
+    }
+    derived::heatIndex(temperatures.data(), humidities.data(), result.data(), count);
+    for (size_t i = 0; i < count; ++i) {
+        expectNear(derived::heatIndex(temperatures[i], humidities[i]), result[i]);
+    }
+    derived::humidex(temperatures.data(), humidities.data(), result.data(), count);
+    for (size_t i = 0; i < count; ++i) {
+        expectNear(derived::humidex(temperatures[i], humidities[i]), result[i]);
+    }
+    derived::windChill(temperatures.data(), windStrengths.data(), result.data(), count);
+    for (size_t i = 0; i < count; ++i) {
+        expectNear(derived::windChill(temperatures[i], windStrengths[i]), result[i]);
+    }
+
+    // In place.
+    vector<double> inPlace = temperatures;
+    derived::dewPoint(inPlace.data(), humidities.data(), inPlace.data(), count);
+    for (size_t i = 0; i < count; ++i) {
+        expectNear(derived::dewPoint(temperatures[i], humidities[i]), inPlace[i]);
+    }
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "core/utils.h"
+
+#include <gtest/gtest.h>
+
+using namespace netatmoapi;
+using namespace netatmoapi::utils;
+
+using namespace std;
+
+Module makeModule(const string &id, const string &type, double temperature, int16_t batteryPercent) {
+    Measures measures;
+    measures.mTimeStamp = 1509446923;
+    measures.mTemperature = temperature;
+    measures.mTemperatureTrend = Measures::stable;
+    Module module(string("Module"), string(id), string(type), batteryPercent, 70);
+    module.setMeasures(move(measures));
+    return module;
+}
+
+list<Station> makeStations(double outdoorTemperature, int16_t outdoorBattery) {
+    list<Station> stations;
+    Station station(string("Station"), string("70:ee:50:29:48:4e"));
+    station.addModule(makeModule("70:ee:50:29:48:4e", Module::sTypeBase, 21.1, -1));
+    station.addModule(makeModule("02:00:00:29:2c:7a", Module::sTypeOutdoor, outdoorTemperature, outdoorBattery));
+    stations.emplace_back(move(station));
+    return stations;
+}
+
+TEST(DiffDevicesTest, unchanged) {
+    EXPECT_TRUE(diffDevices(makeStations(8.2, 88), makeStations(8.2, 88)).empty());
+    EXPECT_TRUE(diffDevices(list<Station>(), list<Station>()).empty());
+}
+
+TEST(DiffDevicesTest, changedValues) {
+    vector<Change> changes = diffDevices(makeStations(8.2, 88), makeStations(9.5, 87));
+    ASSERT_EQ(2, changes.size());
+
+    EXPECT_STREQ("02:00:00:29:2c:7a", changes.at(0).mModuleId.c_str());
+    EXPECT_EQ(Change::batteryPercent, changes.at(0).mKind);
+    EXPECT_DOUBLE_EQ(88, changes.at(0).mOldValue);
+    EXPECT_DOUBLE_EQ(87, changes.at(0).mNewValue);
+
+    EXPECT_STREQ("02:00:00:29:2c:7a", changes.at(1).mModuleId.c_str());
+    EXPECT_EQ(Change::measure, changes.at(1).mKind);
+    EXPECT_EQ(Measures::temperature, changes.at(1).mField);
+    EXPECT_DOUBLE_EQ(8.2, changes.at(1).mOldValue);
+    EXPECT_DOUBLE_EQ(9.5, changes.at(1).mNewValue);
+    EXPECT_EQ(1509446923, changes.at(1).mTimeStamp);
+}
+
+TEST(DiffDevicesTest, addedAndRemovedModules) {
+    list<Station> oldStations = makeStations(8.2, 88);
+    list<Station> newStations = makeStations(8.2, 88);
+    list<Module> &modules = newStations.front().modulesRef();
+    // Reorder the modules and replace the outdoor module by a rain gauge.
+    modules.reverse();
+    modules.front() = makeModule("05:00:00:04:53:b2", Module::sTypeRainGauge, 0, 99);
+
+    vector<Change> changes = diffDevices(oldStations, newStations);
+    ASSERT_EQ(2, changes.size());
+    EXPECT_STREQ("05:00:00:04:53:b2", changes.at(0).mModuleId.c_str());
+    EXPECT_EQ(Change::moduleAdded, changes.at(0).mKind);
+    EXPECT_STREQ("02:00:00:29:2c:7a", changes.at(1).mModuleId.c_str());
+    EXPECT_EQ(Change::moduleRemoved, changes.at(1).mKind);
+}
+
+TEST(DiffDevicesTest, callback) {
+    size_t count = 0;
+    diffDevices(list<Station>(), makeStations(8.2, 88), [&count](const Change &change) {
+        EXPECT_EQ(Change::moduleAdded, change.mKind);
+        ++count;
+    });
+    EXPECT_EQ(2, count);
+}
+
+int main (int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "core/fleetregistry.h"
+
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+using namespace netatmoapi;
+using namespace std;
+
+namespace {
+
+Station makeStation(const string &id, uint64_t timeStamp, double temperature) {
+    Station station(string("Station"), string(id));
+    Module base(string("Indoor"), string(id), string(Module::sTypeBase));
+    Measures measures;
+    measures.mTimeStamp = timeStamp;
+    measures.setValue(Measures::temperature, temperature);
+    base.setMeasures(move(measures));
+    list<Module> modules;
+    modules.push_back(move(base));
+    station.setModules(move(modules));
+    return station;
+}
+
+list<Station> makeStations(initializer_list<Station> stations) {
+    return list<Station>(stations);
+}
+
+double temperature(const Station &station) {
+    return station.modulesRef().front().measures().value(Measures::temperature);
+}
+
+}
+
+TEST(FleetRegistryTest, deduplicatesSharedStations) {
+    FleetRegistry registry;
+    EXPECT_EQ(2, registry.update("alice", makeStations({ makeStation("a", 1000, 20), makeStation("shared", 1000, 10) }), 1005));
+    EXPECT_EQ(1, registry.update("bob", makeStations({ makeStation("shared", 1000, 10), makeStation("b", 1000, 5) }), 1010));
+    EXPECT_EQ(3, registry.size());
+    EXPECT_EQ(vector<string>({ "alice", "bob" }), registry.accounts("shared"));
+    EXPECT_EQ(vector<string>({ "alice" }), registry.accounts("a"));
+    EXPECT_EQ(vector<string>({ "b", "shared" }), registry.devices("bob"));
+    EXPECT_TRUE(registry.accounts("unknown").empty());
+    EXPECT_EQ(1010, registry.lastFetch("shared"));
+
+    list<Station> stations = registry.stations();
+    ASSERT_EQ(3, stations.size());
+    EXPECT_EQ("a", stations.front().id());
+    EXPECT_EQ("shared", stations.back().id());
+}
+
+TEST(FleetRegistryTest, newestDataWins) {
+    FleetRegistry registry;
+    registry.update("alice", makeStations({ makeStation("shared", 2000, 12) }), 2005);
+    EXPECT_EQ(0, registry.update("bob", makeStations({ makeStation("shared", 1400, 11) }), 2010));
+    EXPECT_DOUBLE_EQ(12, temperature(registry.station("shared")));
+    EXPECT_EQ(2010, registry.lastFetch("shared"));
+    EXPECT_EQ(1, registry.update("bob", makeStations({ makeStation("shared", 2600, 13) }), 2610));
+    EXPECT_DOUBLE_EQ(13, temperature(registry.station("shared")));
+    EXPECT_THROW(registry.station("unknown"), out_of_range);
+}
+
+TEST(FleetRegistryTest, skipsFreshStations) {
+    FleetRegistry registry(600);
+    registry.update("alice", makeStations({ makeStation("a", 1000, 20), makeStation("shared", 1000, 10) }), 1000);
+    registry.update("bob", makeStations({ makeStation("shared", 1000, 10), makeStation("b", 1000, 5) }), 1000);
+
+    EXPECT_FALSE(registry.shouldFetch("bob", "shared", 1300));
+    EXPECT_TRUE(registry.devicesToFetch("bob", 1300).empty());
+
+    // Alice polls first, so Bob does not need to fetch the shared station again.
+    EXPECT_TRUE(registry.shouldFetch("alice", "shared", 1600));
+    EXPECT_EQ(vector<string>({ "a", "shared" }), registry.devicesToFetch("alice", 1600));
+    registry.update("alice", makeStations({ makeStation("shared", 1550, 11) }), 1600, false);
+    EXPECT_FALSE(registry.shouldFetch("bob", "shared", 1610));
+    EXPECT_EQ(vector<string>({ "b" }), registry.devicesToFetch("bob", 1610));
+    // A partial update keeps the other stations of the account.
+    EXPECT_EQ(vector<string>({ "a", "shared" }), registry.devices("alice"));
+
+    // Unknown stations are fetched, stations of other accounts are not.
+    EXPECT_TRUE(registry.shouldFetch("alice", "new", 1610));
+    EXPECT_FALSE(registry.shouldFetch("alice", "b", 2000));
+    EXPECT_TRUE(registry.devicesToFetch("carol", 2000).empty());
+}
+
+TEST(FleetRegistryTest, completeUpdateRemovesStations) {
+    FleetRegistry registry;
+    registry.update("alice", makeStations({ makeStation("a", 1000, 20), makeStation("shared", 1000, 10) }), 1000);
+    registry.update("bob", makeStations({ makeStation("shared", 1000, 10) }), 1000);
+
+    // Alice removed her station and the shared station is not shared with her anymore.
+    registry.update("alice", makeStations({ makeStation("a2", 1600, 21) }), 1600);
+    EXPECT_EQ(2, registry.size());
+    EXPECT_THROW(registry.station("a"), out_of_range);
+    EXPECT_EQ(vector<string>({ "bob" }), registry.accounts("shared"));
+    EXPECT_EQ(vector<string>({ "a2" }), registry.devices("alice"));
+
+    registry.removeAccount("bob");
+    EXPECT_EQ(1, registry.size());
+    EXPECT_TRUE(registry.devices("bob").empty());
+    EXPECT_EQ(0, registry.lastFetch("shared"));
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "core/gridinterpolator.h"
+#include "core/stationindex.h"
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace netatmoapi;
+using namespace std;
+
+namespace {
+
+const double cPi = 3.14159265358979323846;
+
+// Straight line distance through the earth, as used by the interpolator.
+double chord(double lat1, double lon1, double lat2, double lon2) {
+    double phi1 = lat1 * cPi / 180, phi2 = lat2 * cPi / 180;
+    double lambda1 = lon1 * cPi / 180, lambda2 = lon2 * cPi / 180;
+    double x = cos(phi1) * cos(lambda1) - cos(phi2) * cos(lambda2);
+    double y = cos(phi1) * sin(lambda1) - cos(phi2) * sin(lambda2);
+    double z = sin(phi1) - sin(phi2);
+    return sqrt(x * x + y * y + z * z) * StationIndex::sEarthRadius;
+}
+
+// Weights all samples, i.e. inverse distance weighting without neighbour limit.
+double referenceIdw(const vector<GridInterpolator::Sample> &samples, double latitude, double longitude, double power) {
+    double weightSum = 0, valueSum = 0;
+    for (const GridInterpolator::Sample &sample: samples) {
+        double weight = pow(chord(latitude, longitude, sample.mLatitude, sample.mLongitude), -power);
+        weightSum += weight;
+        valueSum += weight * sample.mValue;
+    }
+    return valueSum / weightSum;
+}
+
+vector<GridInterpolator::Sample> randomSamples(size_t count) {
+    mt19937 random(3);
+    uniform_real_distribution<double> latitude(45, 55);
+    uniform_real_distribution<double> longitude(0, 15);
+    uniform_real_distribution<double> value(-10, 30);
+    vector<GridInterpolator::Sample> samples;
+    for (size_t i = 0; i < count; ++i) {
+        samples.push_back({ latitude(random), longitude(random), value(random) });
+    }
+    return samples;
+}
+
+}
+
+TEST(GridInterpolatorTest, raster) {
+    Raster raster(BoundingBox(50, 20, 40, 10), 10, 5);
+    ASSERT_EQ(50, raster.mValues.size());
+    EXPECT_DOUBLE_EQ(49.5, raster.latitude(0));
+    EXPECT_DOUBLE_EQ(40.5, raster.latitude(9));
+    EXPECT_DOUBLE_EQ(11, raster.longitude(0));
+    EXPECT_DOUBLE_EQ(19, raster.longitude(4));
+    EXPECT_TRUE(std::isnan(raster.at(3, 3)));
+}
+
+TEST(GridInterpolatorTest, noSamples) {
+    GridInterpolator interpolator;
+    Raster raster = interpolator.interpolate(BoundingBox(50, 20, 40, 10), 4, 4);
+    ASSERT_EQ(16, raster.mValues.size());
+    for (float value: raster.mValues) {
+        EXPECT_TRUE(std::isnan(value));
+    }
+}
+
+TEST(GridInterpolatorTest, inverseDistanceMatchesReference) {
+    vector<GridInterpolator::Sample> samples = randomSamples(6);
+    GridInterpolator interpolator;
+    interpolator.setSamples(samples);
+    ASSERT_EQ(6, interpolator.sampleCount());
+    // With more neighbours than samples, every cell weights all samples.
+    interpolator.setNeighbours(16);
+    BoundingBox region(55, 15, 45, 0);
+    for (double power: { 2.0, 3.0, 1.5, 2.7 }) {
+        interpolator.setPower(power);
+        // 13 columns cover the vectorized loop and the scalar tail.
+        Raster raster = interpolator.interpolate(region, 7, 13, 2);
+        for (size_t row = 0; row < raster.mRows; ++row) {
+            for (size_t column = 0; column < raster.mColumns; ++column) {
+                double expected = referenceIdw(samples, raster.latitude(row), raster.longitude(column), power);
+                EXPECT_NEAR(expected, raster.at(row, column), 1e-4 * max(1.0, fabs(expected))) << power << " " << row << " " << column;
+            }
+        }
+    }
+}
+
+TEST(GridInterpolatorTest, sampleAtCell) {
+    vector<GridInterpolator::Sample> samples = { { 45.5, 0.5, 10 }, { 45.5, 1.5, 20 }, { 44.5, 0.5, 30 } };
+    GridInterpolator interpolator;
+    interpolator.setSamples(samples);
+    Raster raster = interpolator.interpolate(BoundingBox(46, 2, 44, 0), 2, 2);
+    EXPECT_FLOAT_EQ(10, raster.at(0, 0));
+    EXPECT_FLOAT_EQ(20, raster.at(0, 1));
+    EXPECT_FLOAT_EQ(30, raster.at(1, 0));
+    EXPECT_GT(raster.at(1, 1), 10);
+    EXPECT_LT(raster.at(1, 1), 30);
+}
+
+TEST(GridInterpolatorTest, nearestNeighbour) {
+    vector<GridInterpolator::Sample> samples = randomSamples(50);
+    GridInterpolator interpolator(GridInterpolator::nearestNeighbour);
+    interpolator.setSamples(samples);
+    Raster raster = interpolator.interpolate(BoundingBox(55, 15, 45, 0), 9, 11);
+    for (size_t row = 0; row < raster.mRows; ++row) {
+        for (size_t column = 0; column < raster.mColumns; ++column) {
+            double best = numeric_limits<double>::infinity(), expected = 0;
+            for (const GridInterpolator::Sample &sample: samples) {
+                double distance = chord(raster.latitude(row), raster.longitude(column), sample.mLatitude, sample.mLongitude);
+                if (distance < best) {
+                    best = distance;
+                    expected = sample.mValue;
+                }
+            }
+            EXPECT_FLOAT_EQ(static_cast<float>(expected), raster.at(row, column));
+        }
+    }
+}
+
+TEST(GridInterpolatorTest, maxDistance) {
+    GridInterpolator interpolator;
+    interpolator.setSamples({ { 50, 10, 5 } });
+    interpolator.setMaxDistance(100);
+    // Cells are 1 degree apart, about 111 km in latitude.
+    Raster raster = interpolator.interpolate(BoundingBox(50.5, 10.5, 47.5, 9.5), 3, 1);
+    EXPECT_FLOAT_EQ(5, raster.at(0, 0));
+    EXPECT_TRUE(std::isnan(raster.at(1, 0)));
+    EXPECT_TRUE(std::isnan(raster.at(2, 0)));
+}
+
+TEST(GridInterpolatorTest, threadsGiveSameResult) {
+    GridInterpolator interpolator;
+    interpolator.setSamples(randomSamples(500));
+    BoundingBox region(56, 16, 44, -1);
+    Raster single = interpolator.interpolate(region, 40, 37, 1);
+    Raster parallel = interpolator.interpolate(region, 40, 37, 4);
+    ASSERT_EQ(single.mValues.size(), parallel.mValues.size());
+    for (size_t i = 0; i < single.mValues.size(); ++i) {
+        EXPECT_EQ(single.mValues[i], parallel.mValues[i]);
+    }
+}
+
+TEST(GridInterpolatorTest, samplesFromStations) {
+    list<Station> stations;
+    Station home("Home", "70:ee:50:00:00:01");
+    Place place;
+    place.mLatitude = 50;
+    place.mLongitude = 7;
+    home.setPlace(move(place));
+    Module base("Indoor", "70:ee:50:00:00:01", string(Module::sTypeBase));
+    Measures indoor;
+    indoor.setValue(Measures::temperature, 21);
+    indoor.setValue(Measures::pressure, 1013);
+    base.setMeasures(move(indoor));
+    Module outdoor("Outdoor", "02:00:00:00:00:01", string(Module::sTypeOutdoor));
+    Measures outside;
+    outside.setValue(Measures::temperature, 4);
+    outdoor.setMeasures(move(outside));
+    list<Module> modules;
+    modules.push_back(move(base));
+    modules.push_back(move(outdoor));
+    home.setModules(move(modules));
+    stations.push_back(move(home));
+    stations.emplace_back("No place", "70:ee:50:00:00:02");
+
+    GridInterpolator interpolator;
+    EXPECT_EQ(1, interpolator.setSamples(stations, Measures::temperature));
+    EXPECT_FLOAT_EQ(4, interpolator.interpolate(BoundingBox(51, 8, 49, 6), 1, 1).at(0, 0));
+    EXPECT_EQ(1, interpolator.setSamples(stations, Measures::pressure));
+    EXPECT_FLOAT_EQ(1013, interpolator.interpolate(BoundingBox(51, 8, 49, 6), 1, 1).at(0, 0));
+    EXPECT_EQ(0, interpolator.setSamples(stations, Measures::rain));
+}
+
+TEST(GridInterpolatorTest, invalidArguments) {
+    GridInterpolator interpolator;
+    EXPECT_THROW(interpolator.setNeighbours(0), invalid_argument);
+    EXPECT_THROW(interpolator.setPower(0), invalid_argument);
+    EXPECT_EQ(GridInterpolator::sDefaultNeighbours, interpolator.neighbours());
+    EXPECT_DOUBLE_EQ(GridInterpolator::sDefaultPower, interpolator.power());
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,222 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "core/measurelog.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+#include <stdexcept>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace netatmoapi;
+using namespace std;
+
+string tempPath(const string &name) {
+    const char *dir = getenv("TMPDIR");
+    return string(dir ? dir : "/tmp") + "/" + name + "." + to_string(::getpid());
+}
+
+vector<string> listDirectory(const string &directory) {
+    vector<string> names;
+    DIR *dir = ::opendir(directory.c_str());
+    if (dir) {
+        while (struct dirent *entry = ::readdir(dir)) {
+            if (entry->d_name[0] != '.') {
+                names.push_back(entry->d_name);
+            }
+        }
+        ::closedir(dir);
+    }
+    sort(names.begin(), names.end());
+    return names;
+}
+
+void removeDirectory(const string &directory) {
+    for (const string &name: listDirectory(directory)) {
+        remove((directory + "/" + name).c_str());
+    }
+    ::rmdir(directory.c_str());
+}
+
+Measures makeMeasures(uint64_t timeStamp, double temperature) {
+    Measures measures;
+    measures.mTimeStamp = timeStamp;
+    measures.mTemperature = temperature;
+    measures.mTemperatureTrend = Measures::up;
+    return measures;
+}
+
+list<Station> makeStations(size_t count, uint64_t timeStamp) {
+    list<Station> stations;
+    for (size_t i = 0; i < count; ++i) {
+        string id = "70:ee:50:00:00:" + to_string(i);
+        Station station("Station " + to_string(i), string(id));
+        Module mainModule("Indoor", string(id), string(Module::sTypeBase));
+        mainModule.setMeasures(makeMeasures(timeStamp + i, 20.0 + double(i)));
+        station.addModule(move(mainModule));
+        stations.emplace_back(move(station));
+    }
+    return stations;
+}
+
+TEST(MeasureLogTest, appendAndQuery) {
+    string directory = tempPath("measureLogTest");
+    {
+        MeasureLog log(directory, 100);
+        for (uint64_t i = 0; i < 250; ++i) {
+            EXPECT_TRUE(log.append("02:00:00:00:00:01", makeMeasures(1000 + i * 300, double(i))));
+            EXPECT_TRUE(log.append("02:00:00:00:00:02", makeMeasures(1100 + i * 300, -double(i))));
+        }
+        // The same poll again.
+        EXPECT_FALSE(log.append("02:00:00:00:00:01", makeMeasures(1000 + 249 * 300, 0)));
+        EXPECT_THROW(log.append("02:00:00:00:00:01:00:00:00", makeMeasures(1000, 0)), length_error);
+
+        EXPECT_EQ(500, log.size());
+        EXPECT_EQ(6, log.segmentCount());
+
+        vector<Measures> measures = log.query("02:00:00:00:00:01", 1000 + 10 * 300, 1000 + 200 * 300);
+        ASSERT_EQ(191, measures.size());
+        for (size_t i = 0; i < measures.size(); ++i) {
+            EXPECT_EQ(1000 + (10 + i) * 300, measures[i].mTimeStamp);
+            EXPECT_EQ(double(10 + i), measures[i].mTemperature);
+            EXPECT_EQ(Measures::up, measures[i].mTemperatureTrend);
+            EXPECT_EQ(numeric_limits<double>::min(), measures[i].mHumidity);
+        }
+        EXPECT_EQ(250, log.query("02:00:00:00:00:02", 0, numeric_limits<uint64_t>::max()).size());
+        EXPECT_TRUE(log.query("02:00:00:00:00:03", 0, numeric_limits<uint64_t>::max()).empty());
+    }
+    {
+        // Reopen with the sealed segments and the open segment.
+        MeasureLog log(directory, 100);
+        EXPECT_EQ(500, log.size());
+        EXPECT_FALSE(log.append("02:00:00:00:00:02", makeMeasures(1100 + 249 * 300, 0)));
+        EXPECT_TRUE(log.append("02:00:00:00:00:02", makeMeasures(1100 + 250 * 300, 0)));
+        EXPECT_EQ(251, log.query("02:00:00:00:00:02", 0, numeric_limits<uint64_t>::max()).size());
+    }
+    removeDirectory(directory);
+}
+
+TEST(MeasureLogTest, appendStations) {
+    string directory = tempPath("measureLogTestStations");
+    MeasureLog log(directory);
+    EXPECT_EQ(10, log.append(makeStations(10, 1000)));
+    EXPECT_EQ(0, log.append(makeStations(10, 1000)));
+    EXPECT_EQ(10, log.append(makeStations(10, 1300)));
+    vector<Measures> measures = log.query("70:ee:50:00:00:3", 0, 2000);
+    ASSERT_EQ(2, measures.size());
+    EXPECT_EQ(1003, measures[0].mTimeStamp);
+    EXPECT_EQ(1303, measures[1].mTimeStamp);
+    EXPECT_EQ(23.0, measures[1].mTemperature);
+    removeDirectory(directory);
+}
+
+TEST(MeasureLogTest, recovery) {
+    string directory = tempPath("measureLogTestRecovery");
+    {
+        MeasureLog log(directory, 10);
+        for (uint64_t i = 0; i < 15; ++i) {
+            log.append("02:00:00:00:00:01", makeMeasures(1000 + i, double(i)));
+        }
+        log.sync();
+    }
+    EXPECT_EQ((vector<string>{ "0000000001.seg", "0000000002.open", "modules" }), listDirectory(directory));
+
+    // A torn write: half a record at the end of the open segment.
+    int fd = ::open((directory + "/0000000002.open").c_str(), O_WRONLY | O_APPEND);
+    ASSERT_GE(fd, 0);
+    char garbage[100] = {};
+    ASSERT_EQ(sizeof(garbage), ::write(fd, garbage, sizeof(garbage)));
+    ::close(fd);
+    // A crash during a seal.
+    FILE *tmp = fopen((directory + "/0000000002.seg.tmp").c_str(), "w");
+    ASSERT_NE(nullptr, tmp);
+    fclose(tmp);
+    tmp = fopen((directory + "/modules.tmp").c_str(), "w");
+    ASSERT_NE(nullptr, tmp);
+    fclose(tmp);
+
+    {
+        MeasureLog log(directory, 10);
+        EXPECT_EQ(15, log.size());
+        EXPECT_EQ((vector<string>{ "0000000001.seg", "0000000002.open", "modules" }), listDirectory(directory));
+        EXPECT_TRUE(log.append("02:00:00:00:00:01", makeMeasures(2000, 42)));
+        vector<Measures> measures = log.query("02:00:00:00:00:01", 1014, 3000);
+        ASSERT_EQ(2, measures.size());
+        EXPECT_EQ(42.0, measures[1].mTemperature);
+        log.seal();
+        EXPECT_EQ((vector<string>{ "0000000001.seg", "0000000002.seg", "0000000003.open", "modules" }), listDirectory(directory));
+    }
+    removeDirectory(directory);
+}
+
+TEST(MeasureLogTest, restartDetectsDuplicates) {
+    string directory = tempPath("measureLogTestRestart");
+    {
+        MeasureLog log(directory, 10);
+        EXPECT_TRUE(log.append("02:00:00:00:00:01", makeMeasures(1000, 1)));
+        // The first module is only in the oldest segment.
+        for (uint64_t i = 0; i < 25; ++i) {
+            log.append("02:00:00:00:00:02", makeMeasures(1000 + i, double(i)));
+        }
+        log.sync();
+        EXPECT_EQ(3, log.segmentCount());
+    }
+    {
+        MeasureLog log(directory, 10);
+        EXPECT_FALSE(log.append("02:00:00:00:00:01", makeMeasures(1000, 1)));
+        EXPECT_FALSE(log.append("02:00:00:00:00:02", makeMeasures(1024, 24)));
+        EXPECT_TRUE(log.append("02:00:00:00:00:01", makeMeasures(1001, 2)));
+        // The last time stamps survive the removal of the segments.
+        log.seal();
+        log.removeBefore(1025);
+    }
+    {
+        MeasureLog log(directory, 10);
+        EXPECT_FALSE(log.append("02:00:00:00:00:01", makeMeasures(1001, 2)));
+        EXPECT_TRUE(log.append("02:00:00:00:00:01", makeMeasures(1002, 3)));
+    }
+    removeDirectory(directory);
+}
+
+TEST(MeasureLogTest, retention) {
+    string directory = tempPath("measureLogTestRetention");
+    MeasureLog log(directory, 10);
+    log.setRetention(100);
+    EXPECT_EQ(100, log.retention());
+    for (uint64_t i = 0; i < 100; ++i) {
+        log.append("02:00:00:00:00:01", makeMeasures(1000 + i * 10, double(i)));
+    }
+    // Sealed segments, which only contain time stamps older than 1890, are removed.
+    vector<Measures> measures = log.query("02:00:00:00:00:01", 0, numeric_limits<uint64_t>::max());
+    ASSERT_FALSE(measures.empty());
+    EXPECT_EQ(1800, measures.front().mTimeStamp);
+    EXPECT_EQ(1990, measures.back().mTimeStamp);
+
+    EXPECT_EQ(2, log.removeBefore(numeric_limits<uint64_t>::max()));
+    EXPECT_EQ(1, log.segmentCount());
+    removeDirectory(directory);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
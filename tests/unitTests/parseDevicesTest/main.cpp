@@ -18,6 +18,7 @@
  */
 
 #include "core/utils.h"
+#include "core/devicesparser.h"
 
 #include <gtest/gtest.h>
 #include <vector>
@@ -33,13 +34,22 @@ vector<Module> listToVector(list<Module> &&modules) {
     return v;
 }
 
+const string cStationsData = "{\"body\":{\"devices\":[{\"_id\":\"70:ee:50:29:48:4e\",\"cipher_id\":\"enc:16:y+aGVZeVut\\/5aKVfwFPW5FcNsBQ4ugLGB3FjOo05QrOe\\/2ag5gMshltnTt4jBM01\",\"last_status_store\":1509446958,\"modules\":[{\"_id\":\"02:00:00:29:2c:7a\",\"type\":\"NAModule1\",\"last_message\":1509446955,\"last_seen\":1509446923,\"dashboard_data\":{\"time_utc\":1509446923,\"Temperature\":8.2,\"temp_trend\":\"up\",\"Humidity\":84,\"date_max_temp\":1509446923,\"date_min_temp\":1509406779,\"min_temp\":3.8,\"max_temp\":8.2},\"data_type\":[\"Temperature\",\"Humidity\"],\"module_name\":\"Aussenraum\",\"last_setup\":1495880112,\"battery_vp\":5704,\"battery_percent\":88,\"rf_status\":75,\"firmware\":45},{\"_id\":\"05:00:00:04:53:b2\",\"type\":\"NAModule3\",\"last_message\":1509446936,\"last_seen\":1509446936,\"dashboard_data\":{\"time_utc\":1509446936,\"Rain\":0,\"sum_rain_24\":0,\"sum_rain_1\":0},\"data_type\":[\"Rain\"],\"module_name\":\"Niederschlagsmesser\",\"last_setup\":1504020591,\"battery_vp\":5968,\"battery_percent\":99,\"rf_status\":82,\"firmware\":8},{\"_id\":\"06:00:00:01:d9:f2\",\"type\":\"NAModule2\",\"last_message\":1509446827,\"last_seen\":1509446827,\"dashboard_data\":{\"WindAngle\":90,\"WindStrength\":2,\"GustAngle\":90,\"GustStrength\":4,\"time_utc\":1509446827,\"WindHistoric\":[{\"WindStrength\":1,\"WindAngle\":90,\"time_utc\":1509443616},{\"WindStrength\":2,\"WindAngle\":90,\"time_utc\":1509443911},{\"WindStrength\":2,\"WindAngle\":105,\"time_utc\":1509444219},{\"WindStrength\":2,\"WindAngle\":90,\"time_utc\":1509444526},{\"WindStrength\":2,\"WindAngle\":90,\"time_utc\":1509444821},{\"WindStrength\":2,\"WindAngle\":90,\"time_utc\":1509445129},{\"WindStrength\":2,\"WindAngle\":90,\"time_utc\":1509445430},{\"WindStrength\":2,\"WindAngle\":90,\"time_utc\":1509445737},{\"WindStrength\":2,\"WindAngle\":90,\"time_utc\":1509446039},{\"WindStrength\":2,\"WindAngle\":90,\"time_utc\":1509446340},{\"WindStrength\":2,\"WindAngle\":90,\"time_utc\":1509446571},{\"WindStrength\":2,\"WindAngle\":90,\"time_utc\":1509446827}],\"date_max_wind_str\":1509436035,\"date_max_temp\":1509404683,\"date_min_temp\":1509404683,\"min_temp\":0,\"max_temp\":0,\"max_wind_angle\":128,\"max_wind_str\":10},\"data_type\":[\"Wind\"],\"module_name\":\"Windmesser\",\"last_setup\":1507197668,\"battery_vp\":6001,\"battery_percent\":100,\"rf_status\":89,\"firmware\":18}],\"place\":{\"altitude\":248,\"city\":\"Waldbreitbach\",\"country\":\"DE\",\"timezone\":\"Europe\\/Berlin\",\"location\":[7.4027088,50.555413]},\"station_name\":\"Over\",\"type\":\"NAMain\",\"dashboard_data\":{\"AbsolutePressure\":999.2,\"time_utc\":1509446950,\"Noise\":48,\"Temperature\":21.1,\"temp_trend\":\"stable\",\"Humidity\":56,\"Pressure\":1029.1,\"pressure_trend\":\"stable\",\"CO2\":1101,\"date_max_temp\":1509446041,\"date_min_temp\":1509432104,\"min_temp\":19.5,\"max_temp\":21.1},\"data_type\":[\"Temperature\",\"CO2\",\"Humidity\",\"Noise\",\"Pressure\"],\"co2_calibrating\":false,\"date_setup\":1495880328,\"last_setup\":1495880328,\"module_name\":\"Wohnzimmer\",\"firmware\":132,\"last_upgrade\":1495880134,\"wifi_status\":66,\"friend_users\":[\"59297b55ea00a0920c8b4e7d\",\"59d6247ab4809de2c18b66cc\"]}],\"user\":{\"mail\":\"thepaffy@thepaffy.de\",\"administrative\":{\"lang\":\"de-DE\",\"reg_locale\":\"de-DE\",\"country\":\"DE\",\"unit\":0,\"windunit\":0,\"pressureunit\":0,\"feel_like_algo\":0}}},\"status\":\"ok\",\"time_exec\":0.038522005081177,\"time_server\":1509447048}";
+
 TEST(ParseDevicesTest, parseDevices) {
-    json response = json::parse("{\"body\":{\"devices\":[{\"_id\":\"70:ee:50:29:48:4e\",\"cipher_id\":\"enc:16:y+aGVZeVut\\/5aKVfwFPW5FcNsBQ4ugLGB3FjOo05QrOe\\/2ag5gMshltnTt4jBM01\",\"last_status_store\":1509446958,\"modules\":[{\"_id\":\"02:00:00:29:2c:7a\",\"type\":\"NAModule1\",\"last_message\":1509446955,\"last_seen\":1509446923,\"dashboard_data\":{\"time_utc\":1509446923,\"Temperature\":8.2,\"temp_trend\":\"up\",\"Humidity\":84,\"date_max_temp\":1509446923,\"date_min_temp\":1509406779,\"min_temp\":3.8,\"max_temp\":8.2},\"data_type\":[\"Temperature\",\"Humidity\"],\"module_name\":\"Aussenraum\",\"last_setup\":1495880112,\"battery_vp\":5704,\"battery_percent\":88,\"rf_status\":75,\"firmware\":45},{\"_id\":\"05:00:00:04:53:b2\",\"type\":\"NAModule3\",\"last_message\":1509446936,\"last_seen\":1509446936,\"dashboard_data\":{\"time_utc\":1509446936,\"Rain\":0,\"sum_rain_24\":0,\"sum_rain_1\":0},\"data_type\":[\"Rain\"],\"module_name\":\"Niederschlagsmesser\",\"last_setup\":1504020591,\"battery_vp\":5968,\"battery_percent\":99,\"rf_status\":82,\"firmware\":8},{\"_id\":\"06:00:00:01:d9:f2\",\"type\":\"NAModule2\",\"last_message\":1509446827,\"last_seen\":1509446827,\"dashboard_data\":{\"WindAngle\":90,\"WindStrength\":2,\"GustAngle\":90,\"GustStrength\":4,\"time_utc\":1509446827,\"WindHistoric\":[{\"WindStrength\":1,\"WindAngle\":90,\"time_utc\":1509443616},{\"WindStrength\":2,\"WindAngle\":90,\"time_utc\":1509443911},{\"WindStrength\":2,\"WindAngle\":105,\"time_utc\":1509444219},{\"WindStrength\":2,\"WindAngle\":90,\"time_utc\":1509444526},{\"WindStrength\":2,\"WindAngle\":90,\"time_utc\":1509444821},{\"WindStrength\":2,\"WindAngle\":90,\"time_utc\":1509445129},{\"WindStrength\":2,\"WindAngle\":90,\"time_utc\":1509445430},{\"WindStrength\":2,\"WindAngle\":90,\"time_utc\":1509445737},{\"WindStrength\":2,\"WindAngle\":90,\"time_utc\":1509446039},{\"WindStrength\":2,\"WindAngle\":90,\"time_utc\":1509446340},{\"WindStrength\":2,\"WindAngle\":90,\"time_utc\":1509446571},{\"WindStrength\":2,\"WindAngle\":90,\"time_utc\":1509446827}],\"date_max_wind_str\":1509436035,\"date_max_temp\":1509404683,\"date_min_temp\":1509404683,\"min_temp\":0,\"max_temp\":0,\"max_wind_angle\":128,\"max_wind_str\":10},\"data_type\":[\"Wind\"],\"module_name\":\"Windmesser\",\"last_setup\":1507197668,\"battery_vp\":6001,\"battery_percent\":100,\"rf_status\":89,\"firmware\":18}],\"place\":{\"altitude\":248,\"city\":\"Waldbreitbach\",\"country\":\"DE\",\"timezone\":\"Europe\\/Berlin\",\"location\":[7.4027088,50.555413]},\"station_name\":\"Over\",\"type\":\"NAMain\",\"dashboard_data\":{\"AbsolutePressure\":999.2,\"time_utc\":1509446950,\"Noise\":48,\"Temperature\":21.1,\"temp_trend\":\"stable\",\"Humidity\":56,\"Pressure\":1029.1,\"pressure_trend\":\"stable\",\"CO2\":1101,\"date_max_temp\":1509446041,\"date_min_temp\":1509432104,\"min_temp\":19.5,\"max_temp\":21.1},\"data_type\":[\"Temperature\",\"CO2\",\"Humidity\",\"Noise\",\"Pressure\"],\"co2_calibrating\":false,\"date_setup\":1495880328,\"last_setup\":1495880328,\"module_name\":\"Wohnzimmer\",\"firmware\":132,\"last_upgrade\":1495880134,\"wifi_status\":66,\"friend_users\":[\"59297b55ea00a0920c8b4e7d\",\"59d6247ab4809de2c18b66cc\"]}],\"user\":{\"mail\":\"thepaffy@thepaffy.de\",\"administrative\":{\"lang\":\"de-DE\",\"reg_locale\":\"de-DE\",\"country\":\"DE\",\"unit\":0,\"windunit\":0,\"pressureunit\":0,\"feel_like_algo\":0}}},\"status\":\"ok\",\"time_exec\":0.038522005081177,\"time_server\":1509447048}");
+    json response = json::parse(cStationsData);
     list<Station> stations = parseDevices(response);
     EXPECT_EQ(1, stations.size());
     for (const Station &station: stations) {
         EXPECT_STREQ("70:ee:50:29:48:4e", station.id().c_str());
         EXPECT_STREQ("Over", station.name().c_str());
+        const Place &place = station.placeRef();
+        EXPECT_DOUBLE_EQ(50.555413, place.mLatitude);
+        EXPECT_DOUBLE_EQ(7.4027088, place.mLongitude);
+        EXPECT_DOUBLE_EQ(248, place.mAltitude);
+        EXPECT_STREQ("Waldbreitbach", place.mCity.c_str());
+        EXPECT_STREQ("DE", place.mCountry.c_str());
+        EXPECT_STREQ("Europe/Berlin", place.mTimeZone.c_str());
         vector<Module> modules = listToVector(station.modules());
         EXPECT_EQ(4, modules.size());
 
@@ -76,6 +86,188 @@ TEST(ParseDevicesTest, parseDevices) {
     }
 }
 
+TEST(ParseDevicesTest, parseDevicesInPlace) {
+    json response = json::parse(cStationsData);
+    list<Station> stations = parseDevices(response);
+    ASSERT_EQ(1, stations.size());
+    const Station *station = &stations.front();
+    const list<Module> &modules = station->modulesRef();
+    ASSERT_EQ(4, modules.size());
+    const Module *mainModule = &modules.front();
+    const Module *outdoorModule = &*next(modules.begin());
+    const Module *windModule = &modules.back();
+
+    // Unchanged fleet with new measures.
+    json &jsonStation = response["body"]["devices"][0];
+    jsonStation["dashboard_data"]["time_utc"] = 1509447250;
+    jsonStation["modules"][0]["dashboard_data"]["Temperature"] = 9.5;
+    jsonStation["modules"][0]["battery_percent"] = 87;
+    parseDevices(response, stations);
+    ASSERT_EQ(1, stations.size());
+    ASSERT_EQ(station, &stations.front());
+    ASSERT_EQ(4, modules.size());
+    EXPECT_EQ(mainModule, &modules.front());
+    EXPECT_EQ(outdoorModule, &*next(modules.begin()));
+    EXPECT_EQ(1509447250, mainModule->measures().mTimeStamp);
+    EXPECT_DOUBLE_EQ(9.5, outdoorModule->measures().mTemperature);
+    EXPECT_EQ(87, outdoorModule->batteryPercent());
+
+    // Removed rain gauge, reordered and renamed modules and a new indoor module.
+    json jsonModules = jsonStation["modules"];
+    json jsonIndoor = jsonStation["dashboard_data"];
+    jsonStation["modules"] = json::array({ jsonModules[2], jsonModules[0], {
+        { "_id", "03:00:00:00:00:01" },
+        { "type", "NAModule4" },
+        { "module_name", "Schlafzimmer" },
+        { "battery_percent", 50 },
+        { "rf_status", 60 },
+        { "dashboard_data", jsonIndoor }
+    } });
+    jsonStation["modules"][0]["module_name"] = "Wind";
+    parseDevices(response, stations);
+    ASSERT_EQ(station, &stations.front());
+    ASSERT_EQ(4, modules.size());
+    vector<const Module *> ordered;
+    for (const Module &module: modules) {
+        ordered.push_back(&module);
+    }
+    EXPECT_EQ(mainModule, ordered.at(0));
+    EXPECT_EQ(windModule, ordered.at(1));
+    EXPECT_EQ(outdoorModule, ordered.at(2));
+    EXPECT_STREQ("Wind", windModule->name().c_str());
+    EXPECT_STREQ("03:00:00:00:00:01", ordered.at(3)->id().c_str());
+    EXPECT_STREQ("NAModule4", ordered.at(3)->type().c_str());
+    EXPECT_EQ(50, ordered.at(3)->batteryPercent());
+    EXPECT_EQ(1509447250, ordered.at(3)->measures().mTimeStamp);
+
+    // Removed station.
+    response["body"]["devices"] = json::array();
+    parseDevices(response, stations);
+    EXPECT_TRUE(stations.empty());
+}
+
+TEST(ParseDevicesTest, windHistoric) {
+    json response = json::parse(cStationsData);
+    list<Station> stations = parseDevices(response);
+    ASSERT_EQ(1, stations.size());
+    const Module &windModule = stations.front().modulesRef().back();
+    ASSERT_STREQ("NAModule2", windModule.type().c_str());
+    Measures measures = windModule.measures();
+    EXPECT_DOUBLE_EQ(10, measures.mMaxWindStrength);
+    EXPECT_DOUBLE_EQ(128, measures.mMaxWindAngle);
+    EXPECT_EQ(1509436035, measures.mDateMaxWindStrength);
+    EXPECT_TRUE(measures.hasValue(Measures::dateMaxWindStrength));
+    EXPECT_FALSE(stations.front().modulesRef().front().measures().hasValue(Measures::maxWindStrength));
+
+    const WindHistory &history = windModule.windHistory();
+    ASSERT_EQ(12, history.size());
+    EXPECT_EQ(1509443616, history.at(0).mTimeStamp);
+    EXPECT_DOUBLE_EQ(1, history.at(0).mWindStrength);
+    EXPECT_DOUBLE_EQ(105, history.at(2).mWindAngle);
+    EXPECT_EQ(1509446827, history.back().mTimeStamp);
+    EXPECT_TRUE(stations.front().modulesRef().front().windHistory().empty());
+
+    // The next poll overlaps with the last one.
+    json &windHistoric = response["body"]["devices"][0]["modules"][2]["dashboard_data"]["WindHistoric"];
+    windHistoric.erase(0);
+    windHistoric.push_back({ { "WindStrength", 5 }, { "WindAngle", 180 }, { "time_utc", 1509447130 } });
+    parseDevices(response, stations);
+    ASSERT_EQ(13, history.size());
+    EXPECT_EQ(1509443616, history.at(0).mTimeStamp);
+    EXPECT_DOUBLE_EQ(5, history.back().mWindStrength);
+    EXPECT_EQ(0, parseWindHistoric(response["body"]["devices"][0]["modules"][2]["dashboard_data"],
+                                   stations.front().modulesRef().back().windHistory()));
+
+    vector<WindSample> samples = history.samples(1509446571, 1509447130);
+    ASSERT_EQ(3, samples.size());
+    EXPECT_EQ(1509446571, samples.front().mTimeStamp);
+    EXPECT_EQ(1509447130, samples.back().mTimeStamp);
+}
+
+TEST(ParseDevicesTest, windHistoricOutOfOrder) {
+    json dashboardData = {
+        { "WindHistoric", {
+            { { "WindStrength", 3 }, { "WindAngle", 90 }, { "time_utc", 900 } },
+            { { "WindStrength", 1 }, { "WindAngle", 90 }, { "time_utc", 300 } },
+            { { "WindStrength", 2 }, { "WindAngle", 90 }, { "time_utc", 600 } },
+            { { "WindStrength", 4 }, { "WindAngle", 90 }, { "time_utc", 600 } }
+        } }
+    };
+    WindHistory history;
+    EXPECT_TRUE(history.append({ 300, 0, 0 }));
+    // 300 is already in the history, and the second sample of 600 is a duplicate.
+    EXPECT_EQ(2, parseWindHistoric(dashboardData, history));
+    ASSERT_EQ(3, history.size());
+    EXPECT_EQ(600, history.at(1).mTimeStamp);
+    EXPECT_DOUBLE_EQ(2, history.at(1).mWindStrength);
+    EXPECT_EQ(900, history.back().mTimeStamp);
+    EXPECT_EQ(0, parseWindHistoric(dashboardData, history));
+
+    history.stage({ 1500, 5, 0 });
+    history.stage({ 1200, 4, 0 });
+    EXPECT_EQ(2, history.appendStaged());
+    EXPECT_EQ(1500, history.back().mTimeStamp);
+    EXPECT_EQ(0, history.appendStaged());
+}
+
+TEST(ParseDevicesTest, windHistoryCapacity) {
+    WindHistory history(3);
+    EXPECT_TRUE(history.empty());
+    EXPECT_THROW(history.at(0), out_of_range);
+    for (uint64_t timeStamp = 1; timeStamp <= 5; ++timeStamp) {
+        EXPECT_TRUE(history.append({ timeStamp * 300, double(timeStamp), 90 }));
+    }
+    EXPECT_FALSE(history.append({ 1200, 0, 0 }));
+    ASSERT_EQ(3, history.size());
+    EXPECT_EQ(3, history.capacity());
+    EXPECT_EQ(900, history.at(0).mTimeStamp);
+    EXPECT_EQ(1200, history.at(1).mTimeStamp);
+    EXPECT_EQ(1500, history.at(2).mTimeStamp);
+    EXPECT_EQ(2, history.samples(1000, 2000).size());
+    history.clear();
+    EXPECT_TRUE(history.empty());
+    EXPECT_TRUE(history.append({ 300, 1, 90 }));
+}
+
+TEST(ParseDevicesTest, devicesParser) {
+    json response = json::parse(cStationsData);
+    DevicesParser parser;
+    EXPECT_DOUBLE_EQ(0, parser.hitRate());
+
+    const list<Station> &stations = parser.parse(response);
+    ASSERT_EQ(1, stations.size());
+    EXPECT_EQ(0, parser.hits());
+    EXPECT_EQ(1, parser.misses());
+
+    // Same time stamps, the station is not parsed again.
+    json &jsonStation = response["body"]["devices"][0];
+    jsonStation["modules"][0]["dashboard_data"]["Temperature"] = 9.5;
+    parser.parse(response);
+    EXPECT_EQ(1, parser.hits());
+    EXPECT_EQ(1, parser.misses());
+    EXPECT_DOUBLE_EQ(0.5, parser.hitRate());
+    EXPECT_DOUBLE_EQ(8.2, next(stations.front().modulesRef().begin())->measures().mTemperature);
+
+    // New time stamp of a module, the station is parsed again.
+    jsonStation["modules"][0]["dashboard_data"]["time_utc"] = 1509447223;
+    parser.parse(response);
+    EXPECT_EQ(1, parser.hits());
+    EXPECT_EQ(2, parser.misses());
+    EXPECT_DOUBLE_EQ(9.5, next(stations.front().modulesRef().begin())->measures().mTemperature);
+
+    DevicesParser copy(parser);
+    ASSERT_EQ(1, copy.stations().size());
+    EXPECT_STREQ("Over", copy.stations().front().name().c_str());
+    EXPECT_EQ(4, copy.stations().front().modulesRef().size());
+
+    parser.resetStatistics();
+    EXPECT_EQ(0, parser.hits());
+    EXPECT_EQ(0, parser.misses());
+    list<Station> taken = parser.takeStations();
+    EXPECT_EQ(1, taken.size());
+    EXPECT_TRUE(parser.stations().empty());
+}
+
 int main (int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,203 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "core/napublicapiclient.h"
+#include "core/utils.h"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <limits>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+using namespace netatmoapi;
+using namespace std;
+
+namespace {
+
+const string cPublicData = R"({"body":[{"_id":"70:ee:50:00:00:01","place":{"location":[7.4027088,50.555413],"timezone":"Europe/Berlin","country":"DE","altitude":248,"city":"Waldbreitbach"},"mark":10,"measures":{"02:00:00:00:00:01":{"res":{"1509446000":[7.9,85],"1509446923":[8.2,84]},"type":["temperature","humidity"]},"70:ee:50:00:00:01":{"res":{"1509446950":[1029.1]},"type":["pressure"]},"05:00:00:00:00:01":{"rain_60min":0.3,"rain_24h":2.1,"rain_live":0.1,"rain_timeutc":1509446936},"06:00:00:00:00:01":{"wind_strength":2,"wind_angle":90,"gust_strength":4,"gust_angle":95,"wind_timeutc":1509446960}},"modules":["02:00:00:00:00:01","05:00:00:00:00:01","06:00:00:00:00:01"]},{"_id":"70:ee:50:00:00:02","place":{"location":[7.5,50.6]},"measures":{}},{"_id":"70:ee:50:00:00:03","measures":{}}],"status":"ok"})";
+
+// Public api with a dense grid of stations, which returns at most resultCap stations per tile.
+class FakePublicApiClient: public NAPublicApiClient {
+public:
+    explicit FakePublicApiClient(size_t gridSize) {
+        setExpiresIn(numeric_limits<int64_t>::max());
+        for (size_t row = 0; row < gridSize; ++row) {
+            for (size_t column = 0; column < gridSize; ++column) {
+                PublicStation station;
+                station.mId = to_string(row * gridSize + column);
+                station.mLatitude = 50 + (row + 0.5) / gridSize;
+                station.mLongitude = 7 + (column + 0.5) / gridSize;
+                station.mMeasures.mTimeStamp = 1000;
+                mStations.push_back(station);
+            }
+        }
+    }
+
+    atomic<size_t> mRequests{0};
+    string mFailingId;
+
+protected:
+    vector<PublicStation> requestTile(const BoundingBox &tile) override {
+        ++mRequests;
+        vector<PublicStation> result;
+        for (const PublicStation &station: mStations) {
+            if (tile.contains(station.mLatitude, station.mLongitude)) {
+                if (station.mId == mFailingId) {
+                    throw runtime_error("Tile failed.");
+                }
+                result.push_back(station);
+                if (result.size() == resultCap()) {
+                    break;
+                }
+            }
+        }
+        return result;
+    }
+
+private:
+    vector<PublicStation> mStations;
+};
+
+}
+
+TEST(PublicDataTest, boundingBox) {
+    BoundingBox box(51, 8, 50, 7);
+    EXPECT_DOUBLE_EQ(1, box.height());
+    EXPECT_DOUBLE_EQ(1, box.width());
+    EXPECT_TRUE(box.contains(50, 7));
+    EXPECT_TRUE(box.contains(50.5, 7.5));
+    EXPECT_FALSE(box.contains(51.1, 7.5));
+    EXPECT_FALSE(box.contains(50.5, 6.9));
+
+    array<BoundingBox, 4> quarters = box.split();
+    EXPECT_DOUBLE_EQ(51, quarters[0].mNorth);
+    EXPECT_DOUBLE_EQ(7.5, quarters[0].mWest);
+    EXPECT_DOUBLE_EQ(7.5, quarters[1].mEast);
+    EXPECT_DOUBLE_EQ(50.5, quarters[2].mNorth);
+    EXPECT_DOUBLE_EQ(50, quarters[3].mSouth);
+
+    vector<BoundingBox> tiles = box.tiles(0.4);
+    ASSERT_EQ(9, tiles.size());
+    EXPECT_DOUBLE_EQ(51, tiles[0].mNorth);
+    EXPECT_DOUBLE_EQ(7, tiles[0].mWest);
+    EXPECT_DOUBLE_EQ(8, tiles[2].mEast);
+    EXPECT_NEAR(0.2, tiles[2].width(), 1e-12);
+    EXPECT_DOUBLE_EQ(50, tiles[8].mSouth);
+    EXPECT_TRUE(box.tiles(0).empty());
+    EXPECT_EQ(1, box.tiles(5).size());
+
+    // A box across the antimeridian.
+    BoundingBox pacific(-16, -178.5, -18, 177.5);
+    EXPECT_TRUE(pacific.crossesAntimeridian());
+    EXPECT_FALSE(box.crossesAntimeridian());
+    EXPECT_DOUBLE_EQ(4, pacific.width());
+    EXPECT_TRUE(pacific.contains(-17, 179));
+    EXPECT_TRUE(pacific.contains(-17, -179));
+    EXPECT_FALSE(pacific.contains(-17, 0));
+    EXPECT_DOUBLE_EQ(179.5, pacific.split()[0].mWest);
+    tiles = pacific.tiles(2);
+    ASSERT_EQ(3, tiles.size());
+    EXPECT_DOUBLE_EQ(177.5, tiles[0].mWest);
+    EXPECT_DOUBLE_EQ(179.5, tiles[0].mEast);
+    EXPECT_DOUBLE_EQ(180, tiles[1].mEast);
+    EXPECT_DOUBLE_EQ(-180, tiles[2].mWest);
+    EXPECT_DOUBLE_EQ(-178.5, tiles[2].mEast);
+    for (const BoundingBox &tile: tiles) {
+        EXPECT_FALSE(tile.crossesAntimeridian());
+    }
+}
+
+TEST(PublicDataTest, parsePublicData) {
+    vector<PublicStation> stations = utils::parsePublicData(json::parse(cPublicData));
+    ASSERT_EQ(2, stations.size());
+    const PublicStation &station = stations[0];
+    EXPECT_STREQ("70:ee:50:00:00:01", station.mId.c_str());
+    EXPECT_DOUBLE_EQ(50.555413, station.mLatitude);
+    EXPECT_DOUBLE_EQ(7.4027088, station.mLongitude);
+    EXPECT_DOUBLE_EQ(248, station.mAltitude);
+    EXPECT_DOUBLE_EQ(8.2, station.mMeasures.mTemperature);
+    EXPECT_DOUBLE_EQ(84, station.mMeasures.mHumidity);
+    EXPECT_DOUBLE_EQ(1029.1, station.mMeasures.mPressure);
+    EXPECT_DOUBLE_EQ(0.1, station.mMeasures.mRain);
+    EXPECT_DOUBLE_EQ(0.3, station.mMeasures.mSumRain1);
+    EXPECT_DOUBLE_EQ(2.1, station.mMeasures.mSumRain24);
+    EXPECT_DOUBLE_EQ(2, station.mMeasures.mWindStrength);
+    EXPECT_DOUBLE_EQ(95, station.mMeasures.mGustAngle);
+    EXPECT_EQ(1509446960, station.mMeasures.mTimeStamp);
+
+    EXPECT_STREQ("70:ee:50:00:00:02", stations[1].mId.c_str());
+    EXPECT_FALSE(stations[1].mMeasures.hasValue(Measures::temperature));
+    EXPECT_EQ(numeric_limits<double>::min(), stations[1].mAltitude);
+
+    EXPECT_TRUE(utils::parsePublicData(json::object()).empty());
+}
+
+TEST(PublicDataTest, requestPublicStations) {
+    FakePublicApiClient client(40);
+    client.setResultCap(100);
+    BoundingBox region(51, 8, 50, 7);
+
+    // 4 tiles of 400 stations are split until every tile has less than 100 stations.
+    vector<PublicStation> stations = client.requestPublicStations(region, 0.5, 4);
+    ASSERT_EQ(1600, stations.size());
+    set<string> ids;
+    for (size_t i = 0; i < stations.size(); ++i) {
+        ids.insert(stations[i].mId);
+        if (i > 0) {
+            EXPECT_LT(stations[i - 1].mId, stations[i].mId);
+        }
+    }
+    EXPECT_EQ(1600, ids.size());
+    EXPECT_EQ(client.mRequests.load(), client.requestedTiles());
+    EXPECT_EQ(4 + 4 * 4 + 16 * 4, client.requestedTiles());
+
+    // Stations outside of the region are dropped.
+    client.mRequests = 0;
+    stations = client.requestPublicStations(BoundingBox(50.5, 7.5, 50, 7), 1, 1);
+    EXPECT_EQ(400, stations.size());
+
+    // Without cap no tile is split.
+    client.setResultCap(10000);
+    stations = client.requestPublicStations(region, 0.25, 3);
+    EXPECT_EQ(1600, stations.size());
+    EXPECT_EQ(16, client.requestedTiles());
+    EXPECT_EQ(0, client.truncatedTiles());
+}
+
+TEST(PublicDataTest, truncatedTiles) {
+    FakePublicApiClient client(2);
+    // Every tile with a station is at the cap and is split down to sMinTileSize.
+    client.setResultCap(1);
+    vector<PublicStation> stations = client.requestPublicStations(BoundingBox(51, 8, 50, 7), 1, 2);
+    EXPECT_EQ(4, stations.size());
+    EXPECT_GE(client.truncatedTiles(), 4);
+    EXPECT_LT(client.truncatedTiles(), client.requestedTiles());
+}
+
+TEST(PublicDataTest, requestPublicStationsError) {
+    FakePublicApiClient client(10);
+    client.mFailingId = "55";
+    EXPECT_THROW(client.requestPublicStations(BoundingBox(51, 8, 50, 7), 0.1, 4), runtime_error);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
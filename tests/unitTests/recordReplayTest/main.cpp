@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "core/nawsapiclient.h"
+#include "core/recordingtransport.h"
+#include "core/replaytransport.h"
+#include "core/utils.h"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unistd.h>
+
+using namespace netatmoapi;
+using namespace std;
+
+namespace {
+
+string tempPath(const string &name) {
+    const char *dir = getenv("TMPDIR");
+    return string(dir ? dir : "/tmp") + "/" + name + "." + to_string(::getpid());
+}
+
+string readFile(const string &path) {
+    ifstream file(path, ios::binary);
+    return string(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+}
+
+const char *cTokenResponse = R"({"access_token":"secret-access","refresh_token":"secret-refresh","expires_in":10800})";
+const char *cStationsData = R"({"body":{"devices":[{"_id":"70:ee:50:00:00:01","station_name":"Home","module_name":"Indoor","type":"NAMain","modules":[],)"
+    R"("dashboard_data":{"AbsolutePressure":999.2,"time_utc":1509446950,"Noise":48,"Temperature":21.1,"temp_trend":"stable","Humidity":56,)"
+    R"("Pressure":1029.1,"pressure_trend":"stable","CO2":1101,"date_max_temp":1509446041,"date_min_temp":1509432104,"min_temp":19.5,"max_temp":21.1}}]},"status":"ok"})";
+
+// Answers the token and the stations data requests, fails an unknown device and all other requests with a curl error.
+class FakeTransport: public Transport {
+public:
+    explicit FakeTransport(chrono::milliseconds delay = chrono::milliseconds(0)) :
+        mDelay(delay),
+        mStationsRequests(0)
+        {}
+
+    string get(const string &url, const map<string, string> &params) override {
+        this_thread::sleep_for(mDelay);
+        auto device = params.find("device_id");
+        if (device != params.end() && device->second == "70:ee:50:00:00:02") {
+            throw runtime_error("Unknown device");
+        }
+        if (url.find("getstationsdata") != string::npos) {
+            lock_guard<mutex> lock(mMutex);
+            // Every poll returns a newer temperature.
+            string response = cStationsData;
+            response.replace(response.find("21.1"), 4, to_string(20 + mStationsRequests++));
+            return response;
+        }
+        throw CurlException("Couldn't resolve host name", 6);
+    }
+
+    string post(const string &, const map<string, string> &) override {
+        this_thread::sleep_for(mDelay);
+        return cTokenResponse;
+    }
+
+private:
+    chrono::milliseconds mDelay;
+    mutex mMutex;
+    int mStationsRequests;
+};
+
+double temperature(const json &response) {
+    list<Station> stations = utils::parseDevices(response);
+    return stations.front().modulesRef().front().measures().value(Measures::temperature);
+}
+
+}
+
+TEST(RecordReplayTest, recordAndReplay) {
+    string path = tempPath("recordReplayTest");
+    {
+        shared_ptr<RecordingTransport> recorder = make_shared<RecordingTransport>(path, make_shared<FakeTransport>());
+        NAWSApiClient client("user", "password", "id", "client-secret", "", "secret-refresh-0");
+        client.setTransport(recorder);
+        EXPECT_DOUBLE_EQ(20, temperature(client.requestStationsData()));
+        EXPECT_DOUBLE_EQ(21, temperature(client.requestStationsData()));
+        EXPECT_THROW(client.requestStationsData("70:ee:50:00:00:02"), runtime_error);
+        EXPECT_THROW(client.requestMeasures("70:ee:50:00:00:01", "", "max", { "Temperature" }, 0, 100), CurlException);
+        EXPECT_EQ(5, recorder->recordCount());
+    }
+
+    // No credential is written.
+    string raw = readFile(path);
+    for (const char *credential: { "secret-access", "secret-refresh", "client-secret", "password" }) {
+        EXPECT_EQ(string::npos, raw.find(credential)) << credential;
+    }
+
+    vector<RecordingTransport::Record> records = RecordingTransport::read(path);
+    ASSERT_EQ(5, records.size());
+    EXPECT_EQ(RecordingTransport::Record::post, records[0].mMethod);
+    EXPECT_EQ("https://api.netatmo.net/oauth2/token", records[0].mUrl);
+    EXPECT_EQ(RecordingTransport::sRedacted, records[0].mParams["refresh_token"]);
+    EXPECT_EQ("refresh_token", records[0].mParams["grant_type"]);
+    EXPECT_EQ(RecordingTransport::sRedacted, json::parse(records[0].mResponse)["access_token"]);
+    EXPECT_EQ(10800, json::parse(records[0].mResponse)["expires_in"]);
+    EXPECT_EQ(RecordingTransport::Record::get, records[1].mMethod);
+    EXPECT_EQ(RecordingTransport::Record::none, records[1].mError);
+    EXPECT_LE(records[1].mStart, records[2].mStart);
+    EXPECT_EQ(RecordingTransport::Record::otherError, records[3].mError);
+    EXPECT_EQ("Unknown device", records[3].mResponse);
+    EXPECT_EQ(RecordingTransport::Record::curlError, records[4].mError);
+    EXPECT_EQ(6, records[4].mErrorCode);
+    EXPECT_EQ("max", records[4].mParams["scale"]);
+
+    // The replay works with other credentials and serves the polls in order.
+    shared_ptr<ReplayTransport> replay = make_shared<ReplayTransport>(path);
+    NAWSApiClient client("other", "other", "other", "other", "", "other-refresh");
+    client.setTransport(replay);
+    EXPECT_DOUBLE_EQ(20, temperature(client.requestStationsData()));
+    EXPECT_EQ(RecordingTransport::sRedacted, client.accessToken());
+    EXPECT_DOUBLE_EQ(21, temperature(client.requestStationsData()));
+    // The responses start again after the last one.
+    EXPECT_DOUBLE_EQ(20, temperature(client.requestStationsData()));
+    try {
+        client.requestMeasures("70:ee:50:00:00:01", "", "max", { "Temperature" }, 0, 100);
+        FAIL() << "CurlException expected";
+    } catch (const CurlException &ex) {
+        EXPECT_EQ(6, ex.code());
+    }
+    EXPECT_THROW(client.requestStationsData("70:ee:50:00:00:02"), runtime_error);
+    EXPECT_EQ(6, replay->replayCount());
+    // Requests, which were not recorded, fail.
+    EXPECT_THROW(client.requestStationsData("70:ee:50:00:00:03"), runtime_error);
+    ::unlink(path.c_str());
+}
+
+TEST(RecordReplayTest, compactAndTruncated) {
+    string path = tempPath("recordReplayTestCompact");
+    const size_t count = 100;
+    {
+        RecordingTransport recorder(path, make_shared<FakeTransport>());
+        map<string, string> params = { { "access_token", "secret" }, { "device_id", "70:ee:50:00:00:01" }, { "get_favorites", "true" } };
+        for (size_t i = 0; i < count; ++i) {
+            recorder.get("https://api.netatmo.net/api/getstationsdata", params);
+        }
+    }
+    // The url and the parameters are written once.
+    string raw = readFile(path);
+    vector<RecordingTransport::Record> records = RecordingTransport::read(path);
+    ASSERT_EQ(count, records.size());
+    size_t responses = 0;
+    for (const RecordingTransport::Record &record: records) {
+        responses += record.mResponse.size();
+    }
+    EXPECT_LT(raw.size(), responses + count * 24 + 256);
+
+    // An incomplete last record is ignored.
+    ::truncate(path.c_str(), static_cast<off_t>(raw.size() - 10));
+    records = RecordingTransport::read(path);
+    ASSERT_EQ(count - 1, records.size());
+    EXPECT_EQ("70:ee:50:00:00:01", records.back().mParams["device_id"]);
+
+    {
+        ofstream file(path, ios::binary | ios::trunc);
+        file << "no recording";
+    }
+    EXPECT_THROW(RecordingTransport::read(path), runtime_error);
+    ::unlink(path.c_str());
+}
+
+TEST(RecordReplayTest, originalTiming) {
+    string path = tempPath("recordReplayTestTiming");
+    {
+        RecordingTransport recorder(path, make_shared<FakeTransport>(chrono::milliseconds(30)));
+        recorder.get("https://api.netatmo.net/api/getstationsdata", {});
+        this_thread::sleep_for(chrono::milliseconds(50));
+        recorder.get("https://api.netatmo.net/api/getstationsdata", {});
+    }
+    vector<RecordingTransport::Record> records = RecordingTransport::read(path);
+    ASSERT_EQ(2, records.size());
+    EXPECT_GE(records[0].mDuration, 30000);
+    EXPECT_GE(records[1].mStart - records[0].mStart, 80000);
+
+    ReplayTransport replay(path, ReplayTransport::originalTiming);
+    auto start = chrono::steady_clock::now();
+    replay.get("https://api.netatmo.net/api/getstationsdata", {});
+    EXPECT_GE(chrono::steady_clock::now() - start, chrono::milliseconds(30));
+    // The second response keeps its recorded distance to the first request.
+    replay.get("https://api.netatmo.net/api/getstationsdata", {});
+    EXPECT_GE(chrono::steady_clock::now() - start, chrono::milliseconds(110));
+    ::unlink(path.c_str());
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "core/snapshotfile.h"
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+using namespace netatmoapi;
+using namespace std;
+
+string tempPath(const string &name) {
+    const char *dir = getenv("TMPDIR");
+    return string(dir ? dir : "/tmp") + "/" + name + "." + to_string(::getpid());
+}
+
+list<Station> makeStations(size_t count) {
+    list<Station> stations;
+    for (size_t i = 0; i < count; ++i) {
+        string id = "70:ee:50:00:00:" + to_string(i);
+        Station station("Station " + to_string(i), string(id));
+        if (i % 2 == 0) {
+            Place place;
+            place.mLatitude = 52.5 + i;
+            place.mLongitude = 13.4;
+            place.mAltitude = 34;
+            place.mCity = "Berlin";
+            place.mCountry = "DE";
+            place.mTimeZone = "Europe/Berlin";
+            station.setPlace(move(place));
+        }
+        Measures mainMeasures;
+        mainMeasures.mTimeStamp = 1509446950 + i;
+        mainMeasures.mTemperature = 21.1;
+        mainMeasures.mPressureTrend = Measures::up;
+        Module mainModule("Indoor", string(id), string(Module::sTypeBase));
+        mainModule.setMeasures(move(mainMeasures));
+        station.addModule(move(mainModule));
+
+        Measures rainMeasures;
+        rainMeasures.mTimeStamp = 1509446936 + i;
+        rainMeasures.mSumRain24 = 1.5;
+        Module rainModule("Rain", "05:00:00:00:00:" + to_string(i), string(Module::sTypeRainGauge), 99, 82);
+        rainModule.setMeasures(move(rainMeasures));
+        station.addModule(move(rainModule));
+        stations.emplace_back(move(station));
+    }
+    return stations;
+}
+
+TEST(SnapshotFileTest, writeAndRead) {
+    string path = tempPath("snapshotFileTest");
+    SnapshotFile::write(path, makeStations(100));
+
+    SnapshotFile snapshot(path);
+    ASSERT_EQ(100, snapshot.stationCount());
+    ASSERT_EQ(200, snapshot.moduleCount());
+
+    SnapshotFile::StationView station = snapshot.station(7);
+    EXPECT_STREQ("Station 7", station.name());
+    EXPECT_STREQ("70:ee:50:00:00:7", station.id());
+    ASSERT_EQ(2, station.moduleCount());
+    SnapshotFile::ModuleView mainModule = station.module(0);
+    EXPECT_STREQ("Indoor", mainModule.name());
+    EXPECT_STREQ("NAMain", mainModule.type());
+    EXPECT_EQ(1509446957, mainModule.timeStamp());
+    EXPECT_DOUBLE_EQ(21.1, mainModule.value(Measures::temperature));
+    EXPECT_EQ(Measures::up, mainModule.measures().mPressureTrend);
+
+    SnapshotFile::ModuleView rainModule = snapshot.findModule("05:00:00:00:00:42");
+    ASSERT_FALSE(rainModule.isNull());
+    EXPECT_EQ(99, rainModule.batteryPercent());
+    EXPECT_EQ(82, rainModule.rfStatus());
+    EXPECT_DOUBLE_EQ(1.5, rainModule.measures().mSumRain24);
+    EXPECT_EQ(42, rainModule.stationIndex());
+    EXPECT_TRUE(snapshot.findModule("05:00:00:00:00:420").isNull());
+
+    SnapshotFile::StationView found = snapshot.findStation("70:ee:50:00:00:42");
+    ASSERT_FALSE(found.isNull());
+    EXPECT_STREQ("Station 42", found.name());
+    EXPECT_TRUE(snapshot.findStation("05:00:00:00:00:42").isNull());
+
+    list<Station> stations = snapshot.toStations();
+    ASSERT_EQ(100, stations.size());
+    EXPECT_STREQ("Station 0", stations.front().name().c_str());
+    EXPECT_EQ(2, stations.front().modulesRef().size());
+    EXPECT_DOUBLE_EQ(1.5, stations.front().modulesRef().back().measures().mSumRain24);
+
+    remove(path.c_str());
+}
+
+TEST(SnapshotFileTest, place) {
+    string path = tempPath("snapshotFileTestPlace");
+    SnapshotFile::write(path, makeStations(3));
+
+    SnapshotFile snapshot(path);
+    list<Station> stations = snapshot.toStations();
+    ASSERT_EQ(3, stations.size());
+    const Place &place = stations.back().placeRef();
+    EXPECT_TRUE(place.hasLocation());
+    EXPECT_DOUBLE_EQ(54.5, place.mLatitude);
+    EXPECT_DOUBLE_EQ(13.4, place.mLongitude);
+    EXPECT_DOUBLE_EQ(34, place.mAltitude);
+    EXPECT_EQ("Berlin", place.mCity);
+    EXPECT_EQ("DE", place.mCountry);
+    EXPECT_EQ("Europe/Berlin", place.mTimeZone);
+
+    const Place &noPlace = next(stations.begin())->placeRef();
+    EXPECT_FALSE(noPlace.hasLocation());
+    EXPECT_TRUE(noPlace.mCity.empty());
+    EXPECT_EQ("Europe/Berlin", snapshot.station(0).place().mTimeZone);
+
+    // Snapshots of version 1 have no place and are rejected.
+    {
+        fstream file(path, ios::binary | ios::in | ios::out);
+        file.seekp(8);
+        const uint32_t version = 1;
+        file.write(reinterpret_cast<const char *>(&version), sizeof(version));
+    }
+    EXPECT_THROW(SnapshotFile snapshot(path), runtime_error);
+    remove(path.c_str());
+}
+
+TEST(SnapshotFileTest, emptyFleet) {
+    string path = tempPath("snapshotFileTestEmpty");
+    SnapshotFile::write(path, list<Station>());
+    SnapshotFile snapshot(path);
+    EXPECT_EQ(0, snapshot.stationCount());
+    EXPECT_TRUE(snapshot.findModule("70:ee:50:00:00:00").isNull());
+    EXPECT_TRUE(snapshot.toStations().empty());
+    remove(path.c_str());
+}
+
+TEST(SnapshotFileTest, invalidFile) {
+    EXPECT_THROW(SnapshotFile(tempPath("snapshotFileTestMissing")), system_error);
+
+    string path = tempPath("snapshotFileTestInvalid");
+    {
+        ofstream file(path);
+        file << "{\"body\":{}}";
+    }
+    EXPECT_THROW(SnapshotFile snapshot(path), runtime_error);
+
+    // Truncated snapshot.
+    SnapshotFile::write(path, makeStations(10));
+    {
+        ifstream in(path, ios::binary);
+        string data((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+        ofstream out(path, ios::binary | ios::trunc);
+        out.write(data.data(), static_cast<streamsize>(data.size() / 2));
+    }
+    EXPECT_THROW(SnapshotFile snapshot(path), runtime_error);
+    remove(path.c_str());
+}
+
+TEST(SnapshotFileTest, concurrentWriters) {
+    string path = tempPath("snapshotFileTestConcurrent");
+    vector<thread> writers;
+    for (size_t i = 1; i <= 4; ++i) {
+        writers.emplace_back([&path, i]() {
+            for (int j = 0; j < 10; ++j) {
+                SnapshotFile::write(path, makeStations(i));
+            }
+        });
+    }
+    for (thread &writer: writers) {
+        writer.join();
+    }
+    SnapshotFile snapshot(path);
+    EXPECT_GE(snapshot.stationCount(), 1);
+    EXPECT_LE(snapshot.stationCount(), 4);
+    remove(path.c_str());
+
+    EXPECT_THROW(SnapshotFile::write(tempPath("snapshotFileTestMissing") + "/snapshot", makeStations(1)), system_error);
+}
+
+int main (int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
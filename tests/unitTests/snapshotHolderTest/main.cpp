@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "core/snapshotholder.hpp"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace netatmoapi;
+using namespace std;
+
+list<Station> makeStations(size_t count, const string &name) {
+    list<Station> stations;
+    for (size_t i = 0; i < count; ++i) {
+        stations.emplace_back(string(name), to_string(i));
+    }
+    return stations;
+}
+
+TEST(SnapshotHolderTest, publish) {
+    StationsSnapshotHolder holder;
+    StationsSnapshotHolder::Handle empty = holder.load();
+    ASSERT_NE(nullptr, empty);
+    EXPECT_TRUE(empty->empty());
+
+    holder.publish(makeStations(3, "first"));
+    StationsSnapshotHolder::Handle first = holder.load();
+    ASSERT_EQ(3, first->size());
+    EXPECT_STREQ("first", first->front().name().c_str());
+
+    holder.publish(makeStations(2, "second"));
+    StationsSnapshotHolder::Handle second = holder.load();
+    ASSERT_EQ(2, second->size());
+    EXPECT_STREQ("second", second->front().name().c_str());
+
+    // The old handle still refers to the old snapshot.
+    ASSERT_EQ(3, first->size());
+    EXPECT_STREQ("first", first->front().name().c_str());
+
+    holder.publish(StationsSnapshotHolder::Handle());
+    EXPECT_EQ(second, holder.load());
+}
+
+TEST(SnapshotHolderTest, reclaim) {
+    StationsSnapshotHolder holder(makeStations(1, "first"));
+    weak_ptr<const list<Station>> weakFirst;
+    {
+        StationsSnapshotHolder::Handle first = holder.load();
+        weakFirst = first;
+        holder.publish(makeStations(1, "second"));
+        EXPECT_FALSE(weakFirst.expired());
+    }
+    EXPECT_TRUE(weakFirst.expired());
+
+    StationsSnapshotHolder::Handle previous = holder.exchange(make_shared<const list<Station>>(makeStations(1, "third")));
+    EXPECT_STREQ("second", previous->front().name().c_str());
+    EXPECT_STREQ("third", holder.load()->front().name().c_str());
+
+    // A nullptr keeps the current snapshot.
+    StationsSnapshotHolder::Handle current = holder.exchange(StationsSnapshotHolder::Handle());
+    ASSERT_TRUE(current);
+    EXPECT_EQ(holder.load(), current);
+    EXPECT_STREQ("third", current->front().name().c_str());
+}
+
+TEST(SnapshotHolderTest, concurrentReaders) {
+    const size_t stationCount = 16;
+    const int generations = 200;
+    StationsSnapshotHolder holder(makeStations(stationCount, "0"));
+    atomic<bool> done(false);
+    atomic<size_t> inconsistent(0);
+
+    vector<thread> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back([&]() {
+            while (!done.load()) {
+                StationsSnapshotHolder::Handle snapshot = holder.load();
+                if (snapshot->size() != stationCount) {
+                    ++inconsistent;
+                    continue;
+                }
+                string name = snapshot->front().name();
+                for (const Station &station: *snapshot) {
+                    if (station.name() != name) {
+                        ++inconsistent;
+                    }
+                }
+            }
+        });
+    }
+
+    for (int generation = 1; generation <= generations; ++generation) {
+        holder.publish(makeStations(stationCount, to_string(generation)));
+    }
+    done.store(true);
+    for (thread &reader: readers) {
+        reader.join();
+    }
+
+    EXPECT_EQ(0, inconsistent.load());
+    EXPECT_STREQ(to_string(generations).c_str(), holder.load()->front().name().c_str());
+}
+
+int main (int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
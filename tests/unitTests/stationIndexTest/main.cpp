@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "core/stationindex.h"
+#include "core/utils.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace netatmoapi;
+using namespace std;
+
+namespace {
+
+const double cPi = 3.14159265358979323846;
+
+double haversine(double lat1, double lon1, double lat2, double lon2) {
+    double phi1 = lat1 * cPi / 180, phi2 = lat2 * cPi / 180;
+    double dPhi = phi2 - phi1, dLambda = (lon2 - lon1) * cPi / 180;
+    double a = sin(dPhi / 2) * sin(dPhi / 2) + cos(phi1) * cos(phi2) * sin(dLambda / 2) * sin(dLambda / 2);
+    return 2 * StationIndex::sEarthRadius * asin(min(1.0, sqrt(a)));
+}
+
+vector<PublicStation> makeStations(size_t count, unsigned seed) {
+    mt19937 random(seed);
+    uniform_real_distribution<double> latitude(-89.9, 89.9);
+    uniform_real_distribution<double> longitude(-180, 180);
+    vector<PublicStation> stations(count);
+    for (size_t i = 0; i < count; ++i) {
+        stations[i].mId = "s" + to_string(i);
+        stations[i].mLatitude = latitude(random);
+        stations[i].mLongitude = longitude(random);
+    }
+    return stations;
+}
+
+vector<StationIndex::Result> bruteForce(const vector<PublicStation> &stations, double latitude, double longitude) {
+    vector<StationIndex::Result> results;
+    for (const PublicStation &station: stations) {
+        results.push_back({ station.mId, haversine(latitude, longitude, station.mLatitude, station.mLongitude) });
+    }
+    sort(results.begin(), results.end(), [](const StationIndex::Result &a, const StationIndex::Result &b) {
+        return a.mDistance < b.mDistance;
+    });
+    return results;
+}
+
+}
+
+TEST(StationIndexTest, queriesMatchBruteForce) {
+    vector<PublicStation> stations = makeStations(5000, 1);
+    StationIndex index;
+    index.build(stations);
+    ASSERT_EQ(5000, index.size());
+
+    mt19937 random(2);
+    uniform_real_distribution<double> latitude(-90, 90);
+    uniform_real_distribution<double> longitude(-180, 180);
+    for (int query = 0; query < 50; ++query) {
+        double lat = latitude(random), lon = longitude(random);
+        vector<StationIndex::Result> expected = bruteForce(stations, lat, lon);
+
+        vector<StationIndex::Result> nearest = index.nearest(lat, lon, 10);
+        ASSERT_EQ(10, nearest.size());
+        for (size_t i = 0; i < nearest.size(); ++i) {
+            EXPECT_EQ(expected[i].mId, nearest[i].mId);
+            EXPECT_NEAR(expected[i].mDistance, nearest[i].mDistance, 1e-6);
+        }
+
+        vector<StationIndex::Result> within = index.radius(lat, lon, 500);
+        size_t count = 0;
+        while (count < expected.size() && expected[count].mDistance <= 500) {
+            ++count;
+        }
+        ASSERT_EQ(count, within.size());
+        for (size_t i = 0; i < within.size(); ++i) {
+            EXPECT_EQ(expected[i].mId, within[i].mId);
+        }
+    }
+
+    EXPECT_EQ(5000, index.radius(0, 0, 30000).size());
+    EXPECT_TRUE(index.nearest(0, 0, 0).empty());
+    EXPECT_EQ(5000, index.nearest(0, 0, 10000).size());
+}
+
+TEST(StationIndexTest, antimeridianAndPoles) {
+    StationIndex index;
+    index.insert("east", 0, 179.95);
+    index.insert("west", 0, -179.95);
+    index.insert("pole", 89.99, 0);
+    index.insert("pole2", 89.99, 180);
+    vector<StationIndex::Result> results = index.radius(0, 180, 10);
+    ASSERT_EQ(2, results.size());
+    EXPECT_NEAR(5.56, results[0].mDistance, 0.01);
+    results = index.nearest(90, 0, 2);
+    ASSERT_EQ(2, results.size());
+    EXPECT_NEAR(1.11, results[0].mDistance, 0.01);
+    EXPECT_NEAR(1.11, results[1].mDistance, 0.01);
+}
+
+TEST(StationIndexTest, incrementalUpdates) {
+    vector<PublicStation> stations = makeStations(2000, 3);
+    StationIndex index;
+    index.build(vector<PublicStation>(stations.begin(), stations.begin() + 1000));
+
+    // Inserts cross the rebuild threshold, removals and moves hit tree and buffer.
+    for (size_t i = 1000; i < stations.size(); ++i) {
+        index.insert(stations[i].mId, stations[i].mLatitude, stations[i].mLongitude);
+    }
+    for (size_t i = 0; i < stations.size(); i += 3) {
+        EXPECT_TRUE(index.remove(stations[i].mId));
+    }
+    EXPECT_FALSE(index.remove(stations[0].mId));
+    for (size_t i = 1; i < stations.size(); i += 7) {
+        stations[i].mLatitude = -stations[i].mLatitude;
+        index.insert(stations[i].mId, stations[i].mLatitude, stations[i].mLongitude);
+    }
+    vector<PublicStation> expectedStations;
+    for (size_t i = 0; i < stations.size(); ++i) {
+        if (i % 3 != 0 || i % 7 == 1) {
+            expectedStations.push_back(stations[i]);
+        }
+    }
+    ASSERT_EQ(expectedStations.size(), index.size());
+
+    for (int pass = 0; pass < 2; ++pass) {
+        for (double lat: { -60.0, 0.0, 45.0 }) {
+            vector<StationIndex::Result> expected = bruteForce(expectedStations, lat, 10);
+            vector<StationIndex::Result> nearest = index.nearest(lat, 10, 5);
+            ASSERT_EQ(5, nearest.size());
+            for (size_t i = 0; i < nearest.size(); ++i) {
+                EXPECT_EQ(expected[i].mId, nearest[i].mId);
+            }
+            size_t count = 0;
+            while (count < expected.size() && expected[count].mDistance <= 1000) {
+                ++count;
+            }
+            EXPECT_EQ(count, index.radius(lat, 10, 1000).size());
+        }
+        index.rebuild();
+    }
+}
+
+TEST(StationIndexTest, batchQueries) {
+    vector<PublicStation> stations = makeStations(3000, 4);
+    StationIndex index;
+    index.build(stations);
+    vector<StationIndex::Location> locations;
+    for (size_t i = 0; i < 500; ++i) {
+        locations.emplace_back(stations[i].mLatitude + 0.1, stations[i].mLongitude);
+    }
+    vector<vector<StationIndex::Result>> nearest = index.nearest(locations, 3, 4);
+    vector<vector<StationIndex::Result>> within = index.radius(locations, 200, 4);
+    ASSERT_EQ(500, nearest.size());
+    ASSERT_EQ(500, within.size());
+    for (size_t i = 0; i < locations.size(); ++i) {
+        vector<StationIndex::Result> single = index.nearest(locations[i].first, locations[i].second, 3);
+        ASSERT_EQ(single.size(), nearest[i].size());
+        for (size_t j = 0; j < single.size(); ++j) {
+            EXPECT_EQ(single[j].mId, nearest[i][j].mId);
+        }
+        EXPECT_EQ(index.radius(locations[i].first, locations[i].second, 200).size(), within[i].size());
+    }
+}
+
+TEST(StationIndexTest, buildFromStations) {
+    list<Station> stations;
+    Station home("Home", "70:ee:50:00:00:01");
+    Place place;
+    place.mLatitude = 50.555413;
+    place.mLongitude = 7.4027088;
+    home.setPlace(move(place));
+    stations.push_back(move(home));
+    stations.emplace_back("No place", "70:ee:50:00:00:02");
+
+    StationIndex index;
+    index.build(stations);
+    ASSERT_EQ(1, index.size());
+    vector<StationIndex::Result> results = index.nearest(50.56, 7.4, 5);
+    ASSERT_EQ(1, results.size());
+    EXPECT_STREQ("70:ee:50:00:00:01", results[0].mId.c_str());
+    EXPECT_LT(results[0].mDistance, 1);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "core/tdigest.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace netatmoapi;
+using namespace std;
+
+// Returns the largest rank error of the quantiles in fractions of the number of values.
+double rankError(const TDigest &digest, vector<double> sorted, double q) {
+    double estimate = digest.quantile(q);
+    double lower = double(lower_bound(sorted.begin(), sorted.end(), estimate) - sorted.begin()) / double(sorted.size());
+    double upper = double(upper_bound(sorted.begin(), sorted.end(), estimate) - sorted.begin()) / double(sorted.size());
+    if (q < lower) {
+        return lower - q;
+    } else if (q > upper) {
+        return q - upper;
+    }
+    return 0;
+}
+
+template <typename Distribution>
+vector<double> makeValues(size_t count, Distribution distribution) {
+    mt19937_64 random(11);
+    vector<double> values;
+    for (size_t i = 0; i < count; ++i) {
+        values.push_back(distribution(random));
+    }
+    return values;
+}
+
+void expectAccurate(const TDigest &digest, vector<double> values) {
+    sort(values.begin(), values.end());
+    EXPECT_LT(rankError(digest, values, 0.5), 0.01);
+    EXPECT_LT(rankError(digest, values, 0.95), 0.005);
+    EXPECT_LT(rankError(digest, values, 0.99), 0.002);
+    EXPECT_LT(rankError(digest, values, 0.999), 0.0005);
+    EXPECT_LT(rankError(digest, values, 0.01), 0.002);
+    EXPECT_EQ(values.front(), digest.quantile(0));
+    EXPECT_EQ(values.back(), digest.quantile(1));
+    EXPECT_NEAR(0.5, digest.cdf(digest.quantile(0.5)), 0.01);
+}
+
+TEST(TDigestTest, accuracy) {
+    const size_t count = 200000;
+    vector<vector<double>> distributions {
+        makeValues(count, uniform_real_distribution<double>(-10, 30)),
+        makeValues(count, normal_distribution<double>(800, 200)),
+        makeValues(count, exponential_distribution<double>(0.1)),
+        // Noise like values with few distinct values.
+        makeValues(count, [](mt19937_64 &random) { return double(35 + random() % 40); })
+    };
+    for (const vector<double> &values: distributions) {
+        TDigest digest;
+        for (double value: values) {
+            digest.add(value);
+        }
+        EXPECT_EQ(double(count), digest.weight());
+        EXPECT_LE(digest.centroidCount(), 2 * digest.compression());
+        expectAccurate(digest, values);
+    }
+}
+
+TEST(TDigestTest, merge) {
+    vector<double> values = makeValues(100000, normal_distribution<double>(20, 5));
+    vector<TDigest> modules(10);
+    for (size_t i = 0; i < values.size(); ++i) {
+        modules[i % modules.size()].add(values[i]);
+    }
+    TDigest site;
+    for (const TDigest &module: modules) {
+        // Sent over the network.
+        site.merge(TDigest::deserialize(module.serialize()));
+    }
+    EXPECT_EQ(double(values.size()), site.weight());
+    expectAccurate(site, values);
+
+    site.merge(site);
+    EXPECT_EQ(double(2 * values.size()), site.weight());
+
+    EXPECT_THROW(TDigest::deserialize("NATD"), invalid_argument);
+    EXPECT_THROW(TDigest(1), invalid_argument);
+}
+
+TEST(TDigestTest, missingValues) {
+    TDigest digest;
+    EXPECT_EQ(numeric_limits<double>::min(), digest.quantile(0.5));
+    EXPECT_EQ(numeric_limits<double>::min(), digest.min());
+    EXPECT_EQ(0, digest.cdf(1));
+    digest.add(numeric_limits<double>::min());
+    digest.add(numeric_limits<double>::quiet_NaN());
+    Measures measures;
+    measures.mNoise = 42;
+    digest.add(measures, Measures::noise);
+    digest.add(measures, Measures::co2);
+    EXPECT_EQ(1, digest.weight());
+    EXPECT_EQ(42, digest.quantile(0.5));
+    EXPECT_EQ(42, digest.min());
+    EXPECT_EQ(42, digest.max());
+    digest.clear();
+    EXPECT_EQ(0, digest.weight());
+}
+
+TEST(TDigestTest, slidingWindow) {
+    EXPECT_THROW(SlidingTDigest(3600, 0), invalid_argument);
+    EXPECT_THROW(SlidingTDigest(3600, 700), invalid_argument);
+
+    // One hour window in 5 minute panes.
+    SlidingTDigest window(3600, 300);
+    EXPECT_EQ(numeric_limits<double>::min(), window.quantile(0.5));
+    for (uint64_t timeStamp = 0; timeStamp < 3600; timeStamp += 60) {
+        EXPECT_TRUE(window.add(timeStamp, 10));
+    }
+    EXPECT_EQ(10, window.quantile(0.99));
+    // After another half hour the first half of the values drops out.
+    for (uint64_t timeStamp = 3600; timeStamp < 5400; timeStamp += 60) {
+        EXPECT_TRUE(window.add(timeStamp, 20));
+    }
+    EXPECT_EQ(60, window.digest().weight());
+    EXPECT_NEAR(15, window.quantile(0.5), 5);
+    EXPECT_FALSE(window.add(0, 10));
+
+    // A gap longer than the window.
+    Measures measures;
+    measures.mTimeStamp = 100000;
+    measures.mCo2 = 800;
+    EXPECT_TRUE(window.add(measures, Measures::co2));
+    EXPECT_FALSE(window.add(measures, Measures::noise));
+    EXPECT_EQ(1, window.digest().weight());
+    EXPECT_EQ(800, window.quantile(0.5));
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,211 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "core/timeseries.h"
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace netatmoapi;
+using namespace std;
+
+TEST(TimeSeriesTest, roundTrip) {
+    mt19937_64 random(7);
+    uniform_int_distribution<int> jitter(-30, 30);
+    uniform_real_distribution<double> noise(-0.5, 0.5);
+    vector<uint64_t> timeStamps;
+    vector<double> values;
+    uint64_t timeStamp = 1483228800;
+    double temperature = 20.0;
+    for (size_t i = 0; i < 5000; ++i) {
+        if (i % 700 == 0) {
+            // Gaps of some hours, which need the largest delta of delta.
+            timeStamp += 36000;
+        }
+        timeStamp += 300 + jitter(random);
+        temperature = round((temperature + noise(random)) * 10) / 10;
+        timeStamps.push_back(timeStamp);
+        // Some special values, which must be restored bit by bit.
+        if (i == 100) {
+            values.push_back(numeric_limits<double>::max());
+        } else if (i == 101) {
+            values.push_back(-0.0);
+        } else if (i == 102) {
+            values.push_back(numeric_limits<double>::denorm_min());
+        } else {
+            values.push_back(temperature);
+        }
+    }
+
+    TimeSeries series;
+    for (size_t i = 0; i < timeStamps.size(); ++i) {
+        ASSERT_TRUE(series.append(timeStamps[i], values[i]));
+    }
+    ASSERT_EQ(timeStamps.size(), series.size());
+    EXPECT_EQ(timeStamps.front(), series.firstTimeStamp());
+    EXPECT_EQ(timeStamps.back(), series.lastTimeStamp());
+
+    vector<uint64_t> readTimeStamps;
+    vector<double> readValues;
+    ASSERT_EQ(timeStamps.size(), series.read(0, numeric_limits<uint64_t>::max(), readTimeStamps, readValues));
+    EXPECT_EQ(timeStamps, readTimeStamps);
+    ASSERT_EQ(values.size(), readValues.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        ASSERT_EQ(0, memcmp(&values[i], &readValues[i], sizeof(double))) << i;
+    }
+}
+
+TEST(TimeSeriesTest, compression) {
+    // A day of indoor temperature: 5 minute steps and a value, which changes every few measures.
+    TimeSeries series;
+    const size_t count = 288 * 10;
+    for (size_t i = 0; i < count; ++i) {
+        series.append(1483228800 + i * 300, 20.0 + double((i / 6) % 30) / 10);
+    }
+    EXPECT_LT(series.memoryUsage(), count);
+
+    // Noisy measures with one decimal place and some jitter need a tenth of the 16 bytes of a time stamp and a value.
+    mt19937_64 random(42);
+    uniform_int_distribution<int> percent(0, 99);
+    uniform_real_distribution<double> noise(-0.3, 0.3);
+    TimeSeries noisy;
+    const size_t noisyCount = TimeSeries::sBlockSize * 20;
+    uint64_t timeStamp = 1483228800;
+    double value = 20.0;
+    for (size_t i = 0; i < noisyCount; ++i) {
+        timeStamp += percent(random) < 95 ? 300 : 301 + percent(random);
+        value = round((value + noise(random)) * 10) / 10;
+        noisy.append(timeStamp, value);
+    }
+    EXPECT_LT(noisy.memoryUsage(), noisyCount * 16 / 10);
+    RecordProperty("noisyBytes", to_string(noisy.memoryUsage()));
+    RecordProperty("bytes", to_string(series.memoryUsage()));
+}
+
+TEST(TimeSeriesTest, decimals) {
+    // Each value needs more decimals than the ones before, the block is reencoded.
+    const vector<double> values = { 21.0, 21.3, 21.25, 0.101, 1e15, -7.5, 1.0 / 3, 2.0, 21.3 };
+    TimeSeries series;
+    for (size_t i = 0; i < values.size(); ++i) {
+        ASSERT_TRUE(series.append(1000 + i * 300, values[i]));
+    }
+    vector<uint64_t> timeStamps;
+    vector<double> readValues;
+    ASSERT_EQ(values.size(), series.read(0, numeric_limits<uint64_t>::max(), timeStamps, readValues));
+    EXPECT_EQ(values, readValues);
+    EXPECT_EQ(1000 + 8 * 300, timeStamps.back());
+}
+
+TEST(TimeSeriesTest, ignoreOldMeasures) {
+    TimeSeries series;
+    EXPECT_EQ(0, series.firstTimeStamp());
+    EXPECT_TRUE(series.append(1000, 1.0));
+    EXPECT_FALSE(series.append(1000, 2.0));
+    EXPECT_FALSE(series.append(900, 3.0));
+    EXPECT_TRUE(series.append(1300, 4.0));
+    EXPECT_EQ(2, series.size());
+
+    vector<uint64_t> timeStamps;
+    vector<double> values;
+    series.read(0, 2000, timeStamps, values);
+    EXPECT_EQ((vector<uint64_t>{ 1000, 1300 }), timeStamps);
+    EXPECT_EQ((vector<double>{ 1.0, 4.0 }), values);
+}
+
+TEST(TimeSeriesTest, scanRange) {
+    TimeSeries series;
+    const size_t count = TimeSeries::sBlockSize * 3 + 10;
+    for (size_t i = 0; i < count; ++i) {
+        series.append(1000 + i * 300, double(i));
+    }
+
+    size_t expected = 0;
+    size_t scanned = series.scan(1000 + 1000 * 300, 1000 + 2100 * 300, [&expected](uint64_t timeStamp, double value) {
+        EXPECT_EQ(1000 + (1000 + expected) * 300, timeStamp);
+        EXPECT_EQ(double(1000 + expected), value);
+        ++expected;
+    });
+    EXPECT_EQ(1101, scanned);
+    EXPECT_EQ(1101, expected);
+
+    // Bounds between two measures.
+    vector<uint64_t> timeStamps;
+    vector<double> values;
+    EXPECT_EQ(2, series.read(1000 + 299, 1000 + 601, timeStamps, values));
+    EXPECT_EQ((vector<double>{ 1.0, 2.0 }), values);
+    EXPECT_EQ(0, series.read(0, 999, timeStamps, values));
+    EXPECT_EQ(0, series.read(1000 + count * 300, numeric_limits<uint64_t>::max(), timeStamps, values));
+
+    series.removeBefore(1000 + TimeSeries::sBlockSize * 2 * 300);
+    EXPECT_EQ(count - TimeSeries::sBlockSize * 2, series.size());
+    EXPECT_EQ(1000 + TimeSeries::sBlockSize * 2 * 300, series.firstTimeStamp());
+
+    // Appending continues after a copy.
+    TimeSeries copy(series);
+    EXPECT_TRUE(copy.append(1000 + count * 300, 42.0));
+    EXPECT_EQ(series.size() + 1, copy.size());
+}
+
+TEST(TimeSeriesTest, store) {
+    Measures first;
+    first.mTimeStamp = 1000;
+    first.mTemperature = 21.5;
+    first.mHumidity = 45;
+    Measures second = first;
+    second.mTimeStamp = 1300;
+    second.mTemperature = 21.7;
+
+    TimeSeriesStore store;
+    EXPECT_EQ(2, store.append("02:00:00:00:00:01", first));
+    // The same poll again.
+    EXPECT_EQ(0, store.append("02:00:00:00:00:01", first));
+    EXPECT_EQ(2, store.append("02:00:00:00:00:01", second));
+    EXPECT_EQ(4, store.size());
+    ASSERT_EQ(1, store.moduleIds().size());
+
+    const TimeSeries *temperature = store.series("02:00:00:00:00:01", Measures::temperature);
+    ASSERT_NE(nullptr, temperature);
+    vector<uint64_t> timeStamps;
+    vector<double> values;
+    temperature->read(0, 2000, timeStamps, values);
+    EXPECT_EQ((vector<double>{ 21.5, 21.7 }), values);
+    EXPECT_EQ(nullptr, store.series("02:00:00:00:00:01", Measures::co2));
+    EXPECT_EQ(nullptr, store.series("02:00:00:00:00:02", Measures::temperature));
+
+    Module module(string("Outdoor"), string("02:00:00:00:00:02"), string("NAModule1"));
+    Measures measures;
+    measures.mTimeStamp = 1200;
+    measures.mTemperature = 5.5;
+    module.setMeasures(move(measures));
+    Station station(string("Home"), string("70:ee:50:00:00:01"));
+    station.setModules({ module });
+    EXPECT_EQ(1, store.append(list<Station>{ station }));
+    EXPECT_NE(nullptr, store.series("02:00:00:00:00:02", Measures::temperature));
+
+    TimeSeriesStore copy(store);
+    EXPECT_EQ(store.size(), copy.size());
+    EXPECT_EQ(2, copy.moduleIds().size());
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
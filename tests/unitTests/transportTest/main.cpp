@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "core/curltransport.h"
+#include "core/nawsapiclient.h"
+#include "core/utils.h"
+
+#include <gtest/gtest.h>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+using namespace netatmoapi;
+using namespace std;
+
+namespace {
+
+// Answers every request with the canned response of its url.
+class FakeTransport: public Transport {
+public:
+    struct Request {
+        string                  mMethod;
+        string                  mUrl;
+        map<string, string>     mParams;
+    };
+
+    string get(const string &url, const map<string, string> &params) override {
+        return answer("GET", url, params);
+    }
+
+    string post(const string &url, const map<string, string> &params) override {
+        return answer("POST", url, params);
+    }
+
+    map<string, string> mResponses;
+    vector<Request> mRequests;
+
+private:
+    string answer(const string &method, const string &url, const map<string, string> &params) {
+        lock_guard<mutex> lock(mMutex);
+        mRequests.push_back({ method, url, params });
+        auto response = mResponses.find(url);
+        if (response == mResponses.end()) {
+            throw runtime_error("No response for " + url);
+        }
+        return response->second;
+    }
+
+    mutex mMutex;
+};
+
+const char *cStationsData = R"({"body":{"devices":[{"_id":"70:ee:50:00:00:01","station_name":"Home","module_name":"Indoor","type":"NAMain","modules":[],)"
+    R"("dashboard_data":{"AbsolutePressure":999.2,"time_utc":1509446950,"Noise":48,"Temperature":21.1,"temp_trend":"stable","Humidity":56,)"
+    R"("Pressure":1029.1,"pressure_trend":"stable","CO2":1101,"date_max_temp":1509446041,"date_min_temp":1509432104,"min_temp":19.5,"max_temp":21.1}}]},"status":"ok"})";
+
+}
+
+TEST(TransportTest, clientUsesTransport) {
+    shared_ptr<FakeTransport> transport = make_shared<FakeTransport>();
+    transport->mResponses["https://api.netatmo.net/oauth2/token"] = R"({"access_token": "access", "refresh_token": "refresh2", "expires_in": 10800})";
+    transport->mResponses["https://api.netatmo.net/api/getstationsdata"] = cStationsData;
+
+    NAWSApiClient client("user", "password", "id", "secret", "", "refresh");
+    client.setTransport(transport);
+    EXPECT_EQ(transport, client.transport());
+    list<Station> stations = utils::parseDevices(client.requestStationsData("", true));
+
+    ASSERT_EQ(1, stations.size());
+    EXPECT_EQ("70:ee:50:00:00:01", stations.front().id());
+    // The expired session is refreshed first.
+    ASSERT_EQ(2, transport->mRequests.size());
+    EXPECT_EQ("POST", transport->mRequests[0].mMethod);
+    EXPECT_EQ("refresh", transport->mRequests[0].mParams["refresh_token"]);
+    EXPECT_EQ("GET", transport->mRequests[1].mMethod);
+    EXPECT_EQ("access", transport->mRequests[1].mParams["access_token"]);
+    EXPECT_EQ("true", transport->mRequests[1].mParams["get_favorites"]);
+    EXPECT_EQ("refresh2", client.refreshToken());
+    EXPECT_GT(client.expiresIn(), time(nullptr));
+
+    // Copies share the transport.
+    NAWSApiClient copy(client);
+    copy.requestStationsData();
+    EXPECT_EQ(3, transport->mRequests.size());
+}
+
+TEST(TransportTest, errorsOfResponses) {
+    shared_ptr<FakeTransport> transport = make_shared<FakeTransport>();
+    transport->mResponses["https://api.netatmo.net/api/getstationsdata"] = R"({"error": {"code": 2, "message": "Invalid access token"}})";
+    NAWSApiClient client("user", "password", "id", "secret", "access", "refresh");
+    client.setExpiresIn(time(nullptr) + 3600);
+    client.setTransport(transport);
+    EXPECT_THROW(client.requestStationsData(), ResponseException);
+
+    // Exceptions of the transport are passed through.
+    transport->mResponses.clear();
+    EXPECT_THROW(client.requestStationsData(), runtime_error);
+}
+
+TEST(TransportTest, defaultTransport) {
+    NAWSApiClient client;
+    EXPECT_TRUE(dynamic_pointer_cast<CurlTransport>(client.transport()));
+    client.setTransport(make_shared<FakeTransport>());
+    client.setTransport(nullptr);
+    EXPECT_TRUE(dynamic_pointer_cast<CurlTransport>(client.transport()));
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
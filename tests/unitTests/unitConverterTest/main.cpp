@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "core/unitconverter.h"
+#include "core/utils.h"
+
+#include <gtest/gtest.h>
+#include <limits>
+#include <vector>
+
+using namespace netatmoapi;
+using namespace std;
+
+namespace {
+
+const double cMissing = numeric_limits<double>::min();
+
+UserSettings imperialSettings() {
+    UserSettings settings;
+    settings.mUnit = UserSettings::imperial;
+    settings.mWindUnit = UserSettings::mph;
+    settings.mPressureUnit = UserSettings::inHg;
+    return settings;
+}
+
+list<Station> makeFleet() {
+    json response = {
+        { "body", {
+            { "devices", json::array({ {
+                { "_id", "70:ee:50:00:00:01" },
+                { "station_name", "Home" },
+                { "type", "NAMain" },
+                { "module_name", "Indoor" },
+                { "dashboard_data", { { "time_utc", 1000 }, { "Temperature", 20 }, { "Humidity", 50 }, { "CO2", 500 },
+                                      { "Noise", 40 }, { "Pressure", 1013.25 }, { "AbsolutePressure", 1000 },
+                                      { "min_temp", 19 }, { "max_temp", 21 }, { "date_min_temp", 900 },
+                                      { "date_max_temp", 950 }, { "temp_trend", "up" }, { "pressure_trend", "down" } } },
+                { "modules", json::array({ {
+                    { "_id", "06:00:00:00:00:02" },
+                    { "type", "NAModule2" },
+                    { "module_name", "Wind" },
+                    { "battery_percent", 90 },
+                    { "rf_status", 70 },
+                    { "dashboard_data", { { "time_utc", 1010 }, { "WindStrength", 20 }, { "WindAngle", 90 },
+                                          { "GustStrength", 40 }, { "GustAngle", 180 } } }
+                } }) }
+            } }) }
+        } }
+    };
+    return utils::parseDevices(response);
+}
+
+}
+
+TEST(UnitConverterTest, parseUserSettings) {
+    UserSettings defaults = utils::parseUserSettings(json::object());
+    EXPECT_EQ(UserSettings::metric, defaults.mUnit);
+    EXPECT_EQ(UserSettings::kph, defaults.mWindUnit);
+    EXPECT_EQ(UserSettings::mbar, defaults.mPressureUnit);
+    EXPECT_EQ(UserSettings::humidex, defaults.mFeelLikeAlgorithm);
+
+    json response = { { "body", { { "user", { { "administrative", {
+        { "unit", 1 }, { "windunit", 4 }, { "pressureunit", 7 }, { "feel_like_algo", 1 }, { "lang", "en-US" }
+    } } } } } } };
+    UserSettings settings = utils::parseUserSettings(response);
+    EXPECT_EQ(UserSettings::imperial, settings.mUnit);
+    EXPECT_EQ(UserSettings::knot, settings.mWindUnit);
+    EXPECT_EQ(UserSettings::mbar, settings.mPressureUnit);
+    EXPECT_EQ(UserSettings::heatIndex, settings.mFeelLikeAlgorithm);
+    EXPECT_STREQ("en-US", settings.mLang.c_str());
+    EXPECT_TRUE(settings.mRegLocale.empty());
+}
+
+TEST(UnitConverterTest, convertValues) {
+    UnitConverter metric;
+    EXPECT_FALSE(metric.converts(Measures::temperature));
+    EXPECT_DOUBLE_EQ(21.5, metric.convert(Measures::temperature, 21.5));
+    EXPECT_STREQ("°C", metric.unit(Measures::temperature).c_str());
+    EXPECT_STREQ("km/h", metric.unit(Measures::windStrength).c_str());
+    EXPECT_STREQ("mbar", metric.unit(Measures::pressure).c_str());
+
+    UnitConverter imperial(imperialSettings());
+    EXPECT_TRUE(imperial.converts(Measures::temperature));
+    EXPECT_FALSE(imperial.converts(Measures::humidity));
+    EXPECT_DOUBLE_EQ(212, imperial.convert(Measures::temperature, 100));
+    EXPECT_DOUBLE_EQ(-40, imperial.convert(Measures::minTemperature, -40));
+    EXPECT_DOUBLE_EQ(1, imperial.convert(Measures::rain, 25.4));
+    EXPECT_NEAR(29.92, imperial.convert(Measures::pressure, 1013.25), 0.01);
+    EXPECT_NEAR(62.137, imperial.convert(Measures::windStrength, 100), 0.001);
+    EXPECT_DOUBLE_EQ(55, imperial.convert(Measures::humidity, 55));
+    EXPECT_EQ(cMissing, imperial.convert(Measures::temperature, cMissing));
+    EXPECT_STREQ("°F", imperial.unit(Measures::maxTemperature).c_str());
+    EXPECT_STREQ("in", imperial.unit(Measures::sumRain24).c_str());
+    EXPECT_STREQ("inHg", imperial.unit(Measures::absolutePressure).c_str());
+    EXPECT_STREQ("mph", imperial.unit(Measures::gustStrength).c_str());
+
+    UserSettings settings;
+    settings.mWindUnit = UserSettings::beaufort;
+    settings.mPressureUnit = UserSettings::mmHg;
+    UnitConverter beaufort(settings);
+    vector<double> winds = { 0, 0.9, 1, 5.9, 11, 19, 28, 38, 49, 61, 74, 88, 102, 117, 118, 200, cMissing };
+    vector<double> expected = { 0, 0, 1, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 12, cMissing };
+    vector<double> result(winds.size());
+    beaufort.convert(Measures::windStrength, winds.data(), result.data(), winds.size());
+    for (size_t i = 0; i < winds.size(); ++i) {
+        EXPECT_EQ(expected[i], result[i]) << winds[i];
+    }
+    EXPECT_NEAR(760, beaufort.convert(Measures::pressure, 1013.25), 0.01);
+    EXPECT_STREQ("bft", beaufort.unit(Measures::windStrength).c_str());
+    EXPECT_STREQ("mmHg", beaufort.unit(Measures::pressure).c_str());
+}
+
+TEST(UnitConverterTest, convertColumns) {
+    UnitConverter converter(imperialSettings());
+    MeasureColumns columns(2);
+    for (size_t i = 0; i < 101; ++i) {
+        columns.mTimeStamps.push_back(1000 + i * 300);
+        columns.mValues[0].push_back(i % 10 == 0 ? cMissing : double(i));
+        columns.mValues[1].push_back(double(i));
+    }
+    MeasureColumns result = converter.convert(columns, { Measures::temperature, Measures::humidity });
+    ASSERT_EQ(101, result.size());
+    EXPECT_EQ(columns.mTimeStamps, result.mTimeStamps);
+    for (size_t i = 0; i < 101; ++i) {
+        if (i % 10 == 0) {
+            EXPECT_EQ(cMissing, result.mValues[0][i]);
+        } else {
+            EXPECT_DOUBLE_EQ(i * 1.8 + 32, result.mValues[0][i]);
+        }
+        EXPECT_DOUBLE_EQ(double(i), result.mValues[1][i]);
+    }
+    // The input is not modified.
+    EXPECT_DOUBLE_EQ(1, columns.mValues[0][1]);
+    EXPECT_THROW(converter.convert(columns, { Measures::temperature }), invalid_argument);
+}
+
+TEST(UnitConverterTest, convertFleet) {
+    list<Station> stations = makeFleet();
+    UnitConverter converter(imperialSettings());
+
+    MeasureColumns fleet = converter.convert(stations);
+    ASSERT_EQ(2, fleet.size());
+    ASSERT_EQ(Measures::fieldCount, fleet.mValues.size());
+    EXPECT_EQ(1000, fleet.mTimeStamps[0]);
+    EXPECT_EQ(1010, fleet.mTimeStamps[1]);
+    EXPECT_DOUBLE_EQ(68, fleet.mValues[Measures::temperature][0]);
+    EXPECT_DOUBLE_EQ(66.2, fleet.mValues[Measures::minTemperature][0]);
+    EXPECT_DOUBLE_EQ(500, fleet.mValues[Measures::co2][0]);
+    EXPECT_DOUBLE_EQ(950, fleet.mValues[Measures::dateMaxTemp][0]);
+    EXPECT_DOUBLE_EQ(Measures::up, fleet.mValues[Measures::temperatureTrend][0]);
+    EXPECT_EQ(cMissing, fleet.mValues[Measures::temperature][1]);
+    EXPECT_NEAR(12.427, fleet.mValues[Measures::windStrength][1], 0.001);
+    EXPECT_DOUBLE_EQ(90, fleet.mValues[Measures::windAngle][1]);
+
+    Measures measures = converter.convert(stations.front().modulesRef().front().measures());
+    EXPECT_DOUBLE_EQ(68, measures.mTemperature);
+    EXPECT_DOUBLE_EQ(69.8, measures.mMaxTemperature);
+    EXPECT_EQ(Measures::down, measures.mPressureTrend);
+    EXPECT_EQ(950, measures.mDateMaxTemp);
+
+    // The parsed fleet keeps the metric values.
+    EXPECT_DOUBLE_EQ(20, stations.front().modulesRef().front().measures().mTemperature);
+    EXPECT_DOUBLE_EQ(20, stations.front().modulesRef().back().measures().mWindStrength);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
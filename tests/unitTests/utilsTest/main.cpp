@@ -18,9 +18,11 @@
  */
 
 #include "core/utils.h"
+#include "model/params.h"
 
 #include <gtest/gtest.h>
 #include <stdexcept>
+#include <limits>
 
 using namespace netatmoapi;
 using namespace netatmoapi::utils;
@@ -47,6 +49,62 @@ TEST(EncodeUrlTest, urlEncode) {
                  urlEncode("thepaffy.de").c_str());
 }
 
+TEST(SplitTimeRangeTest, scaleInterval) {
+    EXPECT_EQ(300, scaleInterval(params::cScaleMax));
+    EXPECT_EQ(3600, scaleInterval(params::cScale1Hour));
+    EXPECT_EQ(86400, scaleInterval(params::cScale1Day));
+    EXPECT_THROW(scaleInterval("2hours"), invalid_argument);
+}
+
+TEST(SplitTimeRangeTest, splitTimeRange) {
+    // One year of 5 minute measures.
+    uint64_t begin = 1483228800;
+    uint64_t end = begin + 365 * 86400;
+    vector<pair<uint64_t, uint64_t>> chunks = splitTimeRange(begin, end, params::cScaleMax, 1024);
+    ASSERT_EQ(103, chunks.size());
+    EXPECT_EQ(begin, chunks.front().first);
+    EXPECT_EQ(begin + 1024 * 300 - 1, chunks.front().second);
+    EXPECT_EQ(end, chunks.back().second);
+    for (size_t i = 1; i < chunks.size(); ++i) {
+        EXPECT_EQ(chunks[i - 1].second + 1, chunks[i].first);
+    }
+
+    chunks = splitTimeRange(begin, begin + 3600, params::cScale1Hour, 1024);
+    ASSERT_EQ(1, chunks.size());
+    EXPECT_EQ(begin, chunks.front().first);
+    EXPECT_EQ(begin + 3600, chunks.front().second);
+
+    chunks = splitTimeRange(begin, begin + 2 * 3600 - 1, params::cScale1Hour, 1);
+    ASSERT_EQ(2, chunks.size());
+    EXPECT_EQ(begin + 3600, chunks.back().first);
+
+    EXPECT_TRUE(splitTimeRange(end, begin, params::cScaleMax, 1024).empty());
+    EXPECT_THROW(splitTimeRange(begin, end, params::cScaleMax, 0), invalid_argument);
+}
+
+TEST(DecodeMeasureBlocksTest, decodeMeasureBlocks) {
+    json blocks = json::parse("[{\"beg_time\":1509443616,\"step_time\":300,\"value\":[[8.2,84],[8.3,null],[8.1,83]]},"
+                              "{\"beg_time\":1509446616,\"value\":[[7.9,85]]},"
+                              "{\"beg_time\":1509450216,\"step_time\":600,\"value\":[[7.5,86],[7.4]]}]");
+    MeasureColumns columns = decodeMeasureBlocks(blocks);
+    ASSERT_EQ(6, columns.size());
+    ASSERT_EQ(2, columns.mValues.size());
+    EXPECT_EQ(vector<uint64_t>({ 1509443616, 1509443916, 1509444216, 1509446616, 1509450216, 1509450816 }), columns.mTimeStamps);
+    EXPECT_EQ(vector<double>({ 8.2, 8.3, 8.1, 7.9, 7.5, 7.4 }), columns.mValues[0]);
+    EXPECT_DOUBLE_EQ(84, columns.mValues[1][0]);
+    EXPECT_EQ(numeric_limits<double>::min(), columns.mValues[1][1]);
+    EXPECT_EQ(numeric_limits<double>::min(), columns.mValues[1][5]);
+
+    // Append to existing columns.
+    decodeMeasureBlocks(json::parse("[{\"beg_time\":1509451416,\"value\":[[7.3,87]]}]"), columns);
+    ASSERT_EQ(7, columns.size());
+    EXPECT_EQ(7, columns.mValues[1].size());
+    EXPECT_DOUBLE_EQ(87, columns.mValues[1][6]);
+
+    EXPECT_EQ(0, decodeMeasureBlocks(json::array()).size());
+    EXPECT_THROW(decodeMeasureBlocks(json::parse("[{\"beg_time\":1509451416,\"value\":[[1],[2]]}]")), invalid_argument);
+}
+
 int main (int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
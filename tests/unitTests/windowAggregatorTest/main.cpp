@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2017 Christian Paffhausen, <https://github.com/thepaffy/>
+ *
+ * This file is part of Netatmo-API-CPP.
+ *
+ * Netatmo-API-CPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Netatmo-API-CPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Netatmo-API-CPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "core/windowaggregator.h"
+#include "core/simd.hpp"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace netatmoapi;
+using namespace std;
+
+const double cMissing = numeric_limits<double>::min();
+
+// Irregular 5 minute samples with missing values and a gap of two days.
+void makeSamples(size_t count, vector<uint64_t> &timeStamps, vector<double> &values) {
+    mt19937 random(3);
+    uniform_int_distribution<int> percent(0, 99);
+    uniform_real_distribution<double> value(-10, 30);
+    uint64_t timeStamp = 1483228800 + 17;
+    for (size_t i = 0; i < count; ++i) {
+        timeStamp += 300 + percent(random) % 20;
+        if (i == count / 2) {
+            timeStamp += 2 * 86400;
+        }
+        timeStamps.push_back(timeStamp);
+        values.push_back(percent(random) < 5 ? cMissing : value(random));
+    }
+}
+
+vector<Aggregate> bruteForce(const vector<uint64_t> &timeStamps, const vector<double> &values, uint64_t windowSize, uint64_t slide) {
+    vector<Aggregate> windows;
+    uint64_t first = timeStamps.front() < windowSize ? 0 : (timeStamps.front() - windowSize) / slide + 1;
+    for (uint64_t window = first; window * slide <= timeStamps.back(); ++window) {
+        Aggregate aggregate;
+        aggregate.mBegin = window * slide;
+        aggregate.mEnd = aggregate.mBegin + windowSize;
+        for (size_t i = 0; i < timeStamps.size(); ++i) {
+            if (timeStamps[i] < aggregate.mBegin || timeStamps[i] >= aggregate.mEnd || values[i] == cMissing) {
+                continue;
+            }
+            aggregate.mMin = aggregate.mCount == 0 ? values[i] : min(aggregate.mMin, values[i]);
+            aggregate.mMax = aggregate.mCount == 0 ? values[i] : max(aggregate.mMax, values[i]);
+            aggregate.mSum += values[i];
+            ++aggregate.mCount;
+        }
+        if (aggregate.mCount > 0) {
+            windows.push_back(aggregate);
+        }
+    }
+    return windows;
+}
+
+void expectEqual(const vector<Aggregate> &expected, const vector<Aggregate> &actual) {
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(expected[i].mBegin, actual[i].mBegin) << i;
+        EXPECT_EQ(expected[i].mEnd, actual[i].mEnd) << i;
+        EXPECT_EQ(expected[i].mCount, actual[i].mCount) << i;
+        EXPECT_EQ(expected[i].mMin, actual[i].mMin) << i;
+        EXPECT_EQ(expected[i].mMax, actual[i].mMax) << i;
+        EXPECT_NEAR(expected[i].mSum, actual[i].mSum, 1e-9) << i;
+    }
+}
+
+TEST(WindowAggregatorTest, reduce) {
+    vector<uint64_t> timeStamps;
+    vector<double> values;
+    makeSamples(1001, timeStamps, values);
+    for (size_t count: { size_t(0), size_t(1), size_t(3), size_t(4), size_t(7), size_t(1001) }) {
+        simd::Reduction expected;
+        simd::reduceScalar(values.data(), count, cMissing, expected);
+        simd::Reduction actual;
+        simd::reduce(values.data(), count, cMissing, actual);
+        EXPECT_EQ(expected.mCount, actual.mCount);
+        EXPECT_EQ(expected.mMin, actual.mMin);
+        EXPECT_EQ(expected.mMax, actual.mMax);
+        EXPECT_NEAR(expected.mSum, actual.mSum, 1e-9);
+    }
+}
+
+TEST(WindowAggregatorTest, tumbling) {
+    vector<uint64_t> timeStamps { 3600, 3900, 4200, 7199, 7200, 14400 };
+    vector<double> values { 1.0, cMissing, 3.0, 5.0, -2.0, cMissing };
+    vector<Aggregate> windows = WindowAggregator::aggregate(timeStamps.data(), values.data(), values.size(), 3600);
+    ASSERT_EQ(2, windows.size());
+    EXPECT_EQ(3600, windows[0].mBegin);
+    EXPECT_EQ(7200, windows[0].mEnd);
+    EXPECT_EQ(3, windows[0].mCount);
+    EXPECT_EQ(1.0, windows[0].mMin);
+    EXPECT_EQ(5.0, windows[0].mMax);
+    EXPECT_EQ(9.0, windows[0].mSum);
+    EXPECT_EQ(3.0, windows[0].mean());
+    EXPECT_EQ(7200, windows[1].mBegin);
+    EXPECT_EQ(1, windows[1].mCount);
+    // The window at 14400 has only a missing value.
+
+    EXPECT_EQ(cMissing, Aggregate().mean());
+    EXPECT_THROW(WindowAggregator(0), invalid_argument);
+
+    vector<uint64_t> randomTimeStamps;
+    vector<double> randomValues;
+    makeSamples(5000, randomTimeStamps, randomValues);
+    for (uint64_t windowSize: { uint64_t(3600), uint64_t(86400) }) {
+        expectEqual(bruteForce(randomTimeStamps, randomValues, windowSize, windowSize),
+                    WindowAggregator::aggregate(randomTimeStamps.data(), randomValues.data(), randomValues.size(), windowSize));
+    }
+}
+
+TEST(WindowAggregatorTest, sliding) {
+    vector<uint64_t> timeStamps;
+    vector<double> values;
+    makeSamples(3000, timeStamps, values);
+    expectEqual(bruteForce(timeStamps, values, 3600, 300),
+                WindowAggregator::aggregate(timeStamps.data(), values.data(), values.size(), 3600, 300));
+    expectEqual(bruteForce(timeStamps, values, 3600, 1800),
+                WindowAggregator::aggregate(timeStamps.data(), values.data(), values.size(), 3600, 1800));
+    // Windows, which do not cover the time series.
+    expectEqual(bruteForce(timeStamps, values, 600, 3600),
+                WindowAggregator::aggregate(timeStamps.data(), values.data(), values.size(), 600, 3600));
+}
+
+TEST(WindowAggregatorTest, incremental) {
+    vector<uint64_t> timeStamps;
+    vector<double> values;
+    makeSamples(3000, timeStamps, values);
+
+    WindowAggregator aggregator(3600, 900);
+    EXPECT_EQ(3600, aggregator.windowSize());
+    EXPECT_EQ(900, aggregator.slide());
+    vector<Aggregate> windows;
+    for (size_t i = 0; i < timeStamps.size(); ++i) {
+        EXPECT_TRUE(aggregator.append(timeStamps[i], values[i]));
+        if (i % 100 == 0) {
+            vector<Aggregate> completed = aggregator.takeWindows();
+            windows.insert(windows.end(), completed.begin(), completed.end());
+        }
+    }
+    vector<Aggregate> completed = aggregator.takeWindows();
+    windows.insert(windows.end(), completed.begin(), completed.end());
+    vector<Aggregate> open = aggregator.openWindows();
+    EXPECT_EQ(4, open.size());
+    // A sample for a completed window.
+    EXPECT_FALSE(aggregator.append(timeStamps.front(), 1.0));
+
+    aggregator.close();
+    completed = aggregator.takeWindows();
+    expectEqual(open, completed);
+    windows.insert(windows.end(), completed.begin(), completed.end());
+    expectEqual(bruteForce(timeStamps, values, 3600, 900), windows);
+    EXPECT_TRUE(aggregator.takeWindows().empty());
+
+    // Late samples for open windows are accepted.
+    WindowAggregator late(3600);
+    EXPECT_TRUE(late.append(3700, 1.0));
+    EXPECT_TRUE(late.append(3650, 2.0));
+    MeasureColumns columns(1);
+    columns.mTimeStamps = { 3610, 7300 };
+    columns.mValues[0] = { 3.0, 4.0 };
+    EXPECT_EQ(2, late.append(columns, 0));
+    EXPECT_THROW(late.append(columns, 1), out_of_range);
+    vector<Aggregate> lateWindows = late.takeWindows();
+    ASSERT_EQ(1, lateWindows.size());
+    EXPECT_EQ(3, lateWindows[0].mCount);
+    EXPECT_EQ(6.0, lateWindows[0].mSum);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}